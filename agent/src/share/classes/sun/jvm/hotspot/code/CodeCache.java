@@ -32,11 +32,13 @@ import sun.jvm.hotspot.types.*;
 import sun.jvm.hotspot.utilities.*;
 
 public class CodeCache {
-  private static AddressField       heapField;
+  private static AddressField       heapsField;
+  private static AddressField       lowBoundField;
+  private static AddressField       highBoundField;
   private static AddressField       scavengeRootNMethodsField;
   private static VirtualConstructor virtualConstructor;
 
-  private CodeHeap heap;
+  private GrowableArray<CodeHeap> heaps;
 
   static {
     VM.registerVMInitializedObserver(new Observer() {
@@ -49,7 +51,9 @@ public class CodeCache {
   private static synchronized void initialize(TypeDataBase db) {
     Type type = db.lookupType("CodeCache");
 
-    heapField = type.getAddressField("_heap");
+    heapsField = type.getAddressField("_heaps");
+    lowBoundField = type.getAddressField("_low_bound");
+    highBoundField = type.getAddressField("_high_bound");
     scavengeRootNMethodsField = type.getAddressField("_scavenge_root_nmethods");
 
     virtualConstructor = new VirtualConstructor(db);
@@ -68,7 +72,7 @@ public class CodeCache {
   }
 
   public CodeCache() {
-    heap = (CodeHeap) VMObjectFactory.newObject(CodeHeap.class, heapField.getValue());
+    heaps = GrowableArray.create(heapsField.getValue(), new StaticBaseConstructor<CodeHeap>(CodeHeap.class));
   }
 
   public NMethod scavengeRootMethods() {
@@ -76,7 +80,7 @@ public class CodeCache {
   }
 
   public boolean contains(Address p) {
-    return getHeap().contains(p);
+    return getHeap(p) != null;
   }
 
   /** When VM.getVM().isDebugging() returns true, this behaves like
@@ -97,14 +101,18 @@ public class CodeCache {
 
   public CodeBlob findBlobUnsafe(Address start) {
     CodeBlob result = null;
+    CodeHeap heap = getHeap(start);
+    if (heap == null) {
+      return null;
+    }
 
     try {
-      result = (CodeBlob) virtualConstructor.instantiateWrapperFor(getHeap().findStart(start));
+      result = (CodeBlob) virtualConstructor.instantiateWrapperFor(heap.findStart(start));
     }
     catch (WrongTypeException wte) {
       Address cbAddr = null;
       try {
-        cbAddr = getHeap().findStart(start);
+        cbAddr = heap.findStart(start);
       }
       catch (Exception findEx) {
         findEx.printStackTrace();
@@ -167,31 +175,32 @@ public class CodeCache {
   }
 
   public void iterate(CodeCacheVisitor visitor) {
-    CodeHeap heap = getHeap();
-    Address ptr = heap.begin();
-    Address end = heap.end();
-
-    visitor.prologue(ptr, end);
+    visitor.prologue(lowBoundField.getValue(), highBoundField.getValue());
     CodeBlob lastBlob = null;
-    while (ptr != null && ptr.lessThan(end)) {
-      try {
-        // Use findStart to get a pointer inside blob other findBlob asserts
-        CodeBlob blob = findBlobUnsafe(heap.findStart(ptr));
-        if (blob != null) {
-          visitor.visit(blob);
-          if (blob == lastBlob) {
-            throw new InternalError("saw same blob twice");
+    for (int i = 0; i < heaps.length(); i++) {
+      CodeHeap heap = heaps.at(i);
+      Address ptr = heap.begin();
+      Address end = heap.end();
+      while (ptr != null && ptr.lessThan(end)) {
+        try {
+          // Use findStart to get a pointer inside blob other findBlob asserts
+          CodeBlob blob = findBlobUnsafe(heap.findStart(ptr));
+          if (blob != null) {
+            visitor.visit(blob);
+            if (blob == lastBlob) {
+              throw new InternalError("saw same blob twice");
+            }
+            lastBlob = blob;
           }
-          lastBlob = blob;
+        } catch (RuntimeException e) {
+          e.printStackTrace();
         }
-      } catch (RuntimeException e) {
-        e.printStackTrace();
-      }
-      Address next = heap.nextBlock(ptr);
-      if (next != null && next.lessThan(ptr)) {
-        throw new InternalError("pointer moved backwards");
+        Address next = heap.nextBlock(ptr);
+        if (next != null && next.lessThan(ptr)) {
+          throw new InternalError("pointer moved backwards");
+        }
+        ptr = next;
       }
-      ptr = next;
     }
     visitor.epilogue();
   }
@@ -200,7 +209,13 @@ public class CodeCache {
   // Internals only below this point
   //
 
-  private CodeHeap getHeap() {
-    return heap;
+  private CodeHeap getHeap(Address p) {
+    for (int i = 0; i < heaps.length(); i++) {
+      CodeHeap heap = heaps.at(i);
+      if (heap.contains(p)) {
+        return heap;
+      }
+    }
+    return null;
   }
 }
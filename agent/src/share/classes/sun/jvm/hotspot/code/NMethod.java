@@ -58,6 +58,11 @@ public class NMethod extends CodeBlob {
   private static CIntegerField nulChkTableOffsetField;
   private static CIntegerField nmethodEndOffsetField;
 
+  /** Scopes data shared with other nmethods, if any */
+  private static AddressField  sharedScopesDataField;
+  private static AddressField  sharedScopesDataDataField;
+  private static CIntegerField sharedScopesDataLengthField;
+
   /** Offsets for entry points */
   /** Entry point with class check */
   private static AddressField  entryPointField;
@@ -110,6 +115,10 @@ public class NMethod extends CodeBlob {
     handlerTableOffsetField     = type.getCIntegerField("_handler_table_offset");
     nulChkTableOffsetField      = type.getCIntegerField("_nul_chk_table_offset");
     nmethodEndOffsetField       = type.getCIntegerField("_nmethod_end_offset");
+    sharedScopesDataField       = type.getAddressField("_shared_scopes_data");
+    Type sharedType = db.lookupType("SharedScopesData");
+    sharedScopesDataDataField   = sharedType.getAddressField("_data");
+    sharedScopesDataLengthField = sharedType.getCIntegerField("_length");
     entryPointField             = type.getAddressField("_entry_point");
     verifiedEntryPointField     = type.getAddressField("_verified_entry_point");
     osrEntryPointField          = type.getAddressField("_osr_entry_point");
@@ -153,8 +162,20 @@ public class NMethod extends CodeBlob {
   public Address oopsEnd()              { return headerBegin().addOffsetTo(getMetadataOffset());     }
   public Address metadataBegin()        { return headerBegin().addOffsetTo(getMetadataOffset());     }
   public Address metadataEnd()          { return headerBegin().addOffsetTo(getScopesDataOffset());   }
-  public Address scopesDataBegin()      { return headerBegin().addOffsetTo(getScopesDataOffset());   }
-  public Address scopesDataEnd()        { return headerBegin().addOffsetTo(getScopesPCsOffset());    }
+  public Address scopesDataBegin() {
+    Address shared = sharedScopesDataField.getValue(addr);
+    if (shared != null) {
+      return sharedScopesDataDataField.getValue(shared);
+    }
+    return headerBegin().addOffsetTo(getScopesDataOffset());
+  }
+  public Address scopesDataEnd() {
+    Address shared = sharedScopesDataField.getValue(addr);
+    if (shared != null) {
+      return scopesDataBegin().addOffsetTo(sharedScopesDataLengthField.getValue(shared));
+    }
+    return headerBegin().addOffsetTo(getScopesPCsOffset());
+  }
   public Address scopesPCsBegin()       { return headerBegin().addOffsetTo(getScopesPCsOffset());    }
   public Address scopesPCsEnd()         { return headerBegin().addOffsetTo(getDependenciesOffset()); }
   public Address dependenciesBegin()    { return headerBegin().addOffsetTo(getDependenciesOffset()); }
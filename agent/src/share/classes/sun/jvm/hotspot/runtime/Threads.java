@@ -128,6 +128,7 @@ public class Threads {
         virtualConstructor.addMapping("SurrogateLockerThread", JavaThread.class);
         virtualConstructor.addMapping("JvmtiAgentThread", JvmtiAgentThread.class);
         virtualConstructor.addMapping("ServiceThread", ServiceThread.class);
+        virtualConstructor.addMapping("CodeCacheSweeperThread", CodeCacheSweeperThread.class);
     }
 
     public Threads() {
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package jdk.vm.ci.hotspot.test;
+
+import org.junit.Assert;
+import org.junit.Test;
+
+import jdk.vm.ci.hotspot.HotSpotConstantPool;
+import jdk.vm.ci.meta.JavaField;
+import jdk.vm.ci.meta.JavaMethod;
+import jdk.vm.ci.meta.MetaAccessProvider;
+import jdk.vm.ci.meta.ResolvedJavaMethod;
+import jdk.vm.ci.runtime.JVMCI;
+
+public class TestHotSpotConstantPool {
+
+    public static final int ALOAD_0 = 42; // 0x2A
+    public static final int GETFIELD = 180; // 0xB4
+    public static final int INVOKEVIRTUAL = 182; // 0xB6
+
+    int field;
+
+    static int getField(TestHotSpotConstantPool receiver) {
+        return receiver.field;
+    }
+
+    static String invokeVirtual(Object receiver) {
+        return receiver.toString();
+    }
+
+    private static ResolvedJavaMethod getMethod(String name) throws Exception {
+        MetaAccessProvider metaAccess = JVMCI.getRuntime().getHostJVMCIBackend().getMetaAccess();
+        return metaAccess.lookupJavaMethod(TestHotSpotConstantPool.class.getDeclaredMethod(name, name.equals("getField") ? TestHotSpotConstantPool.class : Object.class));
+    }
+
+    private static int beU2(byte[] data, int bci) {
+        return ((data[bci] & 0xff) << 8) | (data[bci + 1] & 0xff);
+    }
+
+    @Test
+    public void loadMemberReferencesMethodTest() throws Exception {
+        ResolvedJavaMethod m = getMethod("invokeVirtual");
+        byte[] code = m.getCode();
+        Assert.assertEquals(ALOAD_0, code[0] & 0xff);
+        Assert.assertEquals(INVOKEVIRTUAL, code[1] & 0xff);
+        int cpi = beU2(code, 2);
+
+        JavaMethod expected = m.getConstantPool().lookupMethod(cpi, INVOKEVIRTUAL);
+        HotSpotConstantPool cp = (HotSpotConstantPool) m.getConstantPool();
+        cp.loadMemberReferences(new int[]{cpi, cpi}, new int[]{INVOKEVIRTUAL, INVOKEVIRTUAL});
+        JavaMethod actual = cp.lookupMethod(cpi, INVOKEVIRTUAL);
+        Assert.assertEquals(expected.getName(), actual.getName());
+        Assert.assertEquals(expected.getSignature().toMethodDescriptor(), actual.getSignature().toMethodDescriptor());
+        Assert.assertEquals(expected.getDeclaringClass().getName(), actual.getDeclaringClass().getName());
+        Assert.assertEquals(expected.getDeclaringClass().getName(), cp.lookupReferencedType(cpi, INVOKEVIRTUAL).getName());
+    }
+
+    @Test
+    public void loadMemberReferencesFieldTest() throws Exception {
+        ResolvedJavaMethod m = getMethod("getField");
+        byte[] code = m.getCode();
+        Assert.assertEquals(ALOAD_0, code[0] & 0xff);
+        Assert.assertEquals(GETFIELD, code[1] & 0xff);
+        int cpi = beU2(code, 2);
+
+        JavaField expected = m.getConstantPool().lookupField(cpi, m, GETFIELD);
+        HotSpotConstantPool cp = (HotSpotConstantPool) m.getConstantPool();
+        cp.loadMemberReferences(new int[]{cpi}, new int[]{GETFIELD});
+        JavaField actual = cp.lookupField(cpi, m, GETFIELD);
+        Assert.assertEquals(expected.getName(), actual.getName());
+        Assert.assertEquals("field", actual.getName());
+        Assert.assertEquals(expected.getType().getName(), actual.getType().getName());
+        Assert.assertEquals(expected.getDeclaringClass().getName(), actual.getDeclaringClass().getName());
+    }
+
+    @Test(expected = IllegalArgumentException.class)
+    public void loadMemberReferencesLengthMismatchTest() throws Exception {
+        HotSpotConstantPool cp = (HotSpotConstantPool) getMethod("invokeVirtual").getConstantPool();
+        cp.loadMemberReferences(new int[]{1, 2}, new int[]{INVOKEVIRTUAL});
+    }
+}
@@ -265,6 +265,27 @@ final class CompilerToVM {
      */
     native int lookupKlassRefIndexInPool(HotSpotConstantPool constantPool, int cpi);
 
+    /**
+     * Gets the name, signature, {@code JVM_CONSTANT_NameAndType} index and {@code JVM_CONSTANT_Class}
+     * index for each of the entries denoted by {@code which} in {@code constantPool}. This is the
+     * batched form of {@link #lookupNameInPool}, {@link #lookupSignatureInPool},
+     * {@link #lookupNameAndTypeRefIndexInPool} and {@link #lookupKlassRefIndexInPool} and needs a
+     * single VM transition for all entries.
+     *
+     * The behavior of this method is undefined if any element of {@code which} does not denote an
+     * entry that references a {@code JVM_CONSTANT_NameAndType} entry.
+     *
+     * @param names receives the name for {@code which[i]} at index {@code i}. Must have the same
+     *            length as {@code which}.
+     * @param signatures receives the signature for {@code which[i]} at index {@code i}. Must have
+     *            the same length as {@code which}.
+     * @param refIndexes receives the {@code JVM_CONSTANT_NameAndType} index for {@code which[i]} at
+     *            index {@code 2 * i} and the {@code JVM_CONSTANT_Class} index at index
+     *            {@code 2 * i + 1}. The latter is -1 for an {@code invokedynamic} entry. Must be
+     *            twice the length of {@code which}.
+     */
+    native void lookupMemberRefsInPool(HotSpotConstantPool constantPool, int[] which, String[] names, String[] signatures, int[] refIndexes);
+
     /**
      * Looks up a class denoted by the {@code JVM_CONSTANT_Class} entry at index {@code cpi} in
      * {@code constantPool}. This method does not perform any resolution.
@@ -929,7 +950,9 @@ final class CompilerToVM {
      *
      * @param currentFailures the known failures at {@code failedSpeculationsAddress}
      * @return the list of failed speculations with each entry being a single speculation in the
-     *         format emitted by {@link HotSpotSpeculationEncoding#toByteArray()}
+     *         format emitted by {@link HotSpotSpeculationEncoding#toByteArray()}. The list is in
+     *         order of failure and {@code currentFailures} is a prefix of it. Only the entries
+     *         after the prefix are copied from native memory.
      */
     native byte[][] getFailedSpeculations(long failedSpeculationsAddress, byte[][] currentFailures);
 
@@ -949,7 +972,8 @@ final class CompilerToVM {
      * Adds a speculation to the failed speculations pointed to by
      * {@code *failedSpeculationsAddress}.
      *
-     * @return {@code false} if the speculation could not be appended to the list
+     * @return {@code false} if the speculation could not be added to the list. Adding a
+     *         speculation that is already in the list succeeds without changing the list.
      */
     native boolean addFailedSpeculation(long failedSpeculationsAddress, byte[] speculation);
 
@@ -134,6 +134,9 @@ public class HotSpotCodeCacheProvider implements CodeCacheProvider {
             speculations = new byte[0];
             failedSpeculationsAddress = 0L;
         }
+        if (HotSpotJVMCIRuntime.Option.InstallCodeSiteStream.getBoolean()) {
+            hsCompiledCode.encodeSiteStream();
+        }
         int result = runtime.getCompilerToVM().installCode(target, (HotSpotCompiledCode) compiledCode, resultInstalledCode, failedSpeculationsAddress, speculations);
         if (result != config.codeInstallResultOk) {
             String resultDesc = config.getCodeInstallResultDescription(result);
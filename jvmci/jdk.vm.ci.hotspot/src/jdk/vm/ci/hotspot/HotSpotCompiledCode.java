@@ -106,6 +106,14 @@ public class HotSpotCompiledCode implements CompiledCode {
      */
     protected final StackSlot deoptRescueSlot;
 
+    /**
+     * Compact encoding of the kind, pc offset and primitive operands of each element of
+     * {@link #sites}. If {@code null}, the VM reads this information from the site objects.
+     *
+     * @see HotSpotSiteEncoding
+     */
+    protected byte[] siteStream;
+
     public static class Comment {
 
         public final String text;
@@ -147,6 +155,16 @@ public class HotSpotCompiledCode implements CompiledCode {
         return name;
     }
 
+    /**
+     * Computes {@link #siteStream} if it has not already been computed. The stream is left
+     * {@code null} if {@link #sites} contains a site that cannot be encoded.
+     */
+    void encodeSiteStream() {
+        if (siteStream == null) {
+            siteStream = HotSpotSiteEncoding.encode(sites);
+        }
+    }
+
     /**
      * Ensure that all the frames passed into the VM are properly formatted with an empty or illegal
      * slot following double word slots.
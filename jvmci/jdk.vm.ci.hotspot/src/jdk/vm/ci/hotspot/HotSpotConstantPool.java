@@ -27,6 +27,11 @@ import static jdk.vm.ci.hotspot.HotSpotJVMCIRuntime.runtime;
 import static jdk.vm.ci.hotspot.HotSpotVMConfig.config;
 import static jdk.vm.ci.hotspot.UnsafeAccess.UNSAFE;
 
+import java.util.HashSet;
+import java.util.Map;
+import java.util.Set;
+import java.util.concurrent.ConcurrentHashMap;
+
 import jdk.vm.ci.common.JVMCIError;
 import jdk.vm.ci.common.NativeImageReinitialize;
 import jdk.vm.ci.meta.ConstantPool;
@@ -190,6 +195,24 @@ public final class HotSpotConstantPool implements ConstantPool, MetaspaceHandleO
         }
     }
 
+    /**
+     * The name, signature and reference indexes of a field or method reference entry as returned
+     * by {@link CompilerToVM#lookupMemberRefsInPool}.
+     */
+    private static final class MemberRef {
+        final String name;
+        final String signature;
+        final int nameAndTypeRefIndex;
+        final int klassRefIndex;
+
+        MemberRef(String name, String signature, int nameAndTypeRefIndex, int klassRefIndex) {
+            this.name = name;
+            this.signature = signature;
+            this.nameAndTypeRefIndex = nameAndTypeRefIndex;
+            this.klassRefIndex = klassRefIndex;
+        }
+    }
+
     /**
      * Handle to the {@code ConstantPool} VM object. The handle is in
      * {@code JVMCI::_metadata_handles}.
@@ -199,6 +222,12 @@ public final class HotSpotConstantPool implements ConstantPool, MetaspaceHandleO
     private volatile LookupTypeCacheElement lastLookupType;
     private final JvmConstants constants;
 
+    /**
+     * Member references loaded by {@link #loadMemberReferences}, keyed by constant pool cache
+     * index. Lazily initialized.
+     */
+    private volatile Map<Integer, MemberRef> memberRefs;
+
     /**
      * Gets the JVMCI mirror from a HotSpot constant pool.The VM is responsible for ensuring that
      * the ConstantPool is kept alive for the duration of this call and the
@@ -389,6 +418,10 @@ public final class HotSpotConstantPool implements ConstantPool, MetaspaceHandleO
      * @return {@code JVM_CONSTANT_NameAndType} reference constant pool entry
      */
     private int getNameAndTypeRefIndexAt(int index) {
+        MemberRef ref = getMemberRef(index);
+        if (ref != null) {
+            return ref.nameAndTypeRefIndex;
+        }
         return compilerToVM().lookupNameAndTypeRefIndexInPool(this, index);
     }
 
@@ -400,6 +433,10 @@ public final class HotSpotConstantPool implements ConstantPool, MetaspaceHandleO
      * @return name as {@link String}
      */
     private String getNameOf(int which) {
+        MemberRef ref = getMemberRef(which);
+        if (ref != null) {
+            return ref.name;
+        }
         return compilerToVM().lookupNameInPool(this, which);
     }
 
@@ -424,6 +461,10 @@ public final class HotSpotConstantPool implements ConstantPool, MetaspaceHandleO
      * @return signature as {@link String}
      */
     private String getSignatureOf(int which) {
+        MemberRef ref = getMemberRef(which);
+        if (ref != null) {
+            return ref.signature;
+        }
         return compilerToVM().lookupSignatureInPool(this, which);
     }
 
@@ -447,9 +488,75 @@ public final class HotSpotConstantPool implements ConstantPool, MetaspaceHandleO
      * @return klass reference index
      */
     private int getKlassRefIndexAt(int index) {
+        MemberRef ref = getMemberRef(index);
+        if (ref != null && ref.klassRefIndex != -1) {
+            return ref.klassRefIndex;
+        }
         return compilerToVM().lookupKlassRefIndexInPool(this, index);
     }
 
+    /**
+     * Gets the member reference loaded by {@link #loadMemberReferences} for the constant pool cache
+     * index {@code which}.
+     *
+     * @return {@code null} if the entry at {@code which} has not been loaded
+     */
+    private MemberRef getMemberRef(int which) {
+        Map<Integer, MemberRef> refs = memberRefs;
+        return refs == null ? null : refs.get(which);
+    }
+
+    /**
+     * Loads the name, signature and holder class reference of the field and method references
+     * used by a set of instructions with a single call into the VM. The results are cached so that
+     * subsequent {@link #lookupMethod}, {@link #lookupField} and {@link #lookupReferencedType}
+     * calls for these entries do not need separate VM calls for this information. A compiler can
+     * use this to load all the member references of a method before parsing its bytecode.
+     *
+     * @param rawIndexes constant pool indexes from the bytecode of field access and invoke
+     *            instructions
+     * @param opcodes the opcodes of the instructions from which {@code rawIndexes} were read
+     */
+    public void loadMemberReferences(int[] rawIndexes, int[] opcodes) {
+        if (rawIndexes.length != opcodes.length) {
+            throw new IllegalArgumentException("length of rawIndexes (" + rawIndexes.length + ") does not match length of opcodes (" + opcodes.length + ")");
+        }
+        Map<Integer, MemberRef> refs = memberRefs;
+        Set<Integer> seen = new HashSet<>();
+        int[] which = new int[rawIndexes.length];
+        int count = 0;
+        for (int i = 0; i < rawIndexes.length; i++) {
+            int index = rawIndexToConstantPoolCacheIndex(rawIndexes[i], opcodes[i]);
+            if ((refs == null || !refs.containsKey(index)) && seen.add(index)) {
+                which[count++] = index;
+            }
+        }
+        if (count == 0) {
+            return;
+        }
+        if (count != which.length) {
+            int[] trimmed = new int[count];
+            System.arraycopy(which, 0, trimmed, 0, count);
+            which = trimmed;
+        }
+        String[] names = new String[count];
+        String[] signatures = new String[count];
+        int[] refIndexes = new int[count * 2];
+        compilerToVM().lookupMemberRefsInPool(this, which, names, signatures, refIndexes);
+        if (refs == null) {
+            synchronized (this) {
+                refs = memberRefs;
+                if (refs == null) {
+                    refs = new ConcurrentHashMap<>();
+                    memberRefs = refs;
+                }
+            }
+        }
+        for (int i = 0; i < count; i++) {
+            refs.put(which[i], new MemberRef(names[i], signatures[i], refIndexes[i * 2], refIndexes[i * 2 + 1]));
+        }
+    }
+
     /**
      * Gets the uncached klass reference index constant pool entry at index {@code index}. See:
      * {@code ConstantPool::uncached_klass_ref_index_at}.
@@ -229,7 +229,10 @@ public final class HotSpotJVMCIRuntime implements JVMCIRuntime {
                 "Enables tracing of profiling info when read by JVMCI.",
                 "Empty value: trace all methods",
                         "Non-empty value: trace methods whose fully qualified name contains the value."),
-        UseProfilingInformation(Boolean.class, true, "");
+        UseProfilingInformation(Boolean.class, true, ""),
+        InstallCodeSiteStream(Boolean.class, false, "Pass the kind, pc offset and primitive operands of code sites " +
+                "to the VM in a compact byte stream when installing code. Call targets, debug info, oop maps " +
+                "and data patch references are still read from the site objects.");
         // @formatter:on
 
         /**
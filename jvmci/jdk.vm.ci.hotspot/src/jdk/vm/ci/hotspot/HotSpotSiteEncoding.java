@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package jdk.vm.ci.hotspot;
+
+import static jdk.vm.ci.hotspot.HotSpotVMConfig.config;
+
+import java.io.ByteArrayOutputStream;
+
+import jdk.vm.ci.code.site.Call;
+import jdk.vm.ci.code.site.DataPatch;
+import jdk.vm.ci.code.site.ExceptionHandler;
+import jdk.vm.ci.code.site.ImplicitExceptionDispatch;
+import jdk.vm.ci.code.site.Infopoint;
+import jdk.vm.ci.code.site.InfopointReason;
+import jdk.vm.ci.code.site.Mark;
+import jdk.vm.ci.code.site.Site;
+
+/**
+ * Encodes the kind, pc offset and primitive operands of {@link HotSpotCompiledCode#sites} into a
+ * byte array that the VM decodes with a {@code CompressedReadStream} during code installation.
+ * This saves the VM from reading these values out of each site object individually.
+ *
+ * The stream starts with the number of sites followed by one entry per site: a kind byte, the pc
+ * offset and, for {@link Mark}, {@link ExceptionHandler} and {@link ImplicitExceptionDispatch}
+ * sites, an operand. Ints are written in the UNSIGNED5 format of {@code CompressedWriteStream}.
+ *
+ * Only these site headers are encoded. The bodies of sites that reference objects (the target of
+ * a {@link Call}, the debug info and oop maps of an {@link Infopoint} and the reference of a
+ * {@link DataPatch}) as well as the data section and the other fields of
+ * {@link HotSpotCompiledCode} are still read by the VM from the object graph.
+ */
+// Also defined in C++ CodeInstaller and CompressedWriteStream classes - keep in sync.
+final class HotSpotSiteEncoding extends ByteArrayOutputStream {
+
+    private static final int LG_H = 6;
+    private static final int H = 1 << LG_H;
+    private static final int L = 256 - H;
+    private static final int MAX_I = 4;
+
+    private HotSpotSiteEncoding(int size) {
+        super(size);
+    }
+
+    /**
+     * Encodes {@code sites}.
+     *
+     * @return the encoded stream or {@code null} if {@code sites} contains a site the encoding
+     *         does not support, in which case the VM reads all sites from the site objects
+     */
+    static byte[] encode(Site[] sites) {
+        HotSpotVMConfig config = config();
+        HotSpotSiteEncoding stream = new HotSpotSiteEncoding(1 + sites.length * 4);
+        stream.writeInt(sites.length);
+        for (Site site : sites) {
+            if (site instanceof Call) {
+                stream.writeSite(config.siteKindCall, site);
+            } else if (site instanceof Infopoint) {
+                InfopointReason reason = ((Infopoint) site).reason;
+                if (reason == InfopointReason.IMPLICIT_EXCEPTION) {
+                    if (site instanceof ImplicitExceptionDispatch) {
+                        stream.writeSite(config.siteKindImplicitExceptionDispatch, site);
+                        stream.writeInt(((ImplicitExceptionDispatch) site).dispatchOffset);
+                    } else {
+                        stream.writeSite(config.siteKindImplicitException, site);
+                    }
+                } else if (reason == InfopointReason.SAFEPOINT || reason == InfopointReason.CALL) {
+                    stream.writeSite(config.siteKindSafepoint, site);
+                } else if (reason != null) {
+                    stream.writeSite(config.siteKindInfopoint, site);
+                } else {
+                    return null;
+                }
+            } else if (site instanceof DataPatch) {
+                stream.writeSite(config.siteKindDataPatch, site);
+            } else if (site instanceof Mark) {
+                Object id = ((Mark) site).id;
+                if (!(id instanceof Integer)) {
+                    return null;
+                }
+                stream.writeSite(config.siteKindMark, site);
+                stream.writeSignedInt((Integer) id);
+            } else if (site instanceof ExceptionHandler) {
+                stream.writeSite(config.siteKindExceptionHandler, site);
+                stream.writeInt(((ExceptionHandler) site).handlerPos);
+            } else {
+                return null;
+            }
+        }
+        return stream.toByteArray();
+    }
+
+    private void writeSite(int kind, Site site) {
+        write(kind);
+        writeInt(site.pcOffset);
+    }
+
+    /**
+     * Equivalent of {@code CompressedWriteStream::write_int}.
+     */
+    private void writeInt(int value) {
+        long sum = value & 0xFFFFFFFFL;
+        for (int i = 0; sum >= L && i < MAX_I; i++) {
+            sum -= L;
+            write((int) (L + (sum & (H - 1))));
+            sum >>>= LG_H;
+        }
+        write((int) sum);
+    }
+
+    /**
+     * Equivalent of {@code CompressedWriteStream::write_signed_int}.
+     */
+    private void writeSignedInt(int value) {
+        writeInt((value << 1) ^ (value >> 31));
+    }
+}
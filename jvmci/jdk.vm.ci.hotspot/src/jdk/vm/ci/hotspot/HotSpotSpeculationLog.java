@@ -24,10 +24,13 @@ package jdk.vm.ci.hotspot;
 
 import static jdk.vm.ci.hotspot.CompilerToVM.compilerToVM;
 
+import java.nio.ByteBuffer;
 import java.util.ArrayList;
 import java.util.Arrays;
 import java.util.Formatter;
+import java.util.HashSet;
 import java.util.List;
+import java.util.Set;
 
 import jdk.vm.ci.code.BailoutException;
 import jdk.vm.ci.common.JVMCIError;
@@ -163,6 +166,12 @@ public class HotSpotSpeculationLog implements SpeculationLog {
      */
     private byte[][] failedSpeculations;
 
+    /**
+     * The elements of {@link #failedSpeculations} wrapped in {@link ByteBuffer}s so that they can
+     * be looked up by content.
+     */
+    private Set<ByteBuffer> failedSpeculationSet;
+
     /**
      * Speculations made during the compilation associated with this log.
      */
@@ -172,8 +181,17 @@ public class HotSpotSpeculationLog implements SpeculationLog {
     @Override
     public void collectFailedSpeculations() {
         if (failedSpeculationsAddress != 0 && UnsafeAccess.UNSAFE.getLong(failedSpeculationsAddress) != 0) {
+            int start = failedSpeculations == null ? 0 : failedSpeculations.length;
             failedSpeculations = compilerToVM().getFailedSpeculations(failedSpeculationsAddress, failedSpeculations);
             assert failedSpeculations.getClass() == byte[][].class;
+            if (failedSpeculations.length != start) {
+                if (failedSpeculationSet == null) {
+                    failedSpeculationSet = new HashSet<>();
+                }
+                for (int i = start; i < failedSpeculations.length; i++) {
+                    failedSpeculationSet.add(ByteBuffer.wrap(failedSpeculations[i]));
+                }
+            }
         }
     }
 
@@ -212,9 +230,9 @@ public class HotSpotSpeculationLog implements SpeculationLog {
         if (failedSpeculations == null) {
             collectFailedSpeculations();
         }
-        if (failedSpeculations != null && failedSpeculations.length != 0) {
+        if (failedSpeculationSet != null) {
             byte[] encoding = encode(reason);
-            return !contains(failedSpeculations, 0, encoding);
+            return !failedSpeculationSet.contains(ByteBuffer.wrap(encoding));
         }
         return true;
     }
@@ -380,6 +380,15 @@ class HotSpotVMConfig extends HotSpotVMConfigAccess {
         return "unknown";
     }
 
+    final int siteKindCall = getConstant("CodeInstaller::SITE_CALL", Integer.class);
+    final int siteKindSafepoint = getConstant("CodeInstaller::SITE_SAFEPOINT", Integer.class);
+    final int siteKindImplicitException = getConstant("CodeInstaller::SITE_IMPLICIT_EXCEPTION", Integer.class);
+    final int siteKindImplicitExceptionDispatch = getConstant("CodeInstaller::SITE_IMPLICIT_EXCEPTION_DISPATCH", Integer.class);
+    final int siteKindInfopoint = getConstant("CodeInstaller::SITE_INFOPOINT", Integer.class);
+    final int siteKindDataPatch = getConstant("CodeInstaller::SITE_DATA_PATCH", Integer.class);
+    final int siteKindMark = getConstant("CodeInstaller::SITE_MARK", Integer.class);
+    final int siteKindExceptionHandler = getConstant("CodeInstaller::SITE_EXCEPTION_HANDLER", Integer.class);
+
     final int bitDataExceptionSeenFlag = getConstant("BitData::exception_seen_flag", Integer.class);
     final int bitDataNullSeenFlag = getConstant("BitData::null_seen_flag", Integer.class);
     final int methodDataCountOffset = getConstant("CounterData::count_off", Integer.class);
@@ -128,6 +128,15 @@ VtableStub* VtableStubs::create_vtable_stub(int vtable_index) {
 }
 
 
+// Computes the byte offset of the dispatch cache entry of a receiver klass
+// in a CompiledICHolder. Klass pointers are aligned, so the entry index is
+// taken from the bits just above the alignment.
+static void dispatch_cache_entry_offset(MacroAssembler* masm, Register klass_to_offset) {
+  assert(CompiledICHolder::dispatch_cache_entry_size() == 2 * wordSize, "entry is a klass and a method");
+  __ shlptr(klass_to_offset, exact_log2(CompiledICHolder::dispatch_cache_entry_size()) - LogKlassAlignmentInBytes);
+  __ andptr(klass_to_offset, (CompiledICHolder::dispatch_cache_size - 1) * CompiledICHolder::dispatch_cache_entry_size());
+}
+
 VtableStub* VtableStubs::create_itable_stub(int itable_index) {
   // Note well: pd_code_size_limit is the absolute minimum we can get
   // away with.  If you add code here, bump the code stub size
@@ -163,14 +172,41 @@ VtableStub* VtableStubs::create_itable_stub(int itable_index) {
   Label L_no_such_interface;
 
   const Register icholder_reg = rax;
-  __ movptr(resolved_klass_reg, Address(icholder_reg, CompiledICHolder::holder_klass_offset()));
-  __ movptr(holder_klass_reg,   Address(icholder_reg, CompiledICHolder::holder_metadata_offset()));
 
   // get receiver klass (also an implicit null-check)
   assert(VtableStub::receiver_location() == j_rarg0->as_VMReg(), "receiver expected in j_rarg0");
   address npe_addr = __ pc();
   __ load_klass(recv_klass_reg, j_rarg0);
 
+  const int cache_klass_offset  = CompiledICHolder::dispatch_cache_offset() + CompiledICHolder::dispatch_cache_klass_offset();
+  const int cache_method_offset = CompiledICHolder::dispatch_cache_offset() + CompiledICHolder::dispatch_cache_method_offset();
+
+  if (UseInterfaceDispatchCache) {
+    // Look for the receiver klass in the dispatch cache of the call site.
+    // The method of an entry is published after its klass, so it may
+    // still be NULL.
+    Label L_cache_miss;
+    __ movptr(temp_reg, recv_klass_reg);
+    dispatch_cache_entry_offset(masm, temp_reg);
+    __ cmpptr(recv_klass_reg, Address(icholder_reg, temp_reg, Address::times_1, cache_klass_offset));
+    __ jccb(Assembler::notEqual, L_cache_miss);
+    __ movptr(rbx, Address(icholder_reg, temp_reg, Address::times_1, cache_method_offset));
+    __ testptr(rbx, rbx);
+    __ jccb(Assembler::zero, L_cache_miss);
+    if (CountInterfaceDispatchCache) {
+      __ incrementq(ExternalAddress(VtableStubs::dispatch_cache_hits_addr()));
+    }
+    __ jmp(Address(rbx, Method::from_compiled_offset()));
+
+    __ bind(L_cache_miss);
+    // Keep the CompiledICHolder for filling the cache below. Nothing
+    // walks the stack before it is popped again.
+    __ push(icholder_reg);
+  }
+
+  __ movptr(resolved_klass_reg, Address(icholder_reg, CompiledICHolder::holder_klass_offset()));
+  __ movptr(holder_klass_reg,   Address(icholder_reg, CompiledICHolder::holder_metadata_offset()));
+
   // Receiver subtype check against REFC.
   // Destroys recv_klass_reg value.
   __ lookup_interface_method(// inputs: rec. class, interface
@@ -209,12 +245,41 @@ VtableStub* VtableStubs::create_itable_stub(int itable_index) {
   }
 #endif // ASSERT
 
+  if (UseInterfaceDispatchCache) {
+    Label L_skip_fill;
+    __ pop(icholder_reg);
+    if (CountInterfaceDispatchCache) {
+      // May use rscratch1 (recv_klass_reg), which is reloaded below.
+      __ incrementq(ExternalAddress(VtableStubs::dispatch_cache_misses_addr()));
+    }
+    __ testptr(method, method);
+    __ jccb(Assembler::zero, L_skip_fill);
+
+    // Claim the entry of the receiver klass if it is still empty and
+    // publish the method. Entries are never overwritten.
+    __ load_klass(recv_klass_reg, j_rarg0);
+    __ movptr(temp_reg, recv_klass_reg);
+    dispatch_cache_entry_offset(masm, temp_reg);
+    __ lea(temp_reg, Address(icholder_reg, temp_reg, Address::times_1, CompiledICHolder::dispatch_cache_offset()));
+    __ xorptr(rax, rax);
+    if (os::is_MP()) {
+      __ lock();
+    }
+    __ cmpxchgptr(recv_klass_reg, Address(temp_reg, CompiledICHolder::dispatch_cache_klass_offset()));
+    __ jccb(Assembler::notEqual, L_skip_fill);
+    __ movptr(Address(temp_reg, CompiledICHolder::dispatch_cache_method_offset()), method);
+    __ bind(L_skip_fill);
+  }
+
   // rbx: Method*
   // j_rarg0: receiver
   address ame_addr = __ pc();
   __ jmp(Address(method, Method::from_compiled_offset()));
 
   __ bind(L_no_such_interface);
+  if (UseInterfaceDispatchCache) {
+    __ pop(icholder_reg);
+  }
   __ jump(RuntimeAddress(StubRoutines::throw_IncompatibleClassChangeError_entry()));
 
   __ flush();
@@ -242,7 +307,9 @@ int VtableStub::pd_code_size_limit(bool is_vtable_stub) {
   } else {
     // Itable stub size
     return (DebugVtables ? 512 : 140) + (CountCompiledCalls ? 13 : 0) +
-           (UseCompressedClassPointers ? 2 * MacroAssembler::instr_size_for_decode_klass_not_null() : 0);
+           (UseCompressedClassPointers ? 2 * MacroAssembler::instr_size_for_decode_klass_not_null() : 0) +
+           (UseInterfaceDispatchCache ? 80 + (UseCompressedClassPointers ? MacroAssembler::instr_size_for_decode_klass_not_null() : 0) +
+                                        (CountInterfaceDispatchCache ? 26 : 0) : 0);
   }
   // In order to tune these parameters, run the JVM with VM options
   // +PrintMiscellaneous and +WizardMode to see information about
@@ -41,6 +41,7 @@
 #include "code/codeBlob.hpp"
 #include "code/nmethod.hpp"
 #include "code/pcDesc.hpp"
+#include "code/sharedScopesData.hpp"
 #include "gc_interface/collectedHeap.hpp"
 #include "memory/heap.hpp"
 #include "memory/memRegion.hpp"
@@ -54,6 +55,7 @@
 #include "runtime/vmStructs.hpp"
 #include "utilities/accessFlags.hpp"
 #include "utilities/globalDefinitions.hpp"
+#include "utilities/growableArray.hpp"
 
 // These are defined somewhere for Solaris
 #define PR_MODEL_ILP32 1
@@ -240,6 +242,10 @@ int generateJvmOffsets(GEN_variant gen_variant) {
   GEN_OFFS(CodeHeap, _log2_segment_size);
   printf("\n");
 
+  GEN_VALUE(OFFSET_GrowableArray_CodeHeap_data, offset_of(GrowableArray<CodeHeap*>, _data));
+  GEN_VALUE(OFFSET_GrowableArray_CodeHeap_len, offset_of(GrowableArray<CodeHeap*>, _len));
+  printf("\n");
+
   GEN_OFFS(VirtualSpace, _low_boundary);
   GEN_OFFS(VirtualSpace, _high_boundary);
   GEN_OFFS(VirtualSpace, _low);
@@ -261,6 +267,9 @@ int generateJvmOffsets(GEN_variant gen_variant) {
   GEN_OFFS(nmethod, _handler_table_offset);
   GEN_OFFS(nmethod, _deoptimize_offset);
   GEN_OFFS(nmethod, _orig_pc_offset);
+  GEN_OFFS(nmethod, _shared_scopes_data);
+
+  GEN_OFFS(SharedScopesData, _data);
 
   GEN_OFFS(PcDesc, _pc_offset);
   GEN_OFFS(PcDesc, _scope_decode_offset);
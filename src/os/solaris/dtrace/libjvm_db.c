@@ -129,6 +129,7 @@ typedef struct Nmethod_t {
   int32_t  deopt_beg;           /* _deoptimize_offset */
   int32_t  scopes_data_beg;     /* _scopes_data_offset */
   int32_t  scopes_data_end;
+  uint64_t scopes_data;         /* address of the scopes data stream */
   int32_t  metadata_beg;        /* _metadata_offset */
   int32_t  metadata_end;
   int32_t  scopes_pcs_beg;      /* _scopes_pcs_offset */
@@ -138,6 +139,9 @@ typedef struct Nmethod_t {
   Vframe_t vframes[MAX_VFRAMES_CNT];
 } Nmethod_t;
 
+/* Upper bound of the number of CodeHeaps, see CodeBlobType */
+#define MAX_CODE_HEAPS 4
+
 struct jvm_agent {
   struct ps_prochandle* P;
 
@@ -150,7 +154,9 @@ struct jvm_agent {
   uint64_t Use_Compressed_Oops_address;
   uint64_t Universe_narrow_oop_base_address;
   uint64_t Universe_narrow_oop_shift_address;
-  uint64_t CodeCache_heap_address;
+  uint64_t CodeCache_heaps_address;
+  uint64_t CodeCache_low_address;
+  uint64_t CodeCache_high_address;
 
   /* Volatiles */
   uint8_t  Use_Compressed_Oops;
@@ -158,8 +164,11 @@ struct jvm_agent {
   uint32_t Universe_narrow_oop_shift;
   uint64_t CodeCache_low;
   uint64_t CodeCache_high;
-  uint64_t CodeCache_segmap_low;
-  uint64_t CodeCache_segmap_high;
+  int32_t  Number_of_heaps;
+  uint64_t Heap_low[MAX_CODE_HEAPS];
+  uint64_t Heap_high[MAX_CODE_HEAPS];
+  uint64_t Heap_segmap_low[MAX_CODE_HEAPS];
+  uint64_t Heap_segmap_high[MAX_CODE_HEAPS];
 
   int32_t  SIZE_CodeCache_log2_segment;
 
@@ -278,8 +287,14 @@ static int parse_vmstructs(jvm_agent_t* J) {
     }
 
     if (vmp->typeName[0] == 'C' && strcmp("CodeCache", vmp->typeName) == 0) {
-      if (strcmp("_heap", vmp->fieldName) == 0) {
-        err = read_pointer(J, vmp->address, &J->CodeCache_heap_address);
+      if (strcmp("_heaps", vmp->fieldName) == 0) {
+        err = read_pointer(J, vmp->address, &J->CodeCache_heaps_address);
+      }
+      if (strcmp("_low_bound", vmp->fieldName) == 0) {
+        J->CodeCache_low_address = vmp->address;
+      }
+      if (strcmp("_high_bound", vmp->fieldName) == 0) {
+        J->CodeCache_high_address = vmp->address;
       }
     } else if (vmp->typeName[0] == 'U' && strcmp("Universe", vmp->typeName) == 0) {
       if (strcmp("_narrow_oop._base", vmp->fieldName) == 0) {
@@ -319,6 +334,7 @@ static int find_symbol(jvm_agent_t* J, const char *name, uint64_t* valuep) {
 
 static int read_volatiles(jvm_agent_t* J) {
   uint64_t ptr;
+  int i;
   int err;
 
   err = find_symbol(J, "UseCompressedOops", &J->Use_Compressed_Oops_address);
@@ -334,22 +350,45 @@ static int read_volatiles(jvm_agent_t* J) {
   err = ps_pread(J->P,  J->Universe_narrow_oop_shift_address, &J->Universe_narrow_oop_shift, sizeof(uint32_t));
   CHECK_FAIL(err);
 
-  err = read_pointer(J, J->CodeCache_heap_address + OFFSET_CodeHeap_memory +
-                     OFFSET_VirtualSpace_low, &J->CodeCache_low);
+  err = read_pointer(J, J->CodeCache_low_address, &J->CodeCache_low);
   CHECK_FAIL(err);
-  err = read_pointer(J, J->CodeCache_heap_address + OFFSET_CodeHeap_memory +
-                     OFFSET_VirtualSpace_high, &J->CodeCache_high);
+  err = read_pointer(J, J->CodeCache_high_address, &J->CodeCache_high);
   CHECK_FAIL(err);
-  err = read_pointer(J, J->CodeCache_heap_address + OFFSET_CodeHeap_segmap +
-                     OFFSET_VirtualSpace_low, &J->CodeCache_segmap_low);
+
+  /* The CodeHeaps are kept in a GrowableArray<CodeHeap*> */
+  err = ps_pread(J->P, J->CodeCache_heaps_address + OFFSET_GrowableArray_CodeHeap_len,
+                 &J->Number_of_heaps, sizeof(J->Number_of_heaps));
   CHECK_FAIL(err);
-  err = read_pointer(J, J->CodeCache_heap_address + OFFSET_CodeHeap_segmap +
-                     OFFSET_VirtualSpace_high, &J->CodeCache_segmap_high);
+  if (J->Number_of_heaps < 0 || J->Number_of_heaps > MAX_CODE_HEAPS) {
+    err = -1;
+    goto fail;
+  }
+  err = read_pointer(J, J->CodeCache_heaps_address + OFFSET_GrowableArray_CodeHeap_data, &ptr);
   CHECK_FAIL(err);
 
-  err = ps_pread(J->P, J->CodeCache_heap_address + OFFSET_CodeHeap_log2_segment_size,
-                 &J->SIZE_CodeCache_log2_segment, sizeof(J->SIZE_CodeCache_log2_segment));
-  CHECK_FAIL(err);
+  for (i = 0; i < J->Number_of_heaps; i++) {
+    uint64_t heap_address;
+    err = read_pointer(J, ptr + i * POINTER_SIZE, &heap_address);
+    CHECK_FAIL(err);
+
+    err = read_pointer(J, heap_address + OFFSET_CodeHeap_memory +
+                       OFFSET_VirtualSpace_low, &J->Heap_low[i]);
+    CHECK_FAIL(err);
+    err = read_pointer(J, heap_address + OFFSET_CodeHeap_memory +
+                       OFFSET_VirtualSpace_high, &J->Heap_high[i]);
+    CHECK_FAIL(err);
+    err = read_pointer(J, heap_address + OFFSET_CodeHeap_segmap +
+                       OFFSET_VirtualSpace_low, &J->Heap_segmap_low[i]);
+    CHECK_FAIL(err);
+    err = read_pointer(J, heap_address + OFFSET_CodeHeap_segmap +
+                       OFFSET_VirtualSpace_high, &J->Heap_segmap_high[i]);
+    CHECK_FAIL(err);
+
+    /* All CodeHeaps use the same segment size */
+    err = ps_pread(J->P, heap_address + OFFSET_CodeHeap_log2_segment_size,
+                   &J->SIZE_CodeCache_log2_segment, sizeof(J->SIZE_CodeCache_log2_segment));
+    CHECK_FAIL(err);
+  }
 
   return PS_OK;
 
@@ -358,42 +397,55 @@ static int read_volatiles(jvm_agent_t* J) {
 }
 
 
+static int codeheap_contains(int heap_num, jvm_agent_t* J, uint64_t ptr) {
+  return (J->Heap_low[heap_num] <= ptr && ptr < J->Heap_high[heap_num]);
+}
+
 static int codecache_contains(jvm_agent_t* J, uint64_t ptr) {
-  /* make sure the code cache is up to date */
-  return (J->CodeCache_low <= ptr && ptr < J->CodeCache_high);
+  int i;
+  for (i = 0; i < J->Number_of_heaps; ++i) {
+    if (codeheap_contains(i, J, ptr)) {
+      return 1;
+    }
+  }
+  return 0;
 }
 
-static uint64_t segment_for(jvm_agent_t* J, uint64_t p) {
-  return (p - J->CodeCache_low) >> J->SIZE_CodeCache_log2_segment;
+static uint64_t segment_for(int heap_num, jvm_agent_t* J, uint64_t p) {
+  return (p - J->Heap_low[heap_num]) >> J->SIZE_CodeCache_log2_segment;
 }
 
-static uint64_t block_at(jvm_agent_t* J, int i) {
-  return J->CodeCache_low + (i << J->SIZE_CodeCache_log2_segment);
+static uint64_t block_at(int heap_num, jvm_agent_t* J, int i) {
+  return J->Heap_low[heap_num] + (i << J->SIZE_CodeCache_log2_segment);
 }
 
 static int find_start(jvm_agent_t* J, uint64_t ptr, uint64_t *startp) {
   int err;
+  int i;
 
   *startp = 0;
-  if (J->CodeCache_low <= ptr && ptr < J->CodeCache_high) {
-    int32_t used;
-    uint64_t segment = segment_for(J, ptr);
-    uint64_t block = J->CodeCache_segmap_low;
-    uint8_t tag;
-    err = ps_pread(J->P, block + segment, &tag, sizeof(tag));
-    CHECK_FAIL(err);
-    if (tag == 0xff)
-      return PS_OK;
-    while (tag > 0) {
+  for (i = 0; i < J->Number_of_heaps; ++i) {
+    if (codeheap_contains(i, J, ptr)) {
+      int32_t used;
+      uint64_t segment = segment_for(i, J, ptr);
+      uint64_t block = J->Heap_segmap_low[i];
+      uint8_t tag;
       err = ps_pread(J->P, block + segment, &tag, sizeof(tag));
       CHECK_FAIL(err);
-      segment -= tag;
-    }
-    block = block_at(J, segment);
-    err = ps_pread(J->P, block + OFFSET_HeapBlockHeader_used, &used, sizeof(used));
-    CHECK_FAIL(err);
-    if (used) {
-      *startp = block + SIZE_HeapBlockHeader;
+      if (tag == 0xff)
+        return PS_OK;
+      while (tag > 0) {
+        err = ps_pread(J->P, block + segment, &tag, sizeof(tag));
+        CHECK_FAIL(err);
+        segment -= tag;
+      }
+      block = block_at(i, J, segment);
+      err = ps_pread(J->P, block + OFFSET_HeapBlockHeader_used, &used, sizeof(used));
+      CHECK_FAIL(err);
+      if (used) {
+        *startp = block + SIZE_HeapBlockHeader;
+      }
+      return PS_OK;
     }
   }
   return PS_OK;
@@ -603,6 +655,16 @@ static int nmethod_info(Nmethod_t *N)
   err = ps_pread(J->P, nm + OFFSET_nmethod_scopes_data_offset, &N->scopes_data_beg, SZ32);
   CHECK_FAIL(err);
 
+  /* scopes_data lives in a SharedScopesData entry if the nmethod shares it */
+  err = read_pointer(J, nm + OFFSET_nmethod_shared_scopes_data, &N->scopes_data);
+  CHECK_FAIL(err);
+  if (N->scopes_data != 0) {
+    err = read_pointer(J, N->scopes_data + OFFSET_SharedScopesData_data, &N->scopes_data);
+    CHECK_FAIL(err);
+  } else {
+    N->scopes_data = nm + N->scopes_data_beg;
+  }
+
   if (debug > 2 ) {
       N->scopes_data_end = N->scopes_pcs_beg;
 
@@ -903,7 +965,7 @@ scope_desc_at(Nmethod_t *N, int32_t decode_offset, Vframe_t *vf)
       fprintf(stderr, "\t\t scope_desc_at: BEGIN \n");
   }
 
-  buffer = N->nm + N->scopes_data_beg + decode_offset;
+  buffer = N->scopes_data + decode_offset;
 
   err = raw_read_int(N->J, &buffer, &vf->sender_decode_offset);
   CHECK_FAIL(err);
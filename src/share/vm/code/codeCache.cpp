@@ -30,6 +30,7 @@
 #include "code/icBuffer.hpp"
 #include "code/nmethod.hpp"
 #include "code/pcDesc.hpp"
+#include "code/sharedScopesData.hpp"
 #include "compiler/compileBroker.hpp"
 #include "gc_implementation/shared/markSweep.hpp"
 #include "jfr/jfrEvents.hpp"
@@ -46,6 +47,7 @@
 #include "runtime/icache.hpp"
 #include "runtime/java.hpp"
 #include "runtime/mutexLocker.hpp"
+#include "runtime/perfData.hpp"
 #include "services/memoryService.hpp"
 #include "utilities/xmlstream.hpp"
 
@@ -119,7 +121,10 @@ class CodeBlob_sizes {
 
 // CodeCache implementation
 
-CodeHeap * CodeCache::_heap = new CodeHeap();
+GrowableArray<CodeHeap*>* CodeCache::_heaps =
+  new (ResourceObj::C_HEAP, mtCode) GrowableArray<CodeHeap*>(CodeBlobType::All, true);
+address CodeCache::_low_bound = NULL;
+address CodeCache::_high_bound = NULL;
 int CodeCache::_number_of_blobs = 0;
 int CodeCache::_number_of_adapters = 0;
 int CodeCache::_number_of_nmethods = 0;
@@ -129,15 +134,39 @@ nmethod* CodeCache::_scavenge_root_nmethods = NULL;
 
 int CodeCache::_codemem_full_count = 0;
 
+CodeBlob* CodeCache::first_blob(int index, bool nmethods_only) {
+  for (int i = index; i < _heaps->length(); i++) {
+    CodeHeap* heap = _heaps->at(i);
+    if (nmethods_only && !heap_may_contain_nmethods(heap)) {
+      continue;
+    }
+    CodeBlob* cb = (CodeBlob*)heap->first();
+    if (cb != NULL) {
+      return cb;
+    }
+  }
+  return NULL;
+}
+
+CodeBlob* CodeCache::next_blob(CodeBlob* cb, bool nmethods_only) {
+  int index = heap_index(cb);
+  assert(index >= 0, "CodeBlob must be in a CodeHeap");
+  CodeBlob* next = (CodeBlob*)_heaps->at(index)->next(cb);
+  if (next != NULL) {
+    return next;
+  }
+  return first_blob(index + 1, nmethods_only);
+}
+
 CodeBlob* CodeCache::first() {
   assert_locked_or_safepoint(CodeCache_lock);
-  return (CodeBlob*)_heap->first();
+  return first_blob(0, false);
 }
 
 
 CodeBlob* CodeCache::next(CodeBlob* cb) {
   assert_locked_or_safepoint(CodeCache_lock);
-  return (CodeBlob*)_heap->next(cb);
+  return next_blob(cb, false);
 }
 
 
@@ -150,31 +179,86 @@ CodeBlob* CodeCache::alive(CodeBlob *cb) {
 
 nmethod* CodeCache::alive_nmethod(CodeBlob* cb) {
   assert_locked_or_safepoint(CodeCache_lock);
-  while (cb != NULL && (!cb->is_alive() || !cb->is_nmethod())) cb = next(cb);
+  while (cb != NULL && (!cb->is_alive() || !cb->is_nmethod())) cb = next_blob(cb, true);
   return (nmethod*)cb;
 }
 
 nmethod* CodeCache::first_nmethod() {
   assert_locked_or_safepoint(CodeCache_lock);
-  CodeBlob* cb = first();
+  CodeBlob* cb = first_blob(0, true);
   while (cb != NULL && !cb->is_nmethod()) {
-    cb = next(cb);
+    cb = next_blob(cb, true);
   }
   return (nmethod*)cb;
 }
 
 nmethod* CodeCache::next_nmethod (CodeBlob* cb) {
   assert_locked_or_safepoint(CodeCache_lock);
-  cb = next(cb);
+  cb = next_blob(cb, true);
   while (cb != NULL && !cb->is_nmethod()) {
-    cb = next(cb);
+    cb = next_blob(cb, true);
   }
   return (nmethod*)cb;
 }
 
 static size_t maxCodeCacheUsed = 0;
 
-CodeBlob* CodeCache::allocate(int size, bool is_critical) {
+CodeHeap* CodeCache::get_code_heap(int code_blob_type) {
+  assert(0 <= code_blob_type && code_blob_type < CodeBlobType::NumTypes, "invalid CodeBlobType");
+  CodeHeap* non_profiled = NULL;
+  for (int i = 0; i < _heaps->length(); i++) {
+    CodeHeap* heap = _heaps->at(i);
+    if (heap->code_blob_type() == code_blob_type || heap->code_blob_type() == CodeBlobType::All) {
+      return heap;
+    }
+    if (heap->code_blob_type() == CodeBlobType::MethodNonProfiled) {
+      non_profiled = heap;
+    }
+  }
+  // There is no profiled code heap without TieredCompilation and
+  // the hot code heap is optional
+  assert(non_profiled != NULL, "code heaps not initialized");
+  return non_profiled;
+}
+
+bool CodeCache::heap_available(int code_blob_type) {
+  for (int i = 0; i < _heaps->length(); i++) {
+    if (_heaps->at(i)->code_blob_type() == code_blob_type) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int CodeCache::get_code_blob_type(int comp_level) {
+  if (comp_level == CompLevel_limited_profile || comp_level == CompLevel_full_profile) {
+    return CodeBlobType::MethodProfiled;
+  }
+  return CodeBlobType::MethodNonProfiled;
+}
+
+// Allocates size bytes in heap, expanding it as necessary.
+// Returns NULL if heap is full.
+static CodeBlob* allocate_in(CodeHeap* heap, int size, bool is_critical) {
+  while (true) {
+    CodeBlob* cb = (CodeBlob*)heap->allocate(size, is_critical);
+    if (cb != NULL) {
+      return cb;
+    }
+    if (!heap->expand_by(CodeCacheExpansionSize)) {
+      // Expansion failed
+      return NULL;
+    }
+    if (PrintCodeCacheExtension) {
+      ResourceMark rm;
+      tty->print_cr("%s extended to [" INTPTR_FORMAT ", " INTPTR_FORMAT "] (" SSIZE_FORMAT " bytes)",
+                    heap->name(), (intptr_t)heap->low_boundary(), (intptr_t)heap->high(),
+                    (address)heap->high() - (address)heap->low_boundary());
+    }
+  }
+}
+
+CodeBlob* CodeCache::allocate(int size, int code_blob_type, bool is_critical) {
   // Do not seize the CodeCache lock here--if the caller has not
   // already done so, we are going to lose bigtime, since the code
   // cache will contain a garbage CodeBlob until the caller can
@@ -182,30 +266,29 @@ CodeBlob* CodeCache::allocate(int size, bool is_critical) {
   // instantiating.
   guarantee(size >= 0, "allocation request must be reasonable");
   assert_locked_or_safepoint(CodeCache_lock);
-  CodeBlob* cb = NULL;
+  CodeHeap* heap = get_code_heap(code_blob_type);
   _number_of_blobs++;
-  while (true) {
-    cb = (CodeBlob*)_heap->allocate(size, is_critical);
-    if (cb != NULL) break;
-    if (!_heap->expand_by(CodeCacheExpansionSize)) {
-      // Expansion failed
-      if (CodeCache_lock->owned_by_self()) {
-        MutexUnlockerEx mu(CodeCache_lock, Mutex::_no_safepoint_check_flag);
-        report_codemem_full();
-      } else {
-        report_codemem_full();
-      }
-      return NULL;
+  CodeBlob* cb = allocate_in(heap, size, is_critical);
+  if (cb == NULL && SegmentedCodeCache) {
+    // Fall back to one of the nmethod code heaps. nmethods must never
+    // end up in the non-nmethod code heap as nmethod iteration skips it.
+    int fallback_type = code_blob_type == CodeBlobType::MethodNonProfiled ?
+                        CodeBlobType::MethodProfiled : CodeBlobType::MethodNonProfiled;
+    CodeHeap* fallback = get_code_heap(fallback_type);
+    if (fallback != heap) {
+      cb = allocate_in(fallback, size, is_critical);
     }
-    if (PrintCodeCacheExtension) {
-      ResourceMark rm;
-      tty->print_cr("code cache extended to [" INTPTR_FORMAT ", " INTPTR_FORMAT "] (" SSIZE_FORMAT " bytes)",
-                    (intptr_t)_heap->low_boundary(), (intptr_t)_heap->high(),
-                    (address)_heap->high() - (address)_heap->low_boundary());
+  }
+  if (cb == NULL) {
+    if (CodeCache_lock->owned_by_self()) {
+      MutexUnlockerEx mu(CodeCache_lock, Mutex::_no_safepoint_check_flag);
+      report_codemem_full(code_blob_type);
+    } else {
+      report_codemem_full(code_blob_type);
     }
+    return NULL;
   }
-  maxCodeCacheUsed = MAX2(maxCodeCacheUsed, ((address)_heap->high_boundary() -
-                          (address)_heap->low_boundary()) - unallocated_capacity());
+  maxCodeCacheUsed = MAX2(maxCodeCacheUsed, (size_t)(high_bound() - low_bound()) - unallocated_capacity());
   verify_if_often();
   print_trace("allocation", cb, size);
   return cb;
@@ -214,20 +297,23 @@ CodeBlob* CodeCache::allocate(int size, bool is_critical) {
 void CodeCache::free(CodeBlob* cb) {
   assert_locked_or_safepoint(CodeCache_lock);
   verify_if_often();
+  CodeHeap* heap = get_code_heap(cb);
 
   print_trace("free", cb);
   if (cb->is_nmethod()) {
     _number_of_nmethods--;
+    heap->set_nmethod_count(heap->nmethod_count() - 1);
     if (((nmethod *)cb)->has_dependencies()) {
       _number_of_nmethods_with_dependencies--;
     }
   }
   if (cb->is_adapter_blob()) {
     _number_of_adapters--;
+    heap->set_adapter_count(heap->adapter_count() - 1);
   }
   _number_of_blobs--;
 
-  _heap->deallocate(cb);
+  heap->deallocate(cb);
 
   verify_if_often();
   assert(_number_of_blobs >= 0, "sanity check");
@@ -237,14 +323,17 @@ void CodeCache::free(CodeBlob* cb) {
 void CodeCache::commit(CodeBlob* cb) {
   // this is called by nmethod::nmethod, which must already own CodeCache_lock
   assert_locked_or_safepoint(CodeCache_lock);
+  CodeHeap* heap = get_code_heap(cb);
   if (cb->is_nmethod()) {
     _number_of_nmethods++;
+    heap->set_nmethod_count(heap->nmethod_count() + 1);
     if (((nmethod *)cb)->has_dependencies()) {
       _number_of_nmethods_with_dependencies++;
     }
   }
   if (cb->is_adapter_blob()) {
     _number_of_adapters++;
+    heap->set_adapter_count(heap->adapter_count() + 1);
   }
 
   // flush the hardware I-cache
@@ -262,12 +351,14 @@ void CodeCache::flush() {
 
 #define FOR_ALL_BLOBS(var)       for (CodeBlob *var =       first() ; var != NULL; var =       next(var) )
 #define FOR_ALL_ALIVE_BLOBS(var) for (CodeBlob *var = alive(first()); var != NULL; var = alive(next(var)))
-#define FOR_ALL_ALIVE_NMETHODS(var) for (nmethod *var = alive_nmethod(first()); var != NULL; var = alive_nmethod(next(var)))
+// Only visit the CodeHeaps that can contain nmethods
+#define FOR_ALL_NMETHOD_BLOBS(var)  for (CodeBlob *var = first_blob(0, true); var != NULL; var = next_blob(var, true))
+#define FOR_ALL_ALIVE_NMETHODS(var) for (nmethod *var = alive_nmethod(first_blob(0, true)); var != NULL; var = alive_nmethod(next_blob(var, true)))
 
 
 bool CodeCache::contains(void *p) {
   // It should be ok to call contains without holding a lock
-  return _heap->contains(p);
+  return get_code_heap(p) != NULL;
 }
 
 
@@ -299,7 +390,7 @@ void CodeCache::blobs_do(void f(CodeBlob* nm)) {
 
 void CodeCache::nmethods_do(void f(nmethod* nm)) {
   assert_locked_or_safepoint(CodeCache_lock);
-  FOR_ALL_BLOBS(nm) {
+  FOR_ALL_NMETHOD_BLOBS(nm) {
     if (nm->is_nmethod()) f((nmethod*)nm);
   }
 }
@@ -311,13 +402,14 @@ void CodeCache::alive_nmethods_do(void f(nmethod* nm)) {
   }
 }
 
+// All CodeHeaps use the same segment size and therefore the same alignment.
 int CodeCache::alignment_unit() {
-  return (int)_heap->alignment_unit();
+  return (int)_heaps->first()->alignment_unit();
 }
 
 
 int CodeCache::alignment_offset() {
-  return (int)_heap->alignment_offset();
+  return (int)_heaps->first()->alignment_offset();
 }
 
 
@@ -488,13 +580,10 @@ void CodeCache::asserted_non_scavengable_nmethods_do(CodeBlobClosure* f) {
 
 // Temporarily mark nmethods that are claimed to be on the non-perm list.
 void CodeCache::mark_scavenge_root_nmethods() {
-  FOR_ALL_ALIVE_BLOBS(cb) {
-    if (cb->is_nmethod()) {
-      nmethod *nm = (nmethod*)cb;
-      assert(nm->scavenge_root_not_marked(), "clean state");
-      if (nm->on_scavenge_root_list())
-        nm->set_scavenge_root_marked();
-    }
+  FOR_ALL_ALIVE_NMETHODS(nm) {
+    assert(nm->scavenge_root_not_marked(), "clean state");
+    if (nm->on_scavenge_root_list())
+      nm->set_scavenge_root_marked();
   }
 }
 
@@ -519,13 +608,10 @@ void CodeCache::verify_perm_nmethods(CodeBlobClosure* f_or_null) {
 
 void CodeCache::verify_clean_inline_caches() {
 #ifdef ASSERT
-  FOR_ALL_ALIVE_BLOBS(cb) {
-    if (cb->is_nmethod()) {
-      nmethod* nm = (nmethod*)cb;
-      assert(!nm->is_unloaded(), "Tautology");
-      nm->verify_clean_inline_caches();
-      nm->verify();
-    }
+  FOR_ALL_ALIVE_NMETHODS(nm) {
+    assert(!nm->is_unloaded(), "Tautology");
+    nm->verify_clean_inline_caches();
+    nm->verify();
   }
 #endif
 }
@@ -534,7 +620,7 @@ void CodeCache::verify_icholder_relocations() {
 #ifdef ASSERT
   // make sure that we aren't leaking icholders
   int count = 0;
-  FOR_ALL_BLOBS(cb) {
+  FOR_ALL_NMETHOD_BLOBS(cb) {
     if (cb->is_nmethod()) {
       nmethod* nm = (nmethod*)cb;
       count += nm->verify_icholder_relocations();
@@ -552,16 +638,13 @@ void CodeCache::gc_prologue() {
 void CodeCache::gc_epilogue() {
   assert_locked_or_safepoint(CodeCache_lock);
   NOT_DEBUG(if (needs_cache_clean())) {
-    FOR_ALL_ALIVE_BLOBS(cb) {
-      if (cb->is_nmethod()) {
-        nmethod *nm = (nmethod*)cb;
-        assert(!nm->is_unloaded(), "Tautology");
-        DEBUG_ONLY(if (needs_cache_clean())) {
-          nm->cleanup_inline_caches();
-        }
-        DEBUG_ONLY(nm->verify());
-        DEBUG_ONLY(nm->verify_oop_relocations());
+    FOR_ALL_ALIVE_NMETHODS(nm) {
+      assert(!nm->is_unloaded(), "Tautology");
+      DEBUG_ONLY(if (needs_cache_clean())) {
+        nm->cleanup_inline_caches();
       }
+      DEBUG_ONLY(nm->verify());
+      DEBUG_ONLY(nm->verify_oop_relocations());
     }
   }
   set_needs_cache_clean(false);
@@ -573,37 +656,292 @@ void CodeCache::gc_epilogue() {
 void CodeCache::verify_oops() {
   MutexLockerEx mu(CodeCache_lock, Mutex::_no_safepoint_check_flag);
   VerifyOopClosure voc;
-  FOR_ALL_ALIVE_BLOBS(cb) {
-    if (cb->is_nmethod()) {
-      nmethod *nm = (nmethod*)cb;
-      nm->oops_do(&voc);
-      nm->verify_oop_relocations();
-    }
+  FOR_ALL_ALIVE_NMETHODS(nm) {
+    nm->oops_do(&voc);
+    nm->verify_oop_relocations();
   }
 }
 
 
 address CodeCache::first_address() {
   assert_locked_or_safepoint(CodeCache_lock);
-  return (address)_heap->low_boundary();
+  return _low_bound;
 }
 
 
 address CodeCache::last_address() {
   assert_locked_or_safepoint(CodeCache_lock);
-  return (address)_heap->high();
+  address last = _low_bound;
+  for (int i = 0; i < _heaps->length(); i++) {
+    last = MAX2(last, (address)_heaps->at(i)->high());
+  }
+  return last;
+}
+
+size_t CodeCache::capacity() {
+  size_t cap = 0;
+  for (int i = 0; i < _heaps->length(); i++) {
+    cap += _heaps->at(i)->capacity();
+  }
+  return cap;
+}
+
+size_t CodeCache::max_capacity() {
+  size_t max_cap = 0;
+  for (int i = 0; i < _heaps->length(); i++) {
+    max_cap += _heaps->at(i)->max_capacity();
+  }
+  return max_cap;
+}
+
+size_t CodeCache::unallocated_capacity() {
+  size_t unallocated_cap = 0;
+  for (int i = 0; i < _heaps->length(); i++) {
+    unallocated_cap += _heaps->at(i)->unallocated_capacity();
+  }
+  return unallocated_cap;
+}
+
+size_t CodeCache::unallocated_capacity(int code_blob_type) {
+  return get_code_heap(code_blob_type)->unallocated_capacity();
 }
 
 /**
- * Returns the reverse free ratio. E.g., if 25% (1/4) of the code cache
- * is free, reverse_free_ratio() returns 4.
+ * Returns the reverse free ratio of the CodeHeap used for the given
+ * CodeBlobType. E.g., if 25% (1/4) of the code heap is free,
+ * reverse_free_ratio() returns 4.
  */
-double CodeCache::reverse_free_ratio() {
-  double unallocated_capacity = (double)(CodeCache::unallocated_capacity() - CodeCacheMinimumFreeSpace);
-  double max_capacity = (double)CodeCache::max_capacity();
+double CodeCache::reverse_free_ratio(int code_blob_type) {
+  CodeHeap* heap = get_code_heap(code_blob_type);
+  double unallocated_capacity = (double)(heap->unallocated_capacity() - CodeCacheMinimumFreeSpace);
+  double max_capacity = (double)heap->max_capacity();
   return max_capacity / unallocated_capacity;
 }
 
+double CodeCache::reverse_free_ratio() {
+  double ratio = 0.0;
+  for (int i = 0; i < _heaps->length(); i++) {
+    CodeHeap* heap = _heaps->at(i);
+    if (heap_may_contain_nmethods(heap)) {
+      ratio = MAX2(ratio, reverse_free_ratio(heap->code_blob_type()));
+    }
+  }
+  return ratio;
+}
+
+// Helper class for the sampled code heap PerfData counters
+class CodeHeapUsedHelper : public PerfLongSampleHelper {
+ private:
+  CodeHeap* _heap;
+
+ public:
+  CodeHeapUsedHelper(CodeHeap* heap) : _heap(heap) { }
+
+  jlong take_sample() {
+    return (jlong)(_heap->max_capacity() - _heap->unallocated_capacity());
+  }
+};
+
+class CodeHeapCapacityHelper : public PerfLongSampleHelper {
+ private:
+  CodeHeap* _heap;
+
+ public:
+  CodeHeapCapacityHelper(CodeHeap* heap) : _heap(heap) { }
+
+  jlong take_sample() {
+    return (jlong)_heap->capacity();
+  }
+};
+
+void CodeCache::create_perf_counters(CodeHeap* heap, int index) {
+  if (UsePerfData) {
+    EXCEPTION_MARK;
+    ResourceMark rm;
+
+    const char* ns = PerfDataManager::name_space("codeHeap", index);
+
+    const char* cname = PerfDataManager::counter_name(ns, "name");
+    PerfDataManager::create_string_constant(SUN_CI, cname, heap->name(), CHECK);
+
+    cname = PerfDataManager::counter_name(ns, "maxCapacity");
+    PerfDataManager::create_constant(SUN_CI, cname, PerfData::U_Bytes,
+                                     (jlong)heap->max_capacity(), CHECK);
+
+    cname = PerfDataManager::counter_name(ns, "capacity");
+    PerfDataManager::create_variable(SUN_CI, cname, PerfData::U_Bytes,
+                                     new CodeHeapCapacityHelper(heap), CHECK);
+
+    cname = PerfDataManager::counter_name(ns, "used");
+    PerfDataManager::create_variable(SUN_CI, cname, PerfData::U_Bytes,
+                                     new CodeHeapUsedHelper(heap), CHECK);
+  }
+}
+
+ReservedCodeSpace CodeCache::reserve_heap_memory(size_t size) {
+  // Determine alignment
+  size_t page_size = os::vm_page_size();
+  if (os::can_execute_large_page_memory()) {
+    page_size = os::page_size_for_region_unaligned(size, 8);
+  }
+
+  const size_t granularity = os::vm_allocation_granularity();
+  const size_t r_align = MAX2(page_size, granularity);
+  const size_t r_size = align_size_up(size, r_align);
+  const size_t rs_align = page_size == (size_t) os::vm_page_size() ? 0 :
+    MAX2(page_size, granularity);
+
+  ReservedCodeSpace rs(r_size, rs_align, rs_align > 0);
+  if (!rs.is_reserved()) {
+    vm_exit_during_initialization("Could not reserve enough space for code cache");
+  }
+
+  // All CodeHeaps are placed in this reservation
+  _low_bound = (address)rs.base();
+  _high_bound = _low_bound + rs.size();
+  return rs;
+}
+
+void CodeCache::add_heap(ReservedSpace rs, const char* name, size_t size_initial, int code_blob_type) {
+  CodeHeap* heap = new CodeHeap(name, code_blob_type);
+  _heaps->append(heap);
+
+  size_initial = round_to(size_initial, os::vm_page_size());
+  if (!heap->reserve(rs, size_initial, CodeCacheSegmentSize)) {
+    vm_exit_during_initialization(err_msg("Could not reserve enough space for %s (" SIZE_FORMAT "K)",
+                                          name, rs.size() / K));
+  }
+
+  MemoryService::add_code_heap_memory_pool(heap, name);
+  create_perf_counters(heap, _heaps->length() - 1);
+}
+
+// Returns the part of InitialCodeCacheSize that is committed for a
+// CodeHeap of the given size, at least one page.
+static size_t initial_heap_size(size_t heap_size, size_t cache_size) {
+  julong initial = (julong)InitialCodeCacheSize * heap_size / cache_size;
+  return MIN2(MAX2((size_t)initial, (size_t)os::vm_page_size()), heap_size);
+}
+
+void CodeCache::initialize_heaps() {
+  if (!SegmentedCodeCache) {
+    if (HotCodeHeapSize != 0) {
+      warning("HotCodeHeapSize is ignored without SegmentedCodeCache");
+      FLAG_SET_ERGO(uintx, HotCodeHeapSize, 0);
+    }
+    // Use a single code heap for all CodeBlobs
+    ReservedCodeSpace rs = reserve_heap_memory(ReservedCodeCacheSize);
+    add_heap(rs, "Code Cache", InitialCodeCacheSize, CodeBlobType::All);
+    return;
+  }
+
+  size_t cache_size        = ReservedCodeCacheSize;
+  size_t non_nmethod_size  = NonNMethodCodeHeapSize;
+  size_t profiled_size     = ProfiledCodeHeapSize;
+  size_t non_profiled_size = NonProfiledCodeHeapSize;
+  size_t hot_size          = HotCodeHeapSize;
+
+  if (FLAG_IS_DEFAULT(NonNMethodCodeHeapSize)) {
+    // Leave most of a small code cache to the nmethods
+    non_nmethod_size = MIN2(non_nmethod_size, cache_size / 4);
+  }
+  bool profiled_set = !FLAG_IS_DEFAULT(ProfiledCodeHeapSize);
+  bool non_profiled_set = !FLAG_IS_DEFAULT(NonProfiledCodeHeapSize);
+  if (!TieredCompilation) {
+    // Without TieredCompilation there are no profiled nmethods
+    if (profiled_set && profiled_size != 0) {
+      warning("ProfiledCodeHeapSize is ignored without TieredCompilation");
+    }
+    profiled_size = 0;
+    profiled_set = true;
+  }
+  if (FLAG_IS_DEFAULT(ReservedCodeCacheSize) && profiled_set && non_profiled_set) {
+    // Derive the code cache size from the code heap sizes
+    cache_size = round_to(non_nmethod_size + hot_size + profiled_size + non_profiled_size, os::vm_page_size());
+  }
+  size_t total_size = non_nmethod_size + hot_size + profiled_size + non_profiled_size;
+  if (total_size > cache_size) {
+    vm_exit_during_initialization(err_msg("Invalid code heap sizes: NonNMethodCodeHeapSize (" SIZE_FORMAT "K)"
+                                          " + HotCodeHeapSize (" SIZE_FORMAT "K)"
+                                          " + ProfiledCodeHeapSize (" SIZE_FORMAT "K)"
+                                          " + NonProfiledCodeHeapSize (" SIZE_FORMAT "K)"
+                                          " = " SIZE_FORMAT "K is greater than ReservedCodeCacheSize (" SIZE_FORMAT "K)",
+                                          non_nmethod_size / K, hot_size / K, profiled_size / K, non_profiled_size / K,
+                                          total_size / K, cache_size / K));
+  }
+
+  // Distribute the remaining space among the nmethod code heaps
+  size_t remaining_size = cache_size - total_size;
+  if (!profiled_set && !non_profiled_set) {
+    profiled_size     += remaining_size / 2;
+    non_profiled_size += remaining_size - remaining_size / 2;
+  } else if (!profiled_set) {
+    profiled_size     += remaining_size;
+  } else {
+    non_profiled_size += remaining_size;
+  }
+
+  const size_t min_non_nmethod_size = (CodeCacheMinimumUseSpace DEBUG_ONLY(* 3)) + CodeCacheMinimumFreeSpace;
+  if (non_nmethod_size < min_non_nmethod_size) {
+    vm_exit_during_initialization(err_msg("Not enough space in non-nmethod code heap to run VM: "
+                                          SIZE_FORMAT "K < " SIZE_FORMAT "K",
+                                          non_nmethod_size / K, min_non_nmethod_size / K));
+  }
+  if (non_profiled_size <= CodeCacheMinimumFreeSpace ||
+      (TieredCompilation && profiled_size <= CodeCacheMinimumFreeSpace)) {
+    vm_exit_during_initialization(err_msg("Not enough space in nmethod code heaps to run VM: "
+                                          "profiled " SIZE_FORMAT "K, non-profiled " SIZE_FORMAT "K, "
+                                          "each must be greater than CodeCacheMinimumFreeSpace (" SIZE_FORMAT "K)",
+                                          profiled_size / K, non_profiled_size / K,
+                                          CodeCacheMinimumFreeSpace / K));
+  }
+  if (hot_size != 0 && hot_size <= CodeCacheMinimumFreeSpace) {
+    vm_exit_during_initialization(err_msg("Not enough space in hot code heap: " SIZE_FORMAT "K, "
+                                          "must be greater than CodeCacheMinimumFreeSpace (" SIZE_FORMAT "K)",
+                                          hot_size / K, CodeCacheMinimumFreeSpace / K));
+  }
+
+  ReservedCodeSpace rs = reserve_heap_memory(cache_size);
+
+  // Align the code heap boundaries to the reservation granularity, the
+  // non-profiled code heap gets whatever is left.
+  const size_t alignment = MAX2(rs.alignment(), (size_t)os::vm_allocation_granularity());
+  non_nmethod_size  = align_size_up(non_nmethod_size, alignment);
+  hot_size          = align_size_up(hot_size, alignment);
+  profiled_size     = align_size_down(profiled_size, alignment);
+  guarantee(non_nmethod_size + hot_size + profiled_size < rs.size(), "no space left for non-profiled code heap");
+  non_profiled_size = rs.size() - non_nmethod_size - hot_size - profiled_size;
+
+  FLAG_SET_ERGO(uintx, ReservedCodeCacheSize, rs.size());
+  FLAG_SET_ERGO(uintx, NonNMethodCodeHeapSize, non_nmethod_size);
+  FLAG_SET_ERGO(uintx, ProfiledCodeHeapSize, profiled_size);
+  FLAG_SET_ERGO(uintx, NonProfiledCodeHeapSize, non_profiled_size);
+  FLAG_SET_ERGO(uintx, HotCodeHeapSize, hot_size);
+
+  // Code heap layout: [non-nmethods | hot nmethods | profiled nmethods | non-profiled nmethods]
+  // The hot code heap follows the stubs it calls into so that the hottest
+  // code of the application is packed into as few (large) pages as possible.
+  ReservedSpace non_nmethod_space  = rs.first_part(non_nmethod_size);
+  ReservedSpace rest_space         = rs.last_part(non_nmethod_size);
+  ReservedSpace hot_space          = rest_space.first_part(hot_size);
+  ReservedSpace nmethod_space      = rest_space.last_part(hot_size);
+  ReservedSpace profiled_space     = nmethod_space.first_part(profiled_size);
+  ReservedSpace non_profiled_space = nmethod_space.last_part(profiled_size);
+
+  add_heap(non_nmethod_space, "CodeHeap 'non-nmethods'",
+           initial_heap_size(non_nmethod_size, rs.size()), CodeBlobType::NonNMethod);
+  if (hot_size > 0) {
+    // Commit the hot code heap up front, it is small and expected to fill up
+    add_heap(hot_space, "CodeHeap 'hot nmethods'", hot_size, CodeBlobType::MethodHot);
+  }
+  if (profiled_size > 0) {
+    add_heap(profiled_space, "CodeHeap 'profiled nmethods'",
+             initial_heap_size(profiled_size, rs.size()), CodeBlobType::MethodProfiled);
+  }
+  add_heap(non_profiled_space, "CodeHeap 'non-profiled nmethods'",
+           initial_heap_size(non_profiled_size, rs.size()), CodeBlobType::MethodNonProfiled);
+}
+
 void icache_init();
 
 void CodeCache::initialize() {
@@ -618,11 +956,8 @@ void CodeCache::initialize() {
   CodeCacheExpansionSize = round_to(CodeCacheExpansionSize, os::vm_page_size());
   InitialCodeCacheSize = round_to(InitialCodeCacheSize, os::vm_page_size());
   ReservedCodeCacheSize = round_to(ReservedCodeCacheSize, os::vm_page_size());
-  if (!_heap->reserve(ReservedCodeCacheSize, InitialCodeCacheSize, CodeCacheSegmentSize)) {
-    vm_exit_during_initialization("Could not reserve enough space for code cache");
-  }
 
-  MemoryService::add_code_heap_memory_pool(_heap);
+  initialize_heaps();
 
   // Initialize ICache flush mechanism
   // This service is needed for os::register_code_area
@@ -631,7 +966,7 @@ void CodeCache::initialize() {
   // Give OS a chance to register generated code area.
   // This is used on Windows 64 bit platforms to register
   // Structured Exception Handlers for our generated code.
-  os::register_code_area(_heap->low_boundary(), _heap->high_boundary());
+  os::register_code_area((char*)_low_bound, (char*)_high_bound);
 }
 
 
@@ -776,25 +1111,29 @@ void CodeCache::make_marked_nmethods_not_entrant() {
 }
 
 void CodeCache::verify() {
-  _heap->verify();
+  for (int i = 0; i < _heaps->length(); i++) {
+    _heaps->at(i)->verify();
+  }
   FOR_ALL_ALIVE_BLOBS(p) {
     p->verify();
   }
 }
 
-void CodeCache::report_codemem_full() {
+void CodeCache::report_codemem_full(int code_blob_type) {
   _codemem_full_count++;
+  CodeHeap* heap = get_code_heap(code_blob_type);
+  heap->report_full();
   EventCodeCacheFull event;
   if (event.should_commit()) {
-    event.set_codeBlobType((u1)CodeBlobType::All);
-    event.set_startAddress((u8)low_bound());
-    event.set_commitedTopAddress((u8)high());
-    event.set_reservedTopAddress((u8)high_bound());
-    event.set_entryCount(nof_blobs());
-    event.set_methodCount(nof_nmethods());
-    event.set_adaptorCount(nof_adapters());
-    event.set_unallocatedCapacity(unallocated_capacity()/K);
-    event.set_fullCount(_codemem_full_count);
+    event.set_codeBlobType((u1)heap->code_blob_type());
+    event.set_startAddress((u8)heap->low_boundary());
+    event.set_commitedTopAddress((u8)heap->high());
+    event.set_reservedTopAddress((u8)heap->high_boundary());
+    event.set_entryCount(heap->blob_count());
+    event.set_methodCount(heap->nmethod_count());
+    event.set_adaptorCount(heap->adapter_count());
+    event.set_unallocatedCapacity(heap->unallocated_capacity()/K);
+    event.set_fullCount(heap->full_count());
     event.commit();
   }
 }
@@ -806,7 +1145,9 @@ void CodeCache::report_codemem_full() {
 
 void CodeCache::verify_if_often() {
   if (VerifyCodeCacheOften) {
-    _heap->verify();
+    for (int i = 0; i < _heaps->length(); i++) {
+      _heaps->at(i)->verify();
+    }
   }
 }
 
@@ -978,17 +1319,27 @@ void CodeCache::print() {
 }
 
 void CodeCache::print_summary(outputStream* st, bool detailed) {
-  size_t total = (_heap->high_boundary() - _heap->low_boundary());
+  size_t total = (size_t)(_high_bound - _low_bound);
   st->print_cr("CodeCache: size=" SIZE_FORMAT "Kb used=" SIZE_FORMAT
                "Kb max_used=" SIZE_FORMAT "Kb free=" SIZE_FORMAT "Kb",
                total/K, (total - unallocated_capacity())/K,
                maxCodeCacheUsed/K, unallocated_capacity()/K);
 
   if (detailed) {
-    st->print_cr(" bounds [" INTPTR_FORMAT ", " INTPTR_FORMAT ", " INTPTR_FORMAT "]",
-                 p2i(_heap->low_boundary()),
-                 p2i(_heap->high()),
-                 p2i(_heap->high_boundary()));
+    for (int i = 0; i < _heaps->length(); i++) {
+      CodeHeap* heap = _heaps->at(i);
+      if (SegmentedCodeCache) {
+        size_t heap_total = heap->max_capacity();
+        st->print_cr(" %s: size=" SIZE_FORMAT "Kb used=" SIZE_FORMAT "Kb free=" SIZE_FORMAT "Kb"
+                     " blobs=" INT32_FORMAT " nmethods=" INT32_FORMAT,
+                     heap->name(), heap_total/K, (heap_total - heap->unallocated_capacity())/K,
+                     heap->unallocated_capacity()/K, heap->blob_count(), heap->nmethod_count());
+      }
+      st->print_cr(" bounds [" INTPTR_FORMAT ", " INTPTR_FORMAT ", " INTPTR_FORMAT "]",
+                   p2i(heap->low_boundary()),
+                   p2i(heap->high()),
+                   p2i(heap->high_boundary()));
+    }
     st->print_cr(" total_blobs=" UINT32_FORMAT " nmethods=" UINT32_FORMAT
                  " adapters=" UINT32_FORMAT,
                  nof_blobs(), nof_nmethods(), nof_adapters());
@@ -999,6 +1350,16 @@ void CodeCache::print_summary(outputStream* st, bool detailed) {
     st->print_cr("              stopped_count=%d, restarted_count=%d",
                  CompileBroker::get_total_compiler_stopped_count(),
                  CompileBroker::get_total_compiler_restarted_count());
+    if (ShareDebugInfoAcrossNMethods) {
+      SharedScopesData::print_statistics(st);
+    }
+  }
+}
+
+void CodeCache::print_freelist_statistics(outputStream* st) {
+  MutexLockerEx mu(CodeCache_lock, Mutex::_no_safepoint_check_flag);
+  for (int i = 0; i < _heaps->length(); i++) {
+    _heaps->at(i)->print_freelist_statistics(st);
   }
 }
 
@@ -30,6 +30,7 @@
 #include "memory/heap.hpp"
 #include "oops/instanceKlass.hpp"
 #include "oops/oopsHierarchy.hpp"
+#include "utilities/growableArray.hpp"
 
 // The CodeCache implements the code cache for various pieces of generated
 // code, e.g., compiled java methods, runtime stubs, transition frames, etc.
@@ -39,6 +40,20 @@
 //   - Each CodeBlob occupies one chunk of memory.
 //   - Like the offset table in oldspace the zone has at table for
 //     locating a method given a addess of an instruction.
+//
+// With SegmentedCodeCache the code cache is split into distinct CodeHeaps,
+// each of which contains CodeBlobs of a specific CodeBlobType:
+//   - Non-nmethods: non-nmethod code like buffers, adapters and runtime stubs
+//   - Profiled nmethods: nmethods compiled at tier 2 and 3 (C1 with profiling)
+//   - Non-profiled nmethods: nmethods compiled at tier 1 and 4 (C1 without
+//     profiling, C2 and JVMCI) as well as native wrappers
+//   - Hot nmethods (optional, see HotCodeHeapSize): non-profiled nmethods
+//     the sweeper found active on thread stacks, recompiled next to each
+//     other to reduce instruction cache and TLB pressure
+// This keeps short-lived profiled code from fragmenting the space used by
+// optimized code. The CodeHeaps are carved out of a single reservation, so
+// low_bound() and high_bound() still enclose all generated code. Without
+// SegmentedCodeCache there is a single CodeHeap of type CodeBlobType::All.
 
 class OopClosure;
 class DepChange;
@@ -46,11 +61,13 @@ class DepChange;
 class CodeCache : AllStatic {
   friend class VMStructs;
  private:
-  // CodeHeap is malloc()'ed at startup and never deleted during shutdown,
+  // CodeHeaps are malloc()'ed at startup and never deleted during shutdown,
   // so that the generated assembly code is always there when it's needed.
   // This may cause memory leak, but is necessary, for now. See 4423824,
-  // 4422213 or 4436291 for details.
-  static CodeHeap * _heap;
+  // 4422213 or 4436291 for details. The heaps are sorted by address.
+  static GrowableArray<CodeHeap*>* _heaps;
+  static address _low_bound;                     // lower bound of CodeHeap addresses
+  static address _high_bound;                    // upper bound of CodeHeap addresses
   static int _number_of_blobs;
   static int _number_of_adapters;
   static int _number_of_nmethods;
@@ -69,15 +86,49 @@ class CodeCache : AllStatic {
   static void prune_scavenge_root_nmethods();
   static void unlink_scavenge_root_nmethod(nmethod* nm, nmethod* prev);
 
+  // CodeHeap management
+  static void initialize_heaps();                // reserves and initializes the CodeHeaps
+  static ReservedCodeSpace reserve_heap_memory(size_t size);
+  static void add_heap(ReservedSpace rs, const char* name, size_t size_initial, int code_blob_type);
+  static int  heap_index(const void* p) {        // index of the CodeHeap containing p or -1
+    if (_heaps == NULL) return -1;
+    for (int i = 0; i < _heaps->length(); i++) {
+      if (_heaps->at(i)->contains(p)) {
+        return i;
+      }
+    }
+    return -1;
+  }
+  static bool heap_may_contain_nmethods(CodeHeap* heap) {
+    return heap->code_blob_type() != CodeBlobType::NonNMethod;
+  }
+  static void create_perf_counters(CodeHeap* heap, int index);
+
+  // Iteration over the CodeBlobs of the CodeHeaps from the one with the
+  // given index on. If nmethods_only is true, CodeHeaps that cannot
+  // contain nmethods are skipped.
+  static CodeBlob* first_blob(int index, bool nmethods_only);
+  static CodeBlob* next_blob(CodeBlob* cb, bool nmethods_only);
+
  public:
 
   // Initialization
   static void initialize();
 
-  static void report_codemem_full();
+  static void report_codemem_full(int code_blob_type);
+
+  // CodeHeaps
+  static GrowableArray<CodeHeap*>* heaps()       { return _heaps; }
+  static CodeHeap* get_code_heap(int code_blob_type);  // the CodeHeap used for the given CodeBlobType
+  static CodeHeap* get_code_heap(const void* p) {      // the CodeHeap containing p or NULL
+    int index = heap_index(p);
+    return index < 0 ? NULL : _heaps->at(index);
+  }
+  static bool heap_available(int code_blob_type);  // whether there is a CodeHeap of exactly the given CodeBlobType
+  static int get_code_blob_type(int comp_level); // the CodeBlobType of nmethods compiled at comp_level
 
   // Allocation/administration
-  static CodeBlob* allocate(int size, bool is_critical = false); // allocates a new CodeBlob
+  static CodeBlob* allocate(int size, int code_blob_type, bool is_critical = false); // allocates a new CodeBlob
   static void commit(CodeBlob* cb);                 // called when the allocated CodeBlob has been filled
   static int alignment_unit();                      // guaranteed alignment of all CodeBlobs
   static int alignment_offset();                    // guaranteed offset of first CodeBlob byte within alignment unit (i.e., allocation header)
@@ -97,9 +148,10 @@ class CodeCache : AllStatic {
   // what you are doing)
   static CodeBlob* find_blob_unsafe(void* start) {
     // NMT can walk the stack before code cache is created
-    if (_heap == NULL) return NULL;
+    CodeHeap* heap = get_code_heap(start);
+    if (heap == NULL) return NULL;
 
-    CodeBlob* result = (CodeBlob*)_heap->find_start(start);
+    CodeBlob* result = (CodeBlob*)heap->find_start(start);
     // this assert is too strong because the heap code will return the
     // heapblock containing start. That block can often be larger than
     // the codeBlob itself. If you look up an address that is within
@@ -157,20 +209,22 @@ class CodeCache : AllStatic {
   static void verify();                          // verifies the code cache
   static void print_trace(const char* event, CodeBlob* cb, int size = 0) PRODUCT_RETURN;
   static void print_summary(outputStream* st, bool detailed = true); // Prints a summary of the code cache usage
+  static void print_freelist_statistics(outputStream* st); // Prints the free blocks and fragmentation of each code heap
   static void log_state(outputStream* st);
 
   // The full limits of the codeCache
-  static address  low_bound()                    { return (address) _heap->low_boundary(); }
-  static address  high_bound()                   { return (address) _heap->high_boundary(); }
-  static address  high()                         { return (address) _heap->high(); }
+  static address  low_bound()                    { return _low_bound; }
+  static address  high_bound()                   { return _high_bound; }
 
   // Profiling
   static address first_address();                // first address used for CodeBlobs
   static address last_address();                 // last  address used for CodeBlobs
-  static size_t  capacity()                      { return _heap->capacity(); }
-  static size_t  max_capacity()                  { return _heap->max_capacity(); }
-  static size_t  unallocated_capacity()          { return _heap->unallocated_capacity(); }
-  static double  reverse_free_ratio();
+  static size_t  capacity();
+  static size_t  max_capacity();
+  static size_t  unallocated_capacity();
+  static size_t  unallocated_capacity(int code_blob_type);
+  static double  reverse_free_ratio(int code_blob_type);
+  static double  reverse_free_ratio();           // the highest reverse free ratio of the nmethod CodeHeaps
 
   static bool needs_cache_clean()                { return _needs_cache_clean; }
   static void set_needs_cache_clean(bool v)      { _needs_cache_clean = v;    }
@@ -123,6 +123,7 @@ class DebugInformationRecorder: public ResourceObj {
 
   // returns the size of the generated scopeDescs.
   int data_size();
+  u_char* data_begin() { return _stream->buffer(); }
   int pcs_size();
   int oop_size() { return oop_recorder()->oop_size(); }
   int metadata_size() { return oop_recorder()->metadata_size(); }
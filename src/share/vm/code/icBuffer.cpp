@@ -37,6 +37,7 @@
 #include "oops/oop.inline.hpp"
 #include "oops/oop.inline2.hpp"
 #include "runtime/mutexLocker.hpp"
+#include "runtime/perfData.hpp"
 #include "runtime/stubRoutines.hpp"
 
 PRAGMA_FORMAT_MUTE_WARNINGS_FOR_GCC
@@ -49,6 +50,8 @@ ICStub*    InlineCacheBuffer::_next_stub = NULL;
 CompiledICHolder* InlineCacheBuffer::_pending_released = NULL;
 int InlineCacheBuffer::_pending_count = 0;
 
+PerfCounter* InlineCacheBuffer::_perf_full_safepoints = NULL;
+
 void ICStub::finalize() {
   if (!is_empty()) {
     ResourceMark rm;
@@ -116,6 +119,13 @@ void InlineCacheBuffer::initialize() {
   _buffer = new StubQueue(new ICStubInterface, 10*K, InlineCacheBuffer_lock, "InlineCacheBuffer");
   assert (_buffer != NULL, "cannot allocate InlineCacheBuffer");
   init_next_stub();
+
+  if (UsePerfData) {
+    EXCEPTION_MARK;
+    _perf_full_safepoints =
+      PerfDataManager::create_counter(SUN_CI, "icBuffer.fullSafepoints",
+                                      PerfData::U_Events, CHECK);
+  }
 }
 
 
@@ -129,6 +139,10 @@ ICStub* InlineCacheBuffer::new_ic_stub() {
     // We do this by forcing a safepoint
     EXCEPTION_MARK;
 
+    if (UsePerfData) {
+      _perf_full_safepoints->inc();
+    }
+
     VM_ForceSafepoint vfs;
     VMThread::execute(&vfs);
     // We could potential get an async. exception at this point.
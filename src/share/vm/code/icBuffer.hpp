@@ -29,6 +29,7 @@
 #include "code/stubs.hpp"
 #include "interpreter/bytecodes.hpp"
 #include "memory/allocation.hpp"
+#include "runtime/perfData.hpp"
 
 //
 // For CompiledIC's:
@@ -104,6 +105,9 @@ class InlineCacheBuffer: public AllStatic {
   static CompiledICHolder* _pending_released;
   static int _pending_count;
 
+  // Number of safepoints forced because the buffer was full
+  static PerfCounter* _perf_full_safepoints;
+
   static StubQueue* buffer()                         { return _buffer;         }
   static void       set_next_stub(ICStub* next_stub) { _next_stub = next_stub; }
   static ICStub*    get_next_stub()                  { return _next_stub;      }
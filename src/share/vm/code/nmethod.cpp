@@ -246,6 +246,9 @@ struct pc_nmethod_stats_struct {
   int pc_desc_tests;    // total number of PcDesc examinations
   int pc_desc_searches; // total number of quasi-binary search steps
   int pc_desc_adds;     // number of LUR cache insertions
+  int pc_desc_index_builds;  // number of PcDescIndexes built
+  int pc_desc_index_hits;    // cache misses answered by a PcDescIndex
+  int pc_desc_index_steps;   // total number of PcDescIndex scan steps
 
   void print_pc_stats() {
     tty->print_cr("PcDesc Statistics:  %d queries, %.2f comparisons per query",
@@ -257,6 +260,8 @@ struct pc_nmethod_stats_struct {
                   pc_desc_queries, pc_desc_approx,
                   pc_desc_repeats, pc_desc_hits,
                   pc_desc_tests, pc_desc_searches, pc_desc_adds);
+    tty->print_cr("  indexes=%d, index hits=%d, index steps=%d",
+                  pc_desc_index_builds, pc_desc_index_hits, pc_desc_index_steps);
   }
 };
 
@@ -453,6 +458,47 @@ void PcDescCache::add_pc_desc(PcDesc* pc_desc) {
   }
 }
 
+PcDescIndex::PcDescIndex(PcDesc* lower, PcDesc* upper) {
+  assert(lower->pc_offset() == PcDesc::lower_offset_limit, "must be sentinel");
+  assert(upper->pc_offset() == PcDesc::upper_offset_limit, "must be sentinel");
+  int count = upper - lower - 1;
+  int max_offset = MAX2((upper - 1)->pc_offset(), 0);
+  // Size the buckets to hold about one PcDesc each
+  _shift = 0;
+  if (count > 0 && (max_offset + 1) / count > 1) {
+    _shift = log2_int((max_offset + 1) / count);
+  }
+  _length = (max_offset >> _shift) + 1;
+  _first = NEW_C_HEAP_ARRAY(int, _length, mtCode);
+  int i = 1;
+  for (int b = 0; b < _length; b++) {
+    while (lower[i].pc_offset() < (b << _shift)) {
+      i++;
+    }
+    _first[b] = i;
+  }
+}
+
+PcDescIndex::~PcDescIndex() {
+  FREE_C_HEAP_ARRAY(int, _first, mtCode);
+}
+
+PcDesc* PcDescIndex::find_upper(PcDesc* lower, int pc_offset) {
+  NOT_PRODUCT(++pc_nmethod_stats.pc_desc_index_hits);
+  int b = pc_offset >> _shift;
+  if (b >= _length) {
+    // Past the last PcDesc, the final sentinel is the upper bound
+    b = _length - 1;
+  }
+  // The final sentinel terminates the scan
+  PcDesc* p = lower + _first[b];
+  while (p->pc_offset() < pc_offset) {
+    NOT_PRODUCT(++pc_nmethod_stats.pc_desc_index_steps);
+    p++;
+  }
+  return p;
+}
+
 // adjust pcs_size so that it is a multiple of both oopSize and
 // sizeof(PcDesc) (assumes that if sizeof(PcDesc) is not a multiple
 // of oopSize, then 2*sizeof(PcDesc) is)
@@ -547,7 +593,7 @@ int nmethod::total_size() const {
     consts_size()        +
     insts_size()         +
     stub_size()          +
-    scopes_data_size()   +
+    (_shared_scopes_data != NULL ? 0 : scopes_data_size()) +
     scopes_pcs_size()    +
     handler_table_size() +
     nul_chk_table_size();
@@ -588,6 +634,7 @@ void nmethod::init_defaults() {
   }
   _scavenge_root_state     = 0;
   _compiler                = NULL;
+  _shared_scopes_data      = NULL;
 #if INCLUDE_RTM_OPT
   _rtm_state               = NoRTM;
 #endif
@@ -614,7 +661,7 @@ nmethod* nmethod::new_native_nmethod(methodHandle method,
     CodeOffsets offsets;
     offsets.set_value(CodeOffsets::Verified_Entry, vep_offset);
     offsets.set_value(CodeOffsets::Frame_Complete, frame_complete);
-    nm = new (native_nmethod_size) nmethod(method(), native_nmethod_size,
+    nm = new (native_nmethod_size, CodeCache::get_code_blob_type(CompLevel_none)) nmethod(method(), native_nmethod_size,
                                             compile_id, &offsets,
                                             code_buffer, frame_size,
                                             basic_lock_owner_sp_offset,
@@ -652,8 +699,8 @@ nmethod* nmethod::new_dtrace_nmethod(methodHandle method,
     offsets.set_value(CodeOffsets::Dtrace_trap, trap_offset);
     offsets.set_value(CodeOffsets::Frame_Complete, frame_complete);
 
-    nm = new (nmethod_size) nmethod(method(), nmethod_size,
-                                    &offsets, code_buffer, frame_size);
+    nm = new (nmethod_size, CodeCache::get_code_blob_type(CompLevel_none)) nmethod(method(), nmethod_size,
+                                                    &offsets, code_buffer, frame_size);
 
     if (nm != NULL)  note_java_nmethod(nm);
     if (PrintAssembly && nm != NULL) {
@@ -698,10 +745,20 @@ nmethod* nmethod::new_nmethod(methodHandle method,
   code_buffer->finalize_oop_references(method);
   // create nmethod
   nmethod* nm = NULL;
+  int scopes_data_saved = 0;
+  unsigned int scopes_data_hash = ShareDebugInfoAcrossNMethods ?
+    SharedScopesData::hash(debug_info->data_begin(), debug_info->data_size()) : 0;
   { MutexLockerEx mu(CodeCache_lock, Mutex::_no_safepoint_check_flag);
 #if INCLUDE_JVMCI
     int jvmci_data_size = !compiler->is_jvmci() ? 0 : JVMCINMethodData::compute_size(nmethod_mirror_name);
 #endif
+    SharedScopesData* shared_scopes_data = NULL;
+    if (ShareDebugInfoAcrossNMethods) {
+      shared_scopes_data = SharedScopesData::acquire(debug_info->data_begin(), debug_info->data_size(), scopes_data_hash);
+      if (shared_scopes_data != NULL && shared_scopes_data->refcount() > 1) {
+        scopes_data_saved = shared_scopes_data->length();
+      }
+    }
     int nmethod_size =
       allocation_size(code_buffer, sizeof(nmethod))
       + adjust_pcs_size(debug_info->pcs_size())
@@ -712,11 +769,17 @@ nmethod* nmethod::new_nmethod(methodHandle method,
       + round_to(speculations_len              , oopSize)
       + round_to(jvmci_data_size               , oopSize)
 #endif
-      + round_to(debug_info->data_size()       , oopSize);
+      + (shared_scopes_data != NULL ? 0 : round_to(debug_info->data_size(), oopSize));
+
+    int code_blob_type = CodeCache::get_code_blob_type(comp_level);
+    if (code_blob_type == CodeBlobType::MethodNonProfiled && method->is_hot_code() &&
+        CodeCache::heap_available(CodeBlobType::MethodHot)) {
+      code_blob_type = CodeBlobType::MethodHot;
+    }
 
-    nm = new (nmethod_size)
+    nm = new (nmethod_size, code_blob_type)
     nmethod(method(), nmethod_size, compile_id, entry_bci, offsets,
-            orig_pc_offset, debug_info, dependencies, code_buffer, frame_size,
+            orig_pc_offset, debug_info, shared_scopes_data, dependencies, code_buffer, frame_size,
             oop_maps,
             handler_table,
             nul_chk_table,
@@ -732,6 +795,16 @@ nmethod* nmethod::new_nmethod(methodHandle method,
 #endif
             );
 
+    if (nm == NULL && shared_scopes_data != NULL) {
+      SharedScopesData::release(shared_scopes_data);
+    }
+
+    if (nm != NULL && code_blob_type == CodeBlobType::MethodHot &&
+        CodeCache::get_code_heap(nm)->code_blob_type() != CodeBlobType::MethodHot) {
+      // The hot code heap is full, don't recompile the method for it again
+      method->set_hot_code(false);
+    }
+
     if (nm != NULL) {
       // To make dependency checking during class loading fast, record
       // the nmethod dependencies in the classes it is dependent on.
@@ -748,7 +821,7 @@ nmethod* nmethod::new_nmethod(methodHandle method,
         }
 
         // record this nmethod as dependent on this klass
-        InstanceKlass::cast(klass)->add_dependent_nmethod(nm);
+        InstanceKlass::cast(klass)->add_dependent_nmethod(nm, deps.type());
       }
       if (nm != NULL)  note_java_nmethod(nm);
       if (PrintAssembly || CompilerOracle::has_option_string(method, "PrintAssembly")) {
@@ -760,7 +833,7 @@ nmethod* nmethod::new_nmethod(methodHandle method,
   if (nm != NULL) {
     // Safepoints in nmethod::verify aren't allowed because nm hasn't been installed yet.
     DEBUG_ONLY(nm->verify();)
-    nm->log_new_nmethod();
+    nm->log_new_nmethod(scopes_data_saved);
   }
   return nm;
 }
@@ -819,7 +892,10 @@ nmethod::nmethod(
     _osr_entry_point         = NULL;
     _exception_cache         = NULL;
     _pc_desc_cache.reset_to(NULL);
+    _pc_desc_index           = NULL;
+    _pc_desc_misses          = 0;
     _hotness_counter         = NMethodSweeper::hotness_counter_reset_val();
+    _hot_sweep_count         = 0;
 
     code_buffer->copy_values_to(this);
     if (ScavengeRootsInCode) {
@@ -906,7 +982,10 @@ nmethod::nmethod(
     _osr_entry_point         = NULL;
     _exception_cache         = NULL;
     _pc_desc_cache.reset_to(NULL);
+    _pc_desc_index           = NULL;
+    _pc_desc_misses          = 0;
     _hotness_counter         = NMethodSweeper::hotness_counter_reset_val();
+    _hot_sweep_count         = 0;
 
     code_buffer->copy_values_to(this);
     if (ScavengeRootsInCode) {
@@ -947,9 +1026,9 @@ nmethod::nmethod(
 }
 #endif // def HAVE_DTRACE_H
 
-void* nmethod::operator new(size_t size, int nmethod_size) throw() {
+void* nmethod::operator new(size_t size, int nmethod_size, int code_blob_type) throw() {
   // Not critical, may return null if there is too little continuous memory
-  return CodeCache::allocate(nmethod_size);
+  return CodeCache::allocate(nmethod_size, code_blob_type);
 }
 
 nmethod::nmethod(
@@ -960,6 +1039,7 @@ nmethod::nmethod(
   CodeOffsets* offsets,
   int orig_pc_offset,
   DebugInformationRecorder* debug_info,
+  SharedScopesData* shared_scopes_data,
   Dependencies* dependencies,
   CodeBuffer *code_buffer,
   int frame_size,
@@ -995,6 +1075,7 @@ nmethod::nmethod(
     _compiler                = compiler;
     _orig_pc_offset          = orig_pc_offset;
     _hotness_counter         = NMethodSweeper::hotness_counter_reset_val();
+    _hot_sweep_count         = 0;
 
     // Section offsets
     _consts_offset           = content_offset()      + code_buffer->total_offset_of(code_buffer->consts());
@@ -1044,7 +1125,9 @@ nmethod::nmethod(
     _metadata_offset         = _oops_offset          + round_to(code_buffer->total_oop_size(), oopSize);
     _scopes_data_offset      = _metadata_offset      + round_to(code_buffer->total_metadata_size(), wordSize);
 
-    _scopes_pcs_offset       = _scopes_data_offset   + round_to(debug_info->data_size       (), oopSize);
+    _shared_scopes_data      = shared_scopes_data;
+    _scopes_pcs_offset       = _scopes_data_offset   + (shared_scopes_data != NULL ? 0 :
+                                                        round_to(debug_info->data_size       (), oopSize));
     _dependencies_offset     = _scopes_pcs_offset    + adjust_pcs_size(debug_info->pcs_size());
     _handler_table_offset    = _dependencies_offset  + round_to(dependencies->size_in_bytes (), oopSize);
     _nul_chk_table_offset    = _handler_table_offset + round_to(handler_table->size_in_bytes(), oopSize);
@@ -1061,6 +1144,8 @@ nmethod::nmethod(
     _osr_entry_point         = code_begin()          + offsets->value(CodeOffsets::OSR_Entry);
     _exception_cache         = NULL;
     _pc_desc_cache.reset_to(scopes_pcs_begin());
+    _pc_desc_index           = NULL;
+    _pc_desc_misses          = 0;
 
     // Copy contents of ScopeDescRecorder to nmethod
     code_buffer->copy_values_to(this);
@@ -1138,7 +1223,7 @@ void nmethod::log_identity(xmlStream* log) const {
                (intptr_t)name##_begin() - (intptr_t)this)
 
 
-void nmethod::log_new_nmethod() const {
+void nmethod::log_new_nmethod(int scopes_data_saved) const {
   if (LogCompilation && xtty != NULL) {
     ttyLocker ttyl;
     HandleMark hm;
@@ -1158,6 +1243,10 @@ void nmethod::log_new_nmethod() const {
     LOG_OFFSET(xtty, nul_chk_table);
     LOG_OFFSET(xtty, oops);
     LOG_OFFSET(xtty, metadata);
+    if (_shared_scopes_data != NULL) {
+      xtty->print(" shared_scopes_data='%d' scopes_data_saved='%d'",
+                  _shared_scopes_data->length(), scopes_data_saved);
+    }
 
     xtty->method(method());
     xtty->stamp();
@@ -1793,6 +1882,16 @@ void nmethod::flush() {
     ec = next;
   }
 
+  if (_pc_desc_index != NULL) {
+    delete _pc_desc_index;
+    _pc_desc_index = NULL;
+  }
+
+  if (_shared_scopes_data != NULL) {
+    SharedScopesData::release(_shared_scopes_data);
+    _shared_scopes_data = NULL;
+  }
+
   if (on_scavenge_root_list()) {
     CodeCache::drop_scavenge_root_nmethod(this);
   }
@@ -1960,6 +2059,7 @@ void static clean_ic_if_metadata_is_dead(CompiledIC *ic, BoolObjectClosure *is_a
     if (mark_on_stack) {
       Metadata::mark_on_stack(cichk_oop->holder_metadata());
       Metadata::mark_on_stack(cichk_oop->holder_klass());
+      cichk_oop->dispatch_cache_metadata_do(Metadata::mark_on_stack);
     }
 
     if (cichk_oop->is_loader_alive(is_alive)) {
@@ -2147,7 +2247,7 @@ void nmethod::mark_metadata_on_stack_non_relocs() {
     if (_method != NULL) Metadata::mark_on_stack(_method);
 }
 
-bool nmethod::do_unloading_parallel(BoolObjectClosure* is_alive, bool unloading_occurred) {
+bool nmethod::do_unloading_parallel(BoolObjectClosure* is_alive, bool unloading_occurred, bool mark_metadata_on_stack) {
   ResourceMark rm;
 
   // Make sure the oop's ready to receive visitors
@@ -2178,8 +2278,9 @@ bool nmethod::do_unloading_parallel(BoolObjectClosure* is_alive, bool unloading_
 
   // When class redefinition is used all metadata in the CodeCache has to be recorded,
   // so that unused "previous versions" can be purged. Since walking the CodeCache can
-  // be expensive, the "mark on stack" is piggy-backed on this parallel unloading code.
-  bool mark_metadata_on_stack = a_class_was_redefined;
+  // be expensive, the "mark on stack" is piggy-backed on this parallel unloading code
+  // if the caller has a MetadataOnStackMark active that skipped the code cache.
+  mark_metadata_on_stack = mark_metadata_on_stack && a_class_was_redefined;
 
   // Exception cache
   clean_exception_cache(is_alive);
@@ -2392,6 +2493,7 @@ void nmethod::metadata_do(void f(Metadata*)) {
           CompiledICHolder* cichk = ic->cached_icholder();
           f(cichk->holder_metadata());
           f(cichk->holder_klass());
+          cichk->dispatch_cache_metadata_do(f);
         } else {
           Metadata* ic_oop = ic->cached_metadata();
           if (ic_oop != NULL) {
@@ -2626,6 +2728,12 @@ void nmethod::copy_scopes_pcs(PcDesc* pcs, int count) {
 }
 
 void nmethod::copy_scopes_data(u_char* buffer, int size) {
+  if (_shared_scopes_data != NULL) {
+    // The side table already holds an identical copy
+    assert(_shared_scopes_data->length() == size &&
+           memcmp(_shared_scopes_data->data(), buffer, size) == 0, "must be the same scopes data");
+    return;
+  }
   assert(scopes_data_size() >= size, "oob");
   memcpy(scopes_data_begin(), buffer, size);
 }
@@ -2684,15 +2792,39 @@ PcDesc* nmethod::find_pc_desc_internal(address pc, bool approximate) {
     return res;
   }
 
-  // Fallback algorithm: quasi-linear search for the PcDesc
-  // Find the last pc_offset less than the given offset.
-  // The successor must be the required match, if there is a match at all.
-  // (Use a fixed radix to avoid expensive affine pointer arithmetic.)
+  // Fallback algorithm: find the first PcDesc at or after the given offset,
+  // with the PcDescIndex if the sweeper built one for this nmethod.
+  // It must be the required match, if there is a match at all.
   PcDesc* lower = scopes_pcs_begin();
   PcDesc* upper = scopes_pcs_end();
   upper -= 1; // exclude final sentinel
   if (lower >= upper)  return NULL;  // native method; no PcDescs at all
 
+  PcDescIndex* index = (PcDescIndex*)OrderAccess::load_ptr_acquire(&_pc_desc_index);
+  if (index != NULL) {
+    upper = index->find_upper(lower, pc_offset);
+  } else {
+    if (UsePcDescIndex) {
+      _pc_desc_misses++;
+    }
+    upper = find_pc_desc_upper(lower, upper, pc_offset);
+  }
+
+  if (match_desc(upper, pc_offset, approximate)) {
+    assert(upper == linear_search(this, pc_offset, approximate), "search ok");
+    _pc_desc_cache.add_pc_desc(upper);
+    return upper;
+  } else {
+    assert(NULL == linear_search(this, pc_offset, approximate), "search ok");
+    return NULL;
+  }
+}
+
+// Quasi-linear search for the first PcDesc in (lower, upper] with a
+// pc_offset of at least pc_offset: find the last pc_offset less than
+// the given offset, the successor is the result.
+// (Use a fixed radix to avoid expensive affine pointer arithmetic.)
+PcDesc* nmethod::find_pc_desc_upper(PcDesc* lower, PcDesc* upper, int pc_offset) {
 #define assert_LU_OK \
   /* invariant on lower..upper during the following search: */ \
   assert(lower->pc_offset() <  pc_offset, "sanity"); \
@@ -2739,14 +2871,24 @@ PcDesc* nmethod::find_pc_desc_internal(address pc, bool approximate) {
   }
 #undef assert_LU_OK
 
-  if (match_desc(upper, pc_offset, approximate)) {
-    assert(upper == linear_search(this, pc_offset, approximate), "search ok");
-    _pc_desc_cache.add_pc_desc(upper);
-    return upper;
-  } else {
-    assert(NULL == linear_search(this, pc_offset, approximate), "search ok");
-    return NULL;
+  return upper;
+}
+
+bool nmethod::possibly_build_pc_desc_index() {
+  if (_pc_desc_index != NULL || _pc_desc_misses < PcDescIndexThreshold) {
+    return false;
   }
+  PcDesc* lower = scopes_pcs_begin();
+  PcDesc* upper = scopes_pcs_end();
+  upper -= 1; // exclude final sentinel
+  if (lower >= upper)  return false;  // native method; no PcDescs at all
+
+  // Only the sweeper builds indexes, so there is no race with another builder.
+  // Readers that do not see the index yet keep searching the PcDescs.
+  PcDescIndex* index = new PcDescIndex(lower, upper);
+  OrderAccess::release_store_ptr(&_pc_desc_index, index);
+  NOT_PRODUCT(++pc_nmethod_stats.pc_desc_index_builds);
+  return true;
 }
 
 
@@ -2762,12 +2904,17 @@ bool nmethod::check_all_dependencies() {
   return found_check;  // tell caller if we found anything
 }
 
-bool nmethod::check_dependency_on(DepChange& changes) {
+bool nmethod::check_dependency_on(DepChange& changes, Klass* context) {
   // What has happened:
   // 1) a new class dependee has been added
   // 2) dependee and all its super classes have been marked
   bool found_check = false;  // set true if we are upset
   for (Dependencies::DepStream deps(this); deps.next(); ) {
+    // Klass dependencies on other contexts are checked when the
+    // dependents of their own context are visited.
+    if (deps.is_klass_type() && deps.context_type() != context) {
+      continue;
+    }
     // Evaluate only relevant dependencies.
     if (deps.spot_check_dependency_at(changes) != NULL) {
       found_check = true;
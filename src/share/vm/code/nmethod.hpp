@@ -27,6 +27,7 @@
 
 #include "code/codeBlob.hpp"
 #include "code/pcDesc.hpp"
+#include "code/sharedScopesData.hpp"
 #include "oops/metadata.hpp"
 
 
@@ -89,6 +90,23 @@ class PcDescCache VALUE_OBJ_CLASS_SPEC {
   PcDesc* last_pc_desc() { return _pc_descs[0]; }
 };
 
+// A dense index from code offsets to PcDescs for nmethods whose PcDescs
+// are searched often (see UsePcDescIndex). The code is divided into
+// buckets of (1 << _shift) bytes and each bucket records the first PcDesc
+// at or after its start, so a lookup is a short linear scan within a
+// single bucket instead of a search over all PcDescs.
+class PcDescIndex : public CHeapObj<mtCode> {
+ private:
+  int  _shift;   // log2 of the bucket size in bytes
+  int  _length;  // number of buckets
+  int* _first;   // index of the first PcDesc with pc_offset >= (bucket << _shift)
+ public:
+  PcDescIndex(PcDesc* lower, PcDesc* upper);
+  ~PcDescIndex();
+  // Returns the first PcDesc in [lower, upper] with a pc_offset >= pc_offset
+  PcDesc* find_upper(PcDesc* lower, int pc_offset);
+};
+
 
 // nmethods (native methods) are the compiled code versions of Java methods.
 //
@@ -255,8 +273,18 @@ class nmethod : public CodeBlob {
   // counter is decreased (by 1) while sweeping.
   int _hotness_counter;
 
+  // The number of consecutive sweeps that found the nmethod active on a
+  // stack. Hot nmethods are recompiled into the hot code heap.
+  int _hot_sweep_count;
+
   ExceptionCache * volatile _exception_cache;
   PcDescCache     _pc_desc_cache;
+  PcDescIndex* volatile _pc_desc_index;  // built by the sweeper, NULL if none
+  int             _pc_desc_misses;        // PcDesc cache misses, racy but only a heuristic
+
+  // The scopes data lives in this side table entry instead of the
+  // nmethod if it is shared with other nmethods, NULL otherwise.
+  SharedScopesData* _shared_scopes_data;
 
   // These are used for compiled synchronized native methods to
   // locate the owner and stack slot for the BasicLock so that we can
@@ -303,6 +331,7 @@ class nmethod : public CodeBlob {
           CodeOffsets* offsets,
           int orig_pc_offset,
           DebugInformationRecorder *recorder,
+          SharedScopesData* shared_scopes_data,
           Dependencies* dependencies,
           CodeBuffer *code_buffer,
           int frame_size,
@@ -322,7 +351,7 @@ class nmethod : public CodeBlob {
           );
 
   // helper methods
-  void* operator new(size_t size, int nmethod_size) throw();
+  void* operator new(size_t size, int nmethod_size, int code_blob_type) throw();
 
   const char* reloc_string_for(u_char* begin, u_char* end);
   // Returns true if this thread changed the state of the nmethod or
@@ -423,8 +452,10 @@ class nmethod : public CodeBlob {
   Metadata** metadata_begin   () const            { return (Metadata**)  (header_begin() + _metadata_offset)     ; }
   Metadata** metadata_end     () const            { return (Metadata**)  (header_begin() + _scopes_data_offset)  ; }
 
-  address scopes_data_begin     () const          { return           header_begin() + _scopes_data_offset   ; }
-  address scopes_data_end       () const          { return           header_begin() + _scopes_pcs_offset    ; }
+  address scopes_data_begin     () const          { return _shared_scopes_data != NULL ? _shared_scopes_data->data() :
+                                                                       header_begin() + _scopes_data_offset   ; }
+  address scopes_data_end       () const          { return _shared_scopes_data != NULL ? _shared_scopes_data->data() + _shared_scopes_data->length() :
+                                                                       header_begin() + _scopes_pcs_offset    ; }
   PcDesc* scopes_pcs_begin      () const          { return (PcDesc*)(header_begin() + _scopes_pcs_offset   ); }
   PcDesc* scopes_pcs_end        () const          { return (PcDesc*)(header_begin() + _dependencies_offset) ; }
   address dependencies_begin    () const          { return           header_begin() + _dependencies_offset  ; }
@@ -464,6 +495,13 @@ class nmethod : public CodeBlob {
   void set_hotness_counter(int val) { _hotness_counter = val; }
   int  hotness_counter() const      { return _hotness_counter; }
 
+  int  inc_hot_sweep_count()        { return ++_hot_sweep_count; }
+  void reset_hot_sweep_count()      { _hot_sweep_count = 0; }
+
+  // Builds the PcDesc index once the PcDesc cache missed often enough,
+  // returns true if it was built
+  bool possibly_build_pc_desc_index();
+
   // Containment
   bool consts_contains       (address addr) const { return consts_begin       () <= addr && addr < consts_end       (); }
   bool insts_contains        (address addr) const { return insts_begin        () <= addr && addr < insts_end        (); }
@@ -682,7 +720,7 @@ public:
   // GC support
   void do_unloading(BoolObjectClosure* is_alive, bool unloading_occurred);
   //  The parallel versions are used by G1.
-  bool do_unloading_parallel(BoolObjectClosure* is_alive, bool unloading_occurred);
+  bool do_unloading_parallel(BoolObjectClosure* is_alive, bool unloading_occurred, bool mark_metadata_on_stack);
   void do_unloading_parallel_postponed(BoolObjectClosure* is_alive, bool unloading_occurred);
  private:
   //  Unload a nmethod if the *root object is dead.
@@ -715,6 +753,7 @@ public:
   address* orig_pc_addr(const frame* fr) { return (address*) ((address)fr->unextended_sp() + _orig_pc_offset); }
 
   PcDesc* find_pc_desc_internal(address pc, bool approximate);
+  PcDesc* find_pc_desc_upper(PcDesc* lower, PcDesc* upper, int pc_offset);
 
   PcDesc* find_pc_desc(address pc, bool approximate) {
     PcDesc* desc = _pc_desc_cache.last_pc_desc();
@@ -777,7 +816,7 @@ public:
 
   // Logging
   void log_identity(xmlStream* log) const;
-  void log_new_nmethod() const;
+  void log_new_nmethod(int scopes_data_saved = 0) const;
   void log_state_change(oop cause = NULL) const;
 
   // Prints block-level comments, including nmethod specific block labels:
@@ -808,8 +847,9 @@ public:
   bool check_all_dependencies();
 
   // tells if this compiled method is dependent on the given changes,
-  // and the changes have invalidated it
-  bool check_dependency_on(DepChange& changes);
+  // and the changes have invalidated it. Only the klass dependencies
+  // with the given context klass are checked.
+  bool check_dependency_on(DepChange& changes, Klass* context);
 
   // Evolution support. Tells if this compiled method is dependent on any of
   // methods m() of class dependee, such that if m() in dependee is replaced,
@@ -75,28 +75,29 @@ void ScopeDesc::decode_body() {
     _expressions_decode_offset = DebugInformationRecorder::serialized_null;
     _monitors_decode_offset = DebugInformationRecorder::serialized_null;
   } else {
-    // decode header
-    DebugInfoReadStream* stream  = stream_at(decode_offset());
+    // decode header, the stream lives on the stack since ScopeDescs
+    // are created for every frame of a stack walk
+    DebugInfoReadStream stream(_code, decode_offset(), _objects);
 
-    _sender_decode_offset = stream->read_int();
-    _method = stream->read_method();
-    _bci    = stream->read_bci();
+    _sender_decode_offset = stream.read_int();
+    _method = stream.read_method();
+    _bci    = stream.read_bci();
 
     // decode offsets for body and sender
-    _locals_decode_offset      = stream->read_int();
-    _expressions_decode_offset = stream->read_int();
-    _monitors_decode_offset    = stream->read_int();
+    _locals_decode_offset      = stream.read_int();
+    _expressions_decode_offset = stream.read_int();
+    _monitors_decode_offset    = stream.read_int();
   }
 }
 
 
 GrowableArray<ScopeValue*>* ScopeDesc::decode_scope_values(int decode_offset) {
   if (decode_offset == DebugInformationRecorder::serialized_null) return NULL;
-  DebugInfoReadStream* stream = stream_at(decode_offset);
-  int length = stream->read_int();
+  DebugInfoReadStream stream(_code, decode_offset, _objects);
+  int length = stream.read_int();
   GrowableArray<ScopeValue*>* result = new GrowableArray<ScopeValue*> (length);
   for (int index = 0; index < length; index++) {
-    result->push(ScopeValue::read_from(stream));
+    result->push(ScopeValue::read_from(&stream));
   }
   return result;
 }
@@ -118,19 +119,15 @@ GrowableArray<ScopeValue*>* ScopeDesc::decode_object_values(int decode_offset) {
 
 GrowableArray<MonitorValue*>* ScopeDesc::decode_monitor_values(int decode_offset) {
   if (decode_offset == DebugInformationRecorder::serialized_null) return NULL;
-  DebugInfoReadStream* stream  = stream_at(decode_offset);
-  int length = stream->read_int();
+  DebugInfoReadStream stream(_code, decode_offset, _objects);
+  int length = stream.read_int();
   GrowableArray<MonitorValue*>* result = new GrowableArray<MonitorValue*> (length);
   for (int index = 0; index < length; index++) {
-    result->push(new MonitorValue(stream));
+    result->push(new MonitorValue(&stream));
   }
   return result;
 }
 
-DebugInfoReadStream* ScopeDesc::stream_at(int decode_offset) const {
-  return new DebugInfoReadStream(_code, decode_offset, _objects);
-}
-
 GrowableArray<ScopeValue*>* ScopeDesc::locals() {
   return decode_scope_values(_locals_decode_offset);
 }
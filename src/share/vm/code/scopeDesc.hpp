@@ -120,8 +120,6 @@ class ScopeDesc : public ResourceObj {
   GrowableArray<MonitorValue*>* decode_monitor_values(int decode_offset);
   GrowableArray<ScopeValue*>* decode_object_values(int decode_offset);
 
-  DebugInfoReadStream* stream_at(int decode_offset) const;
-
 
  public:
   // Verification
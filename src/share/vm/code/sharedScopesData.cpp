@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "code/sharedScopesData.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "utilities/ostream.hpp"
+
+SharedScopesData** SharedScopesData::_table = NULL;
+int    SharedScopesData::_table_size  = 0;
+int    SharedScopesData::_entries     = 0;
+size_t SharedScopesData::_table_bytes = 0;
+size_t SharedScopesData::_saved_bytes = 0;
+
+SharedScopesData::SharedScopesData(u_char* buffer, int length, unsigned int hash) {
+  _next     = NULL;
+  _data     = NEW_C_HEAP_ARRAY(u_char, length, mtCode);
+  _length   = length;
+  _hash     = hash;
+  _refcount = 1;
+  memcpy(_data, buffer, length);
+}
+
+SharedScopesData::~SharedScopesData() {
+  FREE_C_HEAP_ARRAY(u_char, _data, mtCode);
+}
+
+unsigned int SharedScopesData::hash(u_char* buffer, int length) {
+  if (length < min_length) {
+    return 0;
+  }
+  unsigned int hash = length;
+  for (int i = 0; i < length; i++) {
+    hash = 31 * hash + buffer[i];
+  }
+  return hash;
+}
+
+void SharedScopesData::grow() {
+  int new_size = _table == NULL ? initial_table_size : 2 * _table_size;
+  SharedScopesData** new_table = NEW_C_HEAP_ARRAY(SharedScopesData*, new_size, mtCode);
+  for (int i = 0; i < new_size; i++) {
+    new_table[i] = NULL;
+  }
+  for (int i = 0; i < _table_size; i++) {
+    SharedScopesData* e = _table[i];
+    while (e != NULL) {
+      SharedScopesData* next = e->_next;
+      SharedScopesData** bucket = &new_table[e->_hash % new_size];
+      e->_next = *bucket;
+      *bucket = e;
+      e = next;
+    }
+  }
+  if (_table != NULL) {
+    FREE_C_HEAP_ARRAY(SharedScopesData*, _table, mtCode);
+  }
+  _table = new_table;
+  _table_size = new_size;
+}
+
+SharedScopesData* SharedScopesData::acquire(u_char* buffer, int length, unsigned int hash) {
+  assert_locked_or_safepoint(CodeCache_lock);
+  if (length < min_length) {
+    return NULL;
+  }
+  assert(hash == SharedScopesData::hash(buffer, length), "hash must match the scopes data");
+  if (_entries >= 2 * _table_size) {
+    grow();
+  }
+  SharedScopesData** bucket = &_table[hash % _table_size];
+  for (SharedScopesData* e = *bucket; e != NULL; e = e->_next) {
+    if (e->_hash == hash && e->_length == length && memcmp(e->_data, buffer, length) == 0) {
+      e->_refcount++;
+      _saved_bytes += length;
+      return e;
+    }
+  }
+  SharedScopesData* e = new SharedScopesData(buffer, length, hash);
+  e->_next = *bucket;
+  *bucket = e;
+  _entries++;
+  _table_bytes += length;
+  return e;
+}
+
+void SharedScopesData::release(SharedScopesData* data) {
+  assert_locked_or_safepoint(CodeCache_lock);
+  assert(data->_refcount > 0, "released too often");
+  if (--data->_refcount > 0) {
+    _saved_bytes -= data->_length;
+    return;
+  }
+  SharedScopesData** p = &_table[data->_hash % _table_size];
+  while (*p != data) {
+    assert(*p != NULL, "entry must be in the table");
+    p = &(*p)->_next;
+  }
+  *p = data->_next;
+  _entries--;
+  _table_bytes -= data->_length;
+  delete data;
+}
+
+void SharedScopesData::print_statistics(outputStream* st) {
+  st->print_cr(" shared scopes data: entries=%d size=" SIZE_FORMAT " bytes saved=" SIZE_FORMAT " bytes",
+               _entries, _table_bytes, _saved_bytes);
+}
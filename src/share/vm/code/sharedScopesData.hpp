@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_VM_CODE_SHAREDSCOPESDATA_HPP
+#define SHARE_VM_CODE_SHAREDSCOPESDATA_HPP
+
+#include "memory/allocation.hpp"
+
+// Scopes data (the serialized debug information of an nmethod) that
+// lives in a side table outside of the code cache (see
+// ShareDebugInfoAcrossNMethods). nmethods with identical scopes data
+// reference the same entry instead of embedding a copy. This is sound
+// because all offsets and oop/metadata indices in the stream are
+// relative to the nmethod that decodes it.
+//
+// Entries are reference counted and freed when the last nmethod that
+// uses them is flushed. Except for hash(), all operations require the
+// CodeCache_lock or a safepoint. The table doubles in size whenever it
+// holds twice as many entries as it has buckets, so that lookups stay
+// short while the CodeCache_lock is held.
+class SharedScopesData : public CHeapObj<mtCode> {
+  friend class VMStructs;
+ private:
+  enum {
+    initial_table_size = 1009,
+    min_length = 32   // smaller scopes data is not worth the entry
+  };
+
+  static SharedScopesData** _table;
+  static int    _table_size;    // nof. buckets in _table
+  static int    _entries;       // nof. entries in the table
+  static size_t _table_bytes;   // scopes data bytes held by the table
+  static size_t _saved_bytes;   // scopes data bytes not duplicated
+
+  SharedScopesData* _next;
+  u_char*           _data;
+  int               _length;
+  unsigned int      _hash;
+  int               _refcount;
+
+  SharedScopesData(u_char* buffer, int length, unsigned int hash);
+  ~SharedScopesData();
+
+  static void grow();
+
+ public:
+  u_char* data() const     { return _data; }
+  int     length() const   { return _length; }
+  int     refcount() const { return _refcount; }
+
+  // Returns the hash to pass to acquire(). It is computed before taking
+  // the CodeCache_lock since it reads all of the scopes data.
+  static unsigned int hash(u_char* buffer, int length);
+
+  // Returns the entry for the given scopes data, creating it if needed,
+  // or NULL if the scopes data should be embedded into the nmethod.
+  static SharedScopesData* acquire(u_char* buffer, int length, unsigned int hash);
+  static void release(SharedScopesData* data);
+
+  static void print_statistics(outputStream* st);
+};
+
+#endif // SHARE_VM_CODE_SHAREDSCOPESDATA_HPP
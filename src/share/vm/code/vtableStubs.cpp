@@ -34,6 +34,7 @@
 #include "prims/jvmtiExport.hpp"
 #include "runtime/handles.inline.hpp"
 #include "runtime/mutexLocker.hpp"
+#include "runtime/perfData.hpp"
 #include "runtime/sharedRuntime.hpp"
 #ifdef COMPILER2
 #include "opto/matcher.hpp"
@@ -92,6 +93,8 @@ void VtableStub::print_on(outputStream* st) const {
 
 VtableStub* VtableStubs::_table[VtableStubs::N];
 int VtableStubs::_number_of_vtable_stubs = 0;
+jlong VtableStubs::_dispatch_cache_hits = 0;
+jlong VtableStubs::_dispatch_cache_misses = 0;
 
 
 void VtableStubs::initialize() {
@@ -104,6 +107,14 @@ void VtableStubs::initialize() {
       _table[i] = NULL;
     }
   }
+
+  if (UsePerfData && UseInterfaceDispatchCache && CountInterfaceDispatchCache) {
+    EXCEPTION_MARK;
+    PerfDataManager::create_counter(SUN_CI, "itableDispatchCacheHits",
+                                    PerfData::U_Events, &_dispatch_cache_hits, CHECK);
+    PerfDataManager::create_counter(SUN_CI, "itableDispatchCacheMisses",
+                                    PerfData::U_Events, &_dispatch_cache_misses, CHECK);
+  }
 }
 
 
@@ -210,6 +221,14 @@ void VtableStubs::vtable_stub_do(void f(VtableStub*)) {
     }
 }
 
+void VtableStubs::print_statistics() {
+  jlong hits = _dispatch_cache_hits;
+  jlong misses = _dispatch_cache_misses;
+  jlong total = hits + misses;
+  tty->print_cr("Interface dispatch cache: " JLONG_FORMAT " hits, " JLONG_FORMAT " misses (%.1f%% hits)",
+                hits, misses, total > 0 ? (double)hits * 100.0 / (double)total : 0.0);
+}
+
 
 //-----------------------------------------------------------------------------------------------------
 // Non-product code
@@ -116,6 +116,10 @@ class VtableStubs : AllStatic {
   static VtableStub* _table[N];                  // table of existing stubs
   static int         _number_of_vtable_stubs;    // number of stubs created so far (for statistics)
 
+  // Updated by the itable stubs without synchronization if CountInterfaceDispatchCache is set
+  static jlong       _dispatch_cache_hits;
+  static jlong       _dispatch_cache_misses;
+
   static VtableStub* create_vtable_stub(int vtable_index);
   static VtableStub* create_itable_stub(int vtable_index);
   static VtableStub* lookup            (bool is_vtable_stub, int vtable_index);
@@ -132,6 +136,11 @@ class VtableStubs : AllStatic {
   static int         number_of_vtable_stubs() { return _number_of_vtable_stubs; }
   static void        initialize();
   static void        vtable_stub_do(void f(VtableStub*));            // iterates over all vtable stubs
+
+  // interface dispatch cache statistics
+  static address     dispatch_cache_hits_addr()   { return (address)&_dispatch_cache_hits; }
+  static address     dispatch_cache_misses_addr() { return (address)&_dispatch_cache_misses; }
+  static void        print_statistics();
 };
 
 #endif // SHARE_VM_CODE_VTABLESTUBS_HPP
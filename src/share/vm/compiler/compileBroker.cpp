@@ -234,6 +234,9 @@ void compileBroker_init() {
   if (LogEvents) {
     _compilation_log = new CompilationLog();
   }
+  // Code can be installed and swept even without a compiler (e.g. by
+  // JVMCI with -Xint), so this does not depend on UseCompiler.
+  NMethodSweeper::initialize();
 }
 
 CompileTaskWrapper::CompileTaskWrapper(CompileTask* task) {
@@ -318,6 +321,9 @@ CompileTask* CompileTask::allocate() {
 void CompileTask::free(CompileTask* task) {
   MutexLocker locker(CompileTaskAlloc_lock);
   if (!task->is_free()) {
+    // Every path a task can take (compiled, failed, stale or purged from
+    // the queue) ends here while the task still keeps its method alive.
+    NMethodSweeper::possibly_clear_hot_code(task->method());
     task->set_code(NULL);
     assert(!task->lock()->is_locked(), "Should not be locked when freed");
     JNIHandles::destroy_global(task->_method_holder);
@@ -364,13 +370,12 @@ void CompileTask::initialize(int compile_id,
   _hot_method = NULL;
   _hot_method_holder = NULL;
   _hot_count = hot_count;
-  _time_queued = 0;  // tidy
+  _time_queued = os::elapsed_counter();
   _comment = comment;
   _failure_reason = NULL;
   _failure_reason_on_C_heap = false;
 
   if (LogCompilation) {
-    _time_queued = os::elapsed_counter();
     if (hot_method.not_null()) {
       if (hot_method == method) {
         _hot_method = _method;
@@ -812,11 +817,42 @@ CompileTask* CompileQueue::get() {
   }
   if (task != NULL) {
     remove(task);
+    record_wait(task);
   }
   purge_stale_tasks(); // may temporarily release MCQ lock
   return task;
 }
 
+void CompileQueue::create_perf_counters(const char* name_space, TRAPS) {
+  if (!UsePerfData) {
+    return;
+  }
+  static const char* bucket_names[wait_buckets] = {
+    "waitLt1ms", "waitLt10ms", "waitLt100ms", "waitLt1s", "waitGe1s"
+  };
+  ResourceMark rm;
+  char* name = PerfDataManager::counter_name(name_space, "waitTime");
+  _perf_wait_time = PerfDataManager::create_counter(SUN_CI, name, PerfData::U_Ticks, CHECK);
+  for (int i = 0; i < wait_buckets; i++) {
+    name = PerfDataManager::counter_name(name_space, bucket_names[i]);
+    _perf_wait_histogram[i] = PerfDataManager::create_counter(SUN_CI, name, PerfData::U_Events, CHECK);
+  }
+}
+
+void CompileQueue::record_wait(CompileTask* task) {
+  if (_perf_wait_time == NULL) {
+    return;
+  }
+  jlong waited = os::elapsed_counter() - task->time_queued();
+  _perf_wait_time->inc(waited);
+  jlong millis = waited * 1000 / os::elapsed_frequency();
+  int bucket = 0;
+  for (jlong limit = 1; bucket < wait_buckets - 1 && millis >= limit; limit *= 10) {
+    bucket++;
+  }
+  _perf_wait_histogram[bucket]->inc();
+}
+
 // Clean & deallocate stale compile tasks.
 // Temporarily releases MethodCompileQueue lock.
 void CompileQueue::purge_stale_tasks() {
@@ -1117,6 +1153,9 @@ void CompileBroker::compilation_init(TRAPS) {
                                           CHECK);
   }
 
+  // Start the code cache sweeper threads, if any
+  NMethodSweeper::start_threads();
+
   _initialized = true;
 }
 
@@ -1209,10 +1248,12 @@ void CompileBroker::init_compiler_threads(int c1_compiler_count, int c2_compiler
   // Initialize the compilation queue
   if (c2_compiler_count > 0) {
     _c2_compile_queue  = new CompileQueue("C2 CompileQueue",  MethodCompileQueue_lock);
+    _c2_compile_queue->create_perf_counters("c2Queue", CHECK);
     _compilers[1]->set_num_compiler_threads(c2_compiler_count);
   }
   if (c1_compiler_count > 0) {
     _c1_compile_queue  = new CompileQueue("C1 CompileQueue",  MethodCompileQueue_lock);
+    _c1_compile_queue->create_perf_counters("c1Queue", CHECK);
     _compilers[0]->set_num_compiler_threads(c1_compiler_count);
   }
 
@@ -1603,6 +1644,11 @@ bool CompileBroker::compilation_is_complete(methodHandle method,
     } else {
       nmethod* result = method->code();
       if (result == NULL) return false;
+      if (method->is_hot_code() &&
+          CodeCache::get_code_heap(result)->code_blob_type() != CodeBlobType::MethodHot) {
+        // The code is recompiled into the hot code heap
+        return false;
+      }
       return comp_level == result->comp_level();
     }
   }
@@ -2003,9 +2049,12 @@ void CompileBroker::compiler_thread_loop() {
     // We need this HandleMark to avoid leaking VM handles.
     HandleMark hm(thread);
 
-    if (CodeCache::unallocated_capacity() < CodeCacheMinimumFreeSpace) {
+    // Allocations fall back to the other nmethod code heap, so the code
+    // cache is only really full if there is no space left in either.
+    if (CodeCache::unallocated_capacity(CodeBlobType::MethodNonProfiled) < CodeCacheMinimumFreeSpace &&
+        CodeCache::unallocated_capacity(CodeBlobType::MethodProfiled) < CodeCacheMinimumFreeSpace) {
       // the code cache is really full
-      handle_full_code_cache();
+      handle_full_code_cache(CodeBlobType::MethodNonProfiled);
     }
 
     CompileTask* task = queue->get();
@@ -2239,6 +2288,11 @@ void CompileBroker::invoke_compiler_on_method(CompileTask* task) {
       runtime = env.runtime();
       runtime->compile_method(&env, jvmci, method, osr_bci);
 
+      if (should_log) {
+        thread->log()->elem("jvmci_resources resource_area_sampled_max='" SIZE_FORMAT "' local_handle_blocks_sampled_max='%d'",
+                            compile_state.resource_area_sampled_max(), compile_state.local_handle_blocks_sampled_max());
+      }
+
       failure_reason = compile_state.failure_reason();
       failure_reason_on_C_heap = compile_state.failure_reason_on_C_heap();
 
@@ -2393,10 +2447,10 @@ void CompileBroker::invoke_compiler_on_method(CompileTask* task) {
 }
 
 /**
- * The CodeCache is full.  Print out warning and disable compilation
- * or try code cache cleaning so compilation can continue later.
+ * The CodeHeap for code_blob_type is full.  Print out warning and disable
+ * compilation or try code cache cleaning so compilation can continue later.
  */
-void CompileBroker::handle_full_code_cache() {
+void CompileBroker::handle_full_code_cache(int code_blob_type) {
   UseInterpreter = true;
   if (UseCompiler || AlwaysCompileLoopMethods ) {
     if (xtty != NULL) {
@@ -2413,7 +2467,7 @@ void CompileBroker::handle_full_code_cache() {
       xtty->end_elem();
     }
 
-    CodeCache::report_codemem_full();
+    CodeCache::report_codemem_full(code_blob_type);
 
 #ifndef PRODUCT
     if (CompileTheWorld || ExitOnFullCodeCache) {
@@ -2438,8 +2492,14 @@ void CompileBroker::handle_full_code_cache() {
 
     // Print warning only once
     if (should_print_compiler_warning()) {
-      warning("CodeCache is full. Compiler has been disabled.");
-      warning("Try increasing the code cache size using -XX:ReservedCodeCacheSize=");
+      if (SegmentedCodeCache) {
+        warning("%s is full. Compiler has been disabled.", CodeCache::get_code_heap(code_blob_type)->name());
+        warning("Try increasing the code heap sizes using -XX:ReservedCodeCacheSize=, "
+                "-XX:NonNMethodCodeHeapSize=, -XX:ProfiledCodeHeapSize= or -XX:NonProfiledCodeHeapSize=");
+      } else {
+        warning("CodeCache is full. Compiler has been disabled.");
+        warning("Try increasing the code cache size using -XX:ReservedCodeCacheSize=");
+      }
       codecache_print(/* detailed= */ true);
     }
   }
@@ -117,6 +117,8 @@ class CompileTask : public CHeapObj<mtCompiler> {
   void         mark_complete()                   { _is_complete = true; }
   void         mark_success()                    { _is_success = true; }
 
+  jlong        time_queued() const               { return _time_queued; }
+
   int          comp_level()                      { return _comp_level;}
   void         set_comp_level(int comp_level)    { _comp_level = comp_level;}
 
@@ -230,7 +232,16 @@ class CompileQueue : public CHeapObj<mtCompiler> {
 
   int _size;
 
+  // Histogram of the time tasks spend in the queue before
+  // being taken by a compiler thread.
+  enum {
+    wait_buckets = 5            // < 1ms, < 10ms, < 100ms, < 1s, >= 1s
+  };
+  PerfCounter* _perf_wait_time;
+  PerfCounter* _perf_wait_histogram[wait_buckets];
+
   void purge_stale_tasks();
+  void record_wait(CompileTask* task);
  public:
   CompileQueue(const char* name, Monitor* lock) {
     _name = name;
@@ -239,8 +250,15 @@ class CompileQueue : public CHeapObj<mtCompiler> {
     _last = NULL;
     _size = 0;
     _first_stale = NULL;
+    _perf_wait_time = NULL;
+    for (int i = 0; i < wait_buckets; i++) {
+      _perf_wait_histogram[i] = NULL;
+    }
   }
 
+  // Creates the sun.ci.<name_space>.* counters describing queue latency.
+  void         create_perf_counters(const char* name_space, TRAPS);
+
   const char*  name() const                      { return _name; }
   Monitor*     lock() const                      { return _lock; }
 
@@ -479,7 +497,7 @@ class CompileBroker: AllStatic {
   static bool is_compilation_disabled_forever() {
     return _should_compile_new_jobs == shutdown_compilaton;
   }
-  static void handle_full_code_cache();
+  static void handle_full_code_cache(int code_blob_type);
   // Ensures that warning is only printed once.
   static bool should_print_compiler_warning() {
     jint old = Atomic::cmpxchg(1, &_print_compilation_warning, 0);
@@ -41,6 +41,7 @@
 #include "gc_implementation/shared/gcTrace.hpp"
 #include "gc_implementation/shared/gcTraceTime.hpp"
 #include "gc_implementation/shared/isGCActiveMark.hpp"
+#include "gc_implementation/shared/parallelCleaning.hpp"
 #include "gc_interface/collectedHeap.inline.hpp"
 #include "memory/allocation.hpp"
 #include "memory/cardTableRS.hpp"
@@ -6289,7 +6290,8 @@ void CMSCollector::refProcessingWork(bool asynch, bool clear_all_soft_refs) {
       bool purged_class = SystemDictionary::do_unloading(&_is_alive_closure);
 
       // Unload nmethods.
-      CodeCache::do_unloading(&_is_alive_closure, purged_class);
+      ParallelCodeCacheUnloadingTask::unload(GenCollectedHeap::heap()->workers(),
+                                             &_is_alive_closure, purged_class);
 
       // Prune dead klasses from subklass/sibling/implementor lists.
       Klass::clean_weak_klass_links(&_is_alive_closure);
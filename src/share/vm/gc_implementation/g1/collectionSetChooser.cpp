@@ -27,6 +27,7 @@
 #include "gc_implementation/g1/g1CollectedHeap.inline.hpp"
 #include "gc_implementation/g1/g1CollectorPolicy.hpp"
 #include "gc_implementation/g1/g1ErgoVerbose.hpp"
+#include "gc_implementation/g1/heapRegionRemSet.hpp"
 #include "memory/space.inline.hpp"
 
 // Even though we don't use the GC efficiency in our heuristics as
@@ -147,6 +148,14 @@ void CollectionSetChooser::sort_regions() {
 }
 
 
+bool CollectionSetChooser::should_add(HeapRegion* hr) {
+  assert(hr->is_marked(), "pre-condition");
+  assert(!hr->is_young(), "should never consider young regions");
+  return !hr->isHumongous() &&
+          hr->live_bytes() < _region_live_threshold_bytes &&
+          hr->rem_set()->is_complete();
+}
+
 void CollectionSetChooser::add_region(HeapRegion* hr) {
   assert(!hr->isHumongous(),
          "Humongous regions shouldn't be added to the collection set");
@@ -104,13 +104,15 @@ public:
 
   // Determine whether to add the given region to the CSet chooser or
   // not. Currently, we skip humongous regions (we never add them to
-  // the CSet, we only reclaim them during cleanup) and regions whose
-  // live bytes are over the threshold.
-  bool should_add(HeapRegion* hr) {
-    assert(hr->is_marked(), "pre-condition");
-    assert(!hr->is_young(), "should never consider young regions");
-    return !hr->isHumongous() &&
-            hr->live_bytes() < _region_live_threshold_bytes;
+  // the CSet, we only reclaim them during cleanup), regions whose
+  // live bytes are over the threshold and regions without a complete
+  // remembered set.
+  bool should_add(HeapRegion* hr);
+
+  // Returns whether a region with the given amount of live bytes is
+  // sparse enough to become a candidate for collection.
+  static bool region_occupancy_low_enough_for_evac(size_t live_bytes) {
+    return live_bytes < HeapRegion::GrainBytes * (size_t) G1MixedGCLiveThresholdPercent / 100;
   }
 
   // Returns the number candidate old regions added
@@ -34,6 +34,7 @@
 #include "gc_implementation/g1/g1Log.hpp"
 #include "gc_implementation/g1/g1OopClosures.inline.hpp"
 #include "gc_implementation/g1/g1RemSet.hpp"
+#include "gc_implementation/g1/g1RemSetTrackingPolicy.hpp"
 #include "gc_implementation/g1/heapRegion.inline.hpp"
 #include "gc_implementation/g1/heapRegionManager.inline.hpp"
 #include "gc_implementation/g1/heapRegionRemSet.hpp"
@@ -51,6 +52,9 @@
 #include "runtime/java.hpp"
 #include "runtime/prefetch.inline.hpp"
 #include "services/memTracker.hpp"
+#if INCLUDE_JVMCI
+#include "jvmci/jvmci.hpp"
+#endif
 
 // Concurrent marking bit map wrapper
 
@@ -570,7 +574,9 @@ ConcurrentMark::ConcurrentMark(G1CollectedHeap* g1h, G1RegionToSpaceMapper* prev
 
   _count_card_bitmaps(NULL),
   _count_marked_bytes(NULL),
-  _completed_initialization(false) {
+  _completed_initialization(false),
+  _top_at_rebuild_starts(NULL),
+  _num_regions_selected_for_rebuild(0) {
   CMVerboseLevel verbose_level = (CMVerboseLevel) G1MarkingVerboseLevel;
   if (verbose_level < no_verbose) {
     verbose_level = no_verbose;
@@ -725,6 +731,11 @@ ConcurrentMark::ConcurrentMark(G1CollectedHeap* g1h, G1RegionToSpaceMapper* prev
   _count_card_bitmaps = NEW_C_HEAP_ARRAY(BitMap,  _max_worker_id, mtGC);
   _count_marked_bytes = NEW_C_HEAP_ARRAY(size_t*, _max_worker_id, mtGC);
 
+  _top_at_rebuild_starts = NEW_C_HEAP_ARRAY(HeapWord*, _g1h->max_regions(), mtGC);
+  for (uint i = 0; i < _g1h->max_regions(); i++) {
+    _top_at_rebuild_starts[i] = NULL;
+  }
+
   BitMap::idx_t card_bm_size = _card_bm.size();
 
   // so that the assertion in MarkingTaskQueue::task_queue doesn't fail
@@ -1347,6 +1358,9 @@ void ConcurrentMark::checkpointRootsFinal(bool clear_all_soft_refs) {
     // while marking.
     aggregate_count_data();
 
+    // The marked bytes of the regions are final now.
+    select_regions_for_rebuild();
+
     SATBMarkQueueSet& satb_mq_set = JavaThread::satb_mark_queue_set();
     // We're done with marking.
     // This is the end of  the marking cycle, we're expected all
@@ -1831,6 +1845,189 @@ public:
   }
 };
 
+// Selects the old regions whose remembered set is rebuilt concurrently
+// and records the top at rebuild start of all old and humongous regions,
+// which are the sources of references the rebuild has to scan.
+class G1SelectRegionsForRebuildClosure : public HeapRegionClosure {
+  ConcurrentMark* _cm;
+  HeapWord** _top_at_rebuild_starts;
+  uint _num_selected;
+
+public:
+  G1SelectRegionsForRebuildClosure(ConcurrentMark* cm,
+                                   HeapWord** top_at_rebuild_starts) :
+    _cm(cm), _top_at_rebuild_starts(top_at_rebuild_starts), _num_selected(0) { }
+
+  bool doHeapRegion(HeapRegion* r) {
+    HeapWord* top_at_rebuild_start = NULL;
+    if (r->is_old() || r->startsHumongous()) {
+      if (G1RemSetTrackingPolicy::update_before_rebuild(r, r->next_live_bytes())) {
+        _num_selected++;
+      }
+      top_at_rebuild_start = r->top();
+    }
+    _top_at_rebuild_starts[r->hrm_index()] = top_at_rebuild_start;
+    return false;
+  }
+
+  uint num_selected() const { return _num_selected; }
+};
+
+void ConcurrentMark::select_regions_for_rebuild() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at a safepoint");
+  _num_regions_selected_for_rebuild = 0;
+  if (!G1RemSetTrackingPolicy::is_enabled()) {
+    return;
+  }
+  G1SelectRegionsForRebuildClosure cl(this, _top_at_rebuild_starts);
+  _g1h->heap_region_iterate(&cl);
+  _num_regions_selected_for_rebuild = cl.num_selected();
+}
+
+// Adds references into regions whose remembered set is being rebuilt.
+class G1RebuildRemSetClosure : public ExtendedOopClosure {
+  G1CollectedHeap* _g1h;
+  uint _par_id;
+
+  template <class T>
+  void do_oop_work(T* p) {
+    T heap_oop = oopDesc::load_heap_oop(p);
+    if (oopDesc::is_null(heap_oop)) {
+      return;
+    }
+    oop obj = oopDesc::decode_heap_oop_not_null(heap_oop);
+    HeapRegion* to = _g1h->heap_region_containing(obj);
+    HeapRegionRemSet* rem_set = to->rem_set();
+    if (rem_set->is_updating() && !to->is_in_reserved(p)) {
+      rem_set->add_reference(p, _par_id);
+    }
+  }
+
+public:
+  G1RebuildRemSetClosure(G1CollectedHeap* g1h, uint worker_id) :
+    _g1h(g1h), _par_id(HeapRegionRemSet::rebuild_par_id(worker_id)) { }
+
+  virtual void do_oop(oop* p)       { do_oop_work(p); }
+  virtual void do_oop(narrowOop* p) { do_oop_work(p); }
+};
+
+void ConcurrentMark::rebuild_rem_set_in_region(HeapRegion* hr,
+                                               ExtendedOopClosure* cl,
+                                               uint worker_id) {
+  // Scan in chunks of this many words between yield checks.
+  const size_t chunk_words = 256 * K / HeapWordSize;
+
+  const uint region_idx = hr->hrm_index();
+  HeapWord* const ntams = hr->next_top_at_mark_start();
+  HeapWord* cur = hr->bottom();
+
+  while (!has_aborted()) {
+    // Reload the limit every time: the region may have been freed, e.g.
+    // by eager reclaim of a humongous object, while we were yielding.
+    HeapWord* const tars = top_at_rebuild_start(region_idx);
+    if (tars == NULL || cur >= tars) {
+      return;
+    }
+    HeapWord* const limit = MIN2(cur + chunk_words, tars);
+
+    if (hr->startsHumongous()) {
+      // Scan the single, possibly very large, object piecewise.
+      oop obj = oop(hr->bottom());
+      if (hr->bottom() < ntams && !_nextMarkBitMap->isMarked(hr->bottom())) {
+        return;
+      }
+      obj->oop_iterate(cl, MemRegion(cur, limit));
+      cur = limit;
+    } else {
+      // Objects in old regions are smaller than a region, so it is fine
+      // to finish the last object of the chunk in one go.
+      while (cur < limit) {
+        if (cur < ntams && !_nextMarkBitMap->isMarked(cur)) {
+          // Dead objects may refer to unloaded classes, so skip them
+          // using the marking bitmap instead of parsing them.
+          cur = _nextMarkBitMap->getNextMarkedWordAddress(cur, ntams);
+          continue;
+        }
+        cur += oop(cur)->oop_iterate(cl);
+      }
+    }
+
+    do_yield_check(worker_id);
+  }
+}
+
+class G1RebuildRemSetTask: public AbstractGangTask {
+  ConcurrentMark* _cm;
+  volatile jint   _next_region;
+
+  HeapRegion* claim_next() {
+    G1CollectedHeap* g1h = G1CollectedHeap::heap();
+    while (true) {
+      uint idx = (uint) Atomic::add(1, &_next_region) - 1;
+      if (idx >= g1h->max_regions()) {
+        return NULL;
+      }
+      if (_cm->top_at_rebuild_start(idx) != NULL) {
+        return g1h->region_at(idx);
+      }
+    }
+  }
+
+public:
+  G1RebuildRemSetTask(ConcurrentMark* cm) :
+    AbstractGangTask("Rebuild Remembered Sets"), _cm(cm), _next_region(0) { }
+
+  void work(uint worker_id) {
+    assert(Thread::current()->is_ConcurrentGC_thread(),
+           "this should only be done by a conc GC thread");
+    ResourceMark rm;
+
+    SuspendibleThreadSet::join();
+
+    G1RebuildRemSetClosure cl(G1CollectedHeap::heap(), worker_id);
+    HeapRegion* hr = claim_next();
+    while (hr != NULL && !_cm->has_aborted()) {
+      _cm->rebuild_rem_set_in_region(hr, &cl, worker_id);
+      hr = claim_next();
+    }
+
+    SuspendibleThreadSet::leave();
+  }
+};
+
+void ConcurrentMark::rebuild_rem_sets() {
+  assert(num_regions_selected_for_rebuild() > 0, "nothing to rebuild");
+
+  _parallel_marking_threads = calc_parallel_marking_threads();
+  assert(parallel_marking_threads() <= max_parallel_marking_threads(),
+         "Maximum number of marking threads exceeded");
+  uint active_workers = MAX2(1U, parallel_marking_threads());
+
+  G1RebuildRemSetTask task(this);
+  if (use_parallel_marking_threads()) {
+    _parallel_workers->set_active_workers((int) active_workers);
+    _parallel_workers->run_task(&task);
+  } else {
+    task.work(0);
+  }
+}
+
+// Makes the rebuilt remembered sets complete, and forgets the top at
+// rebuild start of all regions.
+class G1UpdateRemSetTrackingAfterRebuildClosure : public HeapRegionClosure {
+  HeapWord** _top_at_rebuild_starts;
+
+public:
+  G1UpdateRemSetTrackingAfterRebuildClosure(HeapWord** top_at_rebuild_starts) :
+    _top_at_rebuild_starts(top_at_rebuild_starts) { }
+
+  bool doHeapRegion(HeapRegion* r) {
+    G1RemSetTrackingPolicy::update_after_rebuild(r);
+    _top_at_rebuild_starts[r->hrm_index()] = NULL;
+    return false;
+  }
+};
+
 class G1ParNoteEndTask;
 
 class G1NoteEndOfConcMarkClosure : public HeapRegionClosure {
@@ -2132,6 +2329,14 @@ void ConcurrentMark::cleanup() {
     _total_rs_scrub_time += this_rs_scrub_time;
   }
 
+  // The remembered sets rebuilt since remark are complete now. This must
+  // happen before the collection set chooser looks at the regions, which
+  // in turn drops the remembered sets of the regions it does not pick.
+  if (G1RemSetTrackingPolicy::is_enabled()) {
+    G1UpdateRemSetTrackingAfterRebuildClosure cl(_top_at_rebuild_starts);
+    g1h->heap_region_iterate(&cl);
+  }
+
   // this will also free any regions totally full of garbage objects,
   // and sort the regions.
   g1h->g1_policy()->record_concurrent_mark_cleanup_end((int)n_workers);
@@ -2620,6 +2825,9 @@ void ConcurrentMark::weakRefsWork(bool clear_all_soft_refs) {
         weakRefsWorkParallelPart(&g1_is_alive, purged_classes);
       }
 
+      // Clean JVMCI metadata handles and mirror caches.
+      JVMCI_ONLY(JVMCI::do_unloading(purged_classes);)
+
       {
         G1RemarkGCTraceTime trace("Deallocate Metadata", G1Log::finest());
         ClassLoaderDataGraph::free_deallocate_lists();
@@ -625,6 +625,21 @@ protected:
   // Set to true when initialization is complete
   bool _completed_initialization;
 
+  // The top of each old and humongous region at the end of remark, if
+  // remembered sets are rebuilt concurrently (G1RebuildRemSetsOnDemand).
+  // The rebuild only scans objects below this address: references in
+  // objects allocated later are added by the post-write barrier or by
+  // the evacuation that copied them. NULL for all other regions.
+  HeapWord** _top_at_rebuild_starts;
+
+  // Number of regions whose remembered set the concurrent rebuild phase
+  // has to fill in.
+  uint _num_regions_selected_for_rebuild;
+
+  // Selects the regions whose remembered set is rebuilt and records the
+  // top at rebuild start of all regions.
+  void select_regions_for_rebuild();
+
 public:
   // Manipulation of the global mark stack.
   // Notice that the first mark_stack_push is CAS-based, whereas the
@@ -770,6 +785,27 @@ public:
 
   void checkpointRootsFinal(bool clear_all_soft_refs);
   void checkpointRootsFinalWork();
+
+  // Concurrently add the references that existed at remark into the
+  // remembered sets selected for rebuild during remark.
+  void rebuild_rem_sets();
+  uint num_regions_selected_for_rebuild() const {
+    return _num_regions_selected_for_rebuild;
+  }
+
+  // Scan the live objects of the given region that existed at remark
+  // with the given closure, yielding regularly.
+  void rebuild_rem_set_in_region(HeapRegion* hr, ExtendedOopClosure* cl,
+                                 uint worker_id);
+
+  HeapWord* top_at_rebuild_start(uint region) const {
+    return _top_at_rebuild_starts[region];
+  }
+  // The region is freed and must no longer be scanned by the rebuild.
+  void clear_top_at_rebuild_start(HeapRegion* hr) {
+    _top_at_rebuild_starts[hr->hrm_index()] = NULL;
+  }
+
   void cleanup();
   void completeCleanup();
 
@@ -170,6 +170,23 @@ void ConcurrentMarkThread::run() {
         }
       } while (cm()->restart_for_overflow());
 
+      if (!cm()->has_aborted() && cm()->num_regions_selected_for_rebuild() > 0) {
+        double rebuild_start_sec = os::elapsedTime();
+        if (G1Log::fine()) {
+          gclog_or_tty->gclog_stamp(cm()->concurrent_gc_id());
+          gclog_or_tty->print_cr("[GC concurrent-rebuild-remsets-start, %u regions]",
+                                 cm()->num_regions_selected_for_rebuild());
+        }
+
+        _cm->rebuild_rem_sets();
+
+        if (!cm()->has_aborted() && G1Log::fine()) {
+          gclog_or_tty->gclog_stamp(cm()->concurrent_gc_id());
+          gclog_or_tty->print_cr("[GC concurrent-rebuild-remsets-end, %1.7lf secs]",
+                                 os::elapsedTime() - rebuild_start_sec);
+        }
+      }
+
       double end_time = os::elapsedVTime();
       // Update the total virtual time before doing this, since it will try
       // to measure it to get the vtime for this marking.  We purposely
@@ -28,6 +28,7 @@
 #include "gc_implementation/g1/g1AllocationContext.hpp"
 #include "gc_implementation/g1/g1AllocRegion.hpp"
 #include "gc_implementation/g1/g1InCSetState.hpp"
+#include "gc_implementation/g1/g1NUMA.hpp"
 #include "gc_implementation/shared/parGCAllocBuffer.hpp"
 
 // Base class for G1 allocators.
@@ -53,9 +54,13 @@ public:
    virtual void release_gc_alloc_regions(uint no_of_gc_workers, EvacuationInfo& evacuation_info) = 0;
    virtual void abandon_gc_alloc_regions() = 0;
 
-   virtual MutatorAllocRegion*    mutator_alloc_region(AllocationContext_t context) = 0;
-   virtual SurvivorGCAllocRegion* survivor_gc_alloc_region(AllocationContext_t context) = 0;
+   // Mutator and survivor alloc regions are kept per NUMA node; node_index
+   // is usually the one of the calling thread, see current_node_index().
+   virtual MutatorAllocRegion*    mutator_alloc_region(AllocationContext_t context, uint node_index) = 0;
+   virtual SurvivorGCAllocRegion* survivor_gc_alloc_region(AllocationContext_t context, uint node_index) = 0;
    virtual OldGCAllocRegion*      old_gc_alloc_region(AllocationContext_t context) = 0;
+   // The number of survivor regions allocated during this GC so far.
+   virtual uint                   survivor_gc_alloc_regions_count() = 0;
    virtual size_t                 used() = 0;
    virtual bool                   is_retained_old_region(HeapRegion* hr) = 0;
 
@@ -63,6 +68,11 @@ public:
                                                             OldGCAllocRegion* old,
                                                             HeapRegion** retained);
 
+   // The index of the NUMA node the calling thread runs on. Callers should
+   // look it up once per allocation attempt and pass it on, since the
+   // thread may move to another node in the meantime.
+   uint current_node_index() const;
+
    size_t used_unlocked() const {
      return _summary_bytes_used;
    }
@@ -92,12 +102,16 @@ public:
 // The default allocator for G1.
 class G1DefaultAllocator : public G1Allocator {
 protected:
-  // Alloc region used to satisfy mutator allocation requests.
-  MutatorAllocRegion _mutator_alloc_region;
+  // The number of NUMA nodes, and so of mutator and survivor alloc regions.
+  uint _num_alloc_regions;
 
-  // Alloc region used to satisfy allocation requests by the GC for
-  // survivor objects.
-  SurvivorGCAllocRegion _survivor_gc_alloc_region;
+  // Alloc regions used to satisfy mutator allocation requests, one per
+  // NUMA node.
+  MutatorAllocRegion* _mutator_alloc_regions;
+
+  // Alloc regions used to satisfy allocation requests by the GC for
+  // survivor objects, one per NUMA node.
+  SurvivorGCAllocRegion* _survivor_gc_alloc_regions;
 
   // Alloc region used to satisfy allocation requests by the GC for
   // old objects.
@@ -105,7 +119,7 @@ protected:
 
   HeapRegion* _retained_old_gc_alloc_region;
 public:
-  G1DefaultAllocator(G1CollectedHeap* heap) : G1Allocator(heap), _retained_old_gc_alloc_region(NULL) { }
+  G1DefaultAllocator(G1CollectedHeap* heap);
 
   virtual void init_mutator_alloc_region();
   virtual void release_mutator_alloc_region();
@@ -118,27 +132,39 @@ public:
     return _retained_old_gc_alloc_region == hr;
   }
 
-  virtual MutatorAllocRegion* mutator_alloc_region(AllocationContext_t context) {
-    return &_mutator_alloc_region;
+  virtual MutatorAllocRegion* mutator_alloc_region(AllocationContext_t context, uint node_index) {
+    assert(node_index < _num_alloc_regions, err_msg("invalid node index %u", node_index));
+    return &_mutator_alloc_regions[node_index];
   }
 
-  virtual SurvivorGCAllocRegion* survivor_gc_alloc_region(AllocationContext_t context) {
-    return &_survivor_gc_alloc_region;
+  virtual SurvivorGCAllocRegion* survivor_gc_alloc_region(AllocationContext_t context, uint node_index) {
+    assert(node_index < _num_alloc_regions, err_msg("invalid node index %u", node_index));
+    return &_survivor_gc_alloc_regions[node_index];
   }
 
   virtual OldGCAllocRegion* old_gc_alloc_region(AllocationContext_t context) {
     return &_old_gc_alloc_region;
   }
 
+  virtual uint survivor_gc_alloc_regions_count() {
+    uint count = 0;
+    for (uint i = 0; i < _num_alloc_regions; i++) {
+      count += _survivor_gc_alloc_regions[i].count();
+    }
+    return count;
+  }
+
   virtual size_t used() {
     assert(Heap_lock->owner() != NULL,
            "Should be owned on this thread's behalf.");
     size_t result = _summary_bytes_used;
 
-    // Read only once in case it is set to NULL concurrently
-    HeapRegion* hr = mutator_alloc_region(AllocationContext::current())->get();
-    if (hr != NULL) {
-      result += hr->used();
+    for (uint i = 0; i < _num_alloc_regions; i++) {
+      // Read only once in case it is set to NULL concurrently
+      HeapRegion* hr = mutator_alloc_region(AllocationContext::current(), i)->get();
+      if (hr != NULL) {
+        result += hr->used();
+      }
     }
     return result;
   }
@@ -42,10 +42,12 @@
 #include "gc_implementation/g1/g1GCPhaseTimes.hpp"
 #include "gc_implementation/g1/g1Log.hpp"
 #include "gc_implementation/g1/g1MarkSweep.hpp"
+#include "gc_implementation/g1/g1ParMarkSweep.hpp"
 #include "gc_implementation/g1/g1OopClosures.inline.hpp"
 #include "gc_implementation/g1/g1ParScanThreadState.inline.hpp"
 #include "gc_implementation/g1/g1RegionToSpaceMapper.hpp"
 #include "gc_implementation/g1/g1RemSet.inline.hpp"
+#include "gc_implementation/g1/g1RemSetTrackingPolicy.hpp"
 #include "gc_implementation/g1/g1RootProcessor.hpp"
 #include "gc_implementation/g1/g1StringDedup.hpp"
 #include "gc_implementation/g1/g1YCTypes.hpp"
@@ -58,6 +60,7 @@
 #include "gc_implementation/shared/gcTrace.hpp"
 #include "gc_implementation/shared/gcTraceTime.hpp"
 #include "gc_implementation/shared/isGCActiveMark.hpp"
+#include "gc_implementation/shared/parallelCleaning.hpp"
 #include "memory/allocation.hpp"
 #include "memory/gcLocker.inline.hpp"
 #include "memory/generationSpec.hpp"
@@ -547,7 +550,7 @@ G1CollectedHeap::new_region_try_secondary_free_list(bool is_old) {
   return NULL;
 }
 
-HeapRegion* G1CollectedHeap::new_region(size_t word_size, bool is_old, bool do_expand) {
+HeapRegion* G1CollectedHeap::new_region(size_t word_size, bool is_old, bool do_expand, uint node_index) {
   assert(!isHumongous(word_size) || word_size <= HeapRegion::GrainWords,
          "the only time we use this to allocate a humongous region is "
          "when we are allocating a single humongous region");
@@ -566,7 +569,7 @@ HeapRegion* G1CollectedHeap::new_region(size_t word_size, bool is_old, bool do_e
     }
   }
 
-  res = _hrm.allocate_free_region(is_old);
+  res = _hrm.allocate_free_region(is_old, node_index);
 
   if (res == NULL) {
     if (G1ConcRegionFreeingVerbose) {
@@ -592,7 +595,7 @@ HeapRegion* G1CollectedHeap::new_region(size_t word_size, bool is_old, bool do_e
       // always expand the heap by an amount aligned to the heap
       // region size, the free list should in theory not be empty.
       // In either case allocate_free_region() will check for NULL.
-      res = _hrm.allocate_free_region(is_old);
+      res = _hrm.allocate_free_region(is_old, node_index);
     } else {
       _expand_heap_after_alloc_failure = false;
     }
@@ -657,6 +660,7 @@ G1CollectedHeap::humongous_obj_allocate_initialize_regions(uint first,
   // first region.
   first_hr->set_startsHumongous(new_top, new_end);
   first_hr->set_allocation_context(context);
+  G1RemSetTrackingPolicy::update_at_allocate(first_hr);
   // Then, if there are any, we will set up the "continues
   // humongous" regions.
   HeapRegion* hr = NULL;
@@ -664,6 +668,7 @@ G1CollectedHeap::humongous_obj_allocate_initialize_regions(uint first,
     hr = region_at(i);
     hr->set_continuesHumongous(first_hr);
     hr->set_allocation_context(context);
+    G1RemSetTrackingPolicy::update_at_allocate(hr);
   }
   // If we have "continues humongous" regions (hr != NULL), then the
   // end of the last one should match new_end.
@@ -891,6 +896,7 @@ G1CollectedHeap::mem_allocate(size_t word_size,
 
 HeapWord* G1CollectedHeap::attempt_allocation_slow(size_t word_size,
                                                    AllocationContext_t context,
+                                                   uint node_index,
                                                    uint* gc_count_before_ret,
                                                    uint* gclocker_retry_count_ret) {
   // Make sure you read the note in attempt_allocation_humongous().
@@ -913,22 +919,22 @@ HeapWord* G1CollectedHeap::attempt_allocation_slow(size_t word_size,
 
     {
       MutexLockerEx x(Heap_lock);
-      result = _allocator->mutator_alloc_region(context)->attempt_allocation_locked(word_size,
-                                                                                    false /* bot_updates */);
+      result = _allocator->mutator_alloc_region(context, node_index)->attempt_allocation_locked(word_size,
+                                                                                                false /* bot_updates */);
       if (result != NULL) {
         return result;
       }
 
       // If we reach here, attempt_allocation_locked() above failed to
       // allocate a new region. So the mutator alloc region should be NULL.
-      assert(_allocator->mutator_alloc_region(context)->get() == NULL, "only way to get here");
+      assert(_allocator->mutator_alloc_region(context, node_index)->get() == NULL, "only way to get here");
 
       if (GC_locker::is_active_and_needs_gc()) {
         if (g1_policy()->can_expand_young_list()) {
           // No need for an ergo verbose message here,
           // can_expand_young_list() does this when it returns true.
-          result = _allocator->mutator_alloc_region(context)->attempt_allocation_force(word_size,
-                                                                                       false /* bot_updates */);
+          result = _allocator->mutator_alloc_region(context, node_index)->attempt_allocation_force(word_size,
+                                                                                                   false /* bot_updates */);
           if (result != NULL) {
             return result;
           }
@@ -988,8 +994,8 @@ HeapWord* G1CollectedHeap::attempt_allocation_slow(size_t word_size,
     // first attempt (without holding the Heap_lock) here and the
     // follow-on attempt will be at the start of the next loop
     // iteration (after taking the Heap_lock).
-    result = _allocator->mutator_alloc_region(context)->attempt_allocation(word_size,
-                                                                           false /* bot_updates */);
+    result = _allocator->mutator_alloc_region(context, node_index)->attempt_allocation(word_size,
+                                                                                       false /* bot_updates */);
     if (result != NULL) {
       return result;
     }
@@ -1128,12 +1134,13 @@ HeapWord* G1CollectedHeap::attempt_allocation_at_safepoint(size_t word_size,
                                                            AllocationContext_t context,
                                                            bool expect_null_mutator_alloc_region) {
   assert_at_safepoint(true /* should_be_vm_thread */);
-  assert(_allocator->mutator_alloc_region(context)->get() == NULL ||
+  uint node_index = _allocator->current_node_index();
+  assert(_allocator->mutator_alloc_region(context, node_index)->get() == NULL ||
                                              !expect_null_mutator_alloc_region,
          "the current alloc region was unexpectedly found to be non-NULL");
 
   if (!isHumongous(word_size)) {
-    return _allocator->mutator_alloc_region(context)->attempt_allocation_locked(word_size,
+    return _allocator->mutator_alloc_region(context, node_index)->attempt_allocation_locked(word_size,
                                                       false /* bot_updates */);
   } else {
     HeapWord* result = humongous_obj_allocate(word_size, context);
@@ -1165,6 +1172,7 @@ public:
 
     _g1h->reset_gc_time_stamps(r);
     hrrs->clear();
+    G1RemSetTrackingPolicy::update_after_full_gc(r);
     // You might think here that we could clear just the cards
     // corresponding to the used region.  But no: if we leave a dirty card
     // in a region we might allocate into, then it would prevent that card
@@ -1361,8 +1369,9 @@ bool G1CollectedHeap::do_collection(bool explicit_gc,
       // G1CollectedHeap::ref_processing_init() about
       // how reference processing currently works in G1.
 
-      // Temporarily make discovery by the STW ref processor single threaded (non-MT).
-      ReferenceProcessorMTDiscoveryMutator stw_rp_disc_ser(ref_processor_stw(), false);
+      // Temporarily make discovery by the STW ref processor single threaded (non-MT),
+      // unless the GC worker threads do the marking.
+      ReferenceProcessorMTDiscoveryMutator stw_rp_disc_ser(ref_processor_stw(), G1ParMarkSweep::is_enabled());
 
       // Temporarily clear the STW ref processor's _is_alive_non_header field.
       ReferenceProcessorIsAliveMutator stw_rp_is_alive_null(ref_processor_stw(), NULL);
@@ -1884,6 +1893,7 @@ G1CollectedHeap::G1CollectedHeap(G1CollectorPolicy* policy_) :
 
   _g1h = this;
 
+  _numa = new G1NUMA();
   _allocator = G1Allocator::create_allocator(_g1h);
   _humongous_object_threshold_in_words = HeapRegion::GrainWords / 2;
 
@@ -2002,14 +2012,16 @@ jint G1CollectedHeap::initialize() {
   // Carve out the G1 part of the heap.
 
   ReservedSpace g1_rs = heap_rs.first_part(max_byte_size);
+  size_t page_size = UseLargePages ? os::large_page_size() : os::vm_page_size();
   G1RegionToSpaceMapper* heap_storage =
     G1RegionToSpaceMapper::create_mapper(g1_rs,
                                          g1_rs.size(),
-                                         UseLargePages ? os::large_page_size() : os::vm_page_size(),
+                                         page_size,
                                          HeapRegion::GrainBytes,
                                          1,
                                          mtJavaHeap);
   heap_storage->set_mapping_changed_listener(&_listener);
+  _numa->set_region_info(HeapRegion::GrainBytes, page_size);
 
   // Create storage for the BOT, card table, card counts table (hot card cache) and the bitmaps.
   G1RegionToSpaceMapper* bot_storage =
@@ -2914,7 +2926,8 @@ size_t G1CollectedHeap::unsafe_max_tlab_alloc(Thread* ignored) const {
   // since we can't allow tlabs to grow big enough to accommodate
   // humongous objects.
 
-  HeapRegion* hr = _allocator->mutator_alloc_region(AllocationContext::current())->get();
+  HeapRegion* hr = _allocator->mutator_alloc_region(AllocationContext::current(),
+                                                    _allocator->current_node_index())->get();
   size_t max_tlab = max_tlab_size() * wordSize;
   if (hr == NULL) {
     return max_tlab;
@@ -3449,6 +3462,47 @@ bool G1CollectedHeap::is_obj_dead_cond(const oop obj,
   return false; // keep some compilers happy
 }
 
+// Counts the used regions on each NUMA node.
+class G1NodeUsageClosure: public HeapRegionClosure {
+  G1NUMA* _numa;
+  uint    _used_regions[G1NUMA::MaxNodes];
+  uint    _young_regions[G1NUMA::MaxNodes];
+public:
+  G1NodeUsageClosure(G1NUMA* numa) : _numa(numa) {
+    for (uint i = 0; i < G1NUMA::MaxNodes; i++) {
+      _used_regions[i] = 0;
+      _young_regions[i] = 0;
+    }
+  }
+
+  bool doHeapRegion(HeapRegion* r) {
+    if (!r->is_free()) {
+      uint node_index = _numa->preferred_node_index_for_index(r->hrm_index());
+      _used_regions[node_index]++;
+      if (r->is_young()) {
+        _young_regions[node_index]++;
+      }
+    }
+    return false;
+  }
+
+  uint used_regions(uint node_index) const  { return _used_regions[node_index]; }
+  uint young_regions(uint node_index) const { return _young_regions[node_index]; }
+};
+
+void G1CollectedHeap::print_numa_on(outputStream* st) const {
+  // This is also used when printing the heap after a crash, so walk the
+  // regions only once and do not allocate.
+  G1NodeUsageClosure blk(_numa);
+  heap_region_iterate(&blk);
+  for (uint i = 0; i < _numa->num_active_nodes(); i++) {
+    st->print_cr("  node %u (id %d): %u used (" SIZE_FORMAT "K), %u young",
+                 i, _numa->node_id_of_index(i), blk.used_regions(i),
+                 (size_t) blk.used_regions(i) * HeapRegion::GrainBytes / K,
+                 blk.young_regions(i));
+  }
+}
+
 void G1CollectedHeap::print_on(outputStream* st) const {
   st->print(" %-20s", "garbage-first heap");
   st->print(" total " SIZE_FORMAT "K, used " SIZE_FORMAT "K",
@@ -3466,6 +3520,9 @@ void G1CollectedHeap::print_on(outputStream* st) const {
   st->print("%u survivors (" SIZE_FORMAT "K)", survivor_regions,
             (size_t) survivor_regions * HeapRegion::GrainBytes / K);
   st->cr();
+  if (_numa->is_enabled()) {
+    print_numa_on(st);
+  }
   MetaspaceAux::print_on(st);
 }
 
@@ -4925,177 +4982,6 @@ public:
   size_t symbols_removed()   const { return (size_t)_symbols_removed; }
 };
 
-class G1CodeCacheUnloadingTask VALUE_OBJ_CLASS_SPEC {
-private:
-  static Monitor* _lock;
-
-  BoolObjectClosure* const _is_alive;
-  const bool               _unloading_occurred;
-  const uint               _num_workers;
-
-  // Variables used to claim nmethods.
-  nmethod* _first_nmethod;
-  volatile nmethod* _claimed_nmethod;
-
-  // The list of nmethods that need to be processed by the second pass.
-  volatile nmethod* _postponed_list;
-  volatile uint     _num_entered_barrier;
-
- public:
-  G1CodeCacheUnloadingTask(uint num_workers, BoolObjectClosure* is_alive, bool unloading_occurred) :
-      _is_alive(is_alive),
-      _unloading_occurred(unloading_occurred),
-      _num_workers(num_workers),
-      _first_nmethod(NULL),
-      _claimed_nmethod(NULL),
-      _postponed_list(NULL),
-      _num_entered_barrier(0)
-  {
-    nmethod::increase_unloading_clock();
-    _first_nmethod = CodeCache::alive_nmethod(CodeCache::first());
-    _claimed_nmethod = (volatile nmethod*)_first_nmethod;
-  }
-
-  ~G1CodeCacheUnloadingTask() {
-    CodeCache::verify_clean_inline_caches();
-
-    CodeCache::set_needs_cache_clean(false);
-    guarantee(CodeCache::scavenge_root_nmethods() == NULL, "Must be");
-
-    CodeCache::verify_icholder_relocations();
-  }
-
- private:
-  void add_to_postponed_list(nmethod* nm) {
-      nmethod* old;
-      do {
-        old = (nmethod*)_postponed_list;
-        nm->set_unloading_next(old);
-      } while ((nmethod*)Atomic::cmpxchg_ptr(nm, &_postponed_list, old) != old);
-  }
-
-  void clean_nmethod(nmethod* nm) {
-    bool postponed = nm->do_unloading_parallel(_is_alive, _unloading_occurred);
-
-    if (postponed) {
-      // This nmethod referred to an nmethod that has not been cleaned/unloaded yet.
-      add_to_postponed_list(nm);
-    }
-
-    // Mark that this thread has been cleaned/unloaded.
-    // After this call, it will be safe to ask if this nmethod was unloaded or not.
-    nm->set_unloading_clock(nmethod::global_unloading_clock());
-  }
-
-  void clean_nmethod_postponed(nmethod* nm) {
-    nm->do_unloading_parallel_postponed(_is_alive, _unloading_occurred);
-  }
-
-  static const int MaxClaimNmethods = 16;
-
-  void claim_nmethods(nmethod** claimed_nmethods, int *num_claimed_nmethods) {
-    nmethod* first;
-    nmethod* last;
-
-    do {
-      *num_claimed_nmethods = 0;
-
-      first = last = (nmethod*)_claimed_nmethod;
-
-      if (first != NULL) {
-        for (int i = 0; i < MaxClaimNmethods; i++) {
-          last = CodeCache::alive_nmethod(CodeCache::next(last));
-
-          if (last == NULL) {
-            break;
-          }
-
-          claimed_nmethods[i] = last;
-          (*num_claimed_nmethods)++;
-        }
-      }
-
-    } while ((nmethod*)Atomic::cmpxchg_ptr(last, &_claimed_nmethod, first) != first);
-  }
-
-  nmethod* claim_postponed_nmethod() {
-    nmethod* claim;
-    nmethod* next;
-
-    do {
-      claim = (nmethod*)_postponed_list;
-      if (claim == NULL) {
-        return NULL;
-      }
-
-      next = claim->unloading_next();
-
-    } while ((nmethod*)Atomic::cmpxchg_ptr(next, &_postponed_list, claim) != claim);
-
-    return claim;
-  }
-
- public:
-  // Mark that we're done with the first pass of nmethod cleaning.
-  void barrier_mark(uint worker_id) {
-    MonitorLockerEx ml(_lock, Mutex::_no_safepoint_check_flag);
-    _num_entered_barrier++;
-    if (_num_entered_barrier == _num_workers) {
-      ml.notify_all();
-    }
-  }
-
-  // See if we have to wait for the other workers to
-  // finish their first-pass nmethod cleaning work.
-  void barrier_wait(uint worker_id) {
-    if (_num_entered_barrier < _num_workers) {
-      MonitorLockerEx ml(_lock, Mutex::_no_safepoint_check_flag);
-      while (_num_entered_barrier < _num_workers) {
-          ml.wait(Mutex::_no_safepoint_check_flag, 0, false);
-      }
-    }
-  }
-
-  // Cleaning and unloading of nmethods. Some work has to be postponed
-  // to the second pass, when we know which nmethods survive.
-  void work_first_pass(uint worker_id) {
-    // The first nmethods is claimed by the first worker.
-    if (worker_id == 0 && _first_nmethod != NULL) {
-      clean_nmethod(_first_nmethod);
-      _first_nmethod = NULL;
-    }
-
-    int num_claimed_nmethods;
-    nmethod* claimed_nmethods[MaxClaimNmethods];
-
-    while (true) {
-      claim_nmethods(claimed_nmethods, &num_claimed_nmethods);
-
-      if (num_claimed_nmethods == 0) {
-        break;
-      }
-
-      for (int i = 0; i < num_claimed_nmethods; i++) {
-        clean_nmethod(claimed_nmethods[i]);
-      }
-    }
-
-    // The nmethod cleaning helps out and does the CodeCache part of MetadataOnStackMark.
-    // Need to retire the buffers now that this thread has stopped cleaning nmethods.
-    MetadataOnStackMark::retire_buffer_for_thread(Thread::current());
-  }
-
-  void work_second_pass(uint worker_id) {
-    nmethod* nm;
-    // Take care of postponed nmethods.
-    while ((nm = claim_postponed_nmethod()) != NULL) {
-      clean_nmethod_postponed(nm);
-    }
-  }
-};
-
-Monitor* G1CodeCacheUnloadingTask::_lock = new Monitor(Mutex::leaf, "Code Cache Unload lock");
-
 class G1KlassCleaningTask : public StackObj {
   BoolObjectClosure*                      _is_alive;
   volatile jint                           _clean_klass_tree_claimed;
@@ -5156,7 +5042,8 @@ public:
 class G1ParallelCleaningTask : public AbstractGangTask {
 private:
   G1StringSymbolTableUnlinkTask _string_symbol_task;
-  G1CodeCacheUnloadingTask      _code_cache_task;
+  CodeCacheUnloadingTask        _code_cache_task;
+  G1GCPhaseTimes*               _phase_times;
   G1KlassCleaningTask           _klass_cleaning_task;
 
 public:
@@ -5164,7 +5051,8 @@ public:
   G1ParallelCleaningTask(BoolObjectClosure* is_alive, bool process_strings, bool process_symbols, uint num_workers, bool unloading_occurred) :
       AbstractGangTask("Parallel Cleaning"),
       _string_symbol_task(is_alive, process_strings, process_symbols),
-      _code_cache_task(num_workers, is_alive, unloading_occurred),
+      _code_cache_task(num_workers, is_alive, unloading_occurred, true /* mark_metadata_on_stack */),
+      _phase_times(G1CollectedHeap::heap()->g1_policy()->phase_times()),
       _klass_cleaning_task(is_alive) {
   }
 
@@ -5183,7 +5071,9 @@ public:
     pre_work_verification();
 
     // Do first pass of code cache cleaning.
-    _code_cache_task.work_first_pass(worker_id);
+    double start_sec = os::elapsedTime();
+    size_t num_nmethods = _code_cache_task.work_first_pass(worker_id);
+    double first_pass_sec = os::elapsedTime() - start_sec;
 
     // Let the threads mark that the first pass is done.
     _code_cache_task.barrier_mark(worker_id);
@@ -5196,7 +5086,11 @@ public:
 
     // Do the second code cache cleaning work, which realize on
     // the liveness information gathered during the first pass.
+    start_sec = os::elapsedTime();
     _code_cache_task.work_second_pass(worker_id);
+    _phase_times->record_time_secs(G1GCPhaseTimes::CodeCacheUnloading, worker_id,
+                                   first_pass_sec + os::elapsedTime() - start_sec);
+    _phase_times->record_thread_work_item(G1GCPhaseTimes::CodeCacheUnloading, worker_id, num_nmethods);
 
     // Clean all klasses that were not unloaded.
     _klass_cleaning_task.work();
@@ -5213,14 +5107,25 @@ void G1CollectedHeap::parallel_cleaning(BoolObjectClosure* is_alive,
   uint n_workers = (G1CollectedHeap::use_parallel_gc_threads() ?
                     workers()->active_workers() : 1);
 
-  G1ParallelCleaningTask g1_unlink_task(is_alive, process_strings, process_symbols,
-                                        n_workers, class_unloading_occurred);
-  if (G1CollectedHeap::use_parallel_gc_threads()) {
-    set_par_threads(n_workers);
-    workers()->run_task(&g1_unlink_task);
-    set_par_threads(0);
-  } else {
-    g1_unlink_task.work(0);
+  G1GCPhaseTimes* phase_times = g1_policy()->phase_times();
+  phase_times->note_parallel_cleaning_start(n_workers);
+
+  double start_sec = os::elapsedTime();
+  {
+    G1ParallelCleaningTask g1_unlink_task(is_alive, process_strings, process_symbols,
+                                          n_workers, class_unloading_occurred);
+    if (G1CollectedHeap::use_parallel_gc_threads()) {
+      set_par_threads(n_workers);
+      workers()->run_task(&g1_unlink_task);
+      set_par_threads(0);
+    } else {
+      g1_unlink_task.work(0);
+    }
+  }
+
+  phase_times->note_parallel_cleaning_end();
+  if (G1Log::finest()) {
+    phase_times->print_parallel_cleaning((os::elapsedTime() - start_sec) * MILLIUNITS);
   }
 }
 
@@ -5942,6 +5847,7 @@ void G1CollectedHeap::free_region(HeapRegion* hr,
   if (!hr->is_young()) {
     _cg1r->hot_card_cache()->reset_card_counts(hr);
   }
+  _cm->clear_top_at_rebuild_start(hr);
   hr->hr_clear(par, true /* clear_space */, locked /* locked */);
   free_list->add_ordered(hr);
 }
@@ -6738,7 +6644,8 @@ bool G1CollectedHeap::is_in_closed_subset(const void* p) const {
 // Methods for the mutator alloc region
 
 HeapRegion* G1CollectedHeap::new_mutator_alloc_region(size_t word_size,
-                                                      bool force) {
+                                                      bool force,
+                                                      uint node_index) {
   assert_heap_locked_or_at_safepoint(true /* should_be_vm_thread */);
   assert(!force || g1_policy()->can_expand_young_list(),
          "if force is true we should be able to expand the young list");
@@ -6746,9 +6653,11 @@ HeapRegion* G1CollectedHeap::new_mutator_alloc_region(size_t word_size,
   if (force || !young_list_full) {
     HeapRegion* new_alloc_region = new_region(word_size,
                                               false /* is_old */,
-                                              false /* do_expand */);
+                                              false /* do_expand */,
+                                              node_index);
     if (new_alloc_region != NULL) {
       set_region_short_lived_locked(new_alloc_region);
+      G1RemSetTrackingPolicy::update_at_allocate(new_alloc_region);
       _hr_printer.alloc(new_alloc_region, G1HRPrinter::Eden, young_list_full);
       check_bitmaps("Mutator Region Allocation", new_alloc_region);
       return new_alloc_region;
@@ -6791,14 +6700,16 @@ void G1CollectedHeap::set_par_threads() {
 
 HeapRegion* G1CollectedHeap::new_gc_alloc_region(size_t word_size,
                                                  uint count,
-                                                 InCSetState dest) {
+                                                 InCSetState dest,
+                                                 uint node_index) {
   assert(FreeList_lock->owned_by_self(), "pre-condition");
 
   if (count < g1_policy()->max_regions(dest)) {
     const bool is_survivor = (dest.is_young());
     HeapRegion* new_alloc_region = new_region(word_size,
                                               !is_survivor,
-                                              true /* do_expand */);
+                                              true /* do_expand */,
+                                              node_index);
     if (new_alloc_region != NULL) {
       // We really only need to do this for old regions given that we
       // should never scan survivors. But it doesn't hurt to do it
@@ -6813,6 +6724,7 @@ HeapRegion* G1CollectedHeap::new_gc_alloc_region(size_t word_size,
         _hr_printer.alloc(new_alloc_region, G1HRPrinter::Old);
         check_bitmaps("Old Region Allocation", new_alloc_region);
       }
+      G1RemSetTrackingPolicy::update_at_allocate(new_alloc_region);
       bool during_im = g1_policy()->during_initial_mark_pause();
       new_alloc_region->note_start_of_copying(during_im);
       return new_alloc_region;
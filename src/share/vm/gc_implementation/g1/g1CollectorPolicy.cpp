@@ -35,6 +35,7 @@
 #include "gc_implementation/g1/g1ErgoVerbose.hpp"
 #include "gc_implementation/g1/g1GCPhaseTimes.hpp"
 #include "gc_implementation/g1/g1Log.hpp"
+#include "gc_implementation/g1/g1RemSetTrackingPolicy.hpp"
 #include "gc_implementation/g1/heapRegionRemSet.hpp"
 #include "gc_implementation/shared/gcPolicyCounters.hpp"
 #include "runtime/arguments.hpp"
@@ -1561,9 +1562,13 @@ public:
       // We will skip any region that's currently used as an old GC
       // alloc region (we should not consider those for collection
       // before we fill them up).
-      if (_hrSorted->should_add(r) && !_g1h->is_old_gc_alloc_region(r)) {
+      bool is_candidate = _hrSorted->should_add(r) && !_g1h->is_old_gc_alloc_region(r);
+      if (is_candidate) {
         _hrSorted->add_region(r);
       }
+      if (r->is_old()) {
+        G1RemSetTrackingPolicy::update_after_candidate_selection(r, is_candidate);
+      }
     }
     return false;
   }
@@ -1585,9 +1590,13 @@ public:
       // We will skip any region that's currently used as an old GC
       // alloc region (we should not consider those for collection
       // before we fill them up).
-      if (_cset_updater.should_add(r) && !_g1h->is_old_gc_alloc_region(r)) {
+      bool is_candidate = _cset_updater.should_add(r) && !_g1h->is_old_gc_alloc_region(r);
+      if (is_candidate) {
         _cset_updater.add_region(r);
       }
+      if (r->is_old()) {
+        G1RemSetTrackingPolicy::update_after_candidate_selection(r, is_candidate);
+      }
     }
     return false;
   }
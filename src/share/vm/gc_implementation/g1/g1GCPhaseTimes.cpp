@@ -291,6 +291,19 @@ G1GCPhaseTimes::G1GCPhaseTimes(uint max_gc_threads) :
   _gc_par_phases[RedirtyCards] = new WorkerDataArray<double>(max_gc_threads, "Parallel Redirty", true, G1Log::LevelFinest, 3);
   _redirtied_cards = new WorkerDataArray<size_t>(max_gc_threads, "Redirtied Cards", true, G1Log::LevelFinest, 3);
   _gc_par_phases[RedirtyCards]->link_thread_work_items(_redirtied_cards);
+
+  _gc_par_phases[CodeCacheUnloading] = new WorkerDataArray<double>(max_gc_threads, "Code Cache Unloading (ms)", true, G1Log::LevelFinest, 2);
+  _cleaned_nmethods = new WorkerDataArray<size_t>(max_gc_threads, "Cleaned NMethods", true, G1Log::LevelFinest, 3);
+  _gc_par_phases[CodeCacheUnloading]->link_thread_work_items(_cleaned_nmethods);
+
+  _gc_par_phases[FullGCMark] = new WorkerDataArray<double>(max_gc_threads, "Marking (ms)", true, G1Log::LevelFiner, 2);
+  _full_gc_marked_objects = new WorkerDataArray<size_t>(max_gc_threads, "Marked Objects", true, G1Log::LevelFinest, 3);
+  _gc_par_phases[FullGCMark]->link_thread_work_items(_full_gc_marked_objects);
+  _gc_par_phases[FullGCPrepare] = new WorkerDataArray<double>(max_gc_threads, "Prepare Compaction (ms)", true, G1Log::LevelFiner, 2);
+  _gc_par_phases[FullGCAdjust] = new WorkerDataArray<double>(max_gc_threads, "Adjust Pointers (ms)", true, G1Log::LevelFiner, 2);
+  _gc_par_phases[FullGCCompact] = new WorkerDataArray<double>(max_gc_threads, "Compaction (ms)", true, G1Log::LevelFiner, 2);
+  _full_gc_compacted_regions = new WorkerDataArray<size_t>(max_gc_threads, "Compacted Regions", true, G1Log::LevelFinest, 3);
+  _gc_par_phases[FullGCCompact]->link_thread_work_items(_full_gc_compacted_regions);
 }
 
 void G1GCPhaseTimes::note_gc_start(uint active_gc_threads, bool mark_in_progress) {
@@ -304,6 +317,10 @@ void G1GCPhaseTimes::note_gc_start(uint active_gc_threads, bool mark_in_progress
 
   _gc_par_phases[StringDedupQueueFixup]->set_enabled(G1StringDedup::is_enabled());
   _gc_par_phases[StringDedupTableFixup]->set_enabled(G1StringDedup::is_enabled());
+  _gc_par_phases[CodeCacheUnloading]->set_enabled(false);
+  for (int i = FullGCPhasesFirst; i <= FullGCPhasesLast; i++) {
+    _gc_par_phases[i]->set_enabled(false);
+  }
 }
 
 void G1GCPhaseTimes::note_gc_end() {
@@ -328,6 +345,36 @@ void G1GCPhaseTimes::note_gc_end() {
   }
 }
 
+void G1GCPhaseTimes::note_parallel_cleaning_start(uint active_gc_threads) {
+  assert(active_gc_threads > 0, "The number of threads must be > 0");
+  assert(active_gc_threads <= _max_gc_threads, "The number of active threads must be <= the max number of threads");
+  _active_gc_threads = active_gc_threads;
+
+  _gc_par_phases[CodeCacheUnloading]->reset();
+  _gc_par_phases[CodeCacheUnloading]->set_enabled(true);
+}
+
+void G1GCPhaseTimes::note_parallel_cleaning_end() {
+  _gc_par_phases[CodeCacheUnloading]->verify(_active_gc_threads);
+}
+
+void G1GCPhaseTimes::note_full_gc_start(uint active_gc_threads) {
+  assert(active_gc_threads > 0, "The number of threads must be > 0");
+  assert(active_gc_threads <= _max_gc_threads, "The number of active threads must be <= the max number of threads");
+  _active_gc_threads = active_gc_threads;
+
+  for (int i = FullGCPhasesFirst; i <= FullGCPhasesLast; i++) {
+    _gc_par_phases[i]->reset();
+    _gc_par_phases[i]->set_enabled(true);
+  }
+}
+
+void G1GCPhaseTimes::note_full_gc_end() {
+  for (int i = FullGCPhasesFirst; i <= FullGCPhasesLast; i++) {
+    _gc_par_phases[i]->verify(_active_gc_threads);
+  }
+}
+
 void G1GCPhaseTimes::print_stats(int level, const char* str, double value) {
   LineBuffer(level).append_and_print_cr("[%s: %.1lf ms]", str, value);
 }
@@ -581,6 +628,26 @@ void G1GCPhaseTimes::print(double pause_time_sec) {
   }
 }
 
+void G1GCPhaseTimes::print_parallel_cleaning(double time_ms) {
+  G1GCParPhasePrinter par_phase_printer(this);
+
+  // The remark pause is logged on a single line, so start a new one.
+  gclog_or_tty->cr();
+  print_stats(1, "Parallel Cleaning", time_ms, _active_gc_threads);
+  par_phase_printer.print(CodeCacheUnloading);
+}
+
+void G1GCPhaseTimes::print_full_gc(double time_ms) {
+  G1GCParPhasePrinter par_phase_printer(this);
+
+  // The full collection is logged on a single line, so start a new one.
+  gclog_or_tty->cr();
+  print_stats(1, "Parallel Full GC", time_ms, _active_gc_threads);
+  for (int i = FullGCPhasesFirst; i <= FullGCPhasesLast; i++) {
+    par_phase_printer.print((GCParPhases) i);
+  }
+}
+
 G1GCParPhaseTimesTracker::G1GCParPhaseTimesTracker(G1GCPhaseTimes* phase_times, G1GCPhaseTimes::GCParPhases phase, uint worker_id) :
     _phase_times(phase_times), _phase(phase), _worker_id(worker_id) {
   if (_phase_times != NULL) {
@@ -70,6 +70,11 @@ class G1GCPhaseTimes : public CHeapObj<mtGC> {
     StringDedupQueueFixup,
     StringDedupTableFixup,
     RedirtyCards,
+    CodeCacheUnloading,
+    FullGCMark,
+    FullGCPrepare,
+    FullGCAdjust,
+    FullGCCompact,
     GCParPhasesSentinel
   };
 
@@ -78,11 +83,16 @@ class G1GCPhaseTimes : public CHeapObj<mtGC> {
   static const int GCMainParPhasesLast = GCWorkerEnd;
   static const int StringDedupPhasesFirst = StringDedupQueueFixup;
   static const int StringDedupPhasesLast = StringDedupTableFixup;
+  static const int FullGCPhasesFirst = FullGCMark;
+  static const int FullGCPhasesLast = FullGCCompact;
 
   WorkerDataArray<double>* _gc_par_phases[GCParPhasesSentinel];
   WorkerDataArray<size_t>* _update_rs_processed_buffers;
   WorkerDataArray<size_t>* _termination_attempts;
   WorkerDataArray<size_t>* _redirtied_cards;
+  WorkerDataArray<size_t>* _cleaned_nmethods;
+  WorkerDataArray<size_t>* _full_gc_marked_objects;
+  WorkerDataArray<size_t>* _full_gc_compacted_regions;
 
   double _cur_collection_par_time_ms;
   double _cur_collection_code_root_fixup_time_ms;
@@ -129,6 +139,18 @@ class G1GCPhaseTimes : public CHeapObj<mtGC> {
   void note_gc_end();
   void print(double pause_time_sec);
 
+  // The parallel cleaning phase of the remark pause reuses the worker
+  // data of the evacuation pauses.
+  void note_parallel_cleaning_start(uint active_gc_threads);
+  void note_parallel_cleaning_end();
+  void print_parallel_cleaning(double time_ms);
+
+  // The parallel full collection records one entry per worker for
+  // each of its phases.
+  void note_full_gc_start(uint active_gc_threads);
+  void note_full_gc_end();
+  void print_full_gc(double time_ms);
+
   // record the time a phase took in seconds
   void record_time_secs(GCParPhases phase, uint worker_i, double secs);
 
@@ -31,12 +31,14 @@
 #include "code/icBuffer.hpp"
 #include "gc_implementation/g1/g1Log.hpp"
 #include "gc_implementation/g1/g1MarkSweep.hpp"
+#include "gc_implementation/g1/g1ParMarkSweep.hpp"
 #include "gc_implementation/g1/g1RootProcessor.hpp"
 #include "gc_implementation/g1/g1StringDedup.hpp"
 #include "gc_implementation/shared/gcHeapSummary.hpp"
 #include "gc_implementation/shared/gcTimer.hpp"
 #include "gc_implementation/shared/gcTrace.hpp"
 #include "gc_implementation/shared/gcTraceTime.hpp"
+#include "gc_implementation/shared/parallelCleaning.hpp"
 #include "memory/gcLocker.hpp"
 #include "memory/genCollectedHeap.hpp"
 #include "memory/modRefBarrierSet.hpp"
@@ -92,20 +94,24 @@ void G1MarkSweep::invoke_at_safepoint(ReferenceProcessor* rp,
   // The marking doesn't preserve the marks of biased objects.
   BiasedLocking::preserve_marks();
 
-  mark_sweep_phase1(marked_for_unloading, clear_all_softrefs);
+  if (G1ParMarkSweep::is_enabled()) {
+    G1ParMarkSweep::mark_sweep(clear_all_softrefs);
+  } else {
+    mark_sweep_phase1(marked_for_unloading, clear_all_softrefs);
 
-  mark_sweep_phase2();
+    mark_sweep_phase2();
 
 #if defined(COMPILER2) || INCLUDE_JVMCI
-  // Don't add any more derived pointers during phase3
-  DerivedPointerTable::set_active(false);
+    // Don't add any more derived pointers during phase3
+    DerivedPointerTable::set_active(false);
 #endif
 
-  mark_sweep_phase3();
+    mark_sweep_phase3();
 
-  mark_sweep_phase4();
+    mark_sweep_phase4();
 
-  GenMarkSweep::restore_marks();
+    GenMarkSweep::restore_marks();
+  }
   BiasedLocking::restore_marks();
   GenMarkSweep::deallocate_stacks();
 
@@ -173,13 +179,18 @@ void G1MarkSweep::mark_sweep_phase1(bool& marked_for_unloading,
   // This is the point where the entire marking should have completed.
   assert(GenMarkSweep::_marking_stack.is_empty(), "Marking should have completed");
 
+  mark_sweep_phase1_epilogue();
+}
+
+void G1MarkSweep::mark_sweep_phase1_epilogue() {
   if (ClassUnloading) {
 
      // Unload classes and purge the SystemDictionary.
      bool purged_class = SystemDictionary::do_unloading(&GenMarkSweep::is_alive);
 
      // Unload nmethods.
-     CodeCache::do_unloading(&GenMarkSweep::is_alive, purged_class);
+     ParallelCodeCacheUnloadingTask::unload(G1CollectedHeap::heap()->workers(),
+                                            &GenMarkSweep::is_alive, purged_class);
 
      // Prune dead klasses from subklass/sibling/implementor lists.
      Klass::clean_weak_klass_links(&GenMarkSweep::is_alive);
@@ -232,24 +243,6 @@ void G1MarkSweep::mark_sweep_phase2() {
   prepare_compaction();
 }
 
-class G1AdjustPointersClosure: public HeapRegionClosure {
- public:
-  bool doHeapRegion(HeapRegion* r) {
-    if (r->isHumongous()) {
-      if (r->startsHumongous()) {
-        // We must adjust the pointers on the single H object.
-        oop obj = oop(r->bottom());
-        // point all the oops to the new location
-        obj->adjust_pointers();
-      }
-    } else {
-      // This really ought to be "as_CompactibleSpace"...
-      r->adjust_pointers();
-    }
-    return false;
-  }
-};
-
 void G1MarkSweep::mark_sweep_phase3() {
   G1CollectedHeap* g1h = G1CollectedHeap::heap();
 
@@ -268,6 +261,17 @@ void G1MarkSweep::mark_sweep_phase3() {
                                      &adjust_code_closure);
   }
 
+  adjust_weak_roots();
+
+  GenMarkSweep::adjust_marks();
+
+  G1AdjustPointersClosure blk;
+  g1h->heap_region_iterate(&blk);
+}
+
+void G1MarkSweep::adjust_weak_roots() {
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+
   assert(GenMarkSweep::ref_processor() == g1h->ref_processor_stw(), "Sanity");
   g1h->ref_processor_stw()->weak_oops_do(&GenMarkSweep::adjust_pointer_closure);
 
@@ -279,11 +283,6 @@ void G1MarkSweep::mark_sweep_phase3() {
   if (G1StringDedup::is_enabled()) {
     G1StringDedup::oops_do(&GenMarkSweep::adjust_pointer_closure);
   }
-
-  GenMarkSweep::adjust_marks();
-
-  G1AdjustPointersClosure blk;
-  g1h->heap_region_iterate(&blk);
 }
 
 class G1SpaceCompactClosure: public HeapRegionClosure {
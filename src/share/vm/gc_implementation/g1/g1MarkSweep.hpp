@@ -48,6 +48,7 @@ class G1PrepareCompactClosure;
 class G1MarkSweep : AllStatic {
   friend class VM_G1MarkSweep;
   friend class Scavenge;
+  friend class G1ParMarkSweep;
 
  public:
 
@@ -62,10 +63,14 @@ class G1MarkSweep : AllStatic {
   // Mark live objects
   static void mark_sweep_phase1(bool& marked_for_deopt,
                                 bool clear_all_softrefs);
+  // Unload classes and clean the weak tables after marking
+  static void mark_sweep_phase1_epilogue();
   // Calculate new addresses
   static void mark_sweep_phase2();
   // Update pointers
   static void mark_sweep_phase3();
+  // Update the pointers in the weak roots
+  static void adjust_weak_roots();
   // Move objects to new positions
   static void mark_sweep_phase4();
 
@@ -74,6 +79,24 @@ class G1MarkSweep : AllStatic {
   static void prepare_compaction_work(G1PrepareCompactClosure* blk);
 };
 
+class G1AdjustPointersClosure: public HeapRegionClosure {
+ public:
+  bool doHeapRegion(HeapRegion* r) {
+    if (r->isHumongous()) {
+      if (r->startsHumongous()) {
+        // We must adjust the pointers on the single H object.
+        oop obj = oop(r->bottom());
+        // point all the oops to the new location
+        obj->adjust_pointers();
+      }
+    } else {
+      // This really ought to be "as_CompactibleSpace"...
+      r->adjust_pointers();
+    }
+    return false;
+  }
+};
+
 class G1PrepareCompactClosure : public HeapRegionClosure {
  protected:
   G1CollectedHeap* _g1h;
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc_implementation/g1/g1NUMA.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/os.hpp"
+#include "runtime/thread.inline.hpp"
+
+G1NUMA::G1NUMA() :
+  _node_ids(NULL), _num_active_nodes(0), _region_size(0), _page_size(0) {
+  size_t num_nodes = UseNUMA ? MIN2(os::numa_get_groups_num(), (size_t)MaxNodes) : 0;
+  if (num_nodes > 1) {
+    _node_ids = NEW_C_HEAP_ARRAY(int, num_nodes, mtGC);
+    _num_active_nodes = (uint)os::numa_get_leaf_groups(_node_ids, num_nodes);
+  }
+  if (_num_active_nodes <= 1) {
+    // Either NUMA is off or there is only a single node to allocate
+    // memory from; treat the whole heap as belonging to node 0.
+    if (_node_ids == NULL) {
+      _node_ids = NEW_C_HEAP_ARRAY(int, 1, mtGC);
+    }
+    _node_ids[0] = 0;
+    _num_active_nodes = 1;
+  }
+}
+
+G1NUMA::~G1NUMA() {
+  FREE_C_HEAP_ARRAY(int, _node_ids, mtGC);
+}
+
+void G1NUMA::set_region_info(size_t region_size, size_t page_size) {
+  assert(region_size > 0 && page_size > 0, "must be");
+  assert(is_power_of_2(region_size) && is_power_of_2(page_size), "must be");
+  _region_size = region_size;
+  _page_size = page_size;
+}
+
+uint G1NUMA::index_of_node_id(int node_id) const {
+  for (uint i = 0; i < _num_active_nodes; i++) {
+    if (_node_ids[i] == node_id) {
+      return i;
+    }
+  }
+  return AnyNodeIndex;
+}
+
+uint G1NUMA::index_of_current_thread() const {
+  if (!is_enabled()) {
+    return 0;
+  }
+  // Same caching as MutableNUMASpace: without group homing the thread may
+  // have moved since we last looked, so ask the os again.
+  Thread* thr = Thread::current();
+  int lgrp_id = thr->lgrp_id();
+  if (lgrp_id == -1 || !os::numa_has_group_homing()) {
+    lgrp_id = os::numa_get_group_id();
+    thr->set_lgrp_id(lgrp_id);
+  }
+  uint node_index = index_of_node_id(lgrp_id);
+  // The thread may run on a node without memory of its own.
+  return node_index == AnyNodeIndex ? 0 : node_index;
+}
+
+uint G1NUMA::preferred_node_index_for_index(uint region_index) const {
+  if (!is_enabled()) {
+    return 0;
+  }
+  if (_region_size >= _page_size) {
+    return region_index % _num_active_nodes;
+  } else {
+    // Several regions share a page, and a page can only be on one node.
+    size_t regions_per_page = _page_size / _region_size;
+    return (uint)((region_index / regions_per_page) % _num_active_nodes);
+  }
+}
+
+void G1NUMA::request_memory_on_node(void* address, size_t size_in_bytes, uint region_index) {
+  if (!is_enabled() || size_in_bytes == 0) {
+    return;
+  }
+  assert(_page_size > 0, "region info not set");
+  // Bind whole pages; if the region is smaller than a page this binds the
+  // page it shares with its neighbours, which have the same preferred node.
+  char* start = (char*)align_ptr_down(address, _page_size);
+  char* end = (char*)align_ptr_up((char*)address + size_in_bytes, _page_size);
+  uint node_index = preferred_node_index_for_index(region_index);
+  os::numa_make_local(start, pointer_delta(end, start, sizeof(char)), _node_ids[node_index]);
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_VM_GC_IMPLEMENTATION_G1_G1NUMA_HPP
+#define SHARE_VM_GC_IMPLEMENTATION_G1_G1NUMA_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+// Maps heap regions and threads to NUMA nodes.
+//
+// With UseNUMA, the memory of every region is bound to a preferred node when
+// the region is committed. Consecutive regions are striped across the nodes;
+// regions smaller than a page share the node of the page they are in.
+// Allocation then tries to hand out regions bound to the node the
+// requesting thread is running on.
+//
+// Nodes are identified by a dense index in [0, num_active_nodes()) rather
+// than by their os node id. Without UseNUMA there is a single node with
+// index 0, so that callers do not need to special-case that.
+class G1NUMA : public CHeapObj<mtGC> {
+  // The os ids of the nodes memory can be allocated on, indexed by node index.
+  int*   _node_ids;
+  uint   _num_active_nodes;
+
+  size_t _region_size;
+  size_t _page_size;
+
+  // Returns the index of the node with the given os id, or AnyNodeIndex
+  // if there is no such node (e.g. the node has no memory).
+  uint index_of_node_id(int node_id) const;
+
+public:
+  // Requests a region from any node.
+  static const uint AnyNodeIndex = (uint)-1;
+
+  // At most this many nodes are used, so that per-node state can be kept
+  // in fixed size arrays (e.g. when printing the heap after a crash).
+  static const uint MaxNodes = 64;
+
+  G1NUMA();
+  ~G1NUMA();
+
+  // Must be called before any region is committed.
+  void set_region_info(size_t region_size, size_t page_size);
+
+  bool is_enabled() const { return _num_active_nodes > 1; }
+
+  uint num_active_nodes() const { return _num_active_nodes; }
+
+  int node_id_of_index(uint node_index) const {
+    assert(node_index < _num_active_nodes, err_msg("invalid node index %u", node_index));
+    return _node_ids[node_index];
+  }
+
+  // Returns the index of the node the current thread is running on.
+  uint index_of_current_thread() const;
+
+  // Returns the index of the node the memory of the given region is bound to.
+  uint preferred_node_index_for_index(uint region_index) const;
+
+  // Binds the memory of the region with the given index, which spans
+  // [address, address + size_in_bytes), to its preferred node.
+  void request_memory_on_node(void* address, size_t size_in_bytes, uint region_index);
+};
+
+#endif // SHARE_VM_GC_IMPLEMENTATION_G1_G1NUMA_HPP
@@ -37,6 +37,7 @@ class CMBitMap;
 class CMMarkStack;
 class G1ParScanThreadState;
 class CMTask;
+class G1ParMarkSweepThreadState;
 class ReferenceProcessor;
 
 // A class that scans oops in a given heap region (much as OopsInGenClosure
@@ -195,6 +196,18 @@ public:
   virtual void do_oop(narrowOop* p) { do_oop_nv(p); }
 };
 
+// Closure for marking through object fields during a parallel full gc
+class G1ParMarkAndPushClosure : public MetadataAwareOopClosure {
+private:
+  G1ParMarkSweepThreadState* _pms;
+public:
+  G1ParMarkAndPushClosure(G1ParMarkSweepThreadState* pms, ReferenceProcessor* rp) :
+    MetadataAwareOopClosure(rp), _pms(pms) { }
+  template <class T> void do_oop_nv(T* p);
+  virtual void do_oop(      oop* p) { do_oop_nv(p); }
+  virtual void do_oop(narrowOop* p) { do_oop_nv(p); }
+};
+
 // Closure that applies the given two closures in sequence.
 // Used by the RSet refinement code (when updating RSets
 // during an evacuation pause) to record cards containing
@@ -28,6 +28,7 @@
 #include "gc_implementation/g1/concurrentMark.inline.hpp"
 #include "gc_implementation/g1/g1CollectedHeap.hpp"
 #include "gc_implementation/g1/g1OopClosures.hpp"
+#include "gc_implementation/g1/g1ParMarkSweep.inline.hpp"
 #include "gc_implementation/g1/g1ParScanThreadState.inline.hpp"
 #include "gc_implementation/g1/g1RemSet.hpp"
 #include "gc_implementation/g1/g1RemSet.inline.hpp"
@@ -134,6 +135,11 @@ inline void G1RootRegionScanClosure::do_oop_nv(T* p) {
   }
 }
 
+template <class T>
+inline void G1ParMarkAndPushClosure::do_oop_nv(T* p) {
+  _pms->mark_and_push(p);
+}
+
 template <class T>
 inline void G1Mux2Closure::do_oop_nv(T* p) {
   // Apply first closure; then apply the second.
@@ -216,9 +222,12 @@ inline void G1UpdateRSOrPushRefOopClosure::do_oop_nv(T* p) {
     // collection set (i.e. we're not during an evacuation pause) _or_
     // the reference doesn't point into the collection set. Either way
     // we add the reference directly to the RSet of the region containing
-    // the referenced object.
+    // the referenced object, unless that remembered set is not
+    // being maintained.
     assert(to->rem_set() != NULL, "Need per-region 'into' remsets.");
-    to->rem_set()->add_reference(p, _worker_i);
+    if (to->rem_set()->is_tracked()) {
+      to->rem_set()->add_reference(p, _worker_i);
+    }
   }
 }
 
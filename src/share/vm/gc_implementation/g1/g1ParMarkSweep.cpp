@@ -0,0 +1,567 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "classfile/classLoaderData.hpp"
+#include "code/codeCache.hpp"
+#include "gc_implementation/g1/g1CollectedHeap.inline.hpp"
+#include "gc_implementation/g1/g1CollectorPolicy.hpp"
+#include "gc_implementation/g1/g1GCPhaseTimes.hpp"
+#include "gc_implementation/g1/g1Log.hpp"
+#include "gc_implementation/g1/g1MarkSweep.hpp"
+#include "gc_implementation/g1/g1OopClosures.inline.hpp"
+#include "gc_implementation/g1/g1ParMarkSweep.inline.hpp"
+#include "gc_implementation/g1/g1RootProcessor.hpp"
+#include "gc_implementation/g1/heapRegion.inline.hpp"
+#include "gc_implementation/shared/gcTimer.hpp"
+#include "gc_implementation/shared/gcTrace.hpp"
+#include "gc_implementation/shared/gcTraceTime.hpp"
+#include "memory/genMarkSweep.hpp"
+#include "memory/iterator.hpp"
+#include "memory/modRefBarrierSet.hpp"
+#include "memory/referenceProcessor.hpp"
+#include "oops/oop.inline.hpp"
+#include "runtime/handles.inline.hpp"
+#include "utilities/stack.inline.hpp"
+
+G1ParMarkSweepThreadState**  G1ParMarkSweep::_thread_states   = NULL;
+G1ParMarkSweepQueueSet*      G1ParMarkSweep::_oop_queues      = NULL;
+G1ParMarkSweepArrayQueueSet* G1ParMarkSweep::_objarray_queues = NULL;
+uint                         G1ParMarkSweep::_n_workers       = 0;
+
+G1ParMarkSweepThreadState::G1ParMarkSweepThreadState(uint worker_id, ReferenceProcessor* rp) :
+  _worker_id(worker_id),
+  _mark_and_push_closure(this, rp),
+  _first_compaction_region(NULL),
+  _last_compaction_region(NULL),
+  _marked_objects(0),
+  _compacted_regions(0) {
+  _oop_queue.initialize();
+  _objarray_queue.initialize();
+}
+
+void G1ParMarkSweepThreadState::drain_stacks() {
+  do {
+    // Drain the overflow stack first, to allow stealing from the marking stack.
+    oop obj;
+    while (_oop_queue.pop_overflow(obj)) {
+      follow_contents(obj);
+    }
+    while (_oop_queue.pop_local(obj)) {
+      follow_contents(obj);
+    }
+
+    // Process ObjArrays one at a time to avoid marking stack bloat.
+    ObjArrayTask task;
+    if (_objarray_queue.pop_overflow(task) || _objarray_queue.pop_local(task)) {
+      follow_array_chunk(objArrayOop(task.obj()), task.index());
+    }
+  } while (!stacks_empty());
+}
+
+// Keeps the workers out of termination as long as there are array chunks
+// left to steal; the terminator itself only peeks at the object queues.
+class G1ParMarkSweepTerminatorTerminator : public TerminatorTerminator {
+ public:
+  virtual bool should_exit_termination() {
+    return G1ParMarkSweep::objarray_queues()->peek();
+  }
+};
+
+void G1ParMarkSweepThreadState::steal_and_drain_stacks(ParallelTaskTerminator* terminator) {
+  G1ParMarkSweepQueueSet* oop_queues = G1ParMarkSweep::oop_queues();
+  G1ParMarkSweepArrayQueueSet* objarray_queues = G1ParMarkSweep::objarray_queues();
+  G1ParMarkSweepTerminatorTerminator tt;
+
+  int random_seed = 17;
+  do {
+    drain_stacks();
+
+    ObjArrayTask task;
+    while (objarray_queues->steal(_worker_id, &random_seed, task)) {
+      follow_array_chunk(objArrayOop(task.obj()), task.index());
+      drain_stacks();
+    }
+    oop obj;
+    while (oop_queues->steal(_worker_id, &random_seed, obj)) {
+      follow_contents(obj);
+      drain_stacks();
+    }
+  } while (!stacks_empty() || !terminator->offer_termination(&tt));
+}
+
+void G1ParMarkSweepThreadState::add_compaction_region(HeapRegion* hr) {
+  assert(!hr->isHumongous(), "humongous regions are not compacted");
+  if (_last_compaction_region == NULL) {
+    // This is the first region claimed by this worker, so initialize
+    // the CompactPoint.
+    _first_compaction_region = hr;
+    _cp.space = hr;
+    _cp.threshold = hr->initialize_threshold();
+  } else {
+    _last_compaction_region->set_next_compaction_space(hr);
+  }
+  _last_compaction_region = hr;
+}
+
+void G1ParMarkSweepThreadState::adjust_marks() {
+  assert(_preserved_oop_stack.size() == _preserved_mark_stack.size(),
+         "inconsistent preserved oop stacks");
+  StackIterator<oop, mtGC> iter(_preserved_oop_stack);
+  while (!iter.is_empty()) {
+    oop* p = iter.next_addr();
+    MarkSweep::adjust_pointer(p);
+  }
+}
+
+void G1ParMarkSweepThreadState::compact_regions() {
+  // Objects only move into regions earlier in the list, which have
+  // already been compacted by the time we get to them.
+  HeapRegion* hr = _first_compaction_region;
+  while (hr != NULL) {
+    HeapRegion* next = (HeapRegion*) hr->CompactibleSpace::next_compaction_space();
+    hr->compact();
+    hr->set_next_compaction_space(NULL);
+    _compacted_regions++;
+    hr = next;
+  }
+}
+
+void G1ParMarkSweepThreadState::restore_marks() {
+  assert(_preserved_oop_stack.size() == _preserved_mark_stack.size(),
+         "inconsistent preserved oop stacks");
+  while (!_preserved_oop_stack.is_empty()) {
+    oop obj       = _preserved_oop_stack.pop();
+    markOop mark  = _preserved_mark_stack.pop();
+    obj->set_mark(mark);
+  }
+}
+
+void G1ParMarkSweepThreadState::reset() {
+  assert(stacks_empty(), "marking should have completed");
+  _preserved_oop_stack.clear(true);
+  _preserved_mark_stack.clear(true);
+  _cp = CompactPoint();
+  _first_compaction_region = NULL;
+  _last_compaction_region = NULL;
+  _marked_objects = 0;
+  _compacted_regions = 0;
+}
+
+class G1ParMarkSweepFollowStackClosure: public VoidClosure {
+  G1ParMarkSweepThreadState* _pms;
+  ParallelTaskTerminator*    _terminator;
+ public:
+  G1ParMarkSweepFollowStackClosure(G1ParMarkSweepThreadState* pms,
+                                   ParallelTaskTerminator* terminator) :
+    _pms(pms), _terminator(terminator) { }
+
+  void do_void() {
+    if (_terminator != NULL) {
+      _pms->steal_and_drain_stacks(_terminator);
+    } else {
+      _pms->drain_stacks();
+    }
+  }
+};
+
+class G1ParMarkTask : public AbstractGangTask {
+  G1CollectedHeap*       _g1h;
+  G1RootProcessor*       _root_processor;
+  ParallelTaskTerminator _terminator;
+
+ public:
+  G1ParMarkTask(G1CollectedHeap* g1h, G1RootProcessor* root_processor, uint n_workers) :
+    AbstractGangTask("G1 Parallel Full GC Marking"),
+    _g1h(g1h),
+    _root_processor(root_processor),
+    _terminator(n_workers, G1ParMarkSweep::oop_queues()) { }
+
+  void work(uint worker_id) {
+    G1GCParPhaseTimesTracker x(_g1h->g1_policy()->phase_times(), G1GCPhaseTimes::FullGCMark, worker_id);
+    HandleMark hm;
+
+    G1ParMarkSweepThreadState* pms = G1ParMarkSweep::thread_state(worker_id);
+    G1ParMarkAndPushClosure* mark_closure = pms->mark_and_push_closure();
+    CLDToOopClosure mark_cld_closure(mark_closure);
+    MarkingCodeBlobClosure mark_code_closure(mark_closure, !CodeBlobToOopClosure::FixRelocations);
+
+    if (ClassUnloading) {
+      _root_processor->process_strong_roots(mark_closure,
+                                            &mark_cld_closure,
+                                            &mark_code_closure);
+    } else {
+      _root_processor->process_all_roots_no_string_table(mark_closure,
+                                                         &mark_cld_closure,
+                                                         &mark_code_closure);
+    }
+
+    pms->steal_and_drain_stacks(&_terminator);
+  }
+};
+
+class G1ParMarkSweepRefProcTaskExecutor: public AbstractRefProcTaskExecutor {
+  G1CollectedHeap* _g1h;
+  uint             _n_workers;
+
+ public:
+  G1ParMarkSweepRefProcTaskExecutor(G1CollectedHeap* g1h, uint n_workers) :
+    _g1h(g1h), _n_workers(n_workers) { }
+
+  virtual void execute(ProcessTask& task);
+  virtual void execute(EnqueueTask& task);
+};
+
+class G1ParMarkSweepRefProcTaskProxy: public AbstractGangTask {
+  typedef AbstractRefProcTaskExecutor::ProcessTask ProcessTask;
+  ProcessTask&           _proc_task;
+  ParallelTaskTerminator _terminator;
+
+ public:
+  G1ParMarkSweepRefProcTaskProxy(ProcessTask& proc_task, uint n_workers) :
+    AbstractGangTask("G1 Parallel Full GC Reference Processing"),
+    _proc_task(proc_task),
+    _terminator(n_workers, G1ParMarkSweep::oop_queues()) { }
+
+  virtual void work(uint worker_id) {
+    HandleMark hm;
+    G1ParMarkSweepThreadState* pms = G1ParMarkSweep::thread_state(worker_id);
+    G1ParMarkSweepFollowStackClosure follow_stack_closure(pms, &_terminator);
+    _proc_task.work(worker_id, GenMarkSweep::is_alive,
+                    *pms->mark_and_push_closure(), follow_stack_closure);
+  }
+};
+
+void G1ParMarkSweepRefProcTaskExecutor::execute(ProcessTask& proc_task) {
+  G1ParMarkSweepRefProcTaskProxy proc_task_proxy(proc_task, _n_workers);
+
+  _g1h->set_par_threads(_n_workers);
+  _g1h->workers()->run_task(&proc_task_proxy);
+  _g1h->set_par_threads(0);
+}
+
+class G1ParMarkSweepRefEnqueueTaskProxy: public AbstractGangTask {
+  typedef AbstractRefProcTaskExecutor::EnqueueTask EnqueueTask;
+  EnqueueTask& _enq_task;
+
+ public:
+  G1ParMarkSweepRefEnqueueTaskProxy(EnqueueTask& enq_task) :
+    AbstractGangTask("G1 Parallel Full GC Reference Enqueueing"),
+    _enq_task(enq_task) { }
+
+  virtual void work(uint worker_id) {
+    _enq_task.work(worker_id);
+  }
+};
+
+void G1ParMarkSweepRefProcTaskExecutor::execute(EnqueueTask& enq_task) {
+  G1ParMarkSweepRefEnqueueTaskProxy enq_task_proxy(enq_task);
+
+  _g1h->set_par_threads(_n_workers);
+  _g1h->workers()->run_task(&enq_task_proxy);
+  _g1h->set_par_threads(0);
+}
+
+// Handles the humongous regions before the parallel forwarding: live
+// humongous objects stay in place, dead ones are freed so that their
+// regions can be claimed as compaction targets by the workers.
+class G1ParPrepareHumongousClosure : public G1PrepareCompactClosure {
+ protected:
+  virtual void prepare_for_compaction(HeapRegion* hr, HeapWord* end) { }
+
+ public:
+  bool doHeapRegion(HeapRegion* hr) {
+    if (hr->isHumongous()) {
+      return G1PrepareCompactClosure::doHeapRegion(hr);
+    }
+    return false;
+  }
+};
+
+class G1ParPrepareCompactClosure : public HeapRegionClosure {
+  G1ParMarkSweepThreadState* _pms;
+  ModRefBarrierSet*          _mrbs;
+
+ public:
+  G1ParPrepareCompactClosure(G1ParMarkSweepThreadState* pms) :
+    _pms(pms), _mrbs(G1CollectedHeap::heap()->g1_barrier_set()) { }
+
+  bool doHeapRegion(HeapRegion* hr) {
+    if (!hr->isHumongous()) {
+      _pms->add_compaction_region(hr);
+      hr->prepare_for_compaction(_pms->compact_point());
+      // Also clear the part of the card table that will be unused after
+      // compaction.
+      _mrbs->clear(MemRegion(hr->compaction_top(), hr->end()));
+    }
+    return false;
+  }
+};
+
+class G1ParPrepareCompactionTask : public AbstractGangTask {
+  G1CollectedHeap* _g1h;
+  uint             _n_workers;
+
+ public:
+  G1ParPrepareCompactionTask(G1CollectedHeap* g1h, uint n_workers) :
+    AbstractGangTask("G1 Parallel Full GC Prepare Compaction"),
+    _g1h(g1h), _n_workers(n_workers) { }
+
+  void work(uint worker_id) {
+    G1GCParPhaseTimesTracker x(_g1h->g1_policy()->phase_times(), G1GCPhaseTimes::FullGCPrepare, worker_id);
+    G1ParPrepareCompactClosure blk(G1ParMarkSweep::thread_state(worker_id));
+    _g1h->heap_region_par_iterate_chunked(&blk, worker_id, _n_workers,
+                                          HeapRegion::ParFullGCPrepareClaimValue);
+  }
+};
+
+class G1ParAdjustPointersTask : public AbstractGangTask {
+  G1CollectedHeap* _g1h;
+  G1RootProcessor* _root_processor;
+  uint             _n_workers;
+
+ public:
+  G1ParAdjustPointersTask(G1CollectedHeap* g1h, G1RootProcessor* root_processor, uint n_workers) :
+    AbstractGangTask("G1 Parallel Full GC Adjust Pointers"),
+    _g1h(g1h), _root_processor(root_processor), _n_workers(n_workers) { }
+
+  void work(uint worker_id) {
+    G1GCParPhaseTimesTracker x(_g1h->g1_policy()->phase_times(), G1GCPhaseTimes::FullGCAdjust, worker_id);
+    HandleMark hm;
+
+    CodeBlobToOopClosure adjust_code_closure(&GenMarkSweep::adjust_pointer_closure, CodeBlobToOopClosure::FixRelocations);
+    _root_processor->process_all_roots(&GenMarkSweep::adjust_pointer_closure,
+                                       &GenMarkSweep::adjust_cld_closure,
+                                       &adjust_code_closure);
+
+    G1ParMarkSweep::thread_state(worker_id)->adjust_marks();
+
+    G1AdjustPointersClosure blk;
+    _g1h->heap_region_par_iterate_chunked(&blk, worker_id, _n_workers,
+                                          HeapRegion::ParFullGCAdjustClaimValue);
+  }
+};
+
+class G1ParCompactTask : public AbstractGangTask {
+  G1CollectedHeap* _g1h;
+
+ public:
+  G1ParCompactTask(G1CollectedHeap* g1h) :
+    AbstractGangTask("G1 Parallel Full GC Compaction"), _g1h(g1h) { }
+
+  void work(uint worker_id) {
+    G1GCParPhaseTimesTracker x(_g1h->g1_policy()->phase_times(), G1GCPhaseTimes::FullGCCompact, worker_id);
+    G1ParMarkSweepThreadState* pms = G1ParMarkSweep::thread_state(worker_id);
+    pms->compact_regions();
+    _g1h->g1_policy()->phase_times()->record_thread_work_item(G1GCPhaseTimes::FullGCCompact, worker_id,
+                                                              pms->compacted_regions());
+  }
+};
+
+class G1ParCompactHumongousClosure: public HeapRegionClosure {
+ public:
+  bool doHeapRegion(HeapRegion* hr) {
+    if (hr->startsHumongous()) {
+      oop obj = oop(hr->bottom());
+      if (obj->is_gc_marked()) {
+        obj->init_mark();
+      } else {
+        assert(hr->is_empty(), "Should have been cleared in phase 2.");
+      }
+      hr->reset_during_compaction();
+    }
+    return false;
+  }
+};
+
+void G1ParMarkSweep::initialize() {
+  assert(_thread_states == NULL, "initialize only once");
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+  uint n = (uint) ParallelGCThreads;
+
+  _oop_queues = new G1ParMarkSweepQueueSet(n);
+  _objarray_queues = new G1ParMarkSweepArrayQueueSet(n);
+  _thread_states = NEW_C_HEAP_ARRAY(G1ParMarkSweepThreadState*, n, mtGC);
+  for (uint i = 0; i < n; i++) {
+    _thread_states[i] = new G1ParMarkSweepThreadState(i, g1h->ref_processor_stw());
+    _oop_queues->register_queue(i, _thread_states[i]->oop_queue());
+    _objarray_queues->register_queue(i, _thread_states[i]->objarray_queue());
+  }
+}
+
+void G1ParMarkSweep::run_task(AbstractGangTask* task) {
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+  g1h->set_par_threads(_n_workers);
+  g1h->workers()->run_task(task);
+  g1h->set_par_threads(0);
+}
+
+void G1ParMarkSweep::mark_sweep(bool clear_all_softrefs) {
+  assert(is_enabled(), "should not be here");
+  if (_thread_states == NULL) {
+    initialize();
+  }
+
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+  _n_workers = g1h->workers()->active_workers();
+
+  G1GCPhaseTimes* phase_times = g1h->g1_policy()->phase_times();
+  phase_times->note_full_gc_start(_n_workers);
+  double start_sec = os::elapsedTime();
+
+  mark_sweep_phase1(clear_all_softrefs);
+
+  mark_sweep_phase2();
+
+#if defined(COMPILER2) || INCLUDE_JVMCI
+  // Don't add any more derived pointers during phase3
+  DerivedPointerTable::set_active(false);
+#endif
+
+  mark_sweep_phase3();
+
+  mark_sweep_phase4();
+
+  for (uint i = 0; i < ParallelGCThreads; i++) {
+    _thread_states[i]->restore_marks();
+    _thread_states[i]->reset();
+  }
+
+  phase_times->note_full_gc_end();
+  if (G1Log::finer()) {
+    phase_times->print_full_gc((os::elapsedTime() - start_sec) * MILLIUNITS);
+  }
+}
+
+void G1ParMarkSweep::mark_sweep_phase1(bool clear_all_softrefs) {
+  // Recursively traverse all live objects and mark them
+  GCTraceTime tm("phase 1", G1Log::fine() && Verbose, true, G1MarkSweep::gc_timer(), G1MarkSweep::gc_tracer()->gc_id());
+  GenMarkSweep::trace(" 1");
+
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+  ReferenceProcessor* rp = g1h->ref_processor_stw();
+  assert(rp == GenMarkSweep::ref_processor(), "Sanity");
+  assert(rp->discovery_is_mt(), "workers discover references");
+
+  // Need cleared claim bits for the roots processing
+  ClassLoaderDataGraph::clear_claimed_marks();
+
+  // Each worker discovers references into its own lists.
+  rp->set_active_mt_degree(_n_workers);
+
+  {
+    G1RootProcessor root_processor(g1h);
+    root_processor.set_num_workers(_n_workers);
+    G1ParMarkTask mark_task(g1h, &root_processor, _n_workers);
+    run_task(&mark_task);
+  }
+
+  // Process reference objects found during marking. The serial parts of
+  // reference processing run in the VM thread with the state of worker 0.
+  G1ParMarkSweepThreadState* pms = thread_state(0);
+  G1ParMarkSweepFollowStackClosure follow_stack_closure(pms, NULL);
+
+  rp->setup_policy(clear_all_softrefs);
+  ReferenceProcessorStats stats;
+  if (rp->processing_is_mt()) {
+    G1ParMarkSweepRefProcTaskExecutor par_task_executor(g1h, _n_workers);
+    stats = rp->process_discovered_references(&GenMarkSweep::is_alive,
+                                              pms->mark_and_push_closure(),
+                                              &follow_stack_closure,
+                                              &par_task_executor,
+                                              G1MarkSweep::gc_timer(),
+                                              G1MarkSweep::gc_tracer()->gc_id());
+  } else {
+    stats = rp->process_discovered_references(&GenMarkSweep::is_alive,
+                                              pms->mark_and_push_closure(),
+                                              &follow_stack_closure,
+                                              NULL,
+                                              G1MarkSweep::gc_timer(),
+                                              G1MarkSweep::gc_tracer()->gc_id());
+  }
+  G1MarkSweep::gc_tracer()->report_gc_reference_stats(stats);
+
+  G1GCPhaseTimes* phase_times = g1h->g1_policy()->phase_times();
+  for (uint i = 0; i < _n_workers; i++) {
+    // This is the point where the entire marking should have completed.
+    assert(thread_state(i)->stacks_empty(), "Marking should have completed");
+    phase_times->record_thread_work_item(G1GCPhaseTimes::FullGCMark, i,
+                                         thread_state(i)->marked_objects());
+  }
+
+  G1MarkSweep::mark_sweep_phase1_epilogue();
+}
+
+void G1ParMarkSweep::mark_sweep_phase2() {
+  // Now all live objects are marked, compute the new object addresses.
+  GCTraceTime tm("phase 2", G1Log::fine() && Verbose, true, G1MarkSweep::gc_timer(), G1MarkSweep::gc_tracer()->gc_id());
+  GenMarkSweep::trace("2");
+
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+
+  G1ParPrepareHumongousClosure humongous_blk;
+  g1h->heap_region_iterate(&humongous_blk);
+  humongous_blk.update_sets();
+
+  G1ParPrepareCompactionTask prepare_task(g1h, _n_workers);
+  assert(g1h->check_heap_region_claim_values(HeapRegion::InitialClaimValue), "sanity check");
+  run_task(&prepare_task);
+  assert(g1h->check_heap_region_claim_values(HeapRegion::ParFullGCPrepareClaimValue), "sanity check");
+  g1h->reset_heap_region_claim_values();
+}
+
+void G1ParMarkSweep::mark_sweep_phase3() {
+  // Adjust the pointers to reflect the new locations
+  GCTraceTime tm("phase 3", G1Log::fine() && Verbose, true, G1MarkSweep::gc_timer(), G1MarkSweep::gc_tracer()->gc_id());
+  GenMarkSweep::trace("3");
+
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+
+  // Need cleared claim bits for the roots processing
+  ClassLoaderDataGraph::clear_claimed_marks();
+
+  {
+    G1RootProcessor root_processor(g1h);
+    root_processor.set_num_workers(_n_workers);
+    G1ParAdjustPointersTask adjust_task(g1h, &root_processor, _n_workers);
+    run_task(&adjust_task);
+  }
+  assert(g1h->check_heap_region_claim_values(HeapRegion::ParFullGCAdjustClaimValue), "sanity check");
+  g1h->reset_heap_region_claim_values();
+
+  G1MarkSweep::adjust_weak_roots();
+}
+
+void G1ParMarkSweep::mark_sweep_phase4() {
+  // All pointers are now adjusted, move objects accordingly
+  GCTraceTime tm("phase 4", G1Log::fine() && Verbose, true, G1MarkSweep::gc_timer(), G1MarkSweep::gc_tracer()->gc_id());
+  GenMarkSweep::trace("4");
+
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+
+  G1ParCompactTask compact_task(g1h);
+  run_task(&compact_task);
+
+  G1ParCompactHumongousClosure humongous_blk;
+  g1h->heap_region_iterate(&humongous_blk);
+}
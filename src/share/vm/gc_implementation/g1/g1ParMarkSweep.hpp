@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_VM_GC_IMPLEMENTATION_G1_G1PARMARKSWEEP_HPP
+#define SHARE_VM_GC_IMPLEMENTATION_G1_G1PARMARKSWEEP_HPP
+
+#include "gc_implementation/g1/g1OopClosures.hpp"
+#include "memory/space.hpp"
+#include "oops/markOop.hpp"
+#include "oops/oop.hpp"
+#include "utilities/stack.hpp"
+#include "utilities/taskqueue.hpp"
+
+class G1CollectedHeap;
+class HeapRegion;
+class ReferenceProcessor;
+
+// G1ParMarkSweep performs the four phases of the G1 full collection with
+// the GC worker threads instead of the VM thread:
+//
+// - Marking: the roots are claimed by the workers through a shared
+//   G1RootProcessor; objects are marked by installing the marked mark word
+//   with a CAS and the marking stacks are balanced by work stealing.
+// - Forwarding: the workers claim regions and compute the new addresses of
+//   the live objects of each claimed region, forwarding them into the
+//   regions previously claimed by the same worker.
+// - Adjusting: roots and regions are claimed and their pointers updated.
+// - Compacting: every worker moves the objects of the regions it claimed
+//   during forwarding, in the same order.
+//
+// Since a worker only moves objects into its own regions, the regions
+// compacted by different workers do not depend on each other.
+// Humongous regions are not moved and are handled by the VM thread.
+
+typedef OverflowTaskQueue<oop, mtGC>                           G1ParMarkSweepQueue;
+typedef GenericTaskQueueSet<G1ParMarkSweepQueue, mtGC>         G1ParMarkSweepQueueSet;
+
+// The remaining chunks of large object arrays, which can be stolen
+// separately from the objects themselves.
+// 32-bit:  4K * 8 = 32KiB; 64-bit:  8K * 16 = 128KiB
+#define G1_PAR_MARK_SWEEP_ARRAY_QUEUE_SIZE (1 << NOT_LP64(12) LP64_ONLY(13))
+typedef OverflowTaskQueue<ObjArrayTask, mtGC, G1_PAR_MARK_SWEEP_ARRAY_QUEUE_SIZE>
+                                                               G1ParMarkSweepArrayQueue;
+typedef GenericTaskQueueSet<G1ParMarkSweepArrayQueue, mtGC>    G1ParMarkSweepArrayQueueSet;
+#undef G1_PAR_MARK_SWEEP_ARRAY_QUEUE_SIZE
+
+class G1ParMarkSweepThreadState : public CHeapObj<mtGC> {
+ private:
+  uint                     _worker_id;
+
+  // Marking stacks
+  G1ParMarkSweepQueue      _oop_queue;
+  G1ParMarkSweepArrayQueue _objarray_queue;
+  G1ParMarkAndPushClosure  _mark_and_push_closure;
+
+  // Space for storing/restoring the mark words of marked objects
+  Stack<oop, mtGC>         _preserved_oop_stack;
+  Stack<markOop, mtGC>     _preserved_mark_stack;
+
+  // The regions this worker compacts, linked through their next
+  // compaction space in the order they were claimed.
+  CompactPoint             _cp;
+  HeapRegion*              _first_compaction_region;
+  HeapRegion*              _last_compaction_region;
+
+  size_t                   _marked_objects;
+  size_t                   _compacted_regions;
+
+  inline bool par_mark_object(oop obj);
+  inline void preserve_mark(oop obj, markOop mark);
+  inline void follow_contents(oop obj);
+  inline void follow_array_chunk(objArrayOop array, int index);
+
+ public:
+  G1ParMarkSweepThreadState(uint worker_id, ReferenceProcessor* rp);
+
+  uint worker_id() const { return _worker_id; }
+
+  G1ParMarkSweepQueue* oop_queue()           { return &_oop_queue; }
+  G1ParMarkSweepArrayQueue* objarray_queue() { return &_objarray_queue; }
+
+  G1ParMarkAndPushClosure* mark_and_push_closure() {
+    return &_mark_and_push_closure;
+  }
+
+  // Phase 1: mark the object and push it on the marking stack if this
+  // worker was the one to mark it.
+  template <class T> inline void mark_and_push(T* p);
+
+  // Empty the marking stacks of this worker.
+  void drain_stacks();
+  // Empty the marking stacks and steal from the other workers until
+  // all of them agree to terminate.
+  void steal_and_drain_stacks(ParallelTaskTerminator* terminator);
+
+  bool stacks_empty() const {
+    return _oop_queue.is_empty() && _objarray_queue.is_empty();
+  }
+
+  size_t marked_objects() const { return _marked_objects; }
+
+  // Phase 2
+  CompactPoint* compact_point() { return &_cp; }
+  void add_compaction_region(HeapRegion* hr);
+
+  // Phase 3
+  void adjust_marks();
+
+  // Phase 4
+  void compact_regions();
+  size_t compacted_regions() const { return _compacted_regions; }
+  void restore_marks();
+
+  // Prepare for the next collection.
+  void reset();
+};
+
+class G1ParMarkSweep : AllStatic {
+  static G1ParMarkSweepThreadState** _thread_states;
+  static G1ParMarkSweepQueueSet*     _oop_queues;
+  static G1ParMarkSweepArrayQueueSet* _objarray_queues;
+  static uint                        _n_workers;
+
+  static void initialize();
+
+  static void run_task(AbstractGangTask* task);
+
+  // Mark live objects
+  static void mark_sweep_phase1(bool clear_all_softrefs);
+  // Calculate new addresses
+  static void mark_sweep_phase2();
+  // Update pointers
+  static void mark_sweep_phase3();
+  // Move objects to new positions
+  static void mark_sweep_phase4();
+
+ public:
+  // Returns true if full collections use the GC worker threads.
+  static bool is_enabled() {
+    return G1ParallelFullGC && ParallelGCThreads > 1;
+  }
+
+  // Runs the four phases of the full collection. Called by
+  // G1MarkSweep::invoke_at_safepoint.
+  static void mark_sweep(bool clear_all_softrefs);
+
+  static uint n_workers() { return _n_workers; }
+
+  static G1ParMarkSweepThreadState* thread_state(uint worker_id) {
+    assert(worker_id < ParallelGCThreads, "out of range");
+    return _thread_states[worker_id];
+  }
+
+  static G1ParMarkSweepQueueSet* oop_queues()           { return _oop_queues; }
+  static G1ParMarkSweepArrayQueueSet* objarray_queues() { return _objarray_queues; }
+};
+
+#endif // SHARE_VM_GC_IMPLEMENTATION_G1_G1PARMARKSWEEP_HPP
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_VM_GC_IMPLEMENTATION_G1_G1PARMARKSWEEP_INLINE_HPP
+#define SHARE_VM_GC_IMPLEMENTATION_G1_G1PARMARKSWEEP_INLINE_HPP
+
+#include "gc_implementation/g1/g1ParMarkSweep.hpp"
+#include "gc_implementation/g1/g1StringDedup.hpp"
+#include "oops/markOop.inline.hpp"
+#include "oops/objArrayOop.hpp"
+#include "oops/oop.inline.hpp"
+#include "utilities/stack.inline.hpp"
+#include "utilities/taskqueue.hpp"
+
+inline void G1ParMarkSweepThreadState::preserve_mark(oop obj, markOop mark) {
+  _preserved_mark_stack.push(mark);
+  _preserved_oop_stack.push(obj);
+}
+
+inline bool G1ParMarkSweepThreadState::par_mark_object(oop obj) {
+  markOop mark = obj->mark();
+  if (mark->is_marked()) {
+    return false;
+  }
+
+  // We must select the deduplication candidates before the object
+  // is marked as we otherwise can't read the object's age.
+  bool dedup_candidate = G1StringDedup::is_enabled() &&
+                         G1StringDedup::is_candidate_from_par_mark(obj);
+
+  if (obj->cas_set_mark(markOopDesc::prototype()->set_marked(), mark) != mark) {
+    // Another worker marked the object first.
+    return false;
+  }
+
+  // some marks may contain information we need to preserve so we store them away
+  // and restore them at the end of the collection.
+  if (mark->must_be_preserved(obj)) {
+    preserve_mark(obj, mark);
+  }
+  if (dedup_candidate) {
+    G1StringDedup::enqueue_from_par_mark(_worker_id, obj);
+  }
+  _marked_objects++;
+  return true;
+}
+
+template <class T>
+inline void G1ParMarkSweepThreadState::mark_and_push(T* p) {
+  T heap_oop = oopDesc::load_heap_oop(p);
+  if (!oopDesc::is_null(heap_oop)) {
+    oop obj = oopDesc::decode_heap_oop_not_null(heap_oop);
+    if (par_mark_object(obj)) {
+      _oop_queue.push(obj);
+    }
+  }
+}
+
+inline void G1ParMarkSweepThreadState::follow_array_chunk(objArrayOop array, int index) {
+  const int len = array->length();
+  const int beg_index = index;
+  assert(beg_index < len || len == 0, "index too large");
+
+  const int stride = MIN2(len - beg_index, (int) ObjArrayMarkingStride);
+  const int end_index = beg_index + stride;
+
+  // Push the continuation first to allow more efficient work stealing.
+  if (end_index < len) {
+    _objarray_queue.push(ObjArrayTask(array, end_index));
+  }
+  array->oop_iterate_range(&_mark_and_push_closure, beg_index, end_index);
+}
+
+inline void G1ParMarkSweepThreadState::follow_contents(oop obj) {
+  assert(obj->is_gc_marked(), "must be marked");
+  if (obj->is_objArray()) {
+    follow_array_chunk(objArrayOop(obj), 0);
+  } else {
+    obj->oop_iterate(&_mark_and_push_closure);
+  }
+}
+
+#endif // SHARE_VM_GC_IMPLEMENTATION_G1_G1PARMARKSWEEP_INLINE_HPP
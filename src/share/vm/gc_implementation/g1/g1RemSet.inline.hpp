@@ -69,7 +69,9 @@ inline void G1RemSet::par_write_ref(HeapRegion* from, T* p, int tid) {
   HeapRegion* to = _g1->heap_region_containing(obj);
   if (from != to) {
     assert(to->rem_set() != NULL, "Need per-region 'into' remsets.");
-    to->rem_set()->add_reference(p, tid);
+    if (to->rem_set()->is_tracked()) {
+      to->rem_set()->add_reference(p, tid);
+    }
   }
 }
 
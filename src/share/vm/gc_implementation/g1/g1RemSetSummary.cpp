@@ -234,6 +234,22 @@ private:
   size_t max_code_root_mem_sz() const       { return _max_code_root_mem_sz; }
   HeapRegion* max_code_root_mem_sz_region() const { return _max_code_root_mem_sz_region; }
 
+  HRRSContainerSizes _container_sizes;
+
+  void print_container_mem_info_on(outputStream* out, size_t mem_size, const char* name) {
+    out->print_cr("    " SIZE_FORMAT_W(8) "%s (%5.1f%%) in %s",
+        byte_size_in_proper_unit(mem_size),
+        proper_unit_for_byte_size(mem_size),
+        percent_of(mem_size, _container_sizes.total_mem_size()), name);
+  }
+
+  void print_container_mem_info_on(outputStream* out, size_t mem_size, size_t num, const char* name) {
+    out->print_cr("    " SIZE_FORMAT_W(8) "%s (%5.1f%%) in " SIZE_FORMAT " %s",
+        byte_size_in_proper_unit(mem_size),
+        proper_unit_for_byte_size(mem_size),
+        percent_of(mem_size, _container_sizes.total_mem_size()), num, name);
+  }
+
 public:
   HRRSStatsIter() : _all("All"), _young("Young"), _humonguous("Humonguous"),
     _free("Free"), _old("Old"), _max_code_root_mem_sz_region(NULL), _max_rs_mem_sz_region(NULL),
@@ -257,6 +273,7 @@ public:
       _max_code_root_mem_sz_region = r;
     }
     size_t code_root_elems = hrrs->strong_code_roots_list_length();
+    hrrs->add_container_sizes(&_container_sizes);
 
     RegionTypeCounter* current = NULL;
     if (r->is_free()) {
@@ -298,6 +315,22 @@ public:
                   byte_size_in_proper_unit(HeapRegionRemSet::fl_mem_size()),
                   proper_unit_for_byte_size(HeapRegionRemSet::fl_mem_size()));
 
+    out->print_cr("   Container sizes = " SIZE_FORMAT "%s.",
+                  byte_size_in_proper_unit(_container_sizes.total_mem_size()),
+                  proper_unit_for_byte_size(_container_sizes.total_mem_size()));
+    print_container_mem_info_on(out, _container_sizes.sparse_mem_size(), "sparse tables");
+    out->print_cr("    " SIZE_FORMAT_W(8) "%s (%5.1f%%) in " SIZE_FORMAT " card arrays, "
+                  SIZE_FORMAT "%s as bitmaps",
+        byte_size_in_proper_unit(_container_sizes.card_array_mem_size()),
+        proper_unit_for_byte_size(_container_sizes.card_array_mem_size()),
+        percent_of(_container_sizes.card_array_mem_size(), _container_sizes.total_mem_size()),
+        _container_sizes.num_card_arrays(),
+        byte_size_in_proper_unit(_container_sizes.card_array_as_bitmap_mem_size()),
+        proper_unit_for_byte_size(_container_sizes.card_array_as_bitmap_mem_size()));
+    print_container_mem_info_on(out, _container_sizes.bitmap_mem_size(),
+                                _container_sizes.num_bitmaps(), "bitmaps");
+    print_container_mem_info_on(out, _container_sizes.coarse_mem_size(), "coarse maps");
+
     out->print_cr("    " SIZE_FORMAT " occupied cards represented.",
                   total_cards_occupied());
     for (RegionTypeCounter** current = &counters[0]; *current != NULL; current++) {
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc_implementation/g1/collectionSetChooser.hpp"
+#include "gc_implementation/g1/g1RemSetTrackingPolicy.hpp"
+#include "gc_implementation/g1/heapRegion.hpp"
+#include "gc_implementation/g1/heapRegionRemSet.hpp"
+
+void G1RemSetTrackingPolicy::update_at_allocate(HeapRegion* r) {
+  if (!is_enabled()) {
+    return;
+  }
+  if (r->is_young() || r->isHumongous()) {
+    r->rem_set()->set_state_complete();
+  } else {
+    assert(r->is_old(), err_msg("unexpected region type %s", r->get_type_str()));
+    // Nothing can be evacuated from this region before a marking has
+    // determined its liveness, which will also rebuild its remembered
+    // set if required.
+    r->rem_set()->set_state_untracked();
+  }
+}
+
+void G1RemSetTrackingPolicy::update_at_free(HeapRegion* r) {
+  if (!is_enabled()) {
+    return;
+  }
+  r->rem_set()->set_state_untracked();
+}
+
+bool G1RemSetTrackingPolicy::update_before_rebuild(HeapRegion* r, size_t live_bytes) {
+  if (!is_enabled()) {
+    return false;
+  }
+  assert(r->is_old() || r->isHumongous(), "only old and humongous regions are rebuild sources");
+  HeapRegionRemSet* rem_set = r->rem_set();
+  if (r->is_old() && !rem_set->is_tracked() &&
+      CollectionSetChooser::region_occupancy_low_enough_for_evac(live_bytes)) {
+    rem_set->set_state_updating();
+    return true;
+  }
+  return false;
+}
+
+void G1RemSetTrackingPolicy::update_after_rebuild(HeapRegion* r) {
+  if (!is_enabled()) {
+    return;
+  }
+  HeapRegionRemSet* rem_set = r->rem_set();
+  if (rem_set->is_updating()) {
+    rem_set->set_state_complete();
+  }
+}
+
+void G1RemSetTrackingPolicy::update_after_candidate_selection(HeapRegion* r, bool is_candidate) {
+  if (!is_enabled()) {
+    return;
+  }
+  assert(r->is_old(), "only old regions can lose their remembered set");
+  HeapRegionRemSet* rem_set = r->rem_set();
+  if (!is_candidate && rem_set->is_tracked()) {
+    rem_set->set_state_untracked();
+    // Keep the strong code roots: the rebuild only scans the heap and would
+    // not find the nmethods referencing this region again.
+    rem_set->clear(true /* only_cardset */);
+  }
+}
+
+void G1RemSetTrackingPolicy::update_after_full_gc(HeapRegion* r) {
+  if (!is_enabled()) {
+    return;
+  }
+  if (r->isHumongous()) {
+    r->rem_set()->set_state_complete();
+  } else {
+    // All remaining regions are old or free after a full collection.
+    r->rem_set()->set_state_untracked();
+  }
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_VM_GC_IMPLEMENTATION_G1_G1REMSETTRACKINGPOLICY_HPP
+#define SHARE_VM_GC_IMPLEMENTATION_G1_G1REMSETTRACKINGPOLICY_HPP
+
+#include "memory/allocation.hpp"
+
+class HeapRegion;
+
+// Decides which remembered sets G1 maintains when G1RebuildRemSetsOnDemand
+// is enabled, and when.
+//
+// The remembered sets of young and humongous regions are always complete:
+// young regions are always collected, and humongous regions need theirs
+// for eager reclamation. The remembered sets of old regions are untracked
+// until a marking finds a region sparse enough to be a candidate for
+// collection. Remark then starts tracking references into the region, and
+// the concurrent rebuild phase adds the references that already existed.
+// At cleanup the rebuilt remembered sets become complete, and the
+// remembered sets of old regions that did not make it into the collection
+// set chooser are dropped again.
+//
+// Without G1RebuildRemSetsOnDemand all remembered sets stay complete.
+class G1RemSetTrackingPolicy : public AllStatic {
+ public:
+  static bool is_enabled() { return G1RebuildRemSetsOnDemand; }
+
+  // The region has just been allocated as young, humongous or old region.
+  static void update_at_allocate(HeapRegion* r);
+
+  // The region is being freed.
+  static void update_at_free(HeapRegion* r);
+
+  // Called for all old and humongous regions at the end of remark.
+  // Returns whether the remembered set of the region must be rebuilt.
+  static bool update_before_rebuild(HeapRegion* r, size_t live_bytes);
+
+  // Called for all regions at cleanup, once the rebuild has completed.
+  static void update_after_rebuild(HeapRegion* r);
+
+  // Called for all old regions at cleanup, after the collection set
+  // chooser has been populated. Drops the remembered sets of regions that
+  // are not candidates for collection.
+  static void update_after_candidate_selection(HeapRegion* r, bool is_candidate);
+
+  // Called for all regions after a full collection, before the remembered
+  // sets are recreated.
+  static void update_after_full_gc(HeapRegion* r);
+};
+
+#endif // SHARE_VM_GC_IMPLEMENTATION_G1_G1REMSETTRACKINGPOLICY_HPP
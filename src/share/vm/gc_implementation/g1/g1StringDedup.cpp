@@ -71,6 +71,11 @@ void G1StringDedup::enqueue_from_mark(oop java_string) {
   }
 }
 
+void G1StringDedup::enqueue_from_par_mark(unsigned int queue, oop java_string) {
+  assert(is_enabled(), "String deduplication not enabled");
+  G1StringDedupQueue::push(queue, java_string);
+}
+
 bool G1StringDedup::is_candidate_from_evacuation(bool from_young, bool to_young, oop obj) {
   if (from_young && java_lang_String::is_instance(obj)) {
     if (to_young && obj->age() == StringDeduplicationAgeThreshold) {
@@ -128,6 +128,14 @@ public:
   static void enqueue_from_evacuation(bool from_young, bool to_young,
                                       unsigned int queue, oop java_string);
 
+  // The parallel full gc marks objects by installing a new mark word, so the
+  // candidate selection must be done before the mark is installed, while the
+  // enqueueing is done by the worker that won the race to mark the object.
+  static bool is_candidate_from_par_mark(oop java_string) {
+    return is_candidate_from_mark(java_string);
+  }
+  static void enqueue_from_par_mark(unsigned int queue, oop java_string);
+
   static void oops_do(OopClosure* keep_alive);
   static void unlink(BoolObjectClosure* is_alive);
   static void unlink_or_oops_do(BoolObjectClosure* is_alive, OopClosure* keep_alive,
@@ -173,6 +173,11 @@
           "Max number of entries per region in a sparse table."             \
           "Will be set ergonomically by default.")                          \
                                                                             \
+  product(intx, G1RSetCardArrayEntries, 0,                                  \
+          "Max number of cards a fine-grain table keeps in a sorted "       \
+          "array before switching to a bitmap. Zero always uses bitmaps. "  \
+          "Will be set ergonomically by default.")                          \
+                                                                            \
   develop(bool, G1RecordHRRSOops, false,                                    \
           "When true, record recent calls to rem set operations.")          \
                                                                             \
@@ -289,6 +294,15 @@
           "An upper bound for the number of old CSet regions expressed "    \
           "as a percentage of the heap size.")                              \
                                                                             \
+  product(bool, G1ParallelFullGC, true,                                     \
+          "Use the GC worker threads to mark, forward, adjust and "         \
+          "compact the heap during a full collection")                      \
+                                                                            \
+  product(bool, G1RebuildRemSetsOnDemand, false,                            \
+          "Only maintain the remembered sets of old regions that are "      \
+          "candidates for mixed collections. They are rebuilt "             \
+          "concurrently after marking selected the candidates")             \
+                                                                            \
   experimental(ccstr, G1LogLevel, NULL,                                     \
           "Log level for G1 logging: fine, finer, finest")                  \
                                                                             \
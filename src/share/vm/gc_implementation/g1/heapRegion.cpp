@@ -27,6 +27,7 @@
 #include "gc_implementation/g1/g1BlockOffsetTable.inline.hpp"
 #include "gc_implementation/g1/g1CollectedHeap.inline.hpp"
 #include "gc_implementation/g1/g1OopClosures.inline.hpp"
+#include "gc_implementation/g1/g1RemSetTrackingPolicy.hpp"
 #include "gc_implementation/g1/heapRegion.inline.hpp"
 #include "gc_implementation/g1/heapRegionBounds.inline.hpp"
 #include "gc_implementation/g1/heapRegionRemSet.hpp"
@@ -181,6 +182,7 @@ void HeapRegion::hr_clear(bool par, bool clear_space, bool locked) {
     }
     _claimed = InitialClaimValue;
   }
+  G1RemSetTrackingPolicy::update_at_free(this);
   zero_marked_bytes();
 
   _offsets.resize(HeapRegion::GrainWords);
@@ -340,6 +342,10 @@ void HeapRegion::report_region_type_change(G1HeapRegionTraceType::Type to) {
 }
 
 CompactibleSpace* HeapRegion::next_compaction_space() const {
+  CompactibleSpace* next = CompactibleSpace::next_compaction_space();
+  if (next != NULL) {
+    return next;
+  }
   return G1CollectedHeap::heap()->next_compaction_region(this);
 }
 
@@ -846,7 +852,8 @@ public:
       HeapRegion* to   = _g1h->heap_region_containing(obj);
       if (from != NULL && to != NULL &&
           from != to &&
-          !to->isHumongous()) {
+          !to->isHumongous() &&
+          to->rem_set()->is_complete()) {
         jbyte cv_obj = *_bs->byte_for_const(_containing_obj);
         jbyte cv_field = *_bs->byte_for_const(p);
         const jbyte dirty = CardTableModRefBS::dirty_card_val();
@@ -344,7 +344,9 @@ class HeapRegion: public G1OffsetTableContigSpace {
     ParEvacFailureClaimValue   = 6,
     AggregateCountClaimValue   = 7,
     VerifyCountClaimValue      = 8,
-    ParMarkRootClaimValue      = 9
+    ParMarkRootClaimValue      = 9,
+    ParFullGCPrepareClaimValue = 10,
+    ParFullGCAdjustClaimValue  = 11
   };
 
   // All allocated blocks are occupied by objects in a HeapRegion
@@ -746,6 +748,9 @@ class HeapRegion: public G1OffsetTableContigSpace {
     _predicted_bytes_to_copy = bytes;
   }
 
+  // The parallel full collection chains the regions compacted by each
+  // worker through the next compaction space field; the serial one
+  // compacts in heap order.
   virtual CompactibleSpace* next_compaction_space() const;
 
   virtual void reset_after_compaction();
@@ -131,6 +131,7 @@ void HeapRegionManager::make_regions_available(uint start, uint num_regions) {
 
   _available_map.par_set_range(start, start + num_regions, BitMap::unknown_range);
 
+  G1NUMA* numa = G1CollectedHeap::heap()->numa();
   for (uint i = start; i < start + num_regions; i++) {
     assert(is_available(i), err_msg("Just made region %u available but is apparently not.", i));
     HeapRegion* hr = at(i);
@@ -140,6 +141,9 @@ void HeapRegionManager::make_regions_available(uint start, uint num_regions) {
     HeapWord* bottom = G1CollectedHeap::heap()->bottom_addr_for_region(i);
     MemRegion mr(bottom, bottom + HeapRegion::GrainWords);
 
+    // Bind the memory before initialize() gets to touch it.
+    numa->request_memory_on_node(bottom, HeapRegion::GrainBytes, i);
+
     hr->initialize(mr);
     insert_into_free_list(at(i));
   }
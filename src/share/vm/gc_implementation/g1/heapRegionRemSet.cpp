@@ -46,6 +46,19 @@ class PerRegionTable: public CHeapObj<mtGC> {
   BitMap          _bm;
   jint            _occupied;
 
+  // While the table is small, its cards are kept sorted in _cards instead
+  // of _bm, which is then only allocated when the array overflows. The
+  // array is only ever modified with the lock of the owning
+  // OtherRegionsTable held.
+  enum Container {
+    CardArray,
+    Bitmap
+  };
+  volatile jint   _container;
+  u2*             _cards;
+  size_t          _num_cards;
+  size_t          _cards_capacity;
+
   // next pointer for free/allocated 'all' list
   PerRegionTable* _next;
 
@@ -69,11 +82,61 @@ protected:
   PerRegionTable(HeapRegion* hr) :
     _hr(hr),
     _occupied(0),
-    _bm(HeapRegion::CardsPerRegion, false /* in-resource-area */),
+    _bm(),
+    _container(CardArray),
+    _cards(NULL), _num_cards(0), _cards_capacity(0),
     _collision_list_next(NULL), _next(NULL), _prev(NULL)
-  {}
+  {
+    if (G1RSetCardArrayEntries == 0) {
+      switch_to_bitmap();
+    }
+  }
+
+  bool is_bitmap() const {
+    return OrderAccess::load_acquire((volatile jint*)&_container) == Bitmap;
+  }
 
-  void add_card_work(CardIdx_t from_card, bool par) {
+  // Returns whether the card array contains "card", and sets "pos" to the
+  // position of "card" or, if it is not there, to where it belongs.
+  bool find_card_in_array(CardIdx_t card, size_t& pos) const {
+    size_t lo = 0;
+    size_t hi = _num_cards;
+    while (lo < hi) {
+      size_t mid = (lo + hi) / 2;
+      if ((CardIdx_t)_cards[mid] < card) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    pos = lo;
+    return lo < _num_cards && (CardIdx_t)_cards[lo] == card;
+  }
+
+  // Moves the cards from the card array into the (cleared) bitmap and
+  // releases the array. Requires the lock, or a newly allocated table.
+  void switch_to_bitmap() {
+    if (_bm.size() == 0) {
+      _bm.resize(HeapRegion::CardsPerRegion, false /* in-resource-area */);
+    } else {
+      _bm.clear();
+    }
+    for (size_t i = 0; i < _num_cards; i++) {
+      _bm.set_bit(_cards[i]);
+    }
+    _occupied = (jint)_num_cards;
+    if (_cards != NULL) {
+      FREE_C_HEAP_ARRAY(u2, _cards, mtGC);
+      _cards = NULL;
+    }
+    _num_cards = 0;
+    _cards_capacity = 0;
+    // Make sure that the bitmap is complete before threads start adding
+    // to it without the lock.
+    OrderAccess::release_store(&_container, Bitmap);
+  }
+
+  void add_card_to_bitmap(CardIdx_t from_card, bool par) {
     if (!_bm.at(from_card)) {
       if (par) {
         if (_bm.par_at_put(from_card, 1)) {
@@ -86,7 +149,50 @@ protected:
     }
   }
 
-  void add_reference_work(OopOrNarrowOopStar from, bool par) {
+  void add_card_to_array(CardIdx_t from_card) {
+    size_t pos;
+    if (find_card_in_array(from_card, pos)) {
+      return;
+    }
+    if (_num_cards == _cards_capacity) {
+      size_t max_cards = (size_t)G1RSetCardArrayEntries;
+      if (_cards_capacity >= max_cards) {
+        switch_to_bitmap();
+        add_card_to_bitmap(from_card, true /* par */);
+        return;
+      }
+      size_t new_capacity = _cards_capacity == 0
+        ? (size_t)SparsePRTEntry::cards_num() * 2
+        : _cards_capacity * 2;
+      new_capacity = MIN2(new_capacity, max_cards);
+      u2* new_cards = NEW_C_HEAP_ARRAY(u2, new_capacity, mtGC);
+      if (_cards != NULL) {
+        memcpy(new_cards, _cards, _num_cards * sizeof(u2));
+        FREE_C_HEAP_ARRAY(u2, _cards, mtGC);
+      }
+      _cards = new_cards;
+      _cards_capacity = new_capacity;
+    }
+    memmove(&_cards[pos + 1], &_cards[pos], (_num_cards - pos) * sizeof(u2));
+    _cards[pos] = (u2)from_card;
+    _num_cards++;
+    _occupied = (jint)_num_cards;
+  }
+
+  // Without "locked" only a bitmap may be updated. Returns false if the
+  // card has not been added because the table still uses its card array.
+  bool add_card_work(CardIdx_t from_card, bool par, bool locked) {
+    if (is_bitmap()) {
+      add_card_to_bitmap(from_card, par);
+      return true;
+    } else if (locked) {
+      add_card_to_array(from_card);
+      return true;
+    }
+    return false;
+  }
+
+  bool add_reference_work(OopOrNarrowOopStar from, bool par, bool locked) {
     // Must make this robust in case "from" is not in "_hr", because of
     // concurrency.
 
@@ -113,8 +219,9 @@ protected:
 
       assert(0 <= from_card && (size_t)from_card < HeapRegion::CardsPerRegion,
              "Must be in range.");
-      add_card_work(from_card, par);
+      return add_card_work(from_card, par, locked);
     }
+    return true;
   }
 
 public:
@@ -136,44 +243,84 @@ public:
     }
     _collision_list_next = NULL;
     _occupied = 0;
-    _bm.clear();
+    if (_bm.size() != 0) {
+      // The table already switched to a bitmap during an earlier use. Keep
+      // using it rather than starting over with a card array next to it:
+      // it cannot be freed, as threads that still add to it without the
+      // lock may not have noticed the reuse yet.
+      _bm.clear();
+      assert(_cards == NULL && _num_cards == 0, "the card array is released on switching");
+    } else {
+      // Start over with the (empty) card array.
+      _num_cards = 0;
+    }
     // Make sure that the bitmap clearing above has been finished before publishing
     // this PRT to concurrent threads.
     OrderAccess::release_store_ptr(&_hr, hr);
   }
 
-  void add_reference(OopOrNarrowOopStar from) {
-    add_reference_work(from, /*parallel*/ true);
+  // Adds "from" without taking the lock. Returns false, without adding
+  // it, if the table still keeps its cards in the card array, in which
+  // case the caller must use add_reference_locked() instead.
+  bool add_reference(OopOrNarrowOopStar from) {
+    return add_reference_work(from, /*parallel*/ true, /*locked*/ false);
+  }
+
+  void add_reference_locked(OopOrNarrowOopStar from) {
+    add_reference_work(from, /*parallel*/ true, /*locked*/ true);
   }
 
   void seq_add_reference(OopOrNarrowOopStar from) {
-    add_reference_work(from, /*parallel*/ false);
+    add_reference_work(from, /*parallel*/ false, /*locked*/ true);
   }
 
   void scrub(CardTableModRefBS* ctbs, BitMap* card_bm) {
     HeapWord* hr_bot = hr()->bottom();
     size_t hr_first_card_index = ctbs->index_for(hr_bot);
-    bm()->set_intersection_at_offset(*card_bm, hr_first_card_index);
-    recount_occupied();
+    if (is_bitmap()) {
+      bm()->set_intersection_at_offset(*card_bm, hr_first_card_index);
+      recount_occupied();
+    } else {
+      size_t num_live = 0;
+      for (size_t i = 0; i < _num_cards; i++) {
+        if (card_bm->at(hr_first_card_index + _cards[i])) {
+          _cards[num_live++] = _cards[i];
+        }
+      }
+      _num_cards = num_live;
+      _occupied = (jint)num_live;
+    }
   }
 
-  void add_card(CardIdx_t from_card_index) {
-    add_card_work(from_card_index, /*parallel*/ true);
+  void add_card_locked(CardIdx_t from_card_index) {
+    add_card_work(from_card_index, /*parallel*/ true, /*locked*/ true);
   }
 
   void seq_add_card(CardIdx_t from_card_index) {
-    add_card_work(from_card_index, /*parallel*/ false);
+    add_card_work(from_card_index, /*parallel*/ false, /*locked*/ true);
   }
 
   // (Destructively) union the bitmap of the current table into the given
   // bitmap (which is assumed to be of the same size.)
   void union_bitmap_into(BitMap* bm) {
-    bm->set_union(_bm);
+    if (is_bitmap()) {
+      bm->set_union(_bm);
+    } else {
+      for (size_t i = 0; i < _num_cards; i++) {
+        bm->set_bit(_cards[i]);
+      }
+    }
+  }
+
+  // Mem size in bytes of a table that uses a bitmap.
+  static size_t bitmap_mem_size() {
+    return sizeof(PerRegionTable) + BitMap::word_align_up(HeapRegion::CardsPerRegion) / BitsPerByte;
   }
 
   // Mem size in bytes.
   size_t mem_size() const {
-    return sizeof(PerRegionTable) + _bm.size_in_words() * HeapWordSize;
+    return sizeof(PerRegionTable) + _bm.size_in_words() * HeapWordSize +
+           _cards_capacity * sizeof(u2);
   }
 
   // Requires "from" to be in "hr()".
@@ -181,7 +328,11 @@ public:
     assert(hr()->is_in_reserved(from), "Precondition.");
     size_t card_ind = pointer_delta(from, hr()->bottom(),
                                     CardTableModRefBS::card_size);
-    return _bm.at(card_ind);
+    if (is_bitmap()) {
+      return _bm.at(card_ind);
+    }
+    size_t pos;
+    return find_card_in_array((CardIdx_t)card_ind, pos);
   }
 
   // Bulk-free the PRTs from prt to last, assumes that they are
@@ -532,7 +683,7 @@ void OtherRegionsTable::add_reference(OopOrNarrowOopStar from, int tid) {
         for (int i = 0; i < SparsePRTEntry::cards_num(); i++) {
           CardIdx_t c = sprt_entry->card(i);
           if (c != SparsePRTEntry::NullEntry) {
-            prt->add_card(c);
+            prt->add_card_locked(c);
           }
         }
         // Now we can delete the sparse entry.
@@ -547,7 +698,11 @@ void OtherRegionsTable::add_reference(OopOrNarrowOopStar from, int tid) {
   // OtherRegionsTable for why this is OK.
   assert(prt != NULL, "Inv");
 
-  prt->add_reference(from);
+  if (!prt->add_reference(from)) {
+    // The PRT still keeps its cards in the card array.
+    MutexLockerEx x(_m, Mutex::_no_safepoint_check_flag);
+    prt->add_reference_locked(from);
+  }
 
   if (G1RecordHRRSOops) {
     HeapRegionRemSet::record(hr(), from);
@@ -753,20 +908,30 @@ size_t OtherRegionsTable::occ_sparse() const {
 }
 
 size_t OtherRegionsTable::mem_size() const {
-  size_t sum = 0;
-  // all PRTs are of the same size so it is sufficient to query only one of them.
-  if (_first_all_fine_prts != NULL) {
-    assert(_last_all_fine_prts != NULL &&
-      _first_all_fine_prts->mem_size() == _last_all_fine_prts->mem_size(), "check that mem_size() is constant");
-    sum += _first_all_fine_prts->mem_size() * _n_fine_entries;
-  }
+  HRRSContainerSizes sizes;
+  add_container_sizes(&sizes);
+  size_t sum = sizes.total_mem_size();
   sum += (sizeof(PerRegionTable*) * _max_fine_entries);
-  sum += (_coarse_map.size_in_words() * HeapWordSize);
-  sum += (_sparse_table.mem_size());
   sum += sizeof(OtherRegionsTable) - sizeof(_sparse_table); // Avoid double counting above.
   return sum;
 }
 
+void OtherRegionsTable::add_container_sizes(HRRSContainerSizes* sizes) const {
+  // PRTs differ in size depending on whether they use a card array or a
+  // bitmap, so we need to look at all of them.
+  PerRegionTable* cur = _first_all_fine_prts;
+  while (cur != NULL) {
+    if (cur->is_bitmap()) {
+      sizes->add_bitmap(cur->mem_size());
+    } else {
+      sizes->add_card_array(cur->mem_size(), PerRegionTable::bitmap_mem_size());
+    }
+    cur = cur->next();
+  }
+  sizes->add_coarse(_coarse_map.size_in_words() * HeapWordSize);
+  sizes->add_sparse(_sparse_table.mem_size());
+}
+
 size_t OtherRegionsTable::static_mem_size() {
   return FromCardCache::static_mem_size();
 }
@@ -858,14 +1023,30 @@ OtherRegionsTable::do_cleanup_work(HRRSCleanupTask* hrrs_cleanup_task) {
 // This can be done by either mutator threads together with the
 // concurrent refinement threads or GC threads.
 uint HeapRegionRemSet::num_par_rem_sets() {
-  return MAX2(DirtyCardQueueSet::num_par_ids() + ConcurrentG1Refine::thread_num(), (uint)ParallelGCThreads);
+  uint n = DirtyCardQueueSet::num_par_ids() + ConcurrentG1Refine::thread_num();
+  if (G1RebuildRemSetsOnDemand) {
+    // The concurrent marking workers rebuild remembered sets concurrently
+    // with the mutator and refinement threads, so they need ids of their own.
+    // There are never more of them than ParallelGCThreads, and there is
+    // a single one if marking is not done in parallel.
+    n += MAX2((uint)ParallelGCThreads, 1U);
+  }
+  return MAX2(n, (uint)ParallelGCThreads);
+}
+
+uint HeapRegionRemSet::rebuild_par_id(uint worker_id) {
+  assert(G1RebuildRemSetsOnDemand, "only used when rebuilding remembered sets");
+  uint par_id = DirtyCardQueueSet::num_par_ids() + ConcurrentG1Refine::thread_num() + worker_id;
+  assert(par_id < num_par_rem_sets(), "out of range");
+  return par_id;
 }
 
 HeapRegionRemSet::HeapRegionRemSet(G1BlockOffsetSharedArray* bosa,
                                    HeapRegion* hr)
   : _bosa(bosa),
     _m(Mutex::leaf, FormatBuffer<128>("HeapRegionRemSet lock #%u", hr->hrm_index()), true),
-    _code_roots(), _other_regions(hr, &_m), _iter_state(Unclaimed), _iter_claimed(0) {
+    _code_roots(), _other_regions(hr, &_m), _iter_state(Unclaimed), _iter_claimed(0),
+    _state(G1RebuildRemSetsOnDemand ? Untracked : CompleteRemSet) {
   reset_for_par_iteration();
 }
 
@@ -881,6 +1062,16 @@ void HeapRegionRemSet::setup_remset_size() {
     G1RSetRegionEntries = G1RSetRegionEntriesBase * (region_size_log_mb + 1);
   }
   guarantee(G1RSetSparseRegionEntries > 0 && G1RSetRegionEntries > 0 , "Sanity");
+
+  // By default a fine-grain table switches from its card array to a bitmap
+  // when the array would grow larger than the bitmap.
+  guarantee(HeapRegion::CardsPerRegion <= (size_t)max_jushort + 1,
+            "Card indices must fit into the card array");
+  if (FLAG_IS_DEFAULT(G1RSetCardArrayEntries)) {
+    G1RSetCardArrayEntries = (intx)(HeapRegion::CardsPerRegion / (BitsPerByte * sizeof(u2)));
+  }
+  G1RSetCardArrayEntries = MIN2(G1RSetCardArrayEntries, (intx)HeapRegion::CardsPerRegion);
+  guarantee(G1RSetCardArrayEntries >= 0, "Sanity");
 }
 
 class VerifyNoZombies : public CodeBlobClosure {
@@ -939,13 +1130,15 @@ void HeapRegionRemSet::cleanup() {
   SparsePRT::cleanup_all();
 }
 
-void HeapRegionRemSet::clear() {
+void HeapRegionRemSet::clear(bool only_cardset) {
   MutexLockerEx x(&_m, Mutex::_no_safepoint_check_flag);
-  clear_locked();
+  clear_locked(only_cardset);
 }
 
-void HeapRegionRemSet::clear_locked() {
-  _code_roots.clear();
+void HeapRegionRemSet::clear_locked(bool only_cardset) {
+  if (!only_cardset) {
+    _code_roots.clear();
+  }
   _other_regions.clear();
   assert(occupied_locked() == 0, "Should be clear.");
   reset_for_par_iteration();
@@ -1028,6 +1221,7 @@ HeapRegionRemSetIterator:: HeapRegionRemSetIterator(HeapRegionRemSet* hrrs) :
   _coarse_cur_region_index(-1),
   _coarse_cur_region_cur_card(HeapRegion::CardsPerRegion-1),
   _cur_card_in_prt(HeapRegion::CardsPerRegion),
+  _cur_pos_in_prt(0),
   _fine_cur_prt(NULL),
   _n_yielded_coarse(0),
   _n_yielded_fine(0),
@@ -1061,8 +1255,7 @@ bool HeapRegionRemSetIterator::coarse_has_next(size_t& card_index) {
 
 bool HeapRegionRemSetIterator::fine_has_next(size_t& card_index) {
   if (fine_has_next()) {
-    _cur_card_in_prt =
-      _fine_cur_prt->_bm.get_next_one_offset(_cur_card_in_prt + 1);
+    _cur_card_in_prt = next_card_in_prt();
   }
   if (_cur_card_in_prt == HeapRegion::CardsPerRegion) {
     // _fine_cur_prt may still be NULL in case if there are not PRTs at all for
@@ -1072,7 +1265,7 @@ bool HeapRegionRemSetIterator::fine_has_next(size_t& card_index) {
     }
     PerRegionTable* next_prt = _fine_cur_prt->next();
     switch_to_prt(next_prt);
-    _cur_card_in_prt = _fine_cur_prt->_bm.get_next_one_offset(_cur_card_in_prt + 1);
+    _cur_card_in_prt = next_card_in_prt();
   }
 
   card_index = _cur_region_card_offset + _cur_card_in_prt;
@@ -1096,6 +1289,19 @@ void HeapRegionRemSetIterator::switch_to_prt(PerRegionTable* prt) {
   // To avoid special-casing this start case, and not miss the first bitmap
   // entry, initialize _cur_region_cur_card with -1 instead of 0.
   _cur_card_in_prt = (size_t)-1;
+  _cur_pos_in_prt = 0;
+}
+
+size_t HeapRegionRemSetIterator::next_card_in_prt() {
+  if (_fine_cur_prt->is_bitmap()) {
+    return _fine_cur_prt->_bm.get_next_one_offset(_cur_card_in_prt + 1);
+  }
+  // The card array is sorted, so both representations yield the cards in
+  // the same order.
+  if (_cur_pos_in_prt < _fine_cur_prt->_num_cards) {
+    return _fine_cur_prt->_cards[_cur_pos_in_prt++];
+  }
+  return HeapRegion::CardsPerRegion;
 }
 
 bool HeapRegionRemSetIterator::has_next(size_t& card_index) {
@@ -93,6 +93,46 @@ class FromCardCache : public AllStatic {
   }
 };
 
+// Memory used by the different container types of one or more remembered
+// sets, as reported by G1SummarizeRSetStats.
+class HRRSContainerSizes VALUE_OBJ_CLASS_SPEC {
+ private:
+  size_t _sparse_mem_size;
+  size_t _card_array_mem_size;
+  size_t _num_card_arrays;
+  // What the PRTs using card arrays would take if they used bitmaps.
+  size_t _card_array_as_bitmap_mem_size;
+  size_t _bitmap_mem_size;
+  size_t _num_bitmaps;
+  size_t _coarse_mem_size;
+
+ public:
+  HRRSContainerSizes() : _sparse_mem_size(0), _card_array_mem_size(0),
+    _num_card_arrays(0), _card_array_as_bitmap_mem_size(0),
+    _bitmap_mem_size(0), _num_bitmaps(0), _coarse_mem_size(0) { }
+
+  void add_sparse(size_t mem_size)     { _sparse_mem_size += mem_size; }
+  void add_card_array(size_t mem_size, size_t as_bitmap_mem_size) {
+    _card_array_mem_size += mem_size;
+    _card_array_as_bitmap_mem_size += as_bitmap_mem_size;
+    _num_card_arrays++;
+  }
+  void add_bitmap(size_t mem_size)     { _bitmap_mem_size += mem_size; _num_bitmaps++; }
+  void add_coarse(size_t mem_size)     { _coarse_mem_size += mem_size; }
+
+  size_t sparse_mem_size() const     { return _sparse_mem_size; }
+  size_t card_array_mem_size() const { return _card_array_mem_size; }
+  size_t num_card_arrays() const     { return _num_card_arrays; }
+  size_t card_array_as_bitmap_mem_size() const { return _card_array_as_bitmap_mem_size; }
+  size_t bitmap_mem_size() const     { return _bitmap_mem_size; }
+  size_t num_bitmaps() const         { return _num_bitmaps; }
+  size_t coarse_mem_size() const     { return _coarse_mem_size; }
+
+  size_t total_mem_size() const {
+    return _sparse_mem_size + _card_array_mem_size + _bitmap_mem_size + _coarse_mem_size;
+  }
+};
+
 // The "_coarse_map" is a bitmap with one bit for each region, where set
 // bits indicate that the corresponding region may contain some pointer
 // into the owning region.
@@ -103,6 +143,13 @@ class FromCardCache : public AllStatic {
 // deleting an entry and setting the corresponding coarse-grained bit when
 // we would overflow this cap.
 
+// A PRT starts out keeping its cards in a sorted array, and only switches
+// to a bitmap over all cards of the source region once the array would
+// take more space than that bitmap (see G1RSetCardArrayEntries).  Most
+// region pairs are connected by a few cards only, for which the array
+// is both smaller and faster to scan than the bitmap.  The card array is
+// only modified with "_m" held; bitmaps may be updated without it.
+
 // We use a mixture of locking and lock-free techniques here.  We allow
 // threads to locate PRTs without locking, but threads attempting to alter
 // a bucket list obtain a lock.  This means that any failing attempt to
@@ -202,6 +249,9 @@ public:
   // Returns size in bytes.
   // Not const because it takes a lock.
   size_t mem_size() const;
+  // Adds the memory used by the sparse table, the PRTs and the coarse map
+  // to "sizes".  Requires the caller to hold _m.
+  void add_container_sizes(HRRSContainerSizes* sizes) const;
   static size_t static_mem_size();
   static size_t fl_mem_size();
 
@@ -251,6 +301,18 @@ private:
   volatile ParIterState _iter_state;
   volatile jlong _iter_claimed;
 
+  // Whether references into the owning region are recorded. With
+  // G1RebuildRemSetsOnDemand only the remembered sets of young and
+  // humongous regions and of old regions that are candidates for
+  // collection are tracked, see G1RemSetTrackingPolicy. Otherwise all
+  // remembered sets are always complete.
+  enum RemSetState {
+    Untracked,      // References into the region are not recorded.
+    Updating,       // References are recorded while the set is being rebuilt.
+    CompleteRemSet  // All references into the region are recorded.
+  };
+  volatile RemSetState _state;
+
   // Unused unless G1RecordHRRSOops is true.
 
   static const int MaxRecorded = 1000000;
@@ -270,8 +332,27 @@ public:
   HeapRegionRemSet(G1BlockOffsetSharedArray* bosa, HeapRegion* hr);
 
   static uint num_par_rem_sets();
+  // The parallel id that concurrent marking worker "worker_id" uses when
+  // it adds references while rebuilding remembered sets.
+  static uint rebuild_par_id(uint worker_id);
   static void setup_remset_size();
 
+  bool is_tracked() const  { return _state != Untracked; }
+  bool is_updating() const { return _state == Updating; }
+  bool is_complete() const { return _state == CompleteRemSet; }
+
+  void set_state_untracked() { _state = Untracked; }
+  void set_state_updating()  { _state = Updating; }
+  void set_state_complete()  { _state = CompleteRemSet; }
+
+  const char* get_state_str() const {
+    switch (_state) {
+      case Untracked: return "Untracked";
+      case Updating:  return "Updating";
+      default:        return "Complete";
+    }
+  }
+
   void verify();
 
   HeapRegion* hr() const {
@@ -320,9 +401,11 @@ public:
   void scrub(CardTableModRefBS* ctbs, BitMap* region_bm, BitMap* card_bm);
 
   // The region is being reclaimed; clear its remset, and any mention of
-  // entries for this region in other remsets.
-  void clear();
-  void clear_locked();
+  // entries for this region in other remsets. If only_cardset is true the
+  // strong code roots are kept, e.g. when the remembered set of a live
+  // region stops being tracked; they are not re-registered by a rebuild.
+  void clear(bool only_cardset = false);
+  void clear_locked(bool only_cardset = false);
 
   // Attempt to claim the region.  Returns true iff this call caused an
   // atomic transition from Unclaimed to Claimed.
@@ -360,6 +443,13 @@ public:
       + strong_code_roots_mem_size();
   }
 
+  // Adds the memory used by the containers of this remembered set, by
+  // container type, to "sizes".
+  void add_container_sizes(HRRSContainerSizes* sizes) {
+    MutexLockerEx x(&_m, Mutex::_no_safepoint_check_flag);
+    _other_regions.add_container_sizes(sizes);
+  }
+
   // Returns the memory occupancy of all static data structures associated
   // with remembered sets.
   static size_t static_mem_size() {
@@ -481,9 +571,14 @@ class HeapRegionRemSetIterator : public StackObj {
   PerRegionTable* _fine_cur_prt;
   // Card offset within the current PRT.
   size_t _cur_card_in_prt;
+  // Position in the card array of the current PRT, if it uses one.
+  size_t _cur_pos_in_prt;
 
   // Update internal variables when switching to the given PRT.
   void switch_to_prt(PerRegionTable* prt);
+  // Returns the card following _cur_card_in_prt in the current PRT, or
+  // HeapRegion::CardsPerRegion if there is none.
+  size_t next_card_in_prt();
   bool fine_has_next();
   bool fine_has_next(size_t& card_index);
 
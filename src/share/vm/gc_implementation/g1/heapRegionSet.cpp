@@ -197,6 +197,29 @@ void FreeRegionList::add_ordered(FreeRegionList* from_list) {
   from_list->verify_optional();
 }
 
+HeapRegion* FreeRegionList::remove_region_with_node_index(bool from_head,
+                                                          uint requested_node_index) {
+  G1NUMA* numa = G1CollectedHeap::heap()->numa();
+  assert(requested_node_index < numa->num_active_nodes(),
+         err_msg("invalid node index %u", requested_node_index));
+  if (!numa->is_enabled()) {
+    // Every region is on the one node.
+    return remove_region(from_head);
+  }
+
+  // Regions are striped across the nodes, so unless the free regions of
+  // the requested node have run out this only looks at a few regions.
+  HeapRegion* cur = from_head ? _head : _tail;
+  while (cur != NULL) {
+    if (numa->preferred_node_index_for_index(cur->hrm_index()) == requested_node_index) {
+      remove_starting_at(cur, 1);
+      return cur;
+    }
+    cur = from_head ? cur->next() : cur->prev();
+  }
+  return NULL;
+}
+
 void FreeRegionList::remove_starting_at(HeapRegion* first, uint num_regions) {
   check_mt_safety();
   assert(num_regions >= 1, hrs_ext_msg(this, "pre-condition"));
@@ -226,9 +226,7 @@ void CardTableExtension::scavenge_contents_parallel(ObjectStartArray* start_arra
     jbyte* current_card = worker_start_card;
     while (current_card < worker_end_card) {
       // Find an unclean card.
-      while (current_card < worker_end_card && card_is_clean(*current_card)) {
-        current_card++;
-      }
+      current_card = find_first_non_clean_card(current_card, worker_end_card);
       jbyte* first_unclean_card = current_card;
 
       // Find the end of a run of contiguous unclean cards
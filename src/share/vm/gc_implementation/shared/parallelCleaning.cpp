@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "classfile/metadataOnStackMark.hpp"
+#include "code/codeCache.hpp"
+#include "code/nmethod.hpp"
+#include "gc_implementation/shared/parallelCleaning.hpp"
+#include "runtime/atomic.inline.hpp"
+#include "runtime/mutex.hpp"
+#include "runtime/mutexLocker.hpp"
+
+Monitor* CodeCacheUnloadingTask::_lock = new Monitor(Mutex::leaf, "Code Cache Unload lock");
+
+CodeCacheUnloadingTask::CodeCacheUnloadingTask(uint num_workers, BoolObjectClosure* is_alive,
+                                               bool unloading_occurred, bool mark_metadata_on_stack) :
+    _is_alive(is_alive),
+    _unloading_occurred(unloading_occurred),
+    _mark_metadata_on_stack(mark_metadata_on_stack),
+    _num_workers(num_workers),
+    _first_nmethod(NULL),
+    _claimed_nmethod(NULL),
+    _postponed_list(NULL),
+    _postponed_array(NULL),
+    _postponed_claimed(0),
+    _num_entered_barrier(0)
+{
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  if (!UseG1GC) {
+    _postponed_array = new (ResourceObj::C_HEAP, mtGC) GrowableArray<nmethod*>(MaxClaimNmethods, true, mtGC);
+  }
+  nmethod::increase_unloading_clock();
+  _first_nmethod = CodeCache::alive_nmethod(CodeCache::first_nmethod());
+  _claimed_nmethod = (volatile nmethod*)_first_nmethod;
+}
+
+CodeCacheUnloadingTask::~CodeCacheUnloadingTask() {
+  CodeCache::verify_clean_inline_caches();
+
+  CodeCache::set_needs_cache_clean(false);
+  guarantee(!UseG1GC || CodeCache::scavenge_root_nmethods() == NULL, "Must be");
+
+  CodeCache::verify_icholder_relocations();
+
+  if (_postponed_array != NULL) {
+    delete _postponed_array;
+  }
+}
+
+void CodeCacheUnloadingTask::add_to_postponed_list(nmethod** nms, int num_nms) {
+  if (num_nms == 0) {
+    return;
+  }
+
+  if (_postponed_array != NULL) {
+    MutexLockerEx ml(_lock, Mutex::_no_safepoint_check_flag);
+    for (int i = 0; i < num_nms; i++) {
+      _postponed_array->append(nms[i]);
+    }
+    return;
+  }
+
+  for (int i = 0; i < num_nms; i++) {
+    nmethod* nm = nms[i];
+    nmethod* old;
+    do {
+      old = (nmethod*)_postponed_list;
+      nm->set_unloading_next(old);
+    } while ((nmethod*)Atomic::cmpxchg_ptr(nm, &_postponed_list, old) != old);
+  }
+}
+
+bool CodeCacheUnloadingTask::clean_nmethod(nmethod* nm) {
+  bool postponed = nm->do_unloading_parallel(_is_alive, _unloading_occurred, _mark_metadata_on_stack);
+
+  // Mark that this thread has been cleaned/unloaded.
+  // After this call, it will be safe to ask if this nmethod was unloaded or not.
+  nm->set_unloading_clock(nmethod::global_unloading_clock());
+
+  // If the nmethod referred to an nmethod that has not been cleaned/unloaded
+  // yet, the caller has to add it to the postponed list.
+  return postponed;
+}
+
+void CodeCacheUnloadingTask::claim_nmethods(nmethod** claimed_nmethods, int *num_claimed_nmethods) {
+  nmethod* first;
+  nmethod* last;
+
+  do {
+    *num_claimed_nmethods = 0;
+
+    first = last = (nmethod*)_claimed_nmethod;
+
+    if (first != NULL) {
+      for (int i = 0; i < MaxClaimNmethods; i++) {
+        last = CodeCache::alive_nmethod(CodeCache::next_nmethod(last));
+
+        if (last == NULL) {
+          break;
+        }
+
+        claimed_nmethods[i] = last;
+        (*num_claimed_nmethods)++;
+      }
+    }
+
+  } while ((nmethod*)Atomic::cmpxchg_ptr(last, &_claimed_nmethod, first) != first);
+}
+
+nmethod* CodeCacheUnloadingTask::claim_postponed_nmethod() {
+  if (_postponed_array != NULL) {
+    // The array is not modified anymore once all workers passed the barrier.
+    jint index = Atomic::add(1, &_postponed_claimed) - 1;
+    return index < _postponed_array->length() ? _postponed_array->at(index) : NULL;
+  }
+
+  nmethod* claim;
+  nmethod* next;
+
+  do {
+    claim = (nmethod*)_postponed_list;
+    if (claim == NULL) {
+      return NULL;
+    }
+
+    next = claim->unloading_next();
+
+  } while ((nmethod*)Atomic::cmpxchg_ptr(next, &_postponed_list, claim) != claim);
+
+  return claim;
+}
+
+void CodeCacheUnloadingTask::barrier_mark(uint worker_id) {
+  MonitorLockerEx ml(_lock, Mutex::_no_safepoint_check_flag);
+  _num_entered_barrier++;
+  if (_num_entered_barrier == _num_workers) {
+    ml.notify_all();
+  }
+}
+
+void CodeCacheUnloadingTask::barrier_wait(uint worker_id) {
+  if (_num_entered_barrier < _num_workers) {
+    MonitorLockerEx ml(_lock, Mutex::_no_safepoint_check_flag);
+    while (_num_entered_barrier < _num_workers) {
+        ml.wait(Mutex::_no_safepoint_check_flag, 0, false);
+    }
+  }
+}
+
+size_t CodeCacheUnloadingTask::work_first_pass(uint worker_id) {
+  size_t num_cleaned = 0;
+  int num_postponed = 0;
+  nmethod* postponed_nmethods[MaxClaimNmethods];
+
+  // The first nmethods is claimed by the first worker.
+  if (worker_id == 0 && _first_nmethod != NULL) {
+    if (clean_nmethod(_first_nmethod)) {
+      postponed_nmethods[num_postponed++] = _first_nmethod;
+      add_to_postponed_list(postponed_nmethods, num_postponed);
+    }
+    _first_nmethod = NULL;
+    num_cleaned++;
+  }
+
+  int num_claimed_nmethods;
+  nmethod* claimed_nmethods[MaxClaimNmethods];
+
+  while (true) {
+    claim_nmethods(claimed_nmethods, &num_claimed_nmethods);
+
+    if (num_claimed_nmethods == 0) {
+      break;
+    }
+
+    num_postponed = 0;
+    for (int i = 0; i < num_claimed_nmethods; i++) {
+      if (clean_nmethod(claimed_nmethods[i])) {
+        postponed_nmethods[num_postponed++] = claimed_nmethods[i];
+      }
+    }
+    add_to_postponed_list(postponed_nmethods, num_postponed);
+    num_cleaned += num_claimed_nmethods;
+  }
+
+  if (_mark_metadata_on_stack) {
+    // The nmethod cleaning helps out and does the CodeCache part of MetadataOnStackMark.
+    // Need to retire the buffers now that this thread has stopped cleaning nmethods.
+    MetadataOnStackMark::retire_buffer_for_thread(Thread::current());
+  }
+
+  return num_cleaned;
+}
+
+size_t CodeCacheUnloadingTask::work_second_pass(uint worker_id) {
+  size_t num_cleaned = 0;
+  nmethod* nm;
+  // Take care of postponed nmethods.
+  while ((nm = claim_postponed_nmethod()) != NULL) {
+    nm->do_unloading_parallel_postponed(_is_alive, _unloading_occurred);
+    num_cleaned++;
+  }
+  return num_cleaned;
+}
+
+ParallelCodeCacheUnloadingTask::ParallelCodeCacheUnloadingTask(uint num_workers,
+                                                               BoolObjectClosure* is_alive,
+                                                               bool unloading_occurred) :
+    AbstractGangTask("Parallel Code Cache Unloading"),
+    _code_cache_task(num_workers, is_alive, unloading_occurred, false /* mark_metadata_on_stack */) {
+}
+
+void ParallelCodeCacheUnloadingTask::work(uint worker_id) {
+  _code_cache_task.work_first_pass(worker_id);
+  _code_cache_task.barrier_mark(worker_id);
+  _code_cache_task.barrier_wait(worker_id);
+  _code_cache_task.work_second_pass(worker_id);
+}
+
+void ParallelCodeCacheUnloadingTask::unload(FlexibleWorkGang* workers,
+                                            BoolObjectClosure* is_alive,
+                                            bool unloading_occurred) {
+  uint n_workers = (workers != NULL) ? workers->active_workers() : 1;
+  if (!ParallelCodeCacheUnloading || n_workers <= 1) {
+    CodeCache::do_unloading(is_alive, unloading_occurred);
+    return;
+  }
+
+  ParallelCodeCacheUnloadingTask task(n_workers, is_alive, unloading_occurred);
+  workers->run_task(&task);
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_VM_GC_IMPLEMENTATION_SHARED_PARALLELCLEANING_HPP
+#define SHARE_VM_GC_IMPLEMENTATION_SHARED_PARALLELCLEANING_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/growableArray.hpp"
+#include "utilities/workgroup.hpp"
+
+class BoolObjectClosure;
+class Monitor;
+class nmethod;
+
+// Cleans and unloads the nmethods in the code cache with several worker
+// threads. The workers claim the nmethods in small chunks. An nmethod with an
+// inline cache that refers to an nmethod that has not been processed yet is
+// postponed to a second pass, which may only start after all workers have
+// finished the first one.
+class CodeCacheUnloadingTask VALUE_OBJ_CLASS_SPEC {
+ private:
+  static Monitor* _lock;
+
+  BoolObjectClosure* const _is_alive;
+  const bool               _unloading_occurred;
+  const bool               _mark_metadata_on_stack;
+  const uint               _num_workers;
+
+  // Variables used to claim nmethods.
+  nmethod* _first_nmethod;
+  volatile nmethod* _claimed_nmethod;
+
+  // The nmethods that need to be processed by the second pass. G1 chains
+  // them through nmethod::unloading_next(). The other collectors use that
+  // field for the scavenge root list, so they collect them in an array.
+  volatile nmethod*        _postponed_list;
+  GrowableArray<nmethod*>* _postponed_array;
+  volatile jint            _postponed_claimed;
+  volatile uint            _num_entered_barrier;
+
+  static const int MaxClaimNmethods = 16;
+
+  void add_to_postponed_list(nmethod** nms, int num_nms);
+  bool clean_nmethod(nmethod* nm);
+  void claim_nmethods(nmethod** claimed_nmethods, int *num_claimed_nmethods);
+  nmethod* claim_postponed_nmethod();
+
+ public:
+  // If mark_metadata_on_stack is set, the first pass also does the code
+  // cache part of a MetadataOnStackMark that is active during the task.
+  CodeCacheUnloadingTask(uint num_workers, BoolObjectClosure* is_alive,
+                         bool unloading_occurred, bool mark_metadata_on_stack);
+  ~CodeCacheUnloadingTask();
+
+  // Mark that we're done with the first pass of nmethod cleaning.
+  void barrier_mark(uint worker_id);
+
+  // See if we have to wait for the other workers to
+  // finish their first-pass nmethod cleaning work.
+  void barrier_wait(uint worker_id);
+
+  // Cleaning and unloading of nmethods. Some work has to be postponed
+  // to the second pass, when we know which nmethods survive. Both
+  // return the number of nmethods processed by this worker.
+  size_t work_first_pass(uint worker_id);
+  size_t work_second_pass(uint worker_id);
+};
+
+// Unloads nmethods on a work gang for the collectors that would otherwise
+// call CodeCache::do_unloading() from the VM thread.
+class ParallelCodeCacheUnloadingTask : public AbstractGangTask {
+ private:
+  CodeCacheUnloadingTask _code_cache_task;
+
+ public:
+  ParallelCodeCacheUnloadingTask(uint num_workers, BoolObjectClosure* is_alive, bool unloading_occurred);
+
+  void work(uint worker_id);
+
+  // Unloads nmethods with the active workers of the gang. Falls back to
+  // CodeCache::do_unloading() if there is only a single worker.
+  static void unload(FlexibleWorkGang* workers, BoolObjectClosure* is_alive, bool unloading_occurred);
+};
+
+#endif // SHARE_VM_GC_IMPLEMENTATION_SHARED_PARALLELCLEANING_HPP
@@ -57,6 +57,10 @@
 #include "services/threadService.hpp"
 #include "utilities/exceptions.hpp"
 #include "utilities/globalDefinitions.hpp"
+#if INCLUDE_JVMCI
+#include "jvmci/jvmciEntryProfiler.hpp"
+#include "runtime/atomic.inline.hpp"
+#endif
 
 /**
  *  JfrPeriodic class
@@ -515,26 +519,44 @@ TRACE_REQUEST_FUNC(CompilerConfiguration) {
   event.commit();
 }
 
+TRACE_REQUEST_FUNC(JVMCIVMEntryStatistics) {
+#if INCLUDE_JVMCI
+  for (JVMCIEntryProfile* p = JVMCIEntryProfiler::profiles(); p != NULL; p = p->_next) {
+    EventJVMCIVMEntryStatistics event;
+    event.set_entryPoint(p->_name);
+    event.set_callCount(Atomic::load(&p->_count));
+    event.set_totalTime(JVMCIEntryProfiler::ticks_to_nanos(Atomic::load(&p->_ticks)));
+    event.set_maxTime(JVMCIEntryProfiler::ticks_to_nanos(Atomic::load(&p->_max_ticks)));
+    event.commit();
+  }
+#endif
+}
+
 TRACE_REQUEST_FUNC(CodeCacheStatistics) {
-  EventCodeCacheStatistics event;
-  event.set_codeBlobType((u1)0/*bt*/); // XXX
-  event.set_startAddress((u8)CodeCache::low_bound());
-  event.set_reservedTopAddress((u8)CodeCache::high_bound());
-  event.set_entryCount(CodeCache::nof_blobs());
-  event.set_methodCount(CodeCache::nof_nmethods());
-  event.set_adaptorCount(CodeCache::nof_adapters());
-  event.set_unallocatedCapacity(CodeCache::unallocated_capacity());
-  event.set_fullCount(CodeCache::get_codemem_full_count());
-  event.commit();
+  // Emit one event per code heap
+  GrowableArray<CodeHeap*>* heaps = CodeCache::heaps();
+  for (int i = 0; i < heaps->length(); i++) {
+    CodeHeap* heap = heaps->at(i);
+    EventCodeCacheStatistics event;
+    event.set_codeBlobType((u1)heap->code_blob_type());
+    event.set_startAddress((u8)heap->low_boundary());
+    event.set_reservedTopAddress((u8)heap->high_boundary());
+    event.set_entryCount(heap->blob_count());
+    event.set_methodCount(heap->nmethod_count());
+    event.set_adaptorCount(heap->adapter_count());
+    event.set_unallocatedCapacity(heap->unallocated_capacity());
+    event.set_fullCount(heap->full_count());
+    event.commit();
+  }
 }
 
 TRACE_REQUEST_FUNC(CodeCacheConfiguration) {
   EventCodeCacheConfiguration event;
   event.set_initialSize(InitialCodeCacheSize);
   event.set_reservedSize(ReservedCodeCacheSize);
-  event.set_nonNMethodSize(0/*NonNMethodCodeHeapSize*/); // XXX
-  event.set_profiledSize(0/*ProfiledCodeHeapSize*/); // XXX
-  event.set_nonProfiledSize(0/*NonProfiledCodeHeapSize*/); // XXX
+  event.set_nonNMethodSize(NonNMethodCodeHeapSize);
+  event.set_profiledSize(ProfiledCodeHeapSize);
+  event.set_nonProfiledSize(NonProfiledCodeHeapSize);
   event.set_expansionSize(CodeCacheExpansionSize);
   event.set_minBlockLength(CodeCacheMinBlockLength);
   event.set_startAddress((u8)CodeCache::low_bound());
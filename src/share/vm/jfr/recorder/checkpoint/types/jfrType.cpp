@@ -280,6 +280,14 @@ void CompilerPhaseTypeConstant::serialize(JfrCheckpointWriter& writer) {
 void CodeBlobTypeConstant::serialize(JfrCheckpointWriter& writer) {
   static const u4 nof_entries = CodeBlobType::NumTypes;
   writer.write_count(nof_entries);
+  writer.write_key((u4)CodeBlobType::MethodNonProfiled);
+  writer.write("CodeHeap 'non-profiled nmethods'");
+  writer.write_key((u4)CodeBlobType::MethodProfiled);
+  writer.write("CodeHeap 'profiled nmethods'");
+  writer.write_key((u4)CodeBlobType::NonNMethod);
+  writer.write("CodeHeap 'non-nmethods'");
+  writer.write_key((u4)CodeBlobType::MethodHot);
+  writer.write("CodeHeap 'hot nmethods'");
   writer.write_key((u4)CodeBlobType::All);
   writer.write("CodeCache");
 };
@@ -27,8 +27,11 @@
 #include "runtime/arguments.hpp"
 #include "jvmci/jvmci.hpp"
 #include "jvmci/jvmci_globals.hpp"
+#include "jvmci/jvmciCompilationCache.hpp"
+#include "jvmci/jvmciCounters.hpp"
 #include "jvmci/jvmciEnv.hpp"
 #include "jvmci/jvmciJavaClasses.hpp"
+#include "jvmci/jvmciMirrorCache.hpp"
 #include "jvmci/jvmciRuntime.hpp"
 #include "jvmci/metadataHandles.hpp"
 #ifdef INCLUDE_ALL_GCS
@@ -110,6 +113,10 @@ void JVMCI::initialize_globals() {
     // There is only a single runtime
     _java_runtime = _compiler_runtime = new JVMCIRuntime(0);
   }
+  if (JVMCICompilationCacheFile != NULL) {
+    JVMCICompilationCache::load();
+  }
+  JVMCICounters::initialize();
 }
 
 void JVMCI::ensure_box_caches_initialized(TRAPS) {
@@ -145,6 +152,7 @@ JavaThread* JVMCI::compilation_tick(JavaThread* thread) {
       JVMCICompileState *state = task->blocking_jvmci_compile_state();
       if (state != NULL) {
         state->inc_compilation_ticks();
+        state->record_resource_usage(thread);
       }
     }
   }
@@ -179,6 +187,12 @@ void JVMCI::metadata_do(void f(Metadata*)) {
 }
 
 void JVMCI::do_unloading(bool unloading_occurred) {
+  if (_java_runtime != NULL) {
+    _java_runtime->_mirror_cache->do_unloading();
+  }
+  if (_compiler_runtime != NULL && _compiler_runtime != _java_runtime) {
+    _compiler_runtime->_mirror_cache->do_unloading();
+  }
   if (unloading_occurred) {
     if (_java_runtime != NULL) {
       _java_runtime->_metadata_handles->do_unloading();
@@ -189,6 +203,17 @@ void JVMCI::do_unloading(bool unloading_occurred) {
   }
 }
 
+void JVMCI::purge_mirror_caches() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  if (_java_runtime != NULL && _java_runtime->_mirror_cache->needs_purging()) {
+    _java_runtime->_mirror_cache->do_unloading();
+  }
+  if (_compiler_runtime != NULL && _compiler_runtime != _java_runtime &&
+      _compiler_runtime->_mirror_cache->needs_purging()) {
+    _compiler_runtime->_mirror_cache->do_unloading();
+  }
+}
+
 bool JVMCI::is_compiler_initialized() {
   return _is_initialized;
 }
@@ -207,6 +232,9 @@ void JVMCI::shutdown() {
   if (compiler_runtime() != NULL) {
     compiler_runtime()->shutdown();
   }
+  if (JVMCICompilationCacheFile != NULL) {
+    JVMCICompilationCache::save();
+  }
 }
 
 bool JVMCI::in_shutdown() {
@@ -91,6 +91,10 @@ class JVMCI : public AllStatic {
 
   static void do_unloading(bool unloading_occurred);
 
+  // Purges the mirror caches that have grown enough since they were last
+  // purged. Called as a safepoint cleanup task.
+  static void purge_mirror_caches();
+
   static void metadata_do(void f(Metadata*));
 
   static void oops_do(OopClosure* f);
@@ -639,6 +639,8 @@ JVMCI::CodeInstallResult CodeInstaller::install(JVMCICompiler* compiler,
     JVMCICompileState* compile_state = (JVMCICompileState*) (address) jvmci_env()->get_HotSpotCompiledNmethod_compileState(compiled_code);
     if (compile_state != NULL) {
       jvmci_env()->set_compile_state(compile_state);
+      // Installation creates a local handle for each embedded oop
+      compile_state->record_resource_usage(JavaThread::current());
     }
 
     methodHandle method = jvmci_env()->asMethod(jvmci_env()->get_HotSpotCompiledNmethod_method(compiled_code));
@@ -720,9 +722,143 @@ void CodeInstaller::initialize_fields(JVMCIObject target, JVMCIObject compiled_c
 
   JVMCIObject arch = jvmci_env()->get_TargetDescription_arch(target);
   _word_kind_handle = jvmci_env()->get_Architecture_wordKind(arch);
+
+  initialize_site_stream(compiled_code, JVMCI_CHECK);
+}
+
+// Copies HotSpotCompiledCode.siteStream (if any) into the installer's arena
+// with one call so that the site headers can be decoded without further
+// accesses to the HotSpotCompiledCode object graph.
+void CodeInstaller::initialize_site_stream(JVMCIObject compiled_code, JVMCI_TRAPS) {
+  _site_stream = NULL;
+  _site_stream_length = 0;
+  JVMCIPrimitiveArray site_stream = jvmci_env()->get_HotSpotCompiledCode_siteStream(compiled_code);
+  if (site_stream.is_null()) {
+    return;
+  }
+  // A site entry is at most a kind byte and two UNSIGNED5 encoded ints. Padding
+  // the copy with zeros means decoding a truncated stream never reads past the
+  // end of the buffer before next_site detects the truncation.
+  const int padding = 16;
+  _site_stream_length = JVMCIENV->get_length(site_stream);
+  _site_stream = NEW_ARENA_ARRAY(&_arena, u_char, _site_stream_length + padding);
+  memset(_site_stream + _site_stream_length, 0, padding);
+  JVMCIENV->copy_bytes_to(site_stream, (jbyte*) _site_stream, 0, _site_stream_length);
+
+  CompressedReadStream stream(_site_stream);
+  int count = stream.read_int();
+  if (count != JVMCIENV->get_length(sites())) {
+    JVMCI_ERROR("site stream describes %d sites but there are %d", count, JVMCIENV->get_length(sites()));
+  }
+}
+
+CodeInstaller::SiteKind CodeInstaller::next_site(CompressedReadStream& stream, jint& pc_offset, jint& operand, JVMCI_TRAPS) {
+  int kind = stream.read_byte();
+  pc_offset = stream.read_int();
+  operand = 0;
+  switch (kind) {
+    case SITE_MARK:
+      operand = stream.read_signed_int();
+      break;
+    case SITE_IMPLICIT_EXCEPTION_DISPATCH:
+    case SITE_EXCEPTION_HANDLER:
+      operand = stream.read_int();
+      break;
+    case SITE_CALL:
+    case SITE_SAFEPOINT:
+    case SITE_IMPLICIT_EXCEPTION:
+    case SITE_INFOPOINT:
+    case SITE_DATA_PATCH:
+      break;
+    default:
+      JVMCI_ERROR_((SiteKind) 0, "invalid site kind %d at site stream position %d", kind, stream.position());
+  }
+  if (stream.position() > _site_stream_length) {
+    JVMCI_ERROR_((SiteKind) 0, "truncated site stream");
+  }
+  return (SiteKind) kind;
+}
+
+int CodeInstaller::estimate_stubs_size_from_stream(JVMCI_TRAPS) {
+  int static_call_stubs = 0;
+  CompressedReadStream stream(_site_stream);
+  int count = stream.read_int();
+  for (int i = 0; i < count; i++) {
+    jint pc_offset;
+    jint id;
+    SiteKind kind = next_site(stream, pc_offset, id, JVMCI_CHECK_0);
+    if (kind == SITE_MARK && (id == INVOKESTATIC || id == INVOKESPECIAL)) {
+      static_call_stubs++;
+    }
+  }
+  return static_call_stubs * CompiledStaticCall::to_interp_stub_size();
+}
+
+// Equivalent of the site loop in initialize_buffer that takes the kind, pc
+// offset and primitive operands of each site from the site stream. Only sites
+// that carry object data (calls, infopoints and data patches) are read from
+// the sites array.
+void CodeInstaller::process_site_stream(CodeBuffer& buffer, JVMCI_TRAPS) {
+  JVMCIObjectArray sites = this->sites();
+  CompressedReadStream stream(_site_stream);
+  int count = stream.read_int();
+  for (int i = 0; i < count; i++) {
+    jint pc_offset;
+    jint operand;
+    SiteKind kind = next_site(stream, pc_offset, operand, JVMCI_CHECK);
+    switch (kind) {
+      case SITE_CALL:
+        JVMCI_event_4("call at %i", pc_offset);
+        site_Call(buffer, pc_offset, JVMCIENV->get_object_at(sites, i), JVMCI_CHECK);
+        break;
+      case SITE_SAFEPOINT:
+      case SITE_IMPLICIT_EXCEPTION:
+      case SITE_IMPLICIT_EXCEPTION_DISPATCH:
+        JVMCI_event_4("safepoint at %i", pc_offset);
+        site_Safepoint(buffer, pc_offset, JVMCIENV->get_object_at(sites, i), JVMCI_CHECK);
+        if (_orig_pc_offset < 0) {
+          JVMCI_ERROR("method contains safepoint, but has no deopt rescue slot");
+        }
+        if (kind == SITE_IMPLICIT_EXCEPTION_DISPATCH) {
+          JVMCI_event_4("implicit exception at %i, dispatch to %i", pc_offset, operand);
+          _implicit_exception_table.append(pc_offset, operand);
+        } else if (kind == SITE_IMPLICIT_EXCEPTION) {
+          JVMCI_event_4("implicit exception at %i", pc_offset);
+          _implicit_exception_table.add_deoptimize(pc_offset);
+        }
+        break;
+      case SITE_INFOPOINT:
+        JVMCI_event_4("infopoint at %i", pc_offset);
+        site_Infopoint(buffer, pc_offset, JVMCIENV->get_object_at(sites, i), JVMCI_CHECK);
+        break;
+      case SITE_DATA_PATCH:
+        JVMCI_event_4("datapatch at %i", pc_offset);
+        site_DataPatch(buffer, pc_offset, JVMCIENV->get_object_at(sites, i), JVMCI_CHECK);
+        break;
+      case SITE_MARK:
+        JVMCI_event_4("mark at %i", pc_offset);
+        record_mark(pc_offset, operand, JVMCI_CHECK);
+        break;
+      case SITE_EXCEPTION_HANDLER:
+        JVMCI_event_4("exceptionhandler at %i", pc_offset);
+        record_exception_handler(pc_offset, operand);
+        break;
+      default:
+        ShouldNotReachHere();
+    }
+
+    JavaThread* thread = JavaThread::current();
+    if (SafepointSynchronize::do_call_back()) {
+      // this is a hacky way to force a safepoint check but nothing else was jumping out at me.
+      ThreadToNativeFromVM ttnfv(thread);
+    }
+  }
 }
 
 int CodeInstaller::estimate_stubs_size(JVMCI_TRAPS) {
+  if (_site_stream != NULL) {
+    return estimate_stubs_size_from_stream(JVMCIENV);
+  }
   // Estimate the number of static and aot call stubs that might be emitted.
   int static_call_stubs = 0;
   int aot_call_stubs = 0;
@@ -859,62 +995,66 @@ JVMCI::CodeInstallResult CodeInstaller::initialize_buffer(CodeBuffer& buffer, bo
       JVMCI_ERROR_OK("invalid constant in data section: %s", jvmci_env()->klass_name(constant));
     }
   }
-  jint last_pc_offset = -1;
-  for (int i = 0; i < JVMCIENV->get_length(sites); i++) {
-    // HandleMark hm(THREAD);
-    JVMCIObject site = JVMCIENV->get_object_at(sites, i);
-    if (site.is_null()) {
-      JVMCI_THROW_(NullPointerException, JVMCI::ok);
-    }
+  if (_site_stream != NULL) {
+    process_site_stream(buffer, JVMCI_CHECK_OK);
+  } else {
+    jint last_pc_offset = -1;
+    for (int i = 0; i < JVMCIENV->get_length(sites); i++) {
+      // HandleMark hm(THREAD);
+      JVMCIObject site = JVMCIENV->get_object_at(sites, i);
+      if (site.is_null()) {
+        JVMCI_THROW_(NullPointerException, JVMCI::ok);
+      }
 
-    jint pc_offset = jvmci_env()->get_site_Site_pcOffset(site);
-
-    if (jvmci_env()->isa_site_Call(site)) {
-      JVMCI_event_4("call at %i", pc_offset);
-      site_Call(buffer, pc_offset, site, JVMCI_CHECK_OK);
-    } else if (jvmci_env()->isa_site_Infopoint(site)) {
-      // three reasons for infopoints denote actual safepoints
-      JVMCIObject reason = jvmci_env()->get_site_Infopoint_reason(site);
-      if (JVMCIENV->equals(reason, jvmci_env()->get_site_InfopointReason_SAFEPOINT()) ||
-          JVMCIENV->equals(reason, jvmci_env()->get_site_InfopointReason_CALL()) ||
-          JVMCIENV->equals(reason, jvmci_env()->get_site_InfopointReason_IMPLICIT_EXCEPTION())) {
-        JVMCI_event_4("safepoint at %i", pc_offset);
-        site_Safepoint(buffer, pc_offset, site, JVMCI_CHECK_OK);
-        if (_orig_pc_offset < 0) {
-          JVMCI_ERROR_OK("method contains safepoint, but has no deopt rescue slot");
-        }
-        if (JVMCIENV->equals(reason, jvmci_env()->get_site_InfopointReason_IMPLICIT_EXCEPTION())) {
-          if (jvmci_env()->isa_site_ImplicitExceptionDispatch(site)) {
-            jint dispatch_offset = jvmci_env()->get_site_ImplicitExceptionDispatch_dispatchOffset(site);
-            JVMCI_event_4("implicit exception at %i, dispatch to %i", pc_offset, dispatch_offset);
-            _implicit_exception_table.append(pc_offset, dispatch_offset);
-          } else {
-            JVMCI_event_4("implicit exception at %i", pc_offset);
-            _implicit_exception_table.add_deoptimize(pc_offset);
+      jint pc_offset = jvmci_env()->get_site_Site_pcOffset(site);
+
+      if (jvmci_env()->isa_site_Call(site)) {
+        JVMCI_event_4("call at %i", pc_offset);
+        site_Call(buffer, pc_offset, site, JVMCI_CHECK_OK);
+      } else if (jvmci_env()->isa_site_Infopoint(site)) {
+        // three reasons for infopoints denote actual safepoints
+        JVMCIObject reason = jvmci_env()->get_site_Infopoint_reason(site);
+        if (JVMCIENV->equals(reason, jvmci_env()->get_site_InfopointReason_SAFEPOINT()) ||
+            JVMCIENV->equals(reason, jvmci_env()->get_site_InfopointReason_CALL()) ||
+            JVMCIENV->equals(reason, jvmci_env()->get_site_InfopointReason_IMPLICIT_EXCEPTION())) {
+          JVMCI_event_4("safepoint at %i", pc_offset);
+          site_Safepoint(buffer, pc_offset, site, JVMCI_CHECK_OK);
+          if (_orig_pc_offset < 0) {
+            JVMCI_ERROR_OK("method contains safepoint, but has no deopt rescue slot");
+          }
+          if (JVMCIENV->equals(reason, jvmci_env()->get_site_InfopointReason_IMPLICIT_EXCEPTION())) {
+            if (jvmci_env()->isa_site_ImplicitExceptionDispatch(site)) {
+              jint dispatch_offset = jvmci_env()->get_site_ImplicitExceptionDispatch_dispatchOffset(site);
+              JVMCI_event_4("implicit exception at %i, dispatch to %i", pc_offset, dispatch_offset);
+              _implicit_exception_table.append(pc_offset, dispatch_offset);
+            } else {
+              JVMCI_event_4("implicit exception at %i", pc_offset);
+              _implicit_exception_table.add_deoptimize(pc_offset);
+            }
           }
+        } else {
+          JVMCI_event_4("infopoint at %i", pc_offset);
+          site_Infopoint(buffer, pc_offset, site, JVMCI_CHECK_OK);
         }
+      } else if (jvmci_env()->isa_site_DataPatch(site)) {
+        JVMCI_event_4("datapatch at %i", pc_offset);
+        site_DataPatch(buffer, pc_offset, site, JVMCI_CHECK_OK);
+      } else if (jvmci_env()->isa_site_Mark(site)) {
+        JVMCI_event_4("mark at %i", pc_offset);
+        site_Mark(buffer, pc_offset, site, JVMCI_CHECK_OK);
+      } else if (jvmci_env()->isa_site_ExceptionHandler(site)) {
+        JVMCI_event_4("exceptionhandler at %i", pc_offset);
+        site_ExceptionHandler(pc_offset, site);
       } else {
-        JVMCI_event_4("infopoint at %i", pc_offset);
-        site_Infopoint(buffer, pc_offset, site, JVMCI_CHECK_OK);
+        JVMCI_ERROR_OK("unexpected site subclass: %s", jvmci_env()->klass_name(site));
       }
-    } else if (jvmci_env()->isa_site_DataPatch(site)) {
-      JVMCI_event_4("datapatch at %i", pc_offset);
-      site_DataPatch(buffer, pc_offset, site, JVMCI_CHECK_OK);
-    } else if (jvmci_env()->isa_site_Mark(site)) {
-      JVMCI_event_4("mark at %i", pc_offset);
-      site_Mark(buffer, pc_offset, site, JVMCI_CHECK_OK);
-    } else if (jvmci_env()->isa_site_ExceptionHandler(site)) {
-      JVMCI_event_4("exceptionhandler at %i", pc_offset);
-      site_ExceptionHandler(pc_offset, site);
-    } else {
-      JVMCI_ERROR_OK("unexpected site subclass: %s", jvmci_env()->klass_name(site));
-    }
-    last_pc_offset = pc_offset;
+      last_pc_offset = pc_offset;
 
-    JavaThread* thread = JavaThread::current();
-    if (SafepointSynchronize::do_call_back()) {
-      // this is a hacky way to force a safepoint check but nothing else was jumping out at me.
-      ThreadToNativeFromVM ttnfv(thread);
+      JavaThread* thread = JavaThread::current();
+      if (SafepointSynchronize::do_call_back()) {
+        // this is a hacky way to force a safepoint check but nothing else was jumping out at me.
+        ThreadToNativeFromVM ttnfv(thread);
+      }
     }
   }
 
@@ -980,7 +1120,10 @@ void CodeInstaller::assumption_CallSiteTargetValue(JVMCIObject assumption, JVMCI
 
 void CodeInstaller::site_ExceptionHandler(jint pc_offset, JVMCIObject exc) {
   jint handler_offset = jvmci_env()->get_site_ExceptionHandler_handlerPos(exc);
+  record_exception_handler(pc_offset, handler_offset);
+}
 
+void CodeInstaller::record_exception_handler(jint pc_offset, jint handler_offset) {
   // Subtable header
   _exception_handler_table.add_entry(HandlerTableEntry(1, pc_offset, 0));
 
@@ -1347,58 +1490,61 @@ void CodeInstaller::site_Mark(CodeBuffer& buffer, jint pc_offset, JVMCIObject si
       JVMCI_ERROR("expected Integer id, got %s", jvmci_env()->klass_name(id_obj));
     }
     jint id = jvmci_env()->get_boxed_value(T_INT, id_obj).i;
+    record_mark(pc_offset, id, JVMCI_CHECK);
+  }
+}
 
-    address pc = _instructions->start() + pc_offset;
-
-    switch (id) {
-      case UNVERIFIED_ENTRY:
-        _offsets.set_value(CodeOffsets::Entry, pc_offset);
-        break;
-      case VERIFIED_ENTRY:
-        _offsets.set_value(CodeOffsets::Verified_Entry, pc_offset);
-        break;
-      case OSR_ENTRY:
-        _offsets.set_value(CodeOffsets::OSR_Entry, pc_offset);
-        break;
-      case EXCEPTION_HANDLER_ENTRY:
-        _offsets.set_value(CodeOffsets::Exceptions, pc_offset);
-        break;
-      case DEOPT_HANDLER_ENTRY:
-        _offsets.set_value(CodeOffsets::Deopt, pc_offset);
-        break;
-      case FRAME_COMPLETE:
-        _offsets.set_value(CodeOffsets::Frame_Complete, pc_offset);
-        break;
-      case DEOPT_MH_HANDLER_ENTRY:
-        _offsets.set_value(CodeOffsets::DeoptMH, pc_offset);
-        break;
-      case INVOKEVIRTUAL:
-      case INVOKEINTERFACE:
-      case INLINE_INVOKE:
-      case INVOKESTATIC:
-      case INVOKESPECIAL:
-        _next_call_type = (MarkId) id;
-        _invoke_mark_pc = pc;
-        break;
-      case POLL_NEAR:
-      case POLL_FAR:
-      case POLL_RETURN_NEAR:
-      case POLL_RETURN_FAR:
-        pd_relocate_poll(pc, id, JVMCI_CHECK);
-        break;
-      case CARD_TABLE_SHIFT:
-      case CARD_TABLE_ADDRESS:
-      case HEAP_TOP_ADDRESS:
-      case HEAP_END_ADDRESS:
-      case NARROW_KLASS_BASE_ADDRESS:
-      case NARROW_OOP_BASE_ADDRESS:
-      case CRC_TABLE_ADDRESS:
-      case LOG_OF_HEAP_REGION_GRAIN_BYTES:
-      case INLINE_CONTIGUOUS_ALLOCATION_SUPPORTED:
-        break;
-      default:
-        JVMCI_ERROR("invalid mark id: %d", id);
-        break;
-    }
+void CodeInstaller::record_mark(jint pc_offset, jint id, JVMCI_TRAPS) {
+  address pc = _instructions->start() + pc_offset;
+
+  switch (id) {
+    case UNVERIFIED_ENTRY:
+      _offsets.set_value(CodeOffsets::Entry, pc_offset);
+      break;
+    case VERIFIED_ENTRY:
+      _offsets.set_value(CodeOffsets::Verified_Entry, pc_offset);
+      break;
+    case OSR_ENTRY:
+      _offsets.set_value(CodeOffsets::OSR_Entry, pc_offset);
+      break;
+    case EXCEPTION_HANDLER_ENTRY:
+      _offsets.set_value(CodeOffsets::Exceptions, pc_offset);
+      break;
+    case DEOPT_HANDLER_ENTRY:
+      _offsets.set_value(CodeOffsets::Deopt, pc_offset);
+      break;
+    case FRAME_COMPLETE:
+      _offsets.set_value(CodeOffsets::Frame_Complete, pc_offset);
+      break;
+    case DEOPT_MH_HANDLER_ENTRY:
+      _offsets.set_value(CodeOffsets::DeoptMH, pc_offset);
+      break;
+    case INVOKEVIRTUAL:
+    case INVOKEINTERFACE:
+    case INLINE_INVOKE:
+    case INVOKESTATIC:
+    case INVOKESPECIAL:
+      _next_call_type = (MarkId) id;
+      _invoke_mark_pc = pc;
+      break;
+    case POLL_NEAR:
+    case POLL_FAR:
+    case POLL_RETURN_NEAR:
+    case POLL_RETURN_FAR:
+      pd_relocate_poll(pc, id, JVMCI_CHECK);
+      break;
+    case CARD_TABLE_SHIFT:
+    case CARD_TABLE_ADDRESS:
+    case HEAP_TOP_ADDRESS:
+    case HEAP_END_ADDRESS:
+    case NARROW_KLASS_BASE_ADDRESS:
+    case NARROW_OOP_BASE_ADDRESS:
+    case CRC_TABLE_ADDRESS:
+    case LOG_OF_HEAP_REGION_GRAIN_BYTES:
+    case INLINE_CONTIGUOUS_ALLOCATION_SUPPORTED:
+      break;
+    default:
+      JVMCI_ERROR("invalid mark id: %d", id);
+      break;
   }
 }
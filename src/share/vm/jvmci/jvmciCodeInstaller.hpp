@@ -156,6 +156,23 @@ private:
     INVOKE_INVALID                         = -1
   };
 
+  // Kinds of entries in HotSpotCompiledCode.siteStream. The stream starts
+  // with the number of sites followed by one entry per element of
+  // HotSpotCompiledCode.sites. Each entry is a kind byte followed by the
+  // pc offset and, for some kinds, an operand. The stream only replaces
+  // the site headers: call targets, debug info, oop maps and data patch
+  // references are still read from the site objects in the sites array.
+  enum SiteKind {
+    SITE_CALL = 1,
+    SITE_SAFEPOINT,
+    SITE_IMPLICIT_EXCEPTION,
+    SITE_IMPLICIT_EXCEPTION_DISPATCH,   // operand: dispatch offset
+    SITE_INFOPOINT,
+    SITE_DATA_PATCH,
+    SITE_MARK,                          // operand: mark id
+    SITE_EXCEPTION_HANDLER              // operand: handler offset
+  };
+
   Arena         _arena;
   JVMCIEnv*     _jvmci_env;
 
@@ -168,6 +185,9 @@ private:
   JVMCIPrimitiveArray    _code_handle;
   JVMCIObject            _word_kind_handle;
 
+  u_char*       _site_stream;
+  int           _site_stream_length;
+
   CodeOffsets   _offsets;
 
   jint          _code_size;
@@ -223,6 +243,8 @@ public:
   CodeInstaller(JVMCIEnv* jvmci_env, bool immutable_pic_compilation) :
     _arena(mtJVMCI),
     _jvmci_env(jvmci_env),
+    _site_stream(NULL),
+    _site_stream_length(0),
     _has_auto_box(false),
     _immutable_pic_compilation(immutable_pic_compilation) {}
 
@@ -280,6 +302,15 @@ protected:
   void site_Mark(CodeBuffer& buffer, jint pc_offset, JVMCIObject site, JVMCI_TRAPS);
   void site_ExceptionHandler(jint pc_offset, JVMCIObject site);
 
+  void record_mark(jint pc_offset, jint id, JVMCI_TRAPS);
+  void record_exception_handler(jint pc_offset, jint handler_offset);
+
+  // Support for installing sites described by HotSpotCompiledCode.siteStream
+  void initialize_site_stream(JVMCIObject compiled_code, JVMCI_TRAPS);
+  SiteKind next_site(CompressedReadStream& stream, jint& pc_offset, jint& operand, JVMCI_TRAPS);
+  int estimate_stubs_size_from_stream(JVMCI_TRAPS);
+  void process_site_stream(CodeBuffer& buffer, JVMCI_TRAPS);
+
   OopMap* create_oop_map(JVMCIObject debug_info, JVMCI_TRAPS);
 
   VMReg getVMRegFromLocation(JVMCIObject location, int total_frame_size, JVMCI_TRAPS);
@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "classfile/symbolTable.hpp"
+#include "compiler/compileBroker.hpp"
+#include "interpreter/bytecodeStream.hpp"
+#include "jvmci/jvmci.hpp"
+#include "jvmci/jvmci_globals.hpp"
+#include "jvmci/jvmciCompilationCache.hpp"
+#include "oops/fieldStreams.hpp"
+#include "oops/instanceKlass.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "utilities/growableArray.hpp"
+#include "utilities/ostream.hpp"
+
+class JVMCICompilationCacheEntry : public CHeapObj<mtJVMCI> {
+ public:
+  enum State {
+    pending,      // read from the cache file, holder not yet initialized
+    queued,       // compilation requested by the cache
+    installed,    // installed by the JVMCI compiler in this run
+    invalidated   // holder no longer matches the cached fingerprint
+  };
+
+  const char* const _class_name;
+  const char* const _name;
+  const char* const _signature;
+  const int _entry_bci;
+  const unsigned int _hash;
+  jlong _fingerprint;
+  State _state;
+  JVMCICompilationCacheEntry* _next;
+
+  JVMCICompilationCacheEntry(const char* class_name, const char* name, const char* signature,
+                             int entry_bci, unsigned int hash, jlong fingerprint, State state) :
+    _class_name(os::strdup(class_name, mtJVMCI)),
+    _name(os::strdup(name, mtJVMCI)),
+    _signature(os::strdup(signature, mtJVMCI)),
+    _entry_bci(entry_bci),
+    _hash(hash),
+    _fingerprint(fingerprint),
+    _state(state),
+    _next(NULL) {}
+
+  bool matches(const char* name, const char* signature, int entry_bci) const {
+    return _entry_bci == entry_bci && strcmp(_name, name) == 0 && strcmp(_signature, signature) == 0;
+  }
+};
+
+JVMCICompilationCacheEntry** JVMCICompilationCache::_table = NULL;
+int JVMCICompilationCache::_table_size = 0;
+int JVMCICompilationCache::_count = 0;
+int JVMCICompilationCache::_loaded = 0;
+int JVMCICompilationCache::_hits = 0;
+int JVMCICompilationCache::_invalidated = 0;
+int JVMCICompilationCache::_misses = 0;
+
+// 64-bit FNV-1a
+static const julong fnv_offset_basis = CONST64(0xcbf29ce484222325);
+static const julong fnv_prime = CONST64(0x100000001b3);
+
+static julong fnv_bytes(julong h, const jbyte* bytes, int len) {
+  for (int i = 0; i < len; i++) {
+    h = (h ^ (u1) bytes[i]) * fnv_prime;
+  }
+  return h;
+}
+
+static julong fnv_int(julong h, jint value) {
+  for (int i = 0; i < 4; i++) {
+    h = (h ^ (value & 0xff)) * fnv_prime;
+    value >>= 8;
+  }
+  return h;
+}
+
+static julong fnv_symbol(julong h, Symbol* symbol) {
+  return fnv_int(fnv_bytes(h, symbol->bytes(), symbol->utf8_length()), symbol->utf8_length());
+}
+
+jlong JVMCICompilationCache::fingerprint(instanceKlassHandle ik) {
+  Thread* thread = Thread::current();
+  julong h = fnv_symbol(fnv_offset_basis, ik->name());
+  if (ik->super() != NULL) {
+    h = fnv_symbol(h, ik->super()->name());
+  }
+  Array<Klass*>* interfaces = ik->local_interfaces();
+  for (int i = 0; i < interfaces->length(); i++) {
+    h = fnv_symbol(h, interfaces->at(i)->name());
+  }
+  for (JavaFieldStream fs(ik); !fs.done(); fs.next()) {
+    h = fnv_symbol(h, fs.name());
+    h = fnv_symbol(h, fs.signature());
+    h = fnv_int(h, fs.access_flags().as_int() & JVM_RECOGNIZED_FIELD_MODIFIERS);
+  }
+
+  // The methods array is sorted by the address of the name symbols which
+  // differs between runs so the per-method hashes are combined with an
+  // order independent operation. The bytecodes are hashed as Java bytecodes
+  // since rewriting may already have replaced some of them.
+  julong methods_hash = 0;
+  Array<Method*>* methods = ik->methods();
+  for (int i = 0; i < methods->length(); i++) {
+    methodHandle m(thread, methods->at(i));
+    julong mh = fnv_symbol(fnv_offset_basis, m->name());
+    mh = fnv_symbol(mh, m->signature());
+    mh = fnv_int(mh, m->access_flags().as_int() & JVM_RECOGNIZED_METHOD_MODIFIERS);
+    mh = fnv_int(mh, m->max_stack());
+    mh = fnv_int(mh, m->max_locals());
+    mh = fnv_int(mh, m->code_size());
+    BytecodeStream s(m);
+    Bytecodes::Code code;
+    while ((code = s.next()) >= 0) {
+      mh = fnv_int(mh, code);
+    }
+    methods_hash += mh;
+  }
+  return (jlong) fnv_int(fnv_int(h, (jint) methods_hash), (jint) (methods_hash >> 32));
+}
+
+unsigned int JVMCICompilationCache::hash(const char* class_name, int len) {
+  unsigned int h = 0;
+  for (int i = 0; i < len; i++) {
+    h = 31 * h + (unsigned int) class_name[i];
+  }
+  return h;
+}
+
+JVMCICompilationCacheEntry* JVMCICompilationCache::lookup(const char* class_name, const char* name, const char* signature, int entry_bci) {
+  assert(JVMCICompilationCache_lock->owned_by_self() || SafepointSynchronize::is_at_safepoint(), "must hold lock");
+  unsigned int h = hash(class_name, (int) strlen(class_name));
+  for (JVMCICompilationCacheEntry* e = _table[h & (_table_size - 1)]; e != NULL; e = e->_next) {
+    if (e->_hash == h && strcmp(e->_class_name, class_name) == 0 && e->matches(name, signature, entry_bci)) {
+      return e;
+    }
+  }
+  return NULL;
+}
+
+void JVMCICompilationCache::add(JVMCICompilationCacheEntry* entry) {
+  if (_count >= _table_size * 2) {
+    grow();
+  }
+  int index = entry->_hash & (_table_size - 1);
+  entry->_next = _table[index];
+  _table[index] = entry;
+  _count++;
+}
+
+void JVMCICompilationCache::grow() {
+  int new_size = _table_size * 2;
+  JVMCICompilationCacheEntry** new_table = NEW_C_HEAP_ARRAY(JVMCICompilationCacheEntry*, new_size, mtJVMCI);
+  memset(new_table, 0, new_size * sizeof(JVMCICompilationCacheEntry*));
+  for (int i = 0; i < _table_size; i++) {
+    JVMCICompilationCacheEntry* e = _table[i];
+    while (e != NULL) {
+      JVMCICompilationCacheEntry* next = e->_next;
+      int index = e->_hash & (new_size - 1);
+      e->_next = new_table[index];
+      new_table[index] = e;
+      e = next;
+    }
+  }
+  FREE_C_HEAP_ARRAY(JVMCICompilationCacheEntry*, _table, mtJVMCI);
+  _table = new_table;
+  _table_size = new_size;
+}
+
+// Parses a line of the form:
+//
+//   <fingerprint> <entry bci> <class name> <method name> <signature>
+void JVMCICompilationCache::parse_line(char* line, int line_no) {
+  char* fields[5];
+  int n = 0;
+  char* p = line;
+  while (n < 5) {
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+      p++;
+    }
+    if (*p == '\0') {
+      break;
+    }
+    fields[n++] = p;
+    while (*p != '\0' && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') {
+      p++;
+    }
+    if (*p != '\0') {
+      *p++ = '\0';
+    }
+  }
+  if (n == 0 || fields[0][0] == '#') {
+    return;
+  }
+  julong fingerprint;
+  int entry_bci;
+  if (n != 5 || sscanf(fields[0], UINT64_FORMAT_X, &fingerprint) != 1 || sscanf(fields[1], "%d", &entry_bci) != 1) {
+    warning("%s:%d: malformed JVMCI compilation cache entry", JVMCICompilationCacheFile, line_no);
+    return;
+  }
+  if (lookup(fields[2], fields[3], fields[4], entry_bci) == NULL) {
+    unsigned int h = hash(fields[2], (int) strlen(fields[2]));
+    add(new JVMCICompilationCacheEntry(fields[2], fields[3], fields[4], entry_bci, h, (jlong) fingerprint,
+                                       JVMCICompilationCacheEntry::pending));
+    _loaded++;
+  }
+}
+
+void JVMCICompilationCache::load() {
+  assert(JVMCICompilationCacheFile != NULL, "must be");
+  _table_size = 256;
+  _table = NEW_C_HEAP_ARRAY(JVMCICompilationCacheEntry*, _table_size, mtJVMCI);
+  memset(_table, 0, _table_size * sizeof(JVMCICompilationCacheEntry*));
+
+  FILE* stream = fopen(JVMCICompilationCacheFile, "r");
+  if (stream == NULL) {
+    // The file is created at VM exit
+    JVMCI_event_1("JVMCI compilation cache %s does not exist", JVMCICompilationCacheFile);
+    return;
+  }
+  MutexLockerEx ml(JVMCICompilationCache_lock, Mutex::_no_safepoint_check_flag);
+  char line[4096];
+  int line_no = 0;
+  while (fgets(line, sizeof(line), stream) != NULL) {
+    line_no++;
+    size_t len = strlen(line);
+    if (len > 0 && line[len - 1] != '\n' && !feof(stream)) {
+      warning("%s:%d: JVMCI compilation cache entry is too long", JVMCICompilationCacheFile, line_no);
+      int c;
+      while ((c = getc(stream)) != EOF && c != '\n') {}
+      continue;
+    }
+    parse_line(line, line_no);
+  }
+  fclose(stream);
+  JVMCI_event_1("read %d entries from JVMCI compilation cache %s", _loaded, JVMCICompilationCacheFile);
+}
+
+void JVMCICompilationCache::save() {
+  if (_table == NULL) {
+    return;
+  }
+  fileStream fs(JVMCICompilationCacheFile, "w");
+  if (!fs.is_open()) {
+    warning("Could not write JVMCI compilation cache to %s", JVMCICompilationCacheFile);
+    return;
+  }
+  fs.print_cr("# JVMCI compilation cache");
+  fs.print_cr("# <fingerprint> <entry bci> <class name> <method name> <signature>");
+  MutexLockerEx ml(JVMCICompilationCache_lock, Mutex::_no_safepoint_check_flag);
+  for (int i = 0; i < _table_size; i++) {
+    for (JVMCICompilationCacheEntry* e = _table[i]; e != NULL; e = e->_next) {
+      if (e->_state != JVMCICompilationCacheEntry::invalidated) {
+        fs.print_cr(UINT64_FORMAT_X " %d %s %s %s", (julong) e->_fingerprint, e->_entry_bci,
+                    e->_class_name, e->_name, e->_signature);
+      }
+    }
+  }
+}
+
+void JVMCICompilationCache::record(methodHandle method, int entry_bci) {
+  instanceKlassHandle holder(Thread::current(), method->method_holder());
+  if (_table == NULL || holder->is_anonymous()) {
+    // The names of anonymous classes are not stable across runs
+    return;
+  }
+  ResourceMark rm;
+  jlong fp = fingerprint(holder);
+  const char* class_name = holder->name()->as_C_string();
+  const char* name = method->name()->as_C_string();
+  const char* signature = method->signature()->as_C_string();
+
+  MutexLockerEx ml(JVMCICompilationCache_lock, Mutex::_no_safepoint_check_flag);
+  JVMCICompilationCacheEntry* e = lookup(class_name, name, signature, entry_bci);
+  if (e == NULL) {
+    unsigned int h = hash(class_name, (int) strlen(class_name));
+    e = new JVMCICompilationCacheEntry(class_name, name, signature, entry_bci, h, fp,
+                                       JVMCICompilationCacheEntry::installed);
+    add(e);
+    _misses++;
+  } else {
+    e->_fingerprint = fp;
+    e->_state = JVMCICompilationCacheEntry::installed;
+  }
+}
+
+void JVMCICompilationCache::class_initialized(instanceKlassHandle ik, TRAPS) {
+  if (_table == NULL || ik->is_anonymous() || THREAD->is_Compiler_thread()) {
+    // Compilations are not requested from compiler threads (which
+    // initialize classes when the JVMCI compiler runs on the HotSpot heap).
+    return;
+  }
+  ResourceMark rm(THREAD);
+  Symbol* class_name = ik->name();
+  unsigned int h = hash((const char*) class_name->bytes(), class_name->utf8_length());
+  GrowableArray<JVMCICompilationCacheEntry*>* entries = new GrowableArray<JVMCICompilationCacheEntry*>();
+  {
+    MutexLockerEx ml(JVMCICompilationCache_lock, Mutex::_no_safepoint_check_flag);
+    for (JVMCICompilationCacheEntry* e = _table[h & (_table_size - 1)]; e != NULL; e = e->_next) {
+      if (e->_hash == h && e->_state == JVMCICompilationCacheEntry::pending && class_name->equals(e->_class_name)) {
+        entries->append(e);
+      }
+    }
+  }
+  if (entries->is_empty()) {
+    return;
+  }
+
+  jlong fp = fingerprint(ik);
+  for (int i = 0; i < entries->length(); i++) {
+    JVMCICompilationCacheEntry* e = entries->at(i);
+    Method* m = NULL;
+    if (e->_fingerprint == fp) {
+      Symbol* name = SymbolTable::probe(e->_name, (int) strlen(e->_name));
+      Symbol* signature = SymbolTable::probe(e->_signature, (int) strlen(e->_signature));
+      if (name != NULL && signature != NULL) {
+        m = ik->find_method(name, signature);
+      }
+      if (m != NULL && (m->is_abstract() ||
+                        (e->_entry_bci != InvocationEntryBci && (m->is_native() || e->_entry_bci >= m->code_size())))) {
+        m = NULL;
+      }
+    }
+    {
+      MutexLockerEx ml(JVMCICompilationCache_lock, Mutex::_no_safepoint_check_flag);
+      if (e->_state != JVMCICompilationCacheEntry::pending) {
+        // Raced with a concurrent record
+        continue;
+      }
+      if (m == NULL) {
+        e->_state = JVMCICompilationCacheEntry::invalidated;
+        _invalidated++;
+        continue;
+      }
+      e->_state = JVMCICompilationCacheEntry::queued;
+      _hits++;
+    }
+    JVMCI_event_2("queueing %s.%s%s@%d from JVMCI compilation cache", e->_class_name, e->_name, e->_signature, e->_entry_bci);
+    methodHandle mh(THREAD, m);
+    CompileBroker::compile_method(mh, e->_entry_bci, CompLevel_full_optimization, mh, 0, "JVMCI compilation cache", THREAD);
+    if (HAS_PENDING_EXCEPTION) {
+      CLEAR_PENDING_EXCEPTION;
+    }
+  }
+}
+
+void JVMCICompilationCache::print_statistics(outputStream* st) {
+  if (JVMCICompilationCacheFile == NULL || _table == NULL) {
+    st->print_cr("JVMCI compilation cache is disabled (see -XX:JVMCICompilationCacheFile)");
+    return;
+  }
+  MutexLockerEx ml(JVMCICompilationCache_lock, Mutex::_no_safepoint_check_flag);
+  int pending = 0;
+  for (int i = 0; i < _table_size; i++) {
+    for (JVMCICompilationCacheEntry* e = _table[i]; e != NULL; e = e->_next) {
+      if (e->_state == JVMCICompilationCacheEntry::pending) {
+        pending++;
+      }
+    }
+  }
+  st->print_cr("JVMCI compilation cache: %s", JVMCICompilationCacheFile);
+  st->print_cr("  loaded:      %d", _loaded);
+  st->print_cr("  hits:        %d", _hits);
+  st->print_cr("  misses:      %d", _misses);
+  st->print_cr("  invalidated: %d", _invalidated);
+  st->print_cr("  pending:     %d", pending);
+}
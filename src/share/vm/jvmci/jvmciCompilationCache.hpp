@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_VM_JVMCI_JVMCICOMPILATIONCACHE_HPP
+#define SHARE_VM_JVMCI_JVMCICOMPILATIONCACHE_HPP
+
+#include "memory/allocation.hpp"
+#include "runtime/handles.hpp"
+
+class JVMCICompilationCacheEntry;
+class outputStream;
+
+// Remembers the methods installed by the JVMCI compiler across VM runs.
+//
+// At VM exit, the methods installed as default code during the run are
+// written to the file named by JVMCICompilationCacheFile along with a
+// fingerprint of their holder class. At startup, that file is read back
+// and when a class with cached entries is initialized, its fingerprint is
+// recomputed. If it matches, the cached methods are queued for compilation
+// right away instead of waiting for their invocation counters to overflow.
+// Otherwise the entries are invalidated.
+//
+// Installed code itself is not persisted: it embeds addresses of metadata,
+// stubs and heap objects that differ from one run to the next.
+class JVMCICompilationCache : public AllStatic {
+ private:
+  static JVMCICompilationCacheEntry** _table;
+  static int _table_size;
+  static int _count;
+
+  // Statistics reported by Compiler.jvmci_compilation_cache
+  static int _loaded;        // entries read from the cache file
+  static int _hits;          // entries whose method was queued for compilation
+  static int _invalidated;   // entries whose holder changed since the file was written
+  static int _misses;        // installed methods that were not in the cache file
+
+  static unsigned int hash(const char* class_name, int len);
+  static JVMCICompilationCacheEntry* lookup(const char* class_name, const char* name, const char* signature, int entry_bci);
+  static void add(JVMCICompilationCacheEntry* entry);
+  static void grow();
+
+  static void parse_line(char* line, int line_no);
+
+ public:
+  // Computes a fingerprint of the structure and bytecodes of `ik` that is
+  // stable across VM runs.
+  static jlong fingerprint(instanceKlassHandle ik);
+
+  // Reads the entries recorded in JVMCICompilationCacheFile.
+  static void load();
+
+  // Writes all live entries to JVMCICompilationCacheFile.
+  static void save();
+
+  // Notifies the cache that `method` has been installed as the default
+  // code for `entry_bci` by the JVMCI compiler.
+  static void record(methodHandle method, int entry_bci);
+
+  // Queues compilations for the cached entries of `ik`, which has just
+  // been initialized.
+  static void class_initialized(instanceKlassHandle ik, TRAPS);
+
+  static void print_statistics(outputStream* st);
+};
+
+#endif // SHARE_VM_JVMCI_JVMCICOMPILATIONCACHE_HPP
@@ -33,6 +33,9 @@
 #include "interpreter/bytecodeStream.hpp"
 #include "jvmci/jvmciCompilerToVM.hpp"
 #include "jvmci/jvmciCodeInstaller.hpp"
+#include "jvmci/jvmciCompilationCache.hpp"
+#include "jvmci/jvmciCounters.hpp"
+#include "jvmci/jvmciEntryProfiler.hpp"
 #include "jvmci/jvmciRuntime.hpp"
 #include "memory/oopFactory.hpp"
 #include "oops/constantPool.hpp"
@@ -150,6 +153,8 @@ static JavaThread* get_current_thread(bool allow_null=true) {
         err_msg("Cannot call into HotSpot from JVMCI shared library without attaching current thread")); \
     return;                                              \
   }                                                      \
+  static JVMCIEntryProfile __profile = { "CompilerToVM::" #name }; \
+  JVMCIEntryProfileMark __jpm(&__profile, thread);       \
   JVMCITraceMark jtm("CompilerToVM::" #name);            \
   C2V_BLOCK(result_type, name, signature)
 
@@ -161,6 +166,8 @@ static JavaThread* get_current_thread(bool allow_null=true) {
         err_msg("Cannot call into HotSpot from JVMCI shared library without attaching current thread")); \
     return result;                                       \
   }                                                      \
+  static JVMCIEntryProfile __profile = { "CompilerToVM::" #name }; \
+  JVMCIEntryProfileMark __jpm(&__profile, thread);       \
   JVMCITraceMark jtm("CompilerToVM::" #name);            \
   C2V_BLOCK(result_type, name, signature)
 
@@ -630,6 +637,32 @@ C2V_VMENTRY_0(jint, lookupKlassRefIndexInPool, (JNIEnv* env, jobject, jobject jv
   return cp->klass_ref_index_at(index);
 C2V_END
 
+C2V_VMENTRY(void, lookupMemberRefsInPool, (JNIEnv* env, jobject, jobject jvmci_constant_pool, jintArray which_handle, jobjectArray names_handle, jobjectArray signatures_handle, jintArray ref_indexes_handle))
+  JVMCIPrimitiveArray which = JVMCIENV->wrap(which_handle);
+  JVMCIObjectArray names = JVMCIENV->wrap(names_handle);
+  JVMCIObjectArray signatures = JVMCIENV->wrap(signatures_handle);
+  JVMCIPrimitiveArray ref_indexes = JVMCIENV->wrap(ref_indexes_handle);
+  if (which.is_null() || names.is_null() || signatures.is_null() || ref_indexes.is_null()) {
+    JVMCI_THROW(NullPointerException);
+  }
+  int length = JVMCIENV->get_length(which);
+  if (JVMCIENV->get_length(names) != length || JVMCIENV->get_length(signatures) != length ||
+      JVMCIENV->get_length(ref_indexes) != length * 2) {
+    JVMCI_THROW_MSG(IllegalArgumentException, "names and signatures must have the length of which and ref_indexes twice that length");
+  }
+  constantPoolHandle cp = JVMCIENV->asConstantPool(jvmci_constant_pool);
+  for (int i = 0; i < length; i++) {
+    int index = JVMCIENV->get_int_at(which, i);
+    JVMCIObject name = JVMCIENV->create_string(cp->name_ref_at(index), JVMCI_CHECK);
+    JVMCIObject signature = JVMCIENV->create_string(cp->signature_ref_at(index), JVMCI_CHECK);
+    JVMCIENV->put_object_at(names, i, name);
+    JVMCIENV->put_object_at(signatures, i, signature);
+    JVMCIENV->put_int_at(ref_indexes, i * 2, cp->name_and_type_ref_index_at(index));
+    // invokedynamic entries have no holder class reference
+    JVMCIENV->put_int_at(ref_indexes, i * 2 + 1, ConstantPool::is_invokedynamic_index(index) ? -1 : cp->klass_ref_index_at(index));
+  }
+C2V_END
+
 C2V_VMENTRY_NULL(jobject, resolveTypeInPool, (JNIEnv* env, jobject, jobject jvmci_constant_pool, jint index))
   constantPoolHandle cp = JVMCIENV->asConstantPool(jvmci_constant_pool);
   Klass* klass = cp->klass_at(index, CHECK_NULL);
@@ -1125,7 +1158,7 @@ C2V_VMENTRY_NULL(jlongArray, collectCounters, (JNIEnv* env, jobject))
   JVMCIPrimitiveArray array = JVMCIENV->new_longArray(JVMCICounterSize, JVMCI_CHECK_NULL);
   if (JVMCICounterSize > 0) {
     jlong* temp_array = NEW_RESOURCE_ARRAY(jlong, JVMCICounterSize);
-    JavaThread::collect_counters(temp_array, JVMCICounterSize);
+    JVMCICounters::collect(temp_array, JVMCICounterSize);
     JVMCIENV->copy_longs_from(temp_array, array, 0, JVMCICounterSize);
   }
   return (jlongArray) JVMCIENV->get_jobject(array);
@@ -1136,7 +1169,7 @@ C2V_VMENTRY_0(int, getCountersSize, (JNIEnv* env, jobject))
 C2V_END
 
 C2V_VMENTRY_0(jboolean, setCountersSize, (JNIEnv* env, jobject, jint new_size))
-  return JavaThread::resize_all_jvmci_counters(new_size);
+  return JVMCICounters::resize(new_size, THREAD);
 C2V_END
 
 C2V_VMENTRY_0(jint, allocateCompileId, (JNIEnv* env, jobject, jobject jvmci_method, int entry_bci))
@@ -1726,7 +1759,13 @@ C2V_VMENTRY_0(jlong, getFingerprint, (JNIEnv* env, jobject, jlong metaspace_klas
     return 0;
   }
 #else
-  THROW_MSG_0(vmSymbols::java_lang_InternalError(), "unimplemented");
+  // Use the fingerprint that keys JVMCICompilationCacheFile entries
+  Klass *k = (Klass*) (address) metaspace_klass;
+  if (k->oop_is_instance()) {
+    return JVMCICompilationCache::fingerprint(instanceKlassHandle(THREAD, k));
+  } else {
+    return 0;
+  }
 #endif
 C2V_END
 
@@ -2617,11 +2656,9 @@ C2V_VMENTRY_NULL(jobject, asReflectionField, (JNIEnv* env, jobject, jobject jvmc
 }
 
 C2V_VMENTRY_NULL(jobjectArray, getFailedSpeculations, (JNIEnv* env, jobject, jlong failed_speculations_address, jobjectArray current))
-  FailedSpeculation* head = *((FailedSpeculation**)(address) failed_speculations_address);
-  int result_length = 0;
-  for (FailedSpeculation* fs = head; fs != NULL; fs = fs->next()) {
-    result_length++;
-  }
+  FailedSpeculation* head = (FailedSpeculation*) OrderAccess::load_ptr_acquire((FailedSpeculation**)(address) failed_speculations_address);
+  // The list is ordered newest first and an entry's index is its position in the result
+  int result_length = head == NULL ? 0 : head->index() + 1;
   int current_length = 0;
   JVMCIObjectArray current_array = NULL;
   if (current != NULL) {
@@ -2631,19 +2668,20 @@ C2V_VMENTRY_NULL(jobjectArray, getFailedSpeculations, (JNIEnv* env, jobject, jlo
       // No new failures
       return current;
     }
+    if (current_length > result_length) {
+      // Not a prefix of the result
+      current_length = 0;
+    }
   }
   JVMCIObjectArray result = JVMCIENV->new_byte_array_array(result_length, JVMCI_CHECK_NULL);
-  int result_index = 0;
-  for (FailedSpeculation* fs = head; result_index < result_length; fs = fs->next()) {
-    assert(fs != NULL, "npe");
-    JVMCIPrimitiveArray entry;
-    if (result_index < current_length) {
-      entry = (JVMCIPrimitiveArray) JVMCIENV->get_object_at(current_array, result_index);
-    } else {
-      entry = JVMCIENV->new_byteArray(fs->data_len(), JVMCI_CHECK_NULL);
-      JVMCIENV->copy_bytes_from((jbyte*) fs->data(), entry, 0, fs->data_len());
-    }
-    JVMCIENV->put_object_at(result, result_index++, entry);
+  for (int i = 0; i < current_length; i++) {
+    JVMCIENV->put_object_at(result, i, JVMCIENV->get_object_at(current_array, i));
+  }
+  // Only the entries added since `current` was retrieved are copied
+  for (FailedSpeculation* fs = head; fs != NULL && fs->index() >= current_length; fs = fs->next()) {
+    JVMCIPrimitiveArray entry = JVMCIENV->new_byteArray(fs->data_len(), JVMCI_CHECK_NULL);
+    JVMCIENV->copy_bytes_from((jbyte*) fs->data(), entry, 0, fs->data_len());
+    JVMCIENV->put_object_at(result, fs->index(), entry);
   }
   return JVMCIENV->get_jobjectArray(result);
 }
@@ -2735,6 +2773,7 @@ JNINativeMethod CompilerToVM::methods[] = {
   {CC "lookupNameAndTypeRefIndexInPool",              CC "(" HS_CONSTANT_POOL "I)I",                                                        FN_PTR(lookupNameAndTypeRefIndexInPool)},
   {CC "lookupSignatureInPool",                        CC "(" HS_CONSTANT_POOL "I)" STRING,                                                  FN_PTR(lookupSignatureInPool)},
   {CC "lookupKlassRefIndexInPool",                    CC "(" HS_CONSTANT_POOL "I)I",                                                        FN_PTR(lookupKlassRefIndexInPool)},
+  {CC "lookupMemberRefsInPool",                       CC "(" HS_CONSTANT_POOL "[I[" STRING "[" STRING "[I)V",                               FN_PTR(lookupMemberRefsInPool)},
   {CC "lookupKlassInPool",                            CC "(" HS_CONSTANT_POOL "I)Ljava/lang/Object;",                                       FN_PTR(lookupKlassInPool)},
   {CC "lookupAppendixInPool",                         CC "(" HS_CONSTANT_POOL "I)" OBJECTCONSTANT,                                          FN_PTR(lookupAppendixInPool)},
   {CC "lookupMethodInPool",                           CC "(" HS_CONSTANT_POOL "IB)" HS_RESOLVED_METHOD,                                     FN_PTR(lookupMethodInPool)},
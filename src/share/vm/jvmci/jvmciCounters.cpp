@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "jvmci/jvmciCounters.hpp"
+#include "jvmci/jvmci_globals.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/orderAccess.inline.hpp"
+#include "runtime/task.hpp"
+#include "runtime/thread.hpp"
+#include "runtime/vmThread.hpp"
+#include "runtime/vm_operations.hpp"
+
+class JVMCICounterSlab : public CHeapObj<mtJVMCI> {
+ public:
+  enum State {
+    available,  // to the next thread that starts
+    in_use      // by a live thread
+  };
+
+  JVMCICounterSlab* _next;
+  char*             _memory;    // the C heap block holding _counters
+  jlong*            _counters;
+  int               _capacity;
+  bool              _included;  // false for compiler threads when JVMCICountersExcludeCompiler
+  State             _state;     // only accessed with Threads_lock held
+  JavaThread*       _owner;
+
+  JVMCICounterSlab(char* memory, int capacity, bool included) :
+    _next(NULL), _memory(memory), _counters(counters_in(memory)), _capacity(capacity),
+    _included(included), _state(in_use), _owner(NULL) {}
+
+  // Pad the counters to whole cache lines so that no two threads
+  // increment counters in the same cache line.
+  static char* allocate(int capacity) {
+    size_t size = align_size_up(capacity * sizeof(jlong), DEFAULT_CACHE_LINE_SIZE) + DEFAULT_CACHE_LINE_SIZE;
+    char* memory = NEW_C_HEAP_ARRAY_RETURN_NULL(char, size, mtJVMCI);
+    if (memory != NULL) {
+      memset(memory, 0, size);
+    }
+    return memory;
+  }
+
+  static jlong* counters_in(char* memory) {
+    return (jlong*) align_ptr_up(memory, DEFAULT_CACHE_LINE_SIZE);
+  }
+};
+
+class VM_JVMCIResizeCounters : public VM_Operation {
+ private:
+  int  _new_capacity;
+  bool _result;
+
+ public:
+  VM_JVMCIResizeCounters(int new_capacity) : _new_capacity(new_capacity), _result(false) {}
+  VMOp_Type type() const { return VMOp_JVMCIResizeCounters; }
+  void doit()            { _result = JVMCICounters::grow(_new_capacity); }
+  bool result() const    { return _result; }
+};
+
+class JVMCICounterSampler : public PeriodicTask {
+ public:
+  JVMCICounterSampler(size_t interval) : PeriodicTask(interval) {}
+  void task() { JVMCICounters::sample(); }
+};
+
+JVMCICounterSlab* volatile JVMCICounters::_slabs = NULL;
+int JVMCICounters::_capacity = 0;
+Mutex* JVMCICounters::_create_lock = NULL;
+Mutex* JVMCICounters::_sample_lock = NULL;
+PerfVariable** JVMCICounters::_perf_counters = NULL;
+jlong* JVMCICounters::_snapshot = NULL;
+int JVMCICounters::_num_perf_counters = 0;
+
+void JVMCICounters::initialize() {
+  if (JVMCICountersSampleInterval > 0 && UsePerfData) {
+    _create_lock = new Mutex(Mutex::nonleaf, "JVMCICounterCreate_lock", true);
+    _sample_lock = new Mutex(Mutex::leaf, "JVMCICounterSample_lock", true);
+    {
+      EXCEPTION_MARK;
+      create_perf_counters((int) JVMCICounterSize, CHECK);
+    }
+    size_t interval = align_size_up(JVMCICountersSampleInterval, PeriodicTask::interval_gran);
+    interval = MIN2(interval, (size_t) PeriodicTask::max_interval);
+    JVMCICounterSampler* sampler = new JVMCICounterSampler(interval);
+    sampler->enroll();
+  }
+}
+
+bool JVMCICounters::include(JavaThread* thread) {
+  return !JVMCICountersExcludeCompiler || !thread->is_Compiler_thread();
+}
+
+JVMCICounterSlab* JVMCICounters::claim_slab(JavaThread* thread) {
+  assert_locked_or_safepoint(Threads_lock);
+  bool included = include(thread);
+  for (JVMCICounterSlab* slab = _slabs; slab != NULL; slab = slab->_next) {
+    if (slab->_state == JVMCICounterSlab::available && slab->_included == included && slab->_capacity >= _capacity) {
+      slab->_state = JVMCICounterSlab::in_use;
+      slab->_owner = thread;
+      return slab;
+    }
+  }
+
+  char* memory = JVMCICounterSlab::allocate(_capacity);
+  if (memory == NULL) {
+    return NULL;
+  }
+  JVMCICounterSlab* slab = new JVMCICounterSlab(memory, _capacity, included);
+  slab->_owner = thread;
+  slab->_next = _slabs;
+  OrderAccess::release_store_ptr(&_slabs, slab);
+  return slab;
+}
+
+void JVMCICounters::thread_added(JavaThread* thread) {
+  if (_capacity == 0) {
+    // The main thread is added before JVMCI is initialized
+    _capacity = (int) JVMCICounterSize;
+    if (_capacity == 0) {
+      return;
+    }
+  }
+  JVMCICounterSlab* slab = claim_slab(thread);
+  if (slab == NULL) {
+    vm_exit_out_of_memory(_capacity * sizeof(jlong), OOM_MALLOC_ERROR, "JVMCI counters");
+  }
+  thread->set_jvmci_counters(slab->_counters);
+}
+
+void JVMCICounters::thread_removed(JavaThread* thread) {
+  assert_locked_or_safepoint(Threads_lock);
+  if (thread->jvmci_counters() == NULL) {
+    return;
+  }
+  for (JVMCICounterSlab* slab = _slabs; slab != NULL; slab = slab->_next) {
+    if (slab->_owner == thread) {
+      slab->_state = JVMCICounterSlab::available;
+      slab->_owner = NULL;
+      break;
+    }
+  }
+  thread->set_jvmci_counters(NULL);
+}
+
+void JVMCICounters::collect(jlong* array, int length) {
+  memset(array, 0, sizeof(jlong) * length);
+  JVMCICounterSlab* slab = (JVMCICounterSlab*) OrderAccess::load_ptr_acquire(&_slabs);
+  for (; slab != NULL; slab = slab->_next) {
+    if (slab->_included) {
+      int n = MIN2(length, slab->_capacity);
+      for (int i = 0; i < n; i++) {
+        array[i] += slab->_counters[i];
+      }
+    }
+  }
+}
+
+// Replaces the counters of every slab with a copy of capacity
+// `new_capacity` and gives a slab to the threads that have none (because
+// the counters were disabled when they started). At a safepoint no thread
+// is in the middle of incrementing a counter, so the old counters can be
+// freed. All the new memory is allocated before anything is changed, so
+// if an allocation fails everything is left as it was.
+bool JVMCICounters::grow(int new_capacity) {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  if (new_capacity <= _capacity) {
+    // Grown by a racing resize
+    return true;
+  }
+  int count = 0;
+  for (JVMCICounterSlab* slab = _slabs; slab != NULL; slab = slab->_next) {
+    count++;
+  }
+  int missing = 0;
+  for (JavaThread* thread = Threads::first(); thread != NULL; thread = thread->next()) {
+    if (thread->jvmci_counters() == NULL) {
+      missing++;
+    }
+  }
+  int total = count + missing;
+  char** memory = NEW_C_HEAP_ARRAY_RETURN_NULL(char*, MAX2(total, 1), mtJVMCI);
+  if (memory == NULL) {
+    return false;
+  }
+  for (int i = 0; i < total; i++) {
+    memory[i] = JVMCICounterSlab::allocate(new_capacity);
+    if (memory[i] == NULL) {
+      while (--i >= 0) {
+        FREE_C_HEAP_ARRAY(char, memory[i], mtJVMCI);
+      }
+      FREE_C_HEAP_ARRAY(char*, memory, mtJVMCI);
+      return false;
+    }
+  }
+  {
+    // The sampler runs on the WatcherThread which keeps running during
+    // a safepoint.
+    MutexLockerEx ml(_sample_lock, Mutex::_no_safepoint_check_flag);
+    int i = 0;
+    for (JVMCICounterSlab* slab = _slabs; slab != NULL; slab = slab->_next, i++) {
+      jlong* counters = JVMCICounterSlab::counters_in(memory[i]);
+      memcpy(counters, slab->_counters, sizeof(jlong) * slab->_capacity);
+      FREE_C_HEAP_ARRAY(char, slab->_memory, mtJVMCI);
+      slab->_memory = memory[i];
+      slab->_counters = counters;
+      slab->_capacity = new_capacity;
+      if (slab->_owner != NULL) {
+        slab->_owner->set_jvmci_counters(counters);
+      }
+    }
+    for (JavaThread* thread = Threads::first(); thread != NULL; thread = thread->next()) {
+      if (thread->jvmci_counters() == NULL) {
+        JVMCICounterSlab* slab = new JVMCICounterSlab(memory[i++], new_capacity, include(thread));
+        slab->_owner = thread;
+        slab->_next = _slabs;
+        OrderAccess::release_store_ptr(&_slabs, slab);
+        thread->set_jvmci_counters(slab->_counters);
+      }
+    }
+  }
+  FREE_C_HEAP_ARRAY(char*, memory, mtJVMCI);
+  _capacity = new_capacity;
+  return true;
+}
+
+bool JVMCICounters::resize(int new_size, TRAPS) {
+  if (new_size > _capacity) {
+    VM_JVMCIResizeCounters op(new_size);
+    VMThread::execute(&op);
+    if (!op.result()) {
+      return false;
+    }
+  }
+  {
+    MutexLocker tl(Threads_lock);
+    int old_size = (int) JVMCICounterSize;
+    if (new_size > old_size) {
+      // Reset counters that were in use before an earlier shrink
+      for (JVMCICounterSlab* slab = _slabs; slab != NULL; slab = slab->_next) {
+        int end = MIN2(new_size, slab->_capacity);
+        if (end > old_size) {
+          memset(slab->_counters + old_size, 0, sizeof(jlong) * (end - old_size));
+        }
+      }
+    }
+    JVMCICounterSize = new_size;
+  }
+  if (_sample_lock != NULL && new_size > _num_perf_counters) {
+    create_perf_counters(new_size, CHECK_false);
+  }
+  return true;
+}
+
+// Creates the performance counters up to length. Threads resizing the
+// counters concurrently are serialized by _create_lock, so that every
+// counter is created once. If creating a counter fails, the counters
+// created before it are kept and the exception is left pending.
+void JVMCICounters::create_perf_counters(int length, TRAPS) {
+  MutexLocker cl(_create_lock);
+  if (length <= _num_perf_counters) {
+    return;
+  }
+  PerfVariable** perf_counters = NEW_C_HEAP_ARRAY(PerfVariable*, length, mtJVMCI);
+  jlong* snapshot = NEW_C_HEAP_ARRAY(jlong, length, mtJVMCI);
+  for (int i = 0; i < _num_perf_counters; i++) {
+    perf_counters[i] = _perf_counters[i];
+  }
+  int created = _num_perf_counters;
+  while (created < length) {
+    ResourceMark rm;
+    char* name = PerfDataManager::counter_name("jvmci.counter", err_msg("%d", created));
+    PerfVariable* counter = PerfDataManager::create_variable(SUN_CI, name, PerfData::U_Events, THREAD);
+    if (HAS_PENDING_EXCEPTION) {
+      break;
+    }
+    perf_counters[created++] = counter;
+  }
+  if (created == _num_perf_counters) {
+    FREE_C_HEAP_ARRAY(PerfVariable*, perf_counters, mtJVMCI);
+    FREE_C_HEAP_ARRAY(jlong, snapshot, mtJVMCI);
+    return;
+  }
+  MutexLockerEx ml(_sample_lock, Mutex::_no_safepoint_check_flag);
+  FREE_C_HEAP_ARRAY(PerfVariable*, _perf_counters, mtJVMCI);
+  FREE_C_HEAP_ARRAY(jlong, _snapshot, mtJVMCI);
+  _perf_counters = perf_counters;
+  _snapshot = snapshot;
+  _num_perf_counters = created;
+}
+
+void JVMCICounters::sample() {
+  MutexLockerEx ml(_sample_lock, Mutex::_no_safepoint_check_flag);
+  int length = MIN2(_num_perf_counters, (int) JVMCICounterSize);
+  collect(_snapshot, length);
+  for (int i = 0; i < length; i++) {
+    _perf_counters[i]->set_value(_snapshot[i]);
+  }
+}
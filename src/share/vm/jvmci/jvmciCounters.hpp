@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_VM_JVMCI_JVMCICOUNTERS_HPP
+#define SHARE_VM_JVMCI_JVMCICOUNTERS_HPP
+
+#include "memory/allocation.hpp"
+#include "runtime/perfData.hpp"
+#include "utilities/exceptions.hpp"
+
+class JavaThread;
+class JVMCICounterSlab;
+
+// Storage for the benchmark counters (see JVMCICounterSize) that are
+// incremented by JVMCI compiled code through JavaThread::_jvmci_counters.
+//
+// Each thread is given a cache line aligned slab of counters when it is
+// added to the thread list. Slabs are never freed. When a thread exits, its
+// slab is handed to the next thread that starts, so the values it holds
+// keep contributing to the totals. This means collecting the totals is a
+// walk over the list of slabs that needs neither Threads_lock nor a
+// safepoint.
+//
+// Growing the counters replaces the counters of every slab with a larger
+// copy in a VM operation, since only at a safepoint can the old counters
+// be freed without losing increments. The capacity of the slabs never
+// shrinks so that code compiled for a larger size cannot write outside a
+// slab.
+//
+// With -XX:JVMCICountersSampleInterval=<ms>, the totals are periodically
+// published as sun.ci.jvmci.counter.<n> performance counters. This makes
+// them visible to tools reading the hsperfdata file of the VM.
+class JVMCICounters : public AllStatic {
+  friend class JVMCICounterSampler;
+  friend class VM_JVMCIResizeCounters;
+ private:
+  static JVMCICounterSlab* volatile _slabs; // All slabs ever allocated, newest first
+  static int _capacity;                     // Capacity of the slabs handed out to threads
+
+  static Mutex* _create_lock;               // Serializes the creation of the performance counters
+  static Mutex* _sample_lock;               // Guards _perf_counters and _snapshot
+  static PerfVariable** _perf_counters;
+  static jlong* _snapshot;
+  static int _num_perf_counters;
+
+  static bool include(JavaThread* thread);
+  static JVMCICounterSlab* claim_slab(JavaThread* thread);
+  static bool grow(int new_capacity);
+  static void create_perf_counters(int length, TRAPS);
+  static void sample();
+
+ public:
+  static void initialize();
+
+  // Called with Threads_lock held when `thread` is added to
+  // or removed from the thread list.
+  static void thread_added(JavaThread* thread);
+  static void thread_removed(JavaThread* thread);
+
+  // Stores the sum of the first `length` counters over all threads in `array`.
+  static void collect(jlong* array, int length);
+
+  // Changes JVMCICounterSize to `new_size`. Returns false if
+  // memory for the counters could not be allocated.
+  static bool resize(int new_size, TRAPS);
+};
+
+#endif // SHARE_VM_JVMCI_JVMCICOUNTERS_HPP
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "jvmci/jvmciEntryProfiler.hpp"
+#include "memory/resourceArea.hpp"
+#include "runtime/atomic.inline.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/orderAccess.inline.hpp"
+#include "runtime/thread.inline.hpp"
+#include "utilities/growableArray.hpp"
+#include "utilities/ostream.hpp"
+
+JVMCIEntryProfile* volatile JVMCIEntryProfiler::_profiles = NULL;
+
+void JVMCIEntryProfiler::register_profile(JVMCIEntryProfile* profile) {
+  if (Atomic::cmpxchg(1, &profile->_registered, 0) != 0) {
+    // Another thread got there first
+    return;
+  }
+  JVMCIEntryProfile* head;
+  do {
+    head = profiles();
+    profile->_next = head;
+  } while (Atomic::cmpxchg_ptr(profile, &_profiles, head) != head);
+}
+
+JVMCIEntryProfile* JVMCIEntryProfiler::profiles() {
+  return (JVMCIEntryProfile*) OrderAccess::load_ptr_acquire(&_profiles);
+}
+
+static int histogram_bucket(jlong nanos) {
+  jlong micros = nanos / (NANOUNITS / MICROUNITS);
+  if (micros <= 0) {
+    return 0;
+  }
+  return MIN2(log2_jlong(micros) + 1, (int) JVMCIEntryProfile::histogram_buckets - 1);
+}
+
+void JVMCIEntryProfiler::record(JVMCIEntryProfile* profile, JavaThread* thread, jlong ticks) {
+  if (ticks < 0) {
+    // The time stamp counters of different cores are not
+    // necessarily in sync and the thread may have migrated.
+    ticks = 0;
+  }
+  if (profile->_registered == 0) {
+    register_profile(profile);
+  }
+  Atomic::add((jlong) 1, &profile->_count);
+  Atomic::add(ticks, &profile->_ticks);
+  Atomic::add((jlong) 1, &profile->_histogram[histogram_bucket(ticks_to_nanos(ticks))]);
+  jlong max = Atomic::load(&profile->_max_ticks);
+  while (ticks > max) {
+    jlong witness = Atomic::cmpxchg(ticks, &profile->_max_ticks, max);
+    if (witness == max) {
+      break;
+    }
+    max = witness;
+  }
+  thread->add_jvmci_vm_entry_ticks(ticks);
+}
+
+static int compare_total_ticks(JVMCIEntryProfile** p1, JVMCIEntryProfile** p2) {
+  jlong t1 = Atomic::load(&(*p1)->_ticks);
+  jlong t2 = Atomic::load(&(*p2)->_ticks);
+  return t1 > t2 ? -1 : (t1 < t2 ? 1 : 0);
+}
+
+void JVMCIEntryProfiler::print_on(outputStream* st) {
+  if (!JVMCIProfileVMEntries) {
+    st->print_cr("JVMCI VM entry profiling is disabled (see -XX:+JVMCIProfileVMEntries)");
+  }
+  ResourceMark rm;
+  GrowableArray<JVMCIEntryProfile*> sorted;
+  for (JVMCIEntryProfile* p = profiles(); p != NULL; p = p->_next) {
+    sorted.append(p);
+  }
+  sorted.sort(compare_total_ticks);
+
+  st->print_cr("%-50s %10s %12s %10s %10s", "entry point", "calls", "total (ms)", "avg (us)", "max (us)");
+  for (int i = 0; i < sorted.length(); i++) {
+    JVMCIEntryProfile* p = sorted.at(i);
+    jlong count = Atomic::load(&p->_count);
+    jlong total = ticks_to_nanos(Atomic::load(&p->_ticks));
+    jlong max = ticks_to_nanos(Atomic::load(&p->_max_ticks));
+    if (count == 0) {
+      continue;
+    }
+    st->print_cr("%-50s " INT64_FORMAT_W(10) " %12.3f %10.3f %10.3f", p->_name, (int64_t) count,
+                 (double) total / NANOSECS_PER_MILLISEC,
+                 (double) total / count / (NANOUNITS / MICROUNITS),
+                 (double) max / (NANOUNITS / MICROUNITS));
+    st->print("  ");
+    for (int b = 0; b < JVMCIEntryProfile::histogram_buckets; b++) {
+      jlong n = Atomic::load(&p->_histogram[b]);
+      if (n == 0) {
+        continue;
+      }
+      if (b == 0) {
+        st->print(" <1us:" JLONG_FORMAT, n);
+      } else if (b == JVMCIEntryProfile::histogram_buckets - 1) {
+        st->print(" >=%dus:" JLONG_FORMAT, 1 << (b - 1), n);
+      } else {
+        st->print(" <%dus:" JLONG_FORMAT, 1 << b, n);
+      }
+    }
+    st->cr();
+  }
+
+  st->cr();
+  st->print_cr("%-50s %10s %12s", "thread", "calls", "total (ms)");
+  MutexLockerEx ml(Threads_lock);
+  for (JavaThread* t = Threads::first(); t != NULL; t = t->next()) {
+    jlong count = t->jvmci_vm_entry_count();
+    if (count == 0) {
+      continue;
+    }
+    st->print_cr("%-50s " INT64_FORMAT_W(10) " %12.3f", t->get_thread_name(), (int64_t) count,
+                 (double) ticks_to_nanos(t->jvmci_vm_entry_ticks()) / NANOSECS_PER_MILLISEC);
+  }
+}
+
+void JVMCIEntryProfiler::reset() {
+  for (JVMCIEntryProfile* p = profiles(); p != NULL; p = p->_next) {
+    Atomic::store((jlong) 0, &p->_count);
+    Atomic::store((jlong) 0, &p->_ticks);
+    Atomic::store((jlong) 0, &p->_max_ticks);
+    for (int b = 0; b < JVMCIEntryProfile::histogram_buckets; b++) {
+      Atomic::store((jlong) 0, &p->_histogram[b]);
+    }
+  }
+  MutexLockerEx ml(Threads_lock);
+  for (JavaThread* t = Threads::first(); t != NULL; t = t->next()) {
+    t->reset_jvmci_vm_entry_ticks();
+  }
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_VM_JVMCI_JVMCIENTRYPROFILER_HPP
+#define SHARE_VM_JVMCI_JVMCIENTRYPROFILER_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/ticks.hpp"
+
+class JavaThread;
+class outputStream;
+
+// Call count and latency statistics for a single CompilerToVM entry point.
+// The C2V_VMENTRY macros statically allocate one per entry point. It is
+// linked into JVMCIEntryProfiler's list the first time it records a call.
+// All fields start out as zero so that no static initializer is needed.
+struct JVMCIEntryProfile {
+  // Bucket 0 counts calls that took less than 1us, bucket i in
+  // [1, histogram_buckets - 2] those that took [2^(i-1), 2^i) us
+  // and the last bucket all the slower ones.
+  enum { histogram_buckets = 16 };
+
+  const char*                 _name;
+  JVMCIEntryProfile* volatile _next;
+  volatile jint               _registered;
+  volatile jlong              _count;
+  volatile jlong              _ticks;
+  volatile jlong              _max_ticks;
+  volatile jlong              _histogram[histogram_buckets];
+};
+
+// Aggregates the JVMCIEntryProfiles (see JVMCIProfileVMEntries). Time is
+// measured with FastUnorderedElapsedCounterSource which reads the time
+// stamp counter directly where that is reliable.
+class JVMCIEntryProfiler : AllStatic {
+  static JVMCIEntryProfile* volatile _profiles;
+
+  static void register_profile(JVMCIEntryProfile* profile);
+
+ public:
+  static void record(JVMCIEntryProfile* profile, JavaThread* thread, jlong ticks);
+
+  // Returns the head of the list of profiles that have recorded a call.
+  static JVMCIEntryProfile* profiles();
+
+  static jlong ticks_to_nanos(jlong ticks) {
+    return (jlong) FastUnorderedElapsedCounterSource::nanoseconds(ticks);
+  }
+
+  // Prints the profiles, slowest entry point first, followed by the
+  // totals of each thread that has called into the VM.
+  static void print_on(outputStream* st);
+
+  // Clears all statistics. Calls that are in progress may still
+  // be recorded after this returns.
+  static void reset();
+};
+
+// Times a CompilerToVM call and records it in a JVMCIEntryProfile.
+// Apart from a flag test, this costs nothing when JVMCIProfileVMEntries
+// is false.
+class JVMCIEntryProfileMark : public StackObj {
+  JVMCIEntryProfile* _profile;
+  JavaThread*        _thread;
+  jlong              _start;
+ public:
+  JVMCIEntryProfileMark(JVMCIEntryProfile* profile, JavaThread* thread) {
+    if (JVMCIProfileVMEntries) {
+      _profile = profile;
+      _thread = thread;
+      _start = FastUnorderedElapsedCounterSource::now();
+    } else {
+      _profile = NULL;
+    }
+  }
+  ~JVMCIEntryProfileMark() {
+    if (_profile != NULL) {
+      JVMCIEntryProfiler::record(_profile, _thread, FastUnorderedElapsedCounterSource::now() - _start);
+    }
+  }
+};
+
+#endif // SHARE_VM_JVMCI_JVMCIENTRYPROFILER_HPP
@@ -31,6 +31,7 @@
 #include "runtime/jniHandles.hpp"
 #include "runtime/javaCalls.hpp"
 #include "jvmci/jniAccessMark.inline.hpp"
+#include "jvmci/jvmciMirrorCache.hpp"
 #include "jvmci/jvmciRuntime.hpp"
 #ifdef INCLUDE_ALL_GCS
 #include "gc_implementation/g1/g1SATBCardTableModRefBS.hpp"
@@ -42,7 +43,10 @@ JVMCICompileState::JVMCICompileState(CompileTask* task, JVMCICompiler* compiler,
   _system_dictionary_modification_counter(system_dictionary_modification_counter),
   _failure_reason(NULL),
   _failure_reason_on_C_heap(false),
-  _retryable(true) {
+  _retryable(true),
+  _resource_area_base(JavaThread::current()->resource_area()->used()),
+  _resource_area_sampled_max(0),
+  _local_handle_blocks_sampled_max(0) {
   // Get Jvmti capabilities under lock to get consistent values.
   MutexLocker mu(JvmtiThreadState_lock);
   _jvmti_can_hotswap_or_post_breakpoint = JvmtiExport::can_hotswap_or_post_breakpoint() ? 1 : 0;
@@ -65,6 +69,20 @@ void JVMCICompileState::inc_compilation_ticks() {
   }
 }
 
+void JVMCICompileState::record_resource_usage(JavaThread* thread) {
+  size_t used = thread->resource_area()->used();
+  if (used > _resource_area_base && used - _resource_area_base > _resource_area_sampled_max) {
+    _resource_area_sampled_max = used - _resource_area_base;
+  }
+  JNIHandleBlock* handles = thread->active_handles();
+  if (handles != NULL) {
+    int blocks = handles->length();
+    if (blocks > _local_handle_blocks_sampled_max) {
+      _local_handle_blocks_sampled_max = blocks;
+    }
+  }
+}
+
 bool JVMCICompileState::jvmti_state_changed() const {
   if (!jvmti_can_access_local_variables() &&
       JvmtiExport::can_access_local_variables()) {
@@ -951,6 +969,17 @@ JVMCIObject JVMCIEnv::get_jvmci_method(const methodHandle& method, JVMCI_TRAPS)
   }
 
   JavaThread* THREAD = JVMCI::compilation_tick(JavaThread::current());
+  bool use_cache = UseJVMCIMirrorCache && is_hotspot();
+  if (use_cache) {
+    oop cached = _runtime->mirror_cache()->lookup(method());
+    if (cached != NULL) {
+      method_object = wrap(cached);
+      if (asMethod(method_object) == method()) {
+        return method_object;
+      }
+    }
+  }
+
   jmetadata handle = _runtime->allocate_handle(method);
   jboolean exception = false;
   if (is_hotspot()) {
@@ -983,6 +1012,9 @@ JVMCIObject JVMCIEnv::get_jvmci_method(const methodHandle& method, JVMCI_TRAPS)
     _runtime->release_handle(handle);
   }
   assert(!method_object.is_null(), "must be");
+  if (use_cache) {
+    _runtime->mirror_cache()->add(method(), Handle(THREAD, HotSpotJVMCI::resolve(method_object)));
+  }
   return method_object;
 }
 
@@ -995,6 +1027,16 @@ JVMCIObject JVMCIEnv::get_jvmci_type(const JVMCIKlassHandle& klass, JVMCI_TRAPS)
 
   jlong pointer = (jlong) klass();
   JavaThread* THREAD = JVMCI::compilation_tick(JavaThread::current());
+  bool use_cache = UseJVMCIMirrorCache && is_hotspot();
+  if (use_cache) {
+    oop cached = _runtime->mirror_cache()->lookup(klass());
+    if (cached != NULL) {
+      type = wrap(cached);
+      if (asKlass(type) == klass()) {
+        return type;
+      }
+    }
+  }
   JVMCIObject signature = create_string(klass->signature_name(), JVMCI_CHECK_(JVMCIObject()));
   jboolean exception = false;
   if (is_hotspot()) {
@@ -1026,6 +1068,9 @@ JVMCIObject JVMCIEnv::get_jvmci_type(const JVMCIKlassHandle& klass, JVMCI_TRAPS)
   }
 
   assert(type.is_non_null(), "must have result");
+  if (use_cache) {
+    _runtime->mirror_cache()->add(klass(), Handle(THREAD, HotSpotJVMCI::resolve(type)));
+  }
   return type;
 }
 
@@ -117,6 +117,18 @@ class JVMCICompileState : public ResourceObj {
   // some degree of JVMCI compilation occurred between the calls.
   jint             _compilation_ticks;
 
+  // The largest values seen by record_resource_usage for the bytes the
+  // compilation has in use in the compiler thread's resource area and for
+  // the number of JNI local handle blocks chained to the thread's active
+  // block. They are sampled on each compilation tick, on code installation
+  // and when JVMCIRuntime::compile_method returns, so usage that comes and
+  // goes between two samples is not seen. With UseJVMCINativeLibrary only
+  // the usage of the VM side of the compiler is measured; allocations in
+  // the shared library heap and its JNI handles are not.
+  size_t           _resource_area_base;
+  size_t           _resource_area_sampled_max;
+  int              _local_handle_blocks_sampled_max;
+
  public:
   JVMCICompileState(CompileTask* task, JVMCICompiler* compiler, int system_dictionary_modification_counter);
 
@@ -141,6 +153,11 @@ class JVMCICompileState : public ResourceObj {
 
   jint compilation_ticks() const { return _compilation_ticks; }
   void inc_compilation_ticks();
+
+  // Samples the resource usage of `thread`, the compiler thread.
+  void record_resource_usage(JavaThread* thread);
+  size_t resource_area_sampled_max() const { return _resource_area_sampled_max; }
+  int local_handle_blocks_sampled_max() const { return _local_handle_blocks_sampled_max; }
 };
 
 // This class is a top level wrapper around interactions between HotSpot
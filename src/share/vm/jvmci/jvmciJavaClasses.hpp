@@ -105,6 +105,7 @@
     primarray_field(HotSpotCompiledCode, targetCode, "[B")                                                    \
     int_field(HotSpotCompiledCode, targetCodeSize)                                                            \
     objectarray_field(HotSpotCompiledCode, sites, "[Ljdk/vm/ci/code/site/Site;")                              \
+    primarray_field(HotSpotCompiledCode, siteStream, "[B")                                                    \
     objectarray_field(HotSpotCompiledCode, assumptions, "[Ljdk/vm/ci/meta/Assumptions$Assumption;")           \
     objectarray_field(HotSpotCompiledCode, methods, "[Ljdk/vm/ci/meta/ResolvedJavaMethod;")                   \
     objectarray_field(HotSpotCompiledCode, comments, "[Ljdk/vm/ci/hotspot/HotSpotCompiledCode$Comment;")      \
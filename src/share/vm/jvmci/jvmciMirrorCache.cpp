@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "jvmci/jvmciMirrorCache.hpp"
+#include "runtime/atomic.inline.hpp"
+#include "runtime/jniHandles.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/orderAccess.inline.hpp"
+#include "runtime/safepoint.hpp"
+
+class JVMCIMirrorCacheEntry : public CHeapObj<mtJVMCI> {
+  friend class JVMCIMirrorCache;
+ private:
+  Metadata* _metadata;
+  jobject _mirror;              // weak global handle
+  JVMCIMirrorCacheEntry* _next;
+
+  JVMCIMirrorCacheEntry(Metadata* metadata, jobject mirror, JVMCIMirrorCacheEntry* next) :
+    _metadata(metadata), _mirror(mirror), _next(next) {}
+};
+
+JVMCIMirrorCache::JVMCIMirrorCache() {
+  _table_size = 1024;
+  _table = NEW_C_HEAP_ARRAY(JVMCIMirrorCacheEntry*, _table_size, mtJVMCI);
+  for (int i = 0; i < _table_size; i++) {
+    _table[i] = NULL;
+  }
+  _count = 0;
+  _purge_threshold = _table_size;
+  _lock = new Mutex(Mutex::leaf, "JVMCIMirrorCache_lock", true);
+  _hits = 0;
+  _misses = 0;
+}
+
+JVMCIMirrorCacheEntry* JVMCIMirrorCache::find(Metadata* metadata) {
+  int index = hash(metadata) % _table_size;
+  JVMCIMirrorCacheEntry* entry = (JVMCIMirrorCacheEntry*) OrderAccess::load_ptr_acquire(&_table[index]);
+  while (entry != NULL) {
+    if (entry->_metadata == metadata) {
+      return entry;
+    }
+    entry = entry->_next;
+  }
+  return NULL;
+}
+
+oop JVMCIMirrorCache::lookup(Metadata* metadata) {
+  JVMCIMirrorCacheEntry* entry = find(metadata);
+  oop mirror = entry != NULL ? JNIHandles::resolve(entry->_mirror) : (oop) NULL;
+  if (mirror != NULL) {
+    Atomic::inc(&_hits);
+  } else {
+    Atomic::inc(&_misses);
+  }
+  return mirror;
+}
+
+void JVMCIMirrorCache::add(Metadata* metadata, Handle mirror) {
+  jobject handle = JNIHandles::make_weak_global(mirror);
+  {
+    MutexLockerEx ml(_lock, Mutex::_no_safepoint_check_flag);
+    JVMCIMirrorCacheEntry* entry = find(metadata);
+    if (entry == NULL || JNIHandles::resolve(entry->_mirror) != mirror()) {
+      // A stale entry for the same key is shadowed by the new one
+      // until do_unloading removes it.
+      int index = hash(metadata) % _table_size;
+      entry = new JVMCIMirrorCacheEntry(metadata, handle, _table[index]);
+      OrderAccess::release_store_ptr(&_table[index], entry);
+      _count++;
+      return;
+    }
+  }
+  // Another thread cached the same mirror first
+  JNIHandles::destroy_weak_global(handle);
+}
+
+void JVMCIMirrorCache::resize(int new_size) {
+  JVMCIMirrorCacheEntry* volatile* new_table = NEW_C_HEAP_ARRAY(JVMCIMirrorCacheEntry*, new_size, mtJVMCI);
+  for (int i = 0; i < new_size; i++) {
+    new_table[i] = NULL;
+  }
+  for (int i = 0; i < _table_size; i++) {
+    JVMCIMirrorCacheEntry* entry = _table[i];
+    while (entry != NULL) {
+      JVMCIMirrorCacheEntry* next = entry->_next;
+      int index = hash(entry->_metadata) % new_size;
+      entry->_next = new_table[index];
+      new_table[index] = entry;
+      entry = next;
+    }
+  }
+  FREE_C_HEAP_ARRAY(JVMCIMirrorCacheEntry*, _table, mtJVMCI);
+  _table = new_table;
+  _table_size = new_size;
+}
+
+void JVMCIMirrorCache::do_unloading() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  for (int i = 0; i < _table_size; i++) {
+    JVMCIMirrorCacheEntry* prev = NULL;
+    JVMCIMirrorCacheEntry* entry = _table[i];
+    while (entry != NULL) {
+      JVMCIMirrorCacheEntry* next = entry->_next;
+      // The Metadata* of a cleared entry may already have been freed
+      // so only the handle can be examined.
+      if (JNIHandles::is_global_weak_cleared(entry->_mirror)) {
+        if (prev == NULL) {
+          _table[i] = next;
+        } else {
+          prev->_next = next;
+        }
+        JNIHandles::destroy_weak_global(entry->_mirror);
+        delete entry;
+        _count--;
+      } else {
+        prev = entry;
+      }
+      entry = next;
+    }
+  }
+  if (_count > 2 * _table_size) {
+    resize(2 * _table_size);
+  }
+  _purge_threshold = MAX2(2 * _count, _table_size);
+}
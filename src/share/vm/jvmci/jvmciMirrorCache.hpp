@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_VM_JVMCI_JVMCIMIRRORCACHE_HPP
+#define SHARE_VM_JVMCI_JVMCIMIRRORCACHE_HPP
+
+#include "memory/allocation.hpp"
+#include "oops/metadata.hpp"
+#include "runtime/handles.hpp"
+#include "runtime/mutex.hpp"
+
+class JVMCIMirrorCacheEntry;
+
+// Maps a Method* or Klass* to the HotSpotResolvedJavaMethodImpl or
+// HotSpotResolvedObjectTypeImpl mirror previously returned for it by
+// JVMCIEnv::get_jvmci_method or JVMCIEnv::get_jvmci_type. A hit saves the
+// call into HotSpotResolvedJavaMethodImpl.fromMetaspace or
+// HotSpotResolvedObjectTypeImpl.fromMetaspace (and for methods, the
+// allocation of a metadata handle) which is otherwise made for every
+// lookup, many of which come from the inliner asking for the same methods
+// over and over.
+//
+// Mirrors are referenced through weak global JNI handles so the cache does
+// not extend their lifetime. Since the Java code keeps the canonical mirror
+// reachable for as long as it can be returned by fromMetaspace, an entry
+// whose handle has been cleared can simply be treated as a miss. A mirror
+// strongly references the java.lang.Class of its (holder) class, so the
+// handles of all entries for an unloaded class are cleared by the time the
+// class is unloaded.
+//
+// Only mirrors in the HotSpot heap are cached. Mirrors in the JVMCI shared
+// library heap are referenced by JNI handles of the shared library JavaVM
+// which cannot be released from within a GC pause.
+//
+// Lookups do not take a lock. Entries are only ever prepended to a bucket
+// while the cache is in use and are only unlinked (and the table resized)
+// by do_unloading, which runs at a safepoint. Besides being called for every
+// GC that may unload classes, do_unloading is called as a safepoint cleanup
+// task once the cache has grown to twice its size after the previous purge,
+// which reclaims the entries whose mirrors were collected by young GCs.
+class JVMCIMirrorCache : public CHeapObj<mtJVMCI> {
+ private:
+  JVMCIMirrorCacheEntry* volatile* _table;
+  int _table_size;
+  int _count;
+  int _purge_threshold; // _count above which needs_purging() is true
+
+  Mutex* _lock; // Serializes insertions
+
+  volatile jint _hits;
+  volatile jint _misses;
+
+  static unsigned int hash(Metadata* metadata) {
+    uintptr_t value = (uintptr_t) metadata;
+    return (unsigned int) ((value >> LogBytesPerWord) ^ (value >> 16));
+  }
+
+  JVMCIMirrorCacheEntry* find(Metadata* metadata);
+  void resize(int new_size);
+
+ public:
+  JVMCIMirrorCache();
+
+  // Gets the mirror cached for `metadata` or NULL if there is none. The
+  // caller must still check that the returned mirror denotes `metadata`
+  // since the memory of an entry's Method* may have been reused after its
+  // mirror died.
+  oop lookup(Metadata* metadata);
+
+  // Caches `mirror` as the mirror of `metadata`.
+  void add(Metadata* metadata, Handle mirror);
+
+  // Removes the entries whose mirror has been garbage collected, which
+  // includes all entries for unloaded classes. Must be called at a safepoint.
+  void do_unloading();
+
+  // Determines if enough entries have been added since the last call to
+  // do_unloading to warrant purging the cache outside of a full GC.
+  bool needs_purging() const { return _count > _purge_threshold; }
+
+  int size() const   { return _count; }
+  jint hits() const  { return _hits; }
+  jint misses() const { return _misses; }
+};
+
+#endif // SHARE_VM_JVMCI_JVMCIMIRRORCACHE_HPP
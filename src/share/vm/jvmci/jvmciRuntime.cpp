@@ -24,7 +24,9 @@
 #include "precompiled.hpp"
 #include "compiler/compileBroker.hpp"
 #include "jvmci/jniAccessMark.inline.hpp"
+#include "jvmci/jvmciCompilationCache.hpp"
 #include "jvmci/jvmciCompilerToVM.hpp"
+#include "jvmci/jvmciMirrorCache.hpp"
 #include "jvmci/jvmciRuntime.hpp"
 #include "jvmci/metadataHandles.hpp"
 #include "memory/oopFactory.hpp"
@@ -781,6 +783,7 @@ JVMCIRuntime::JVMCIRuntime(int id) {
   _id = id;
   _object_handles = JNIHandleBlock::allocate_block();
   _metadata_handles = new MetadataHandles();
+  _mirror_cache = new JVMCIMirrorCache();
   JVMCI_event_1("created new JVMCI runtime %d (" PTR_FORMAT ")", id, p2i(this));
 }
 
@@ -801,18 +804,15 @@ bool JVMCIRuntime::is_global_handle(jobject handle) {
 }
 
 jmetadata JVMCIRuntime::allocate_handle(const methodHandle& handle) {
-  MutexLocker ml(JVMCI_lock);
   return _metadata_handles->allocate_handle(handle);
 }
 
 jmetadata JVMCIRuntime::allocate_handle(const constantPoolHandle& handle) {
-  MutexLocker ml(JVMCI_lock);
   return _metadata_handles->allocate_handle(handle);
 }
 
 void JVMCIRuntime::release_handle(jmetadata handle) {
-  MutexLocker ml(JVMCI_lock);
-  _metadata_handles->chain_free_list(handle);
+  _metadata_handles->release_handle(handle);
 }
 
 // Function for redirecting shared library JavaVM output to tty
@@ -1124,6 +1124,12 @@ void JVMCIRuntime::shutdown() {
     JVMCIENV->call_HotSpotJVMCIRuntime_shutdown(_HotSpotJVMCIRuntime_instance);
     JVMCI_event_1("shut down HotSpotJVMCIRuntime for JVMCI runtime %d", _id);
   }
+  JVMCI_event_1("metadata handles of JVMCI runtime %d: blocks=%d live=%d free=%d released=%d rebuilds=%d contended=%d",
+                _id, _metadata_handles->num_blocks(), _metadata_handles->num_live_handles(),
+                _metadata_handles->num_free_handles(), _metadata_handles->num_released_handles(),
+                _metadata_handles->num_rebuilds(), _metadata_handles->num_contended());
+  JVMCI_event_1("mirror cache of JVMCI runtime %d: entries=%d hits=%d misses=%d",
+                _id, _mirror_cache->size(), _mirror_cache->hits(), _mirror_cache->misses());
 }
 
 void JVMCIRuntime::bootstrap_finished(TRAPS) {
@@ -1579,6 +1585,7 @@ void JVMCIRuntime::compile_method(JVMCIEnv* JVMCIENV, JVMCICompiler* compiler, c
     // The only sensible thing to do here is to exit the VM.
     fatal_exception(JVMCIENV, "Exception during JVMCI compiler initialization");
   }
+  compile_state->record_resource_usage(JavaThread::current());
   if (compiler->is_bootstrapping()) {
     compiler->set_bootstrap_compilation_request_handled();
   }
@@ -1693,7 +1700,7 @@ JVMCI::CodeInstallResult JVMCIRuntime::register_method(JVMCIEnv* JVMCIENV,
         {
           MutexUnlocker ml(Compile_lock);
           MutexUnlocker locker(MethodCompileQueue_lock);
-          CompileBroker::handle_full_code_cache();
+          CompileBroker::handle_full_code_cache(CodeCache::get_code_blob_type(comp_level));
         }
       } else {
         nm->set_has_unsafe_access(has_unsafe_access);
@@ -1762,6 +1769,9 @@ JVMCI::CodeInstallResult JVMCIRuntime::register_method(JVMCIEnv* JVMCIENV,
   // JVMTI -- compiled method notification (must be done outside lock)
   if (nm != NULL) {
     nm->post_compiled_method_load_event();
+    if (install_default && JVMCICompilationCacheFile != NULL) {
+      JVMCICompilationCache::record(method, entry_bci);
+    }
   }
 
   return result;
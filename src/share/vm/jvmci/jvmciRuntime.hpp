@@ -33,6 +33,7 @@ class JVMCIEnv;
 class JVMCICompiler;
 class JVMCICompileState;
 class MetadataHandles;
+class JVMCIMirrorCache;
 
 // Encapsulates the JVMCI metadata for an nmethod.
 // JVMCINMethodData objects are inlined into nmethods
@@ -141,6 +142,9 @@ class JVMCIRuntime: public CHeapObj<mtJVMCI> {
   // Handles to Metadata objects.
   MetadataHandles* _metadata_handles;
 
+  // Mirrors returned by JVMCIEnv::get_jvmci_method and JVMCIEnv::get_jvmci_type.
+  JVMCIMirrorCache* _mirror_cache;
+
   JVMCIObject create_jvmci_primitive_type(BasicType type, JVMCI_TRAPS);
 
   // Implementation methods for loading and constant pool access.
@@ -218,6 +222,8 @@ class JVMCIRuntime: public CHeapObj<mtJVMCI> {
   jmetadata allocate_handle(const constantPoolHandle& handle);
   void release_handle(jmetadata handle);
 
+  JVMCIMirrorCache* mirror_cache() const { return _mirror_cache; }
+
   // Gets the HotSpotJVMCIRuntime instance for this runtime,
   // initializing it first if necessary.
   JVMCIObject get_HotSpotJVMCIRuntime(JVMCI_TRAPS);
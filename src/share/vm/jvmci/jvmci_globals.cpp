@@ -156,6 +156,8 @@ bool JVMCIGlobals::check_jvmci_flags_are_consistent() {
   CHECK_NOT_SET(PrintBootstrap,   UseJVMCICompiler)
   CHECK_NOT_SET(JVMCIThreads,     UseJVMCICompiler)
   CHECK_NOT_SET(JVMCIHostThreads, UseJVMCICompiler)
+  CHECK_NOT_SET(JVMCICompilationCacheFile, UseJVMCICompiler)
+  CHECK_NOT_SET(JVMCICompileQueueAgingPeriod, UseJVMCICompiler)
 
   if (UseJVMCICompiler) {
     if (!FLAG_IS_DEFAULT(EnableJVMCI) && !EnableJVMCI) {
@@ -185,12 +187,15 @@ bool JVMCIGlobals::check_jvmci_flags_are_consistent() {
   CHECK_NOT_SET(CodeInstallSafepointChecks,   EnableJVMCI)
   CHECK_NOT_SET(JVMCIEventLogLevel,           EnableJVMCI)
   CHECK_NOT_SET(JVMCITraceLevel,              EnableJVMCI)
+  CHECK_NOT_SET(JVMCIProfileVMEntries,        EnableJVMCI)
   CHECK_NOT_SET(JVMCICounterSize,             EnableJVMCI)
+  CHECK_NOT_SET(JVMCICountersSampleInterval,  EnableJVMCI)
   CHECK_NOT_SET(JVMCICountersExcludeCompiler, EnableJVMCI)
   CHECK_NOT_SET(JVMCIUseFastLocking,          EnableJVMCI)
   CHECK_NOT_SET(JVMCINMethodSizeLimit,        EnableJVMCI)
   CHECK_NOT_SET(MethodProfileWidth,           EnableJVMCI)
   CHECK_NOT_SET(JVMCIPrintProperties,         EnableJVMCI)
+  CHECK_NOT_SET(UseJVMCIMirrorCache,          EnableJVMCI)
   CHECK_NOT_SET(UseJVMCINativeLibrary,        EnableJVMCI)
   CHECK_NOT_SET(JVMCILibPath,                 EnableJVMCI)
   CHECK_NOT_SET(JVMCILibDumpJNIConfig,        EnableJVMCI)
@@ -80,6 +80,13 @@
           "Force number of C1 compiler threads. Ignored if "                \
           "UseJVMCICompiler is false.")                                     \
                                                                             \
+  product(intx, JVMCICompileQueueAgingPeriod, 0,                            \
+          "If non-zero, queued JVMCI compilations of hotter methods are "   \
+          "selected first unless a compilation has been queued for more "   \
+          "than this many milliseconds. 0 selects compilations in the "     \
+          "order they were queued. Only applies when TieredCompilation "    \
+          "is disabled.")                                                   \
+                                                                            \
   product(bool, CodeInstallSafepointChecks, true,                           \
           "Perform explicit safepoint checks while installing code")        \
                                                                             \
@@ -96,12 +103,21 @@
   product(intx, JVMCIEventLogLevel, 1,                                      \
           "Event log level for JVMCI")                                      \
                                                                             \
+  product(bool, JVMCIProfileVMEntries, false,                               \
+          "Record call counts and latency histograms for the CompilerToVM " \
+          "entry points (see Compiler.jvmci_vm_entries)")                   \
+                                                                            \
   product(intx, JVMCICounterSize, 0,                                        \
           "Reserved size for benchmark counters")                           \
                                                                             \
   product(bool, JVMCICountersExcludeCompiler, true,                         \
           "Exclude JVMCI compiler threads from benchmark counters")         \
                                                                             \
+  product(intx, JVMCICountersSampleInterval, 0,                             \
+          "Milliseconds between updates of the sun.ci.jvmci.counter.<n> "   \
+          "performance counters that publish the benchmark counters. "      \
+          "0 disables publishing")                                          \
+                                                                            \
   develop(bool, JVMCIUseFastLocking, true,                                  \
           "Use fast inlined locking code")                                  \
                                                                             \
@@ -121,6 +137,17 @@
           "Dumps to the given file a description of the classes, fields "   \
           "and methods the JVMCI shared library must provide")              \
                                                                             \
+  product(ccstr, JVMCICompilationCacheFile, NULL,                           \
+          "File in which the methods installed by the JVMCI compiler are "  \
+          "recorded at VM exit. Methods recorded by a previous run are "    \
+          "queued for compilation as soon as their holder is initialized, " \
+          "provided the holder's fingerprint still matches.")               \
+                                                                            \
+  product(bool, UseJVMCIMirrorCache, true,                                  \
+          "Cache the JVMCI mirrors of methods and types in the VM so that " \
+          "repeated lookups do not call into Java. Not used for the "       \
+          "JVMCI shared library (see UseJVMCINativeLibrary)")               \
+                                                                            \
   product(bool, UseJVMCINativeLibrary, false,                               \
           "Execute JVMCI Java code from a shared library "                  \
           "instead of loading it from class files and executing it "        \
@@ -23,9 +23,47 @@
 
 #include "precompiled.hpp"
 #include "jvmci/metadataHandles.hpp"
+#include "runtime/atomic.inline.hpp"
+#include "runtime/safepoint.hpp"
+
+jmetadata MetadataHandles::allocate_locked(Metadata* obj) {
+  if (!_lock->try_lock()) {
+    Atomic::inc(&_num_contended);
+    _lock->lock();
+  }
+  jmetadata handle = allocate_metadata_handle(obj);
+  _lock->unlock();
+  return handle;
+}
+
+void MetadataHandles::release_handle(HandleRecord* handle) {
+#ifdef METADATA_TRACK_NAMES
+  handle->set_name(NULL);
+#endif
+  intptr_t head;
+  do {
+    head = _released;
+    handle->set_value((Metadata*) (ptr_tag | head));
+  } while (Atomic::cmpxchg_ptr((intptr_t) handle, &_released, head) != head);
+  Atomic::inc(&_num_released);
+}
+
+void MetadataHandles::drain_released_handles() {
+  assert(_lock->owned_by_self(), "must hold lock");
+  // Taking the whole list at once means there is no ABA problem
+  // with concurrent pushes in release_handle.
+  intptr_t list = Atomic::xchg_ptr((intptr_t) 0, &_released);
+  while (list != 0) {
+    HandleRecord* handle = (HandleRecord*) list;
+    list = ptr_mask & (intptr_t) handle->value();
+    chain_free_list(handle);
+    Atomic::dec(&_num_released);
+  }
+}
 
 jmetadata MetadataHandles::allocate_metadata_handle(Metadata* obj) {
   assert(obj->is_valid() && obj->is_metadata(), "must be");
+  assert(_lock->owned_by_self(), "must hold lock");
 
   if (_head == NULL) {
     // This is the first allocation.
@@ -51,6 +89,12 @@ jmetadata MetadataHandles::allocate_metadata_handle(Metadata* obj) {
     return allocate_metadata_handle(obj);
   }
 
+  // Reuse handles released since the last drain
+  if (_released != 0) {
+    drain_released_handles();
+    return allocate_metadata_handle(obj);
+  }
+
   // No space available, we have to rebuild free list or expand
   if (_allocate_before_rebuild == 0) {
     rebuild_free_list(); // updates _allocate_before_rebuild counter
@@ -69,6 +113,7 @@ void MetadataHandles::rebuild_free_list() {
   assert(_allocate_before_rebuild == 0 && _free_list == 0, "just checking");
   int free = 0;
   int blocks = 0;
+  _num_rebuilds++;
   for (MetadataHandleBlock* current = _head; current != NULL; current = current->_next) {
     for (int index = 0; index < current->_top; index++) {
       HandleRecord* handle = &(current->_handles)[index];
@@ -94,13 +139,16 @@ void MetadataHandles::rebuild_free_list() {
     _allocate_before_rebuild = (extra + MetadataHandleBlock::block_size_in_handles - 1) / MetadataHandleBlock::block_size_in_handles;
   }
   if (TraceJNIHandleAllocation) {
-    tty->print_cr("Rebuild free list MetadataHandles " PTR_FORMAT " blocks=%d used=%d free=%d add=%d",
-                  p2i(this), blocks, total-free, free, _allocate_before_rebuild);
+    tty->print_cr("Rebuild free list MetadataHandles " PTR_FORMAT " blocks=%d used=%d free=%d add=%d contended=%d",
+                  p2i(this), blocks, total-free, free, _allocate_before_rebuild, _num_contended);
   }
 }
 
 void MetadataHandles::clear() {
+  MutexLockerEx ml(_lock, Mutex::_no_safepoint_check_flag);
   _free_list = 0;
+  _released = 0;
+  _num_released = 0;
   _last = _head;
   if (_head != NULL) {
     for (MetadataHandleBlock* block = _head; block != NULL; block = block->_next) {
@@ -132,14 +180,22 @@ void MetadataHandles::metadata_do(void f(Metadata*)) {
 
 // Visit any live metadata handles and clean them up.  Since clearing of these handles is driven by
 // weak references they will be cleared at some point in the future when the reference cleaning logic is run.
+// Handles already cleared are put on the free list, saving the next rebuild_free_list from having to find them.
 void MetadataHandles::do_unloading() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  int reclaimed = 0;
   for (MetadataHandleBlock* current = _head; current != NULL; current = current->_next) {
     for (int index = 0; index < current->_top; index++) {
       HandleRecord* handle = &(current->_handles)[index];
       Metadata* value = handle->value();
+      if (value == NULL) {
+        chain_free_list(handle);
+        reclaimed++;
+        continue;
+      }
       // traverse heap pointers only, not deleted handles or free list
       // pointers
-      if (value != NULL && ((intptr_t) value & ptr_tag) == 0) {
+      if (((intptr_t) value & ptr_tag) == 0) {
         Klass* klass = NULL;
         if (value->is_klass()) {
           klass = (Klass*)value;
@@ -171,4 +227,7 @@ void MetadataHandles::do_unloading() {
       break;
     }
   }
+  if (TraceJNIHandleAllocation && reclaimed > 0) {
+    tty->print_cr("Reclaimed %d cleared handles in MetadataHandles " PTR_FORMAT, reclaimed, p2i(this));
+  }
 }
@@ -28,6 +28,7 @@
 #include "oops/metadata.hpp"
 #include "oops/method.hpp"
 #include "runtime/handles.hpp"
+#include "runtime/mutex.hpp"
 #include "runtime/os.hpp"
 
 #ifdef ASSERT
@@ -78,7 +79,7 @@ class MetadataHandleBlock : public CHeapObj<mtJVMCI> {
   friend class MetadataHandles;
  private:
   enum SomeConstants {
-    block_size_in_handles  = 32 // Number of handles per handle block
+    block_size_in_handles  = 128 // Number of handles per handle block
   };
 
   // Free handles always have their low bit set so those pointers can
@@ -116,6 +117,11 @@ class MetadataHandleBlock : public CHeapObj<mtJVMCI> {
 // passed back to the Java code which is responsible for setting the handle to NULL when it
 // is no longer in use. This is done by jdk.vm.ci.hotspot.HandleCleaner. The
 // rebuild_free_list function notices when the handle is clear and reclaims it for re-use.
+// Cleared handles are also reclaimed by do_unloading as it walks the handles during GC.
+//
+// Allocation is guarded by a lock private to the MetadataHandles instance. Handles
+// explicitly released by the VM are pushed onto a lock-free list which is drained
+// into the free list by the next allocation that needs a handle.
 class MetadataHandles : public CHeapObj<mtJVMCI> {
  private:
   enum SomeConstants {
@@ -130,6 +136,12 @@ class MetadataHandles : public CHeapObj<mtJVMCI> {
   int              _num_blocks; // Number of blocks
   int             _num_handles;
   int        _num_free_handles;
+  int            _num_rebuilds; // Number of calls to rebuild_free_list
+
+  Mutex*                 _lock; // Guards allocation and the free list
+  volatile intptr_t  _released; // Handles released by release_handle, linked like _free_list
+  volatile jint  _num_released;
+  volatile jint _num_contended; // Number of allocations that found _lock held by another thread
 
   HandleRecord* get_free_handle() {
     HandleRecord* handle = (HandleRecord*) (_free_list & ptr_mask);
@@ -153,7 +165,11 @@ class MetadataHandles : public CHeapObj<mtJVMCI> {
   }
   void rebuild_free_list();
 
+  // Moves the handles on the released list to the free list.
+  void drain_released_handles();
+
   jmetadata allocate_metadata_handle(Metadata* metadata);
+  jmetadata allocate_locked(Metadata* metadata);
 
  public:
   MetadataHandles() {
@@ -164,14 +180,29 @@ class MetadataHandles : public CHeapObj<mtJVMCI> {
     _num_blocks = 0;
     _num_handles = 0;
     _num_free_handles = 0;
+    _num_rebuilds = 0;
+    _lock = new Mutex(Mutex::leaf, "MetadataHandles_lock", true);
+    _released = 0;
+    _num_released = 0;
+    _num_contended = 0;
   }
 
   int num_handles() const { return _num_handles; }
   int num_free_handles() const { return _num_free_handles; }
   int num_blocks() const { return _num_blocks; }
-
-  jmetadata allocate_handle(const methodHandle& handle)       { return allocate_metadata_handle(handle()); }
-  jmetadata allocate_handle(const constantPoolHandle& handle) { return allocate_metadata_handle(handle()); }
+  int num_rebuilds() const { return _num_rebuilds; }
+  int num_released_handles() const { return _num_released; }
+  int num_contended() const { return _num_contended; }
+  // Number of handles that are neither free nor waiting to be added to the
+  // free list. This includes handles cleared by the HandleCleaner that have
+  // not yet been reclaimed.
+  int num_live_handles() const { return _num_handles - _num_free_handles - _num_released; }
+
+  jmetadata allocate_handle(const methodHandle& handle)       { return allocate_locked(handle()); }
+  jmetadata allocate_handle(const constantPoolHandle& handle) { return allocate_locked(handle()); }
+
+  // Releases `handle` for re-use. This does not block.
+  void release_handle(HandleRecord* handle);
 
   // Adds `handle` to the free list
   void chain_free_list(HandleRecord* handle) {
@@ -194,6 +194,15 @@
   declare_constant(CodeInstaller::DEOPT_MH_HANDLER_ENTRY)                                         \
   declare_constant(CodeInstaller::INVOKE_INVALID)                                                 \
                                                                                                   \
+  declare_constant(CodeInstaller::SITE_CALL)                                                      \
+  declare_constant(CodeInstaller::SITE_SAFEPOINT)                                                 \
+  declare_constant(CodeInstaller::SITE_IMPLICIT_EXCEPTION)                                        \
+  declare_constant(CodeInstaller::SITE_IMPLICIT_EXCEPTION_DISPATCH)                               \
+  declare_constant(CodeInstaller::SITE_INFOPOINT)                                                 \
+  declare_constant(CodeInstaller::SITE_DATA_PATCH)                                                \
+  declare_constant(CodeInstaller::SITE_MARK)                                                      \
+  declare_constant(CodeInstaller::SITE_EXCEPTION_HANDLER)                                         \
+                                                                                                  \
   declare_constant(vmIntrinsics::FIRST_MH_SIG_POLY)                                               \
   declare_constant(vmIntrinsics::LAST_MH_SIG_POLY)                                                \
   declare_constant(vmIntrinsics::_invokeGeneric)                                                  \
@@ -535,7 +535,8 @@ void CardTableModRefBS::non_clean_card_iterate_serial(MemRegion mr,
           MemRegion dirty_region = cur_cards.intersection(mri);
           cl->do_MemRegion(dirty_region);
         }
-        cur_entry = next_entry;
+        // Skip the run of clean cards up to the next non-clean one.
+        cur_entry = find_last_non_clean_card(limit, next_entry + 1);
       }
     }
   }
@@ -647,6 +648,74 @@ MemRegion CardTableModRefBS::dirty_card_range_after_reset(MemRegion mr,
   return MemRegion(mr.end(), mr.end());
 }
 
+jbyte* CardTableModRefBS::find_first_non_clean_card(jbyte* start, jbyte* end) {
+  jbyte* cur = start;
+  // Test card by card up to the first row boundary.
+  while (cur < end && !is_ptr_aligned(cur, BytesPerWord)) {
+    if (*cur != clean_card) {
+      return cur;
+    }
+    cur++;
+  }
+  // Skip whole blocks of clean rows. The rows of a block are combined
+  // with a bitwise and, which keeps all bits set only if every card of
+  // the block is clean. The loop body has no branch per row, so the
+  // compiler is free to use the widest loads available.
+  const size_t block_size = clean_card_block_rows * BytesPerWord;
+  while (pointer_delta(end, cur, sizeof(jbyte)) >= block_size) {
+    const intptr_t* row = (const intptr_t*) cur;
+    intptr_t all_rows = row[0];
+    for (size_t i = 1; i < clean_card_block_rows; i++) {
+      all_rows &= row[i];
+    }
+    if (all_rows != clean_card_row) {
+      break;
+    }
+    cur += block_size;
+  }
+  // Narrow down to the row, and then to the card.
+  while (pointer_delta(end, cur, sizeof(jbyte)) >= (size_t) BytesPerWord &&
+         *(intptr_t*) cur == clean_card_row) {
+    cur += BytesPerWord;
+  }
+  while (cur < end && *cur == clean_card) {
+    cur++;
+  }
+  return cur;
+}
+
+jbyte* CardTableModRefBS::find_last_non_clean_card(jbyte* start, jbyte* end) {
+  // "cur" is one past the next card to test.
+  jbyte* cur = end;
+  while (cur > start && !is_ptr_aligned(cur, BytesPerWord)) {
+    if (cur[-1] != clean_card) {
+      return cur - 1;
+    }
+    cur--;
+  }
+  // See find_first_non_clean_card().
+  const size_t block_size = clean_card_block_rows * BytesPerWord;
+  while (pointer_delta(cur, start, sizeof(jbyte)) >= block_size) {
+    const intptr_t* row = (const intptr_t*) (cur - block_size);
+    intptr_t all_rows = row[0];
+    for (size_t i = 1; i < clean_card_block_rows; i++) {
+      all_rows &= row[i];
+    }
+    if (all_rows != clean_card_row) {
+      break;
+    }
+    cur -= block_size;
+  }
+  while (pointer_delta(cur, start, sizeof(jbyte)) >= (size_t) BytesPerWord &&
+         *(intptr_t*) (cur - BytesPerWord) == clean_card_row) {
+    cur -= BytesPerWord;
+  }
+  while (cur > start && cur[-1] == clean_card) {
+    cur--;
+  }
+  return cur - 1;
+}
+
 uintx CardTableModRefBS::ct_max_alignment_constraint() {
   return card_size * os::vm_page_size();
 }
@@ -713,3 +782,91 @@ bool CardTableModRefBSForCTRS::card_may_have_been_dirty(jbyte cv) {
     (CardTableModRefBS::card_may_have_been_dirty(cv) ||
      CardTableRS::youngergen_may_have_been_dirty(cv));
 };
+
+#ifndef PRODUCT
+// Compares the searches for non-clean cards against a card by card
+// search on synthetic card tables of different dirtiness. With
+// -XX:+Verbose it also reports how long walking all non-clean cards of
+// each table takes with either kind of search.
+void CardTableModRefBS::test_find_non_clean_card() {
+  const size_t num_cards = 64 * K;
+  const int num_walks = 100;
+  // On average one in this many cards is not clean; 0 means all are clean.
+  const uint one_in[] = { 0, 16 * K, K, 64, 8, 1 };
+
+  jbyte* table = NEW_C_HEAP_ARRAY(jbyte, num_cards, mtGC);
+  // Leave a few cards at either end out to exercise unaligned bounds.
+  jbyte* const start = table + 3;
+  jbyte* const end = table + num_cards - 5;
+
+  for (size_t t = 0; t < ARRAY_SIZE(one_in); t++) {
+    memset(table, clean_card, num_cards);
+    if (one_in[t] != 0) {
+      for (size_t i = 0; i < num_cards; i++) {
+        if (os::random() % one_in[t] == 0) {
+          table[i] = (i % 2 == 0) ? dirty_card : claimed_card;
+        }
+      }
+    }
+
+    size_t num_found = 0;
+    jbyte* cur = start;
+    while (true) {
+      jbyte* expected = cur;
+      while (expected < end && *expected == clean_card) {
+        expected++;
+      }
+      jbyte* found = find_first_non_clean_card(cur, end);
+      guarantee(found == expected, "forward search found the wrong card");
+      if (found == end) {
+        break;
+      }
+      num_found++;
+      cur = found + 1;
+    }
+
+    cur = end;
+    while (true) {
+      jbyte* expected = cur - 1;
+      while (expected >= start && *expected == clean_card) {
+        expected--;
+      }
+      jbyte* found = find_last_non_clean_card(start, cur);
+      guarantee(found == expected, "backward search found the wrong card");
+      if (found < start) {
+        break;
+      }
+      num_found--;
+      cur = found;
+    }
+    guarantee(num_found == 0, "searches disagree on the number of non-clean cards");
+
+    if (Verbose) {
+      size_t visited = 0;
+      jlong begin = os::elapsed_counter();
+      for (int w = 0; w < num_walks; w++) {
+        for (jbyte* c = find_first_non_clean_card(start, end); c < end;
+             c = find_first_non_clean_card(c + 1, end)) {
+          visited++;
+        }
+      }
+      jlong search_ticks = os::elapsed_counter() - begin;
+      begin = os::elapsed_counter();
+      for (int w = 0; w < num_walks; w++) {
+        for (jbyte* c = start; c < end; c++) {
+          if (*c != clean_card) {
+            visited++;
+          }
+        }
+      }
+      jlong naive_ticks = os::elapsed_counter() - begin;
+      double freq = (double) os::elapsed_frequency();
+      tty->print_cr("  1 in %6u cards non-clean: search %8.3f ms, card by card %8.3f ms ("
+                    SIZE_FORMAT " visits)",
+                    one_in[t], search_ticks * 1000.0 / freq, naive_ticks * 1000.0 / freq, visited);
+    }
+  }
+
+  FREE_C_HEAP_ARRAY(jbyte, table, mtGC);
+}
+#endif
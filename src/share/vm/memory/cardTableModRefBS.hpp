@@ -75,6 +75,10 @@ class CardTableModRefBS: public ModRefBarrierSet {
   // a word's worth (row) of clean card values
   static const intptr_t clean_card_row = (intptr_t)(-1);
 
+  // Number of rows the searches for non-clean cards check at once
+  // while skipping clean spans.
+  static const size_t clean_card_block_rows = 8;
+
   // dirty and precleaned are equivalent wrt younger_refs_iter.
   static bool card_is_dirty_wrt_gen_iter(jbyte cv) {
     return cv == dirty_card || cv == precleaned_card;
@@ -410,6 +414,16 @@ public:
 
   static uintx ct_max_alignment_constraint();
 
+  // Return the first card in [start, end) that is not clean, or "end" if
+  // there is none.  Clean spans are skipped several words at a time,
+  // which is much faster than testing card by card when dirty cards are
+  // sparse.
+  static jbyte* find_first_non_clean_card(jbyte* start, jbyte* end);
+
+  // Return the last card in [start, end) that is not clean, or "start - 1"
+  // if there is none.
+  static jbyte* find_last_non_clean_card(jbyte* start, jbyte* end);
+
   // Apply closure "cl" to the dirty cards containing some part of
   // MemRegion "mr".
   void dirty_card_iterate(MemRegion mr, MemRegionClosure* cl);
@@ -471,6 +485,9 @@ public:
     return ParGCCardsPerStrideChunk * card_size_in_words;
   }
 
+#ifndef PRODUCT
+  static void test_find_non_clean_card();
+#endif
 };
 
 class CardTableRS;
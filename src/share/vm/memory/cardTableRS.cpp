@@ -186,10 +186,6 @@ ClearNoncleanCardWrapper::ClearNoncleanCardWrapper(
             SharedHeap::heap()->workers()->active_workers()), "Mismatch");
 }
 
-bool ClearNoncleanCardWrapper::is_word_aligned(jbyte* entry) {
-  return (((intptr_t)entry) & (BytesPerWord-1)) == 0;
-}
-
 void ClearNoncleanCardWrapper::do_MemRegion(MemRegion mr) {
   assert(mr.word_size() > 0, "Error");
   assert(_ct->is_aligned(mr.start()), "mr.start() should be card aligned");
@@ -212,15 +208,9 @@ void ClearNoncleanCardWrapper::do_MemRegion(MemRegion mr) {
         _dirty_card_closure->do_MemRegion(mrd);
       }
 
-      // fast forward through potential continuous whole-word range of clean cards beginning at a word-boundary
-      if (is_word_aligned(cur_entry)) {
-        jbyte* cur_row = cur_entry - BytesPerWord;
-        while (cur_row >= limit && *((intptr_t*)cur_row) ==  CardTableRS::clean_card_row()) {
-          cur_row -= BytesPerWord;
-        }
-        cur_entry = cur_row + BytesPerWord;
-        cur_hw = _ct->addr_for(cur_entry);
-      }
+      // fast forward through the range of clean cards below cur_entry
+      cur_entry = CardTableModRefBS::find_last_non_clean_card((jbyte*)limit, cur_entry) + 1;
+      cur_hw = _ct->addr_for(cur_entry);
 
       // Reset the dirty window, while continuing to look
       // for the next dirty card that will start a
@@ -35,14 +35,24 @@ size_t CodeHeap::header_size() {
 
 // Implementation of Heap
 
-CodeHeap::CodeHeap() {
+CodeHeap::CodeHeap(const char* name, int code_blob_type) {
+  _name                         = name;
+  _code_blob_type               = code_blob_type;
   _number_of_committed_segments = 0;
   _number_of_reserved_segments  = 0;
   _segment_size                 = 0;
   _log2_segment_size            = 0;
   _next_segment                 = 0;
-  _freelist                     = NULL;
+  for (int i = 0; i < freelist_bins; i++) {
+    _freelist[i]                = NULL;
+  }
+  _freelist_bin_map             = 0;
   _freelist_segments            = 0;
+  _freelist_length              = 0;
+  _blob_count                   = 0;
+  _nmethod_count                = 0;
+  _adapter_count                = 0;
+  _full_count                   = 0;
 }
 
 
@@ -72,6 +82,26 @@ void CodeHeap::mark_segmap_as_used(size_t beg, size_t end) {
 }
 
 
+// Joins the block starting at segment joined to the block starting at beg.
+// Only the first entry of the joined block needs to change: it now refers
+// back into the block at beg, so that a find_start walk from anywhere in the
+// joined block continues to beg. This keeps merging free blocks O(1).
+void CodeHeap::mark_segmap_as_joined(size_t beg, size_t joined) {
+  assert(beg < joined && joined < _number_of_committed_segments, "interval out of bounds");
+  address p = (address)_segmap.low() + joined;
+  *p = (u1)MIN2(joined - beg, (size_t)0xFE);
+}
+
+
+// Returns the used or free block that contains segment i
+HeapBlock* CodeHeap::block_containing(size_t i) const {
+  address b = (address)_segmap.low();
+  assert(b[i] != 0xFF, "segment must belong to a block");
+  while (b[i] > 0) i -= (int)b[i];
+  return block_at(i);
+}
+
+
 static size_t align_to_page_size(size_t size) {
   const size_t alignment = (size_t)os::vm_page_size();
   assert(is_power_of_2(alignment), "no kidding ???");
@@ -87,30 +117,24 @@ void CodeHeap::on_code_mapping(char* base, size_t size) {
 }
 
 
-bool CodeHeap::reserve(size_t reserved_size, size_t committed_size,
-                       size_t segment_size) {
-  assert(reserved_size >= committed_size, "reserved < committed");
+bool CodeHeap::reserve(ReservedSpace rs, size_t committed_size, size_t segment_size) {
+  assert(rs.size() >= committed_size, "reserved < committed");
   assert(segment_size >= sizeof(FreeBlock), "segment size is too small");
   assert(is_power_of_2(segment_size), "segment_size must be a power of 2");
 
   _segment_size      = segment_size;
   _log2_segment_size = exact_log2(segment_size);
 
-  // Reserve and initialize space for _memory.
+  // Initialize space for _memory from the given reservation.
   size_t page_size = os::vm_page_size();
   if (os::can_execute_large_page_memory()) {
-    page_size = os::page_size_for_region_unaligned(reserved_size, 8);
+    page_size = os::page_size_for_region_unaligned(rs.size(), 8);
   }
 
   const size_t granularity = os::vm_allocation_granularity();
-  const size_t r_align = MAX2(page_size, granularity);
-  const size_t r_size = align_size_up(reserved_size, r_align);
   const size_t c_size = align_size_up(committed_size, page_size);
 
-  const size_t rs_align = page_size == (size_t) os::vm_page_size() ? 0 :
-    MAX2(page_size, granularity);
-  ReservedCodeSpace rs(r_size, rs_align, rs_align > 0);
-  os::trace_page_sizes("code heap", committed_size, reserved_size, page_size,
+  os::trace_page_sizes(_name, committed_size, rs.size(), page_size,
                        rs.base(), rs.size());
   if (!_memory.initialize(rs, c_size)) {
     return false;
@@ -177,6 +201,12 @@ void CodeHeap::shrink_by(size_t size) {
 
 void CodeHeap::clear() {
   _next_segment = 0;
+  for (int i = 0; i < freelist_bins; i++) {
+    _freelist[i] = NULL;
+  }
+  _freelist_bin_map  = 0;
+  _freelist_segments = 0;
+  _freelist_length   = 0;
   mark_segmap_as_free(0, _number_of_committed_segments);
 }
 
@@ -195,6 +225,7 @@ void* CodeHeap::allocate(size_t instance_size, bool is_critical) {
 #ifdef ASSERT
     memset((void *)block->allocated_space(), badCodeHeapNewVal, instance_size);
 #endif
+    _blob_count++;
     return block->allocated_space();
   }
 
@@ -220,6 +251,7 @@ void* CodeHeap::allocate(size_t instance_size, bool is_critical) {
 #ifdef ASSERT
     memset((void *)b->allocated_space(), badCodeHeapNewVal, instance_size);
 #endif
+    _blob_count++;
     return b->allocated_space();
   } else {
     return NULL;
@@ -238,6 +270,7 @@ void CodeHeap::deallocate(void* p) {
          segments_to_size(b->length()) - sizeof(HeapBlock));
 #endif
   add_to_freelist(b);
+  _blob_count--;
 
   debug_only(if (VerifyCodeCacheOften) verify());
 }
@@ -252,8 +285,7 @@ void* CodeHeap::find_start(void* p) const {
   if (b[i] == 0xFF) {
     return NULL;
   }
-  while (b[i] > 0) i -= (int)b[i];
-  HeapBlock* h = block_at(i);
+  HeapBlock* h = block_containing(i);
   if (h->free()) {
     return NULL;
   }
@@ -327,143 +359,209 @@ size_t CodeHeap::heap_unallocated_capacity() const {
 
 // Free list management
 
-FreeBlock *CodeHeap::following_block(FreeBlock *b) {
+// Returns the bin holding free blocks of the given length
+size_t CodeHeap::freelist_bin(size_t length) {
+  assert(length > 0, "no empty blocks");
+  if (length < freelist_small_bins) {
+    return length;
+  }
+  size_t bin = freelist_small_bins + log2_intptr((uintptr_t)length) - log2_freelist_small_bins;
+  return MIN2(bin, (size_t)freelist_bins - 1);
+}
+
+FreeBlock *CodeHeap::following_block(FreeBlock *b) const {
   return (FreeBlock*)(((address)b) + _segment_size * b->length());
 }
 
-// Inserts block b after a
-void CodeHeap::insert_after(FreeBlock* a, FreeBlock* b) {
-  assert(a != NULL && b != NULL, "must be real pointers");
+void CodeHeap::add_to_bin(FreeBlock* b) {
+  assert(b->free(), "must be a free block");
+  size_t bin = freelist_bin(b->length());
+  b->set_prev(NULL);
+  b->set_link(_freelist[bin]);
+  if (_freelist[bin] != NULL) {
+    _freelist[bin]->set_prev(b);
+  }
+  _freelist[bin] = b;
+  _freelist_bin_map |= (julong)1 << bin;
+  _freelist_length++;
+}
 
-  // Link b into the list after a
-  b->set_link(a->link());
-  a->set_link(b);
+void CodeHeap::remove_from_bin(FreeBlock* b) {
+  assert(b->free(), "must be a free block");
+  size_t bin = freelist_bin(b->length());
+  if (b->prev() == NULL) {
+    assert(_freelist[bin] == b, "must be first in its bin");
+    _freelist[bin] = b->link();
+    if (_freelist[bin] == NULL) {
+      _freelist_bin_map &= ~((julong)1 << bin);
+    }
+  } else {
+    b->prev()->set_link(b->link());
+  }
+  if (b->link() != NULL) {
+    b->link()->set_prev(b->prev());
+  }
+  _freelist_length--;
+}
 
-  // See if we can merge blocks
-  merge_right(b); // Try to make b bigger
-  merge_right(a); // Try to make a include b
+// Returns the index of the lowest bit set in map
+static size_t lowest_bin(julong map) {
+  assert(map != 0, "no bin set");
+  size_t bin = 0;
+  if ((map & CONST64(0xFFFFFFFF)) == 0) { bin += 32; map >>= 32; }
+  if ((map & CONST64(0xFFFF)) == 0)     { bin += 16; map >>= 16; }
+  if ((map & CONST64(0xFF)) == 0)       { bin +=  8; map >>=  8; }
+  if ((map & CONST64(0xF)) == 0)        { bin +=  4; map >>=  4; }
+  if ((map & CONST64(0x3)) == 0)        { bin +=  2; map >>=  2; }
+  if ((map & CONST64(0x1)) == 0)        { bin +=  1; }
+  return bin;
 }
 
-// Try to merge this block with the following block
+// Returns the first block of the bin that can hold length segments, or NULL.
+// The scan stops at the first fitting block. It only passes over blocks that
+// are too short, which can only be in the request's own large bin, and, for
+// non critical requests, blocks that end in the reserved last part of the
+// code heap. There are at most CodeCacheMinimumFreeSpace /
+// (CodeCacheMinBlockLength * CodeCacheSegmentSize) of the latter.
+FreeBlock* CodeHeap::search_bin(size_t bin, size_t length, bool is_critical) const {
+  // Non critical allocations are not allowed to use the last part of the code heap.
+  // Allocations are carved from the end of a free block, so check where it ends.
+  const char* limit = is_critical ? high_boundary() : high_boundary() - CodeCacheMinimumFreeSpace;
+  for (FreeBlock* cur = _freelist[bin]; cur != NULL; cur = cur->link()) {
+    if (cur->length() >= length && (const char*)following_block(cur) <= limit) {
+      return cur;
+    }
+  }
+  return NULL;
+}
+
+// Merges a with the following block if that one is free. The length of a
+// changes, so a must not be on a freelist.
 void CodeHeap::merge_right(FreeBlock *a) {
   assert(a->free(), "must be a free block");
-  if (following_block(a) == a->link()) {
-    assert(a->link() != NULL && a->link()->free(), "must be free too");
-    // Update block a to include the following block
-    a->set_length(a->length() + a->link()->length());
-    a->set_link(a->link()->link());
-    // Update find_start map
-    size_t beg = segment_for(a);
-    mark_segmap_as_used(beg, beg + a->length());
+  size_t beg = segment_for(a);
+  size_t next = beg + a->length();
+  if (next < _next_segment && block_at(next)->free()) {
+    FreeBlock* b = (FreeBlock*)block_at(next);
+    remove_from_bin(b);
+    a->set_length(a->length() + b->length());
+    mark_segmap_as_joined(beg, next);
   }
 }
 
 void CodeHeap::add_to_freelist(HeapBlock *a) {
   FreeBlock* b = (FreeBlock*)a;
-  assert(b != _freelist, "cannot be removed twice");
+  assert(!b->free(), "cannot be removed twice");
 
   // Mark as free and update free space count
   _freelist_segments += b->length();
   b->set_free();
 
-  // First element in list?
-  if (_freelist == NULL) {
-    _freelist = b;
-    b->set_link(NULL);
-    return;
-  }
-
-  // Scan for right place to put into list. List
-  // is sorted by increasing addresseses
-  FreeBlock* prev = NULL;
-  FreeBlock* cur  = _freelist;
-  while(cur != NULL && cur < b) {
-    assert(prev == NULL || prev < cur, "must be ordered");
-    prev = cur;
-    cur  = cur->link();
-  }
-
-  assert( (prev == NULL && b < _freelist) ||
-          (prev < b && (cur == NULL || b < cur)), "list must be ordered");
-
-  if (prev == NULL) {
-    // Insert first in list
-    b->set_link(_freelist);
-    _freelist = b;
-    merge_right(_freelist);
-  } else {
-    insert_after(prev, b);
+  // Merge with the neighbouring free blocks so that there is at most one
+  // free block between two used ones
+  merge_right(b);
+  size_t beg = segment_for(b);
+  if (beg > 0) {
+    HeapBlock* prev = block_containing(beg - 1);
+    if (prev->free()) {
+      FreeBlock* left = (FreeBlock*)prev;
+      remove_from_bin(left);
+      left->set_length(left->length() + b->length());
+      mark_segmap_as_joined(segment_for(left), beg);
+      b = left;
+    }
   }
+  add_to_bin(b);
 }
 
-// Search freelist for an entry on the list with the best fit
+// Search the freelist for a block that fits length segments
 // Return NULL if no one was found
 FreeBlock* CodeHeap::search_freelist(size_t length, bool is_critical) {
-  FreeBlock *best_block = NULL;
-  FreeBlock *best_prev  = NULL;
-  size_t best_length = 0;
-
-  // Search for smallest block which is bigger than length
-  FreeBlock *prev = NULL;
-  FreeBlock *cur = _freelist;
-  while(cur != NULL) {
-    size_t l = cur->length();
-    if (l >= length && (best_block == NULL || best_length > l)) {
-
-      // Non critical allocations are not allowed to use the last part of the code heap.
-      if (!is_critical) {
-        // Make sure the end of the allocation doesn't cross into the last part of the code heap
-        if (((size_t)cur + length) > ((size_t)high_boundary() - CodeCacheMinimumFreeSpace)) {
-          // the freelist is sorted by address - if one fails, all consecutive will also fail.
-          break;
-        }
-      }
-
-      // Remember best block, its previous element, and its length
-      best_block = cur;
-      best_prev  = prev;
-      best_length = best_block->length();
-    }
-
-    // Next element in list
-    prev = cur;
-    cur  = cur->link();
+  size_t bin = freelist_bin(length);
+  FreeBlock* best_block = NULL;
+
+  // Every block in a bin above the one of the request is long enough, so
+  // the lowest non-empty such bin holds a good fit. Small bins contain
+  // blocks of a single length, so the request's own bin qualifies as well.
+  // The bin map yields the next non-empty bin without visiting empty ones.
+  size_t first = (bin < freelist_small_bins) ? bin : bin + 1;
+  julong map = (first < freelist_bins) ? (_freelist_bin_map & (~CONST64(0) << first)) : 0;
+  while (map != 0 && best_block == NULL) {
+    best_block = search_bin(lowest_bin(map), length, is_critical);
+    map &= map - 1;
+  }
+  if (best_block == NULL && bin >= freelist_small_bins) {
+    // Blocks in the request's own large bin may be too short
+    best_block = search_bin(bin, length, is_critical);
   }
-
   if (best_block == NULL) {
     // None found
     return NULL;
   }
 
-  assert((best_prev == NULL && _freelist == best_block ) ||
-         (best_prev != NULL && best_prev->link() == best_block), "sanity check");
+  remove_from_bin(best_block);
+  size_t best_length = best_block->length();
 
   // Exact (or at least good enough) fit. Remove from list.
   // Don't leave anything on the freelist smaller than CodeCacheMinBlockLength.
   if (best_length < length + CodeCacheMinBlockLength) {
     length = best_length;
-    if (best_prev == NULL) {
-      assert(_freelist == best_block, "sanity check");
-      _freelist = _freelist->link();
-    } else {
-      // Unmap element
-      best_prev->set_link(best_block->link());
-    }
   } else {
     // Truncate block and return a pointer to the following block
     best_block->set_length(best_length - length);
+    add_to_bin(best_block);
     best_block = following_block(best_block);
-    // Set used bit and length on new block
-    size_t beg = segment_for(best_block);
-    mark_segmap_as_used(beg, beg + length);
-    best_block->set_length(length);
   }
 
+  // Set used bit and length on new block. Rebuild its part of the segment
+  // map, which may still refer to blocks merged into it.
+  size_t beg = segment_for(best_block);
+  mark_segmap_as_used(beg, beg + length);
+  best_block->set_length(length);
   best_block->set_used();
   _freelist_segments -= length;
   return best_block;
 }
 
+// Prints the number of free blocks per bin and the external fragmentation,
+// i.e. the share of the free space that is not part of the largest free
+// block. The unallocated end of the heap counts as one free block.
+void CodeHeap::print_freelist_statistics(outputStream* st) const {
+  size_t largest = _number_of_committed_segments - _next_segment;
+  size_t free_segments = _freelist_segments + largest;
+  for (int bin = 0; bin < freelist_bins; bin++) {
+    for (FreeBlock* b = _freelist[bin]; b != NULL; b = b->link()) {
+      largest = MAX2(largest, b->length());
+    }
+  }
+  double fragmentation = (free_segments == 0) ? 0.0 :
+      100.0 * (double)(free_segments - largest) / (double)free_segments;
+
+  st->print_cr("%s: high_water=" SIZE_FORMAT "Kb free=" SIZE_FORMAT "Kb free_blocks=" SIZE_FORMAT
+               " free_in_blocks=" SIZE_FORMAT "Kb largest_free=" SIZE_FORMAT "Kb fragmentation=%3.1f%%",
+               _name, segments_to_size(_next_segment)/K, segments_to_size(free_segments)/K, _freelist_length,
+               segments_to_size(_freelist_segments)/K, segments_to_size(largest)/K, fragmentation);
+  for (int bin = 0; bin < freelist_bins; bin++) {
+    if (_freelist[bin] == NULL) {
+      continue;
+    }
+    size_t count = 0;
+    size_t segments = 0;
+    for (FreeBlock* b = _freelist[bin]; b != NULL; b = b->link()) {
+      count++;
+      segments += b->length();
+    }
+    if (bin < freelist_small_bins) {
+      st->print_cr("  " SIZE_FORMAT_W(8) " segments: " SIZE_FORMAT_W(8) " blocks " SIZE_FORMAT_W(8) "Kb",
+                   (size_t)bin, count, segments_to_size(segments)/K);
+    } else {
+      size_t low = (size_t)1 << (bin - freelist_small_bins + log2_freelist_small_bins);
+      st->print_cr(" >=" SIZE_FORMAT_W(8) " segments: " SIZE_FORMAT_W(8) " blocks " SIZE_FORMAT_W(8) "Kb",
+                   low, count, segments_to_size(segments)/K);
+    }
+  }
+}
+
 //----------------------------------------------------------------------------
 // Non-product code
 
@@ -480,13 +578,18 @@ void CodeHeap::verify() {
   // represented.
   int count = 0;
   size_t len = 0;
-  for(FreeBlock* b = _freelist; b != NULL; b = b->link()) {
-    len += b->length();
-    count++;
+  for (int bin = 0; bin < freelist_bins; bin++) {
+    assert((_freelist[bin] != NULL) == ((_freelist_bin_map & ((julong)1 << bin)) != 0), "bin map out of sync");
+    for (FreeBlock* b = _freelist[bin]; b != NULL; b = b->link()) {
+      assert(b->free() && freelist_bin(b->length()) == (size_t)bin, "block in wrong bin");
+      len += b->length();
+      count++;
+    }
   }
 
   // Verify that freelist contains the right amount of free space
-  //  guarantee(len == _freelist_segments, "wrong freelist");
+  guarantee(len == _freelist_segments, "wrong freelist");
+  guarantee((size_t)count == _freelist_length, "wrong freelist length");
 
   // Verify that the number of free blocks is not out of hand.
   static int free_block_threshold = 10000;
@@ -501,5 +604,5 @@ void CodeHeap::verify() {
   for(HeapBlock *h = first_block(); h != NULL; h = next_block(h)) {
     if (h->free()) count--;
   }
-  //  guarantee(count == 0, "missing free blocks");
+  guarantee(count == 0, "missing free blocks");
 }
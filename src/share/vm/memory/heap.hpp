@@ -64,10 +64,11 @@ class FreeBlock: public HeapBlock {
   friend class VMStructs;
  protected:
   FreeBlock* _link;
+  FreeBlock* _prev;
 
  public:
   // Initialization
-  void initialize(size_t length)             { HeapBlock::initialize(length); _link= NULL; }
+  void initialize(size_t length)             { HeapBlock::initialize(length); _link = NULL; _prev = NULL; }
 
   // Merging
   void set_length(size_t l)                  { _header._length = l; }
@@ -75,11 +76,16 @@ class FreeBlock: public HeapBlock {
   // Accessors
   FreeBlock* link() const                    { return _link; }
   void set_link(FreeBlock* link)             { _link = link; }
+  FreeBlock* prev() const                    { return _prev; }
+  void set_prev(FreeBlock* prev)             { _prev = prev; }
 };
 
 class CodeHeap : public CHeapObj<mtCode> {
   friend class VMStructs;
  private:
+  const char*  _name;                            // name of the heap, used for printing and memory pools
+  int          _code_blob_type;                  // CodeBlobType of the blobs allocated in this heap
+
   VirtualSpace _memory;                          // the memory holding the blocks
   VirtualSpace _segmap;                          // the memory holding the segment map
 
@@ -90,8 +96,25 @@ class CodeHeap : public CHeapObj<mtCode> {
 
   size_t       _next_segment;
 
-  FreeBlock*   _freelist;
+  // Free blocks are kept in doubly linked lists segregated by size. Blocks
+  // shorter than freelist_small_bins segments are binned by their exact
+  // length, longer ones by the power of two below their length. A bit is
+  // set in _freelist_bin_map for every non-empty bin.
+  enum {
+    freelist_small_bins      = 32,
+    log2_freelist_small_bins = 5,
+    freelist_bins            = 64
+  };
+
+  FreeBlock*   _freelist[freelist_bins];
+  julong       _freelist_bin_map;
   size_t       _freelist_segments;               // No. of segments in freelist
+  size_t       _freelist_length;                 // No. of blocks in freelist
+
+  int          _blob_count;                      // Number of CodeBlobs
+  int          _nmethod_count;                   // Number of nmethods
+  int          _adapter_count;                   // Number of adapters
+  int          _full_count;                      // Number of times the code heap was full
 
   // Helper functions
   size_t   size_to_segments(size_t size) const { return (size + _segment_size - 1) >> _log2_segment_size; }
@@ -103,10 +126,16 @@ class CodeHeap : public CHeapObj<mtCode> {
   void  mark_segmap_as_free(size_t beg, size_t end);
   void  mark_segmap_as_used(size_t beg, size_t end);
 
+  void  mark_segmap_as_joined(size_t beg, size_t joined);
+  HeapBlock* block_containing(size_t i) const;
+
   // Freelist management helpers
-  FreeBlock* following_block(FreeBlock *b);
-  void insert_after(FreeBlock* a, FreeBlock* b);
-  void merge_right (FreeBlock* a);
+  static size_t freelist_bin(size_t length);
+  FreeBlock* following_block(FreeBlock *b) const;
+  void add_to_bin(FreeBlock* b);
+  void remove_from_bin(FreeBlock* b);
+  FreeBlock* search_bin(size_t bin, size_t length, bool is_critical) const;
+  void merge_right(FreeBlock* a);
 
   // Toplevel freelist management
   void add_to_freelist(HeapBlock *b);
@@ -122,10 +151,10 @@ class CodeHeap : public CHeapObj<mtCode> {
   void on_code_mapping(char* base, size_t size);
 
  public:
-  CodeHeap();
+  CodeHeap(const char* name, int code_blob_type);
 
   // Heap extents
-  bool  reserve(size_t reserved_size, size_t committed_size, size_t segment_size);
+  bool  reserve(ReservedSpace rs, size_t committed_size, size_t segment_size);
   void  release();                               // releases all allocated memory
   bool  expand_by(size_t size);                  // expands commited memory by size
   void  shrink_by(size_t size);                  // shrinks commited memory by size
@@ -153,6 +182,17 @@ class CodeHeap : public CHeapObj<mtCode> {
   // returns the next block given a block p or NULL
   void* next(void* p) const { return next_free(next_block(block_start(p))); }
 
+  const char* name() const                       { return _name; }
+  int code_blob_type() const                     { return _code_blob_type; }
+
+  int  blob_count() const                        { return _blob_count; }
+  int  nmethod_count() const                     { return _nmethod_count; }
+  void set_nmethod_count(int count)              { _nmethod_count = count; }
+  int  adapter_count() const                     { return _adapter_count; }
+  void set_adapter_count(int count)              { _adapter_count = count; }
+  int  full_count() const                        { return _full_count; }
+  void report_full()                             { _full_count++; }
+
   // Statistics
   size_t capacity() const;
   size_t max_capacity() const;
@@ -163,6 +203,9 @@ private:
   size_t heap_unallocated_capacity() const;
 
 public:
+  // Prints the free block histogram and the fragmentation of the heap
+  void print_freelist_statistics(outputStream* st) const;
+
   // Debugging
   void verify();
   void print()  PRODUCT_RETURN;
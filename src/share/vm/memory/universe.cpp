@@ -68,6 +68,7 @@
 #include "runtime/thread.inline.hpp"
 #include "runtime/timer.hpp"
 #include "runtime/vm_operations.hpp"
+#include "services/classLoadingService.hpp"
 #include "services/memoryService.hpp"
 #include "utilities/copy.hpp"
 #include "utilities/events.hpp"
@@ -1227,7 +1228,13 @@ void Universe::flush_dependents_on(instanceKlassHandle dependee) {
   KlassDepChange changes(dependee);
 
   // Compute the dependent nmethods
-  if (CodeCache::mark_for_deoptimization(changes) > 0) {
+  elapsedTimer timer;
+  timer.start();
+  int marked = CodeCache::mark_for_deoptimization(changes);
+  timer.stop();
+  ClassLoadingService::add_dependency_check_time(timer.ticks());
+
+  if (marked > 0) {
     // At least one nmethod has been marked for deoptimization
     VM_Deoptimize op;
     VMThread::execute(&op);
@@ -29,6 +29,34 @@
 volatile int CompiledICHolder::_live_count;
 volatile int CompiledICHolder::_live_not_claimed_count;
 
+int CompiledICHolder::dispatch_cache_count() const {
+  int count = 0;
+  if (!_has_dispatch_cache) {
+    return count;
+  }
+  for (int i = 0; i < dispatch_cache_size; i++) {
+    if (dispatch_cache()[i]._method != NULL) {
+      count++;
+    }
+  }
+  return count;
+}
+
+void CompiledICHolder::dispatch_cache_metadata_do(void f(Metadata*)) {
+  if (!_has_dispatch_cache) {
+    return;
+  }
+  for (int i = 0; i < dispatch_cache_size; i++) {
+    Klass* k = dispatch_cache()[i]._klass;
+    Method* m = dispatch_cache()[i]._method;
+    // The method is published after the klass.
+    if (k != NULL && m != NULL) {
+      f(k);
+      f(m);
+    }
+  }
+}
+
 
 // Printing
 
@@ -36,6 +64,9 @@ void CompiledICHolder::print_on(outputStream* st) const {
   st->print("%s", internal_name());
   st->print(" - metadata: "); holder_metadata()->print_value_on(st); st->cr();
   st->print(" - klass:    "); holder_klass()->print_value_on(st); st->cr();
+  if (_has_dispatch_cache) {
+    st->print_cr(" - dispatch cache: %d/%d", dispatch_cache_count(), (int)dispatch_cache_size);
+  }
 }
 
 void CompiledICHolder::print_value_on(outputStream* st) const {
@@ -34,6 +34,13 @@
 //   (1) (method+klass pair) when converting from compiled to an interpreted call
 //   (2) (klass+klass pair) when calling itable stub from megamorphic compiled call
 //
+// For (2) it also holds a small dispatch cache that maps the receiver klasses
+// seen at the call site to the selected methods (see UseInterfaceDispatchCache).
+// The cache is allocated right behind the holder, and only if the flag is on.
+// The itable stub fills an empty entry by claiming its klass first and then
+// publishing the method. Entries are never overwritten, so a stub that finds
+// the receiver klass only has to check that the method has been published.
+//
 // These are always allocated in the C heap and are freed during a
 // safepoint by the ICBuffer logic.  It's unsafe to free them earlier
 // since they might be in use.
@@ -42,7 +49,17 @@
 
 class CompiledICHolder : public CHeapObj<mtCompiler> {
   friend class VMStructs;
+ public:
+  enum {
+    dispatch_cache_size = 8              // must be a power of two
+  };
+
  private:
+  struct DispatchCacheEntry {
+    Klass* volatile  _klass;
+    Method* volatile _method;
+  };
+
   static volatile int _live_count; // allocated
   static volatile int _live_not_claimed_count; // allocated but not yet in use so not
                                                // reachable by iterating over nmethods
@@ -51,11 +68,36 @@ class CompiledICHolder : public CHeapObj<mtCompiler> {
   Klass*    _holder_klass;    // to avoid name conflict with oopDesc::_klass
   CompiledICHolder* _next;
   bool _is_metadata_method;
+  bool _has_dispatch_cache;
+
+  DispatchCacheEntry* dispatch_cache() const {
+    assert(_has_dispatch_cache, "no dispatch cache");
+    return (DispatchCacheEntry*)((address)this + dispatch_cache_offset());
+  }
 
  public:
+  // Allocation. Holders for megamorphic interface call sites have to be
+  // allocated with new (UseInterfaceDispatchCache) to make room for the cache.
+  void* operator new(size_t size) throw() {
+    return CHeapObj<mtCompiler>::operator new(size);
+  }
+  void* operator new(size_t size, bool with_dispatch_cache) throw() {
+    if (with_dispatch_cache) {
+      size = dispatch_cache_offset() + dispatch_cache_size * sizeof(DispatchCacheEntry);
+    }
+    return CHeapObj<mtCompiler>::operator new(size);
+  }
+
   // Constructor
   CompiledICHolder(Metadata* metadata, Klass* klass, bool is_method = true)
-      : _holder_metadata(metadata), _holder_klass(klass), _is_metadata_method(is_method) {
+      : _holder_metadata(metadata), _holder_klass(klass), _is_metadata_method(is_method),
+        _has_dispatch_cache(!is_method && UseInterfaceDispatchCache) {
+    if (_has_dispatch_cache) {
+      for (int i = 0; i < dispatch_cache_size; i++) {
+        dispatch_cache()[i]._klass = NULL;
+        dispatch_cache()[i]._method = NULL;
+      }
+    }
 #ifdef ASSERT
     Atomic::inc(&_live_count);
     Atomic::inc(&_live_not_claimed_count);
@@ -82,6 +124,20 @@ class CompiledICHolder : public CHeapObj<mtCompiler> {
   static int holder_metadata_offset() { return offset_of(CompiledICHolder, _holder_metadata); }
   static int holder_klass_offset()    { return offset_of(CompiledICHolder, _holder_klass); }
 
+  // dispatch cache
+  static int dispatch_cache_offset()            { return (int)align_size_up(sizeof(CompiledICHolder), wordSize); }
+  static int dispatch_cache_entry_size()        { return sizeof(DispatchCacheEntry); }
+  static int dispatch_cache_klass_offset()      { return offset_of(DispatchCacheEntry, _klass); }
+  static int dispatch_cache_method_offset()     { return offset_of(DispatchCacheEntry, _method); }
+
+  bool    has_dispatch_cache() const            { return _has_dispatch_cache; }
+  Klass*  dispatch_cache_klass_at(int i) const  { return dispatch_cache()[i]._klass; }
+  Method* dispatch_cache_method_at(int i) const { return dispatch_cache()[i]._method; }
+  int     dispatch_cache_count() const;
+
+  // Applies f to the klasses and methods in the dispatch cache.
+  void dispatch_cache_metadata_do(void f(Metadata*));
+
   CompiledICHolder* next()     { return _next; }
   void set_next(CompiledICHolder* n) { _next = n; }
 
@@ -93,6 +149,16 @@ class CompiledICHolder : public CHeapObj<mtCompiler> {
     if (!_holder_klass->is_loader_alive(is_alive)) {
       return false;
     }
+    // A cached receiver klass could be unloaded and its memory reused by
+    // another klass, so the IC has to be cleaned with it.
+    if (_has_dispatch_cache) {
+      for (int i = 0; i < dispatch_cache_size; i++) {
+        Klass* cached = dispatch_cache()[i]._klass;
+        if (cached != NULL && !cached->is_loader_alive(is_alive)) {
+          return false;
+        }
+      }
+    }
     return true;
   }
 
@@ -65,6 +65,7 @@
 #include "utilities/macros.hpp"
 #if INCLUDE_JVMCI
 #include "classfile/javaAssertions.hpp"
+#include "jvmci/jvmciCompilationCache.hpp"
 #include "jvmci/jvmciRuntime.hpp"
 #endif
 #if INCLUDE_ALL_GCS
@@ -946,6 +947,11 @@ void InstanceKlass::initialize_impl(instanceKlassHandle this_oop, TRAPS) {
     { ResourceMark rm(THREAD);
       debug_only(this_oop->vtable()->verify(tty, true);)
     }
+#if INCLUDE_JVMCI
+    if (JVMCICompilationCacheFile != NULL) {
+      JVMCICompilationCache::class_initialized(this_oop, THREAD);
+    }
+#endif
   }
   else {
     // Step 10 and 11
@@ -1947,13 +1953,16 @@ int nmethodBucket::decrement() {
 //
 int InstanceKlass::mark_dependent_nmethods(DepChange& changes) {
   assert_locked_or_safepoint(CodeCache_lock);
+  // Only nmethods with dependencies of a matching type can be affected
+  int dep_types = changes.is_klass_change() ? Dependencies::klass_types : Dependencies::non_klass_types;
   int found = 0;
   nmethodBucket* b = _dependencies;
   while (b != NULL) {
     nmethod* nm = b->get_nmethod();
     // since dependencies aren't removed until an nmethod becomes a zombie,
     // the dependency list may contain nmethods which aren't alive.
-    if (b->count() > 0 && nm->is_alive() && !nm->is_marked_for_deoptimization() && nm->check_dependency_on(changes)) {
+    if (b->count() > 0 && (b->dep_types() & dep_types) != 0 && nm->is_alive() &&
+        !nm->is_marked_for_deoptimization() && nm->check_dependency_on(changes, this)) {
       if (TraceDependencies) {
         ResourceMark rm;
         tty->print_cr("Marked for deoptimization");
@@ -2014,18 +2023,18 @@ void InstanceKlass::clean_dependent_nmethods() {
 // so a count is kept for each bucket to guarantee that creation and
 // deletion of dependencies is consistent.
 //
-void InstanceKlass::add_dependent_nmethod(nmethod* nm) {
+void InstanceKlass::add_dependent_nmethod(nmethod* nm, int dep_type) {
   assert_locked_or_safepoint(CodeCache_lock);
   nmethodBucket* b = _dependencies;
   nmethodBucket* last = NULL;
   while (b != NULL) {
     if (nm == b->get_nmethod()) {
-      b->increment();
+      b->increment(dep_type);
       return;
     }
     b = b->next();
   }
-  _dependencies = new nmethodBucket(nm, _dependencies);
+  _dependencies = new nmethodBucket(nm, dep_type, _dependencies);
 }
 
 
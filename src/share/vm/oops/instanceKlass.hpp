@@ -823,7 +823,7 @@ class InstanceKlass: public Klass {
 
   // maintenance of deoptimization dependencies
   int mark_dependent_nmethods(DepChange& changes);
-  void add_dependent_nmethod(nmethod* nm);
+  void add_dependent_nmethod(nmethod* nm, int dep_type);
   void remove_dependent_nmethod(nmethod* nm, bool delete_immediately);
 
   // On-stack replacement support
@@ -1250,23 +1250,28 @@ class JNIid: public CHeapObj<mtClass> {
 // recording the method, a count of how many times a particular nmethod
 // was recorded is kept.  This ensures that any recording errors are
 // noticed since an nmethod should be removed as many times are it's
-// added.
+// added.  The bucket also records which dependency types the nmethod
+// has with this klass as context, so that a class hierarchy change
+// only checks the nmethods that can be affected by it.
 //
 class nmethodBucket: public CHeapObj<mtClass> {
   friend class VMStructs;
  private:
   nmethod*       _nmethod;
   int            _count;
+  int            _dep_types;  // mask of Dependencies::DepType
   nmethodBucket* _next;
 
  public:
-  nmethodBucket(nmethod* nmethod, nmethodBucket* next) {
+  nmethodBucket(nmethod* nmethod, int dep_type, nmethodBucket* next) {
     _nmethod = nmethod;
     _next = next;
     _count = 1;
+    _dep_types = 1 << dep_type;
   }
   int count()                             { return _count; }
-  int increment()                         { _count += 1; return _count; }
+  int increment(int dep_type)             { _dep_types |= 1 << dep_type; _count += 1; return _count; }
+  int dep_types()                         { return _dep_types; }
   int decrement();
   nmethodBucket* next()                   { return _next; }
   void set_next(nmethodBucket* b)         { _next = b; }
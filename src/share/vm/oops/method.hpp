@@ -35,6 +35,7 @@
 #include "oops/instanceKlass.hpp"
 #include "oops/oop.hpp"
 #include "oops/typeArrayOop.hpp"
+#include "runtime/atomic.hpp"
 #include "utilities/accessFlags.hpp"
 #include "utilities/growableArray.hpp"
 #include "utilities/macros.hpp"
@@ -120,7 +121,8 @@ class Method : public Metadata {
     _dont_inline          = 1 << 3,
     _hidden               = 1 << 4,
     _has_injected_profile = 1 << 5,
-    _running_emcp         = 1 << 6
+    _running_emcp         = 1 << 6,
+    _hot_code             = 1 << 7
   };
   u1 _flags;
 
@@ -844,6 +846,22 @@ class Method : public Metadata {
     _flags = x ? (_flags | _has_injected_profile) : (_flags & ~_has_injected_profile);
   }
 
+  // The sweeper found the compiled code of this method hot, it is
+  // recompiled into the hot code heap. Unlike the other flags, this one
+  // changes while the method is in use (by the sweeper and when the
+  // recompilation is installed), so it is updated atomically.
+  bool is_hot_code() {
+    return (_flags & _hot_code) != 0;
+  }
+  void set_hot_code(bool x) {
+    u1 old_flags;
+    u1 new_flags;
+    do {
+      old_flags = _flags;
+      new_flags = x ? (old_flags | _hot_code) : (old_flags & ~_hot_code);
+    } while ((u1)Atomic::cmpxchg((jbyte)new_flags, (volatile jbyte*)&_flags, (jbyte)old_flags) != old_flags);
+  }
+
   JFR_ONLY(DEFINE_TRACE_FLAG_ACCESSOR;)
 
   ConstMethod::MethodType method_type() const {
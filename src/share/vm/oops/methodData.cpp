@@ -875,10 +875,28 @@ void* FailedSpeculation::operator new(size_t size, size_t fs_size) throw() {
   return CHeapObj<mtCompiler>::operator new(fs_size, std::nothrow);
 }
 
-FailedSpeculation::FailedSpeculation(address speculation, int speculation_len) : _data_len(speculation_len), _next(NULL) {
+FailedSpeculation::FailedSpeculation(address speculation, int speculation_len, unsigned int hash) :
+  _data_len(speculation_len), _hash(hash), _index(0), _next(NULL) {
   memcpy(data(), speculation, speculation_len);
 }
 
+unsigned int FailedSpeculation::hash(address data, int data_len) {
+  unsigned int h = 2166136261u;
+  for (int i = 0; i < data_len; i++) {
+    h = (h ^ data[i]) * 16777619u;
+  }
+  return h;
+}
+
+bool FailedSpeculation::contains(FailedSpeculation* fs, FailedSpeculation* end, address data, int data_len, unsigned int hash) {
+  for (; fs != end; fs = fs->next()) {
+    if (fs->_hash == hash && fs->_data_len == data_len && memcmp(fs->data(), data, data_len) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 // A heuristic check to detect nmethods that outlive a failed speculations list.
 static void guarantee_failed_speculations_alive(nmethod* nm, FailedSpeculation** failed_speculations_address) {
   long head = (long)(address) *failed_speculations_address;
@@ -906,28 +924,38 @@ static void guarantee_failed_speculations_alive(nmethod* nm, FailedSpeculation**
 
 bool FailedSpeculation::add_failed_speculation(nmethod* nm, FailedSpeculation** failed_speculations_address, address speculation, int speculation_len) {
   assert(failed_speculations_address != NULL, "must be");
+  guarantee_failed_speculations_alive(nm, failed_speculations_address);
+
+  unsigned int h = hash(speculation, speculation_len);
+  FailedSpeculation* head = (FailedSpeculation*) OrderAccess::load_ptr_acquire(failed_speculations_address);
+  if (contains(head, NULL, speculation, speculation_len, h)) {
+    // Already recorded by an earlier failure of the same speculation
+    return true;
+  }
+
   size_t fs_size = sizeof(FailedSpeculation) + speculation_len;
-  FailedSpeculation* fs = new (fs_size) FailedSpeculation(speculation, speculation_len);
+  FailedSpeculation* fs = new (fs_size) FailedSpeculation(speculation, speculation_len, h);
   if (fs == NULL) {
     // no memory -> ignore failed speculation
     return false;
   }
-
   guarantee(is_ptr_aligned(fs, sizeof(FailedSpeculation*)), "FailedSpeculation objects must be pointer aligned");
-  guarantee_failed_speculations_alive(nm, failed_speculations_address);
 
-  FailedSpeculation** cursor = failed_speculations_address;
   do {
-    if (*cursor == NULL) {
-      FailedSpeculation* old_fs = (FailedSpeculation*) Atomic::cmpxchg_ptr(fs, cursor, NULL);
-      if (old_fs == NULL) {
-        // Successfully appended fs to end of the list
-        return true;
-      }
-      cursor = old_fs->next_adr();
-    } else {
-      cursor = (*cursor)->next_adr();
+    fs->_index = head == NULL ? 0 : head->_index + 1;
+    fs->_next = head;
+    FailedSpeculation* old_head = (FailedSpeculation*) Atomic::cmpxchg_ptr(fs, failed_speculations_address, head);
+    if (old_head == head) {
+      // Successfully prepended fs to the list
+      return true;
+    }
+    guarantee_failed_speculations_alive(nm, failed_speculations_address);
+    // Only the entries added since the list was last searched need to be checked
+    if (contains(old_head, head, speculation, speculation_len, h)) {
+      delete fs;
+      return true;
     }
+    head = old_head;
   } while (true);
 }
 
@@ -2149,8 +2149,12 @@ class CleanExtraDataClosure;
 
 #if INCLUDE_JVMCI
 // Encapsulates an encoded speculation reason. These are linked together in
-// a list that is atomically appended to during deoptimization. Entries are
-// never removed from the list.
+// a list that is atomically prepended to during deoptimization, so the head
+// of the list is the most recently failed speculation. Each entry records
+// its position in the order of failure which lets readers fetch only the
+// entries added since they last looked. A speculation is added at most
+// once, no matter how many times it fails. Entries are never removed from
+// the list.
 // @see jdk.vm.ci.hotspot.HotSpotSpeculationLog.HotSpotSpeculationEncoding
 class FailedSpeculation: public CHeapObj<mtCompiler> {
  private:
@@ -2158,24 +2162,34 @@ class FailedSpeculation: public CHeapObj<mtCompiler> {
   // is an array embedded at the end of this object.
   int   _data_len;
 
-  // Next entry in a linked list.
-  FailedSpeculation* _next;
+  // Hash of the data, compared before the data when looking for duplicates.
+  unsigned int _hash;
+
+  // Number of entries that failed before this one.
+  int   _index;
 
-  FailedSpeculation(address data, int data_len);
+  // Next (older) entry in a linked list.
+  FailedSpeculation* _next;
 
-  FailedSpeculation** next_adr() { return &_next; }
+  FailedSpeculation(address data, int data_len, unsigned int hash);
 
   // Placement new operator for inlining the speculation data into
   // the FailedSpeculation object.
   void* operator new(size_t size, size_t fs_size) throw();
 
+  static unsigned int hash(address data, int data_len);
+
+  // Searches the entries from `fs` up to but excluding `end` for `data`.
+  static bool contains(FailedSpeculation* fs, FailedSpeculation* end, address data, int data_len, unsigned int hash);
+
  public:
   char* data()         { return (char*)(((address) this) + sizeof(FailedSpeculation)); }
   int data_len() const { return _data_len; }
+  int index() const    { return _index; }
   FailedSpeculation* next() const { return _next; }
 
-  // Atomically appends a speculation from nm to the list whose head is at (*failed_speculations_address).
-  // Returns false if the FailedSpeculation object could not be allocated.
+  // Atomically prepends a speculation from nm to the list whose head is at (*failed_speculations_address)
+  // unless the list already contains it. Returns false if the FailedSpeculation object could not be allocated.
   static bool add_failed_speculation(nmethod* nm, FailedSpeculation** failed_speculations_address, address speculation, int speculation_len);
 
   // Frees all entries in the linked list whose head is at (*failed_speculations_address).
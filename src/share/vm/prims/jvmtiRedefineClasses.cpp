@@ -3811,6 +3811,12 @@ void VM_RedefineClasses::flush_dependent_code(instanceKlassHandle k_h, TRAPS) {
     // From now on we know that the dependency information is complete
     JvmtiExport::set_all_dependencies_are_recorded(true);
   }
+
+  // Megamorphic interface call sites cache the methods selected for their
+  // receiver klasses, which may be the old versions of the redefined methods.
+  if (UseInterfaceDispatchCache) {
+    CodeCache::clear_inline_caches();
+  }
 }
 
 void VM_RedefineClasses::compute_added_deleted_matching_methods() {
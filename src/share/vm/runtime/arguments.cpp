@@ -2603,6 +2603,14 @@ bool Arguments::check_vm_args_consistency() {
   status = status && JVMCIGlobals::check_jvmci_flags_are_consistent();
 #endif
 
+#ifndef AMD64
+  // Only the x86_64 itable stubs use the interface dispatch cache.
+  if (UseInterfaceDispatchCache) {
+    warning("UseInterfaceDispatchCache is not supported on this platform");
+    FLAG_SET_DEFAULT(UseInterfaceDispatchCache, false);
+  }
+#endif
+
   // Need to limit the extent of the padding to reasonable size.
   // 8K is well beyond the reasonable HW cache line size, even with the
   // aggressive prefetching, while still leaving the room for segregating
@@ -2651,6 +2659,9 @@ bool Arguments::check_vm_args_consistency() {
 
   status &= verify_interval(NmethodSweepFraction, 1, ReservedCodeCacheSize/K, "NmethodSweepFraction");
   status &= verify_interval(NmethodSweepActivity, 0, 2000, "NmethodSweepActivity");
+  status &= verify_interval(HotCodeMinSweeps, 1, max_jint, "HotCodeMinSweeps");
+  status &= verify_interval(HotCodeRelocationLimit, 0, 1000, "HotCodeRelocationLimit");
+  status &= verify_interval(CodeCacheSweeperThreads, 0, 256, "CodeCacheSweeperThreads");
 
   if (!FLAG_IS_DEFAULT(CICompilerCount) && !FLAG_IS_DEFAULT(CICompilerCountPerCPU) && CICompilerCountPerCPU) {
     warning("The VM option CICompilerCountPerCPU overrides CICompilerCount.");
@@ -4406,8 +4417,10 @@ jint Arguments::adjust_after_os() {
     // platforms when UseNUMA is set to ON. NUMA-aware collectors
     // such as the parallel collector for Linux and Solaris will
     // interleave old gen and survivor spaces on top of NUMA
-    // allocation policy for the eden space.
-    // Non NUMA-aware collectors such as CMS, G1 and Serial-GC on
+    // allocation policy for the eden space. G1 binds every heap
+    // region to a node when committing it, so only its auxiliary
+    // data structures stay interleaved.
+    // Non NUMA-aware collectors such as CMS and Serial-GC on
     // all platforms and ParallelGC on Windows will interleave all
     // of the heap spaces across NUMA nodes.
     if (FLAG_IS_DEFAULT(UseNUMAInterleaving)) {
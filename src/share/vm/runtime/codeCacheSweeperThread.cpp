@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "classfile/systemDictionary.hpp"
+#include "runtime/codeCacheSweeperThread.hpp"
+#include "runtime/interfaceSupport.hpp"
+#include "runtime/javaCalls.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/sweeper.hpp"
+
+void CodeCacheSweeperThread::initialize() {
+  EXCEPTION_MARK;
+
+  instanceKlassHandle klass (THREAD,  SystemDictionary::Thread_klass());
+  for (int i = 0; i < CodeCacheSweeperThreads; i++) {
+    instanceHandle thread_oop = klass->allocate_instance_handle(CHECK);
+
+    char name_buffer[256];
+    sprintf(name_buffer, "Code Cache Sweeper Thread%d", i);
+    Handle string = java_lang_String::create_from_str(name_buffer, CHECK);
+
+    // Initialize thread_oop to put it into the system threadGroup
+    Handle thread_group (THREAD, Universe::system_thread_group());
+    JavaValue result(T_VOID);
+    JavaCalls::call_special(&result, thread_oop,
+                            klass,
+                            vmSymbols::object_initializer_name(),
+                            vmSymbols::threadgroup_string_void_signature(),
+                            thread_group,
+                            string,
+                            CHECK);
+
+    {
+      MutexLocker mu(Threads_lock);
+      CodeCacheSweeperThread* thread = new CodeCacheSweeperThread(&sweeper_thread_entry);
+
+      // At this point it may be possible that no osthread was created for the
+      // JavaThread due to lack of memory. We would have to throw an exception
+      // in that case. However, since this must work and we do not allow
+      // exceptions anyway, check and abort if this fails.
+      if (thread == NULL || thread->osthread() == NULL) {
+        vm_exit_during_initialization("java.lang.OutOfMemoryError",
+                                      "unable to create new native thread");
+      }
+
+      java_lang_Thread::set_thread(thread_oop(), thread);
+      java_lang_Thread::set_priority(thread_oop(), NearMaxPriority);
+      java_lang_Thread::set_daemon(thread_oop());
+      thread->set_threadObj(thread_oop());
+
+      Threads::add(thread);
+      Thread::start(thread);
+    }
+  }
+}
+
+void CodeCacheSweeperThread::sweeper_thread_entry(JavaThread* jt, TRAPS) {
+  while (true) {
+    {
+      // Need state transition ThreadBlockInVM so that this thread
+      // will be handled by safepoint correctly when this thread is
+      // notified at a safepoint.
+      ThreadBlockInVM tbivm(jt);
+
+      MutexLockerEx ml(CodeCacheSweeper_lock, Mutex::_no_safepoint_check_flag);
+      // Wake up periodically to check if a sweep is due, like idle
+      // compiler threads do without dedicated sweeper threads
+      if (!NMethodSweeper::has_sweep_work()) {
+        CodeCacheSweeper_lock->wait(Mutex::_no_safepoint_check_flag, 100);
+      }
+    }
+
+    // Either start a sweep or help the thread that did
+    NMethodSweeper::possibly_sweep();
+    NMethodSweeper::help_sweep();
+  }
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_VM_RUNTIME_CODECACHESWEEPERTHREAD_HPP
+#define SHARE_VM_RUNTIME_CODECACHESWEEPERTHREAD_HPP
+
+#include "runtime/thread.hpp"
+
+// A JavaThread dedicated to sweeping the code cache (see
+// CodeCacheSweeperThreads). All sweeper threads process the
+// nmethods of a sweep in parallel.
+class CodeCacheSweeperThread : public JavaThread {
+  friend class VMStructs;
+ private:
+  static void sweeper_thread_entry(JavaThread* thread, TRAPS);
+  CodeCacheSweeperThread(ThreadFunction entry_point) : JavaThread(entry_point) {};
+
+ public:
+  // Starts CodeCacheSweeperThreads sweeper threads
+  static void initialize();
+
+  bool is_Code_cache_sweeper_thread() const      { return true; }
+
+  // Hide this thread from external view.
+  bool is_hidden_from_external_view() const      { return true; }
+};
+
+#endif // SHARE_VM_RUNTIME_CODECACHESWEEPERTHREAD_HPP
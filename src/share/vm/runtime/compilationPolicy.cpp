@@ -203,6 +203,35 @@ CompileTask* CompilationPolicy::select_task_helper(CompileQueue* compile_queue)
       }
     }
   }
+  if (UseJVMCICompiler && JVMCICompileQueueAgingPeriod > 0) {
+    /*
+     * Select the task for the hottest method so that it does not wait
+     * behind colder methods that happened to be queued earlier. A task
+     * that has been waiting for more than JVMCICompileQueueAgingPeriod
+     * milliseconds is selected regardless of hotness so that tasks for
+     * methods whose counters have decayed are not starved.
+     */
+    CompileTask* first = compile_queue->first();
+    if (first == NULL) {
+      return NULL;
+    }
+    jlong aged = os::elapsed_counter() - (JVMCICompileQueueAgingPeriod * os::elapsed_frequency()) / 1000;
+    if (first->time_queued() <= aged) {
+      // The queue is in FIFO order so this is the oldest task.
+      return first;
+    }
+    CompileTask* max_task = first;
+    int max_count = -1;
+    for (CompileTask* task = first; task != NULL; task = task->next()) {
+      Method* method = task->method();
+      int count = method->invocation_count() + method->backedge_count();
+      if (count > max_count) {
+        max_task = task;
+        max_count = count;
+      }
+    }
+    return max_task;
+  }
 #endif
   return compile_queue->first();
 }
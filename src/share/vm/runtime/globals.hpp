@@ -681,6 +681,19 @@ class CommandLineFlags {
   product(bool, MethodFlushing, true,                                       \
           "Reclamation of zombie and not-entrant methods")                  \
                                                                             \
+  product(intx, CodeCacheSweeperThreads, 0,                                 \
+          "Number of dedicated threads that sweep the code cache in "       \
+          "parallel (0 to 256). If 0, the compiler threads sweep the code " \
+          "cache")                                                          \
+                                                                            \
+  product(bool, UsePcDescIndex, false,                                      \
+          "Let the sweeper build a compact index for the PcDescs of "       \
+          "nmethods whose PcDescs are searched often")                      \
+                                                                            \
+  product(intx, PcDescIndexThreshold, 100,                                  \
+          "Number of PcDesc cache misses of an nmethod after which an "     \
+          "index is built for it. Only used with UsePcDescIndex")           \
+                                                                            \
   develop(bool, VerifyStack, false,                                         \
           "Verify stack of each thread when it is entering a runtime call") \
                                                                             \
@@ -707,6 +720,13 @@ class CommandLineFlags {
   product(bool, UseInlineCaches, true,                                      \
           "Use Inline Caches for virtual calls ")                           \
                                                                             \
+  product(bool, UseInterfaceDispatchCache, false,                           \
+          "Cache the selected method per receiver klass at megamorphic "    \
+          "interface call sites. Only supported on x86_64")                 \
+                                                                            \
+  diagnostic(bool, CountInterfaceDispatchCache, false,                      \
+          "Count hits and misses of the interface dispatch cache")          \
+                                                                            \
   develop(bool, InlineArrayCopy, true,                                      \
           "Inline arraycopy native that is known to be part of "            \
           "base library DLL")                                               \
@@ -1023,6 +1043,10 @@ class CommandLineFlags {
   product(bool, ShareDebugInfo, IS_JVMCI_DEFINED,                           \
           "Always tries to share similar debug info inside a nmethod")      \
                                                                             \
+  product(bool, ShareDebugInfoAcrossNMethods, false,                        \
+          "Share identical debug info of different nmethods in a side "     \
+          "table outside of the code cache")                                \
+                                                                            \
   diagnostic(bool, PrintNMethods, false,                                    \
           "Print assembly code for nmethods when generated")                \
                                                                             \
@@ -1122,6 +1146,10 @@ class CommandLineFlags {
   product(bool, ClassUnloadingWithConcurrentMark, true,                     \
           "Do unloading of classes with a concurrent marking cycle")        \
                                                                             \
+  product(bool, ParallelCodeCacheUnloading, true,                           \
+          "Unload and clean nmethods with the GC worker threads during "    \
+          "class unloading")                                                \
+                                                                            \
   develop(bool, DisableStartThread, false,                                  \
           "Disable starting of additional Java threads "                    \
           "(for debugging only)")                                           \
@@ -3435,6 +3463,39 @@ class CommandLineFlags {
   product(uintx, CodeCacheMinimumFreeSpace, 500*K,                          \
           "When less than X space left, we stop compiling")                 \
                                                                             \
+  product(bool, SegmentedCodeCache, false,                                  \
+          "Use a segmented code cache with separate code heaps for "        \
+          "non-nmethods, profiled nmethods and non-profiled nmethods")      \
+                                                                            \
+  product(uintx, NonNMethodCodeHeapSize, 8*M,                               \
+          "Size of code heap with non-nmethods (in bytes). Only used "      \
+          "with SegmentedCodeCache")                                        \
+                                                                            \
+  product(uintx, ProfiledCodeHeapSize, 0,                                   \
+          "Size of code heap with profiled methods (in bytes). If 0, "      \
+          "the size is derived from ReservedCodeCacheSize. Only used "      \
+          "with SegmentedCodeCache")                                        \
+                                                                            \
+  product(uintx, NonProfiledCodeHeapSize, 0,                                \
+          "Size of code heap with non-profiled methods (in bytes). If "     \
+          "0, the size is derived from ReservedCodeCacheSize. Only "        \
+          "used with SegmentedCodeCache")                                   \
+                                                                            \
+  product(uintx, HotCodeHeapSize, 0,                                        \
+          "Size of code heap with hot non-profiled methods (in bytes). "    \
+          "Methods found hot by the sweeper are recompiled into this "      \
+          "heap. If 0, there is no hot code heap. Only used with "          \
+          "SegmentedCodeCache")                                             \
+                                                                            \
+  product(intx, HotCodeMinSweeps, 4,                                        \
+          "Number of consecutive sweeps an nmethod must be found active "   \
+          "on a thread stack before it is moved to the hot code heap. "     \
+          "Long running or blocked frames are counted as active too")       \
+                                                                            \
+  product(intx, HotCodeRelocationLimit, 16,                                 \
+          "Maximum number of methods moved to the hot code heap per "       \
+          "sweep (0 to 1000)")                                              \
+                                                                            \
   product_pd(uintx, CodeCacheExpansionSize,                                 \
           "Code cache expansion size (in bytes)")                           \
                                                                             \
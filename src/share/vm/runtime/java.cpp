@@ -27,6 +27,7 @@
 #include "classfile/symbolTable.hpp"
 #include "classfile/systemDictionary.hpp"
 #include "code/codeCache.hpp"
+#include "code/vtableStubs.hpp"
 #include "compiler/compileBroker.hpp"
 #include "compiler/compilerOracle.hpp"
 #include "interpreter/bytecodeHistogram.hpp"
@@ -304,6 +305,9 @@ void print_statistics() {
   if (PrintNMethodStatistics) {
     nmethod::print_statistics();
   }
+  if (UseInterfaceDispatchCache && CountInterfaceDispatchCache) {
+    VtableStubs::print_statistics();
+  }
   if (CountCompiledCalls) {
     print_method_invocation_histogram();
   }
@@ -418,6 +422,9 @@ void print_statistics() {
   if (PrintNMethodStatistics) {
     nmethod::print_statistics();
   }
+  if (UseInterfaceDispatchCache && CountInterfaceDispatchCache) {
+    VtableStubs::print_statistics();
+  }
 
   // Native memory tracking data
   if (PrintNMTStatistics) {
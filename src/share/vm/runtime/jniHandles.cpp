@@ -133,6 +133,11 @@ void JNIHandles::destroy_global(jobject handle) {
   }
 }
 
+bool JNIHandles::is_global_weak_cleared(jweak handle) {
+  assert(is_jweak(handle), "not a weak handle");
+  return guard_value<false>(jweak_ref(handle)) == NULL;
+}
+
 void JNIHandles::destroy_weak_global(jobject handle) {
   if (handle != NULL) {
     jweak_ref(handle) = deleted_handle();
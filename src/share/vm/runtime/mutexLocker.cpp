@@ -124,6 +124,7 @@ Monitor* GCTaskManager_lock           = NULL;
 
 Mutex*   Management_lock              = NULL;
 Monitor* Service_lock                 = NULL;
+Monitor* CodeCacheSweeper_lock        = NULL;
 Monitor* PeriodicTask_lock            = NULL;
 Monitor* RedefineClasses_lock         = NULL;
 
@@ -145,6 +146,7 @@ Mutex*   UnsafeJlong_lock             = NULL;
 
 #if INCLUDE_JVMCI
 Monitor* JVMCI_lock                   = NULL;
+Mutex*   JVMCICompilationCache_lock   = NULL;
 #endif
 
 
@@ -224,6 +226,7 @@ void mutex_init() {
   def(Patching_lock                , Mutex  , special,     true ); // used for safepointing and code patching.
   def(ObjAllocPost_lock            , Monitor, special,     false);
   def(Service_lock                 , Monitor, special,     true ); // used for service thread operations
+  def(CodeCacheSweeper_lock        , Monitor, special,     true ); // used for code cache sweeper thread operations
   def(JmethodIdCreation_lock       , Mutex  , leaf,        true ); // used for creating jmethodIDs.
 
   def(SystemDictionary_lock        , Monitor, leaf,        true ); // lookups done by VM thread
@@ -309,6 +312,7 @@ void mutex_init() {
 
 #if INCLUDE_JVMCI
   def(JVMCI_lock                   , Monitor, nonleaf+2,   true);
+  def(JVMCICompilationCache_lock   , Mutex,   leaf,        true);
 #endif
 }
 
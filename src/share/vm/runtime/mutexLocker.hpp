@@ -140,6 +140,7 @@ extern Mutex*   MMUTracker_lock;                 // protects the MMU
 
 extern Mutex*   Management_lock;                 // a lock used to serialize JVM management
 extern Monitor* Service_lock;                    // a lock used for service thread operation
+extern Monitor* CodeCacheSweeper_lock;           // a lock used by the code cache sweeper threads
 extern Monitor* PeriodicTask_lock;               // protects the periodic task structure
 extern Monitor* RedefineClasses_lock;            // locks classes from parallel redefinition
 
@@ -162,6 +163,7 @@ extern Mutex*   UnsafeJlong_lock;                // provides Unsafe atomic updat
 
 #if INCLUDE_JVMCI
 extern Monitor* JVMCI_lock;                      // Monitor to control initialization of JVMCI
+extern Mutex*   JVMCICompilationCache_lock;      // a lock on the JVMCI compilation cache
 #endif
 
 // A MutexLocker provides mutual exclusion with respect to a given mutex
@@ -85,6 +85,9 @@
 #ifdef COMPILER1
 #include "c1/c1_globals.hpp"
 #endif
+#if INCLUDE_JVMCI
+#include "jvmci/jvmci.hpp"
+#endif
 
 PRAGMA_FORMAT_MUTE_WARNINGS_FOR_GCC
 
@@ -670,6 +673,13 @@ void SafepointSynchronize::do_cleanup_tasks() {
     }
   }
 
+#if INCLUDE_JVMCI
+  if (EnableJVMCI) {
+    TraceTime t9("purging JVMCI mirror caches", TraceSafepointCleanupTime);
+    JVMCI::purge_mirror_caches();
+  }
+#endif
+
   // rotate log files?
   if (UseGCLogFileRotation) {
     TraceTime t8("rotating gc logs", TraceSafepointCleanupTime);
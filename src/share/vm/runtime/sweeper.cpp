@@ -32,10 +32,13 @@
 #include "memory/resourceArea.hpp"
 #include "oops/method.hpp"
 #include "runtime/atomic.hpp"
+#include "runtime/codeCacheSweeperThread.hpp"
 #include "runtime/compilationPolicy.hpp"
+#include "runtime/interfaceSupport.hpp"
 #include "runtime/mutexLocker.hpp"
 #include "runtime/orderAccess.inline.hpp"
 #include "runtime/os.hpp"
+#include "runtime/perfData.hpp"
 #include "runtime/sweeper.hpp"
 #include "runtime/thread.inline.hpp"
 #include "runtime/vm_operations.hpp"
@@ -137,9 +140,14 @@ long     NMethodSweeper::_total_nof_code_cache_sweeps  = 0;    // Total number o
 long     NMethodSweeper::_time_counter                 = 0;    // Virtual time used to periodically invoke sweeper
 long     NMethodSweeper::_last_sweep                   = 0;    // Value of _time_counter when the last sweep happened
 int      NMethodSweeper::_seen                         = 0;    // Nof. nmethod we have currently processed in current pass of CodeCache
-int      NMethodSweeper::_flushed_count                = 0;    // Nof. nmethods flushed in current sweep
-int      NMethodSweeper::_zombified_count              = 0;    // Nof. nmethods made zombie in current sweep
-int      NMethodSweeper::_marked_for_reclamation_count = 0;    // Nof. nmethods marked for reclaim in current sweep
+int      NMethodSweeper::_swept_count                  = 0;    // Nof. nmethods claimed in current sweep
+volatile int  NMethodSweeper::_flushed_count           = 0;    // Nof. nmethods flushed in current sweep
+volatile int  NMethodSweeper::_flushed_c2_count        = 0;    // Nof. C2-compiled nmethods flushed in current sweep
+volatile int  NMethodSweeper::_zombified_count         = 0;    // Nof. nmethods made zombie in current sweep
+volatile int  NMethodSweeper::_marked_for_reclamation_count = 0; // Nof. nmethods marked for reclaim in current sweep
+volatile int  NMethodSweeper::_hot_relocation_count    = 0;    // Nof. nmethods moved to the hot code heap in current sweep
+nmethod**     NMethodSweeper::_hot_nmethods            = NULL; // Hot nmethods found in current sweep, HotCodeRelocationLimit at most
+volatile int  NMethodSweeper::_pc_desc_index_count     = 0;    // Nof. PcDesc indexes built in current sweep
 
 volatile bool NMethodSweeper::_should_sweep            = true; // Indicates if we should invoke the sweeper
 volatile int  NMethodSweeper::_sweep_fractions_left    = 0;    // Nof. invocations left until we are completed with this pass
@@ -158,6 +166,21 @@ Tickspan  NMethodSweeper::_total_time_this_sweep;               // Total time th
 Tickspan  NMethodSweeper::_peak_sweep_time;                     // Peak time for a full sweep
 Tickspan  NMethodSweeper::_peak_sweep_fraction_time;            // Peak time sweeping one fraction
 
+bool   NMethodSweeper::_helping_allowed                 = false; // Other sweeper threads may join the current sweep
+int    NMethodSweeper::_sweep_todo                      = 0;     // Nof. nmethods to sweep in the current sweep
+int    NMethodSweeper::_active_helpers                  = 0;     // Nof. sweeper threads helping with the current sweep
+int    NMethodSweeper::_helper_count                    = 0;     // Nof. sweeper threads that helped with the current sweep
+int    NMethodSweeper::_helper_freed_memory             = 0;     // Memory freed by the helping sweeper threads
+
+PerfCounter*  NMethodSweeper::_perf_sweeps              = NULL;
+PerfCounter*  NMethodSweeper::_perf_nmethods_swept      = NULL;
+PerfCounter*  NMethodSweeper::_perf_nmethods_flushed    = NULL;
+PerfCounter*  NMethodSweeper::_perf_helpers             = NULL;
+PerfCounter*  NMethodSweeper::_perf_pc_desc_indexes     = NULL;
+PerfCounter*  NMethodSweeper::_perf_bytes_flushed       = NULL;
+PerfCounter*  NMethodSweeper::_perf_total_time          = NULL;
+PerfVariable* NMethodSweeper::_perf_peak_fraction_time  = NULL;
+
 
 
 class MarkActivationClosure: public CodeBlobClosure {
@@ -240,8 +263,19 @@ void NMethodSweeper::mark_active_nmethods() {
  */
 void NMethodSweeper::possibly_sweep() {
   assert(JavaThread::current()->thread_state() == _thread_in_vm, "must run in vm mode");
-  // Only compiler threads are allowed to sweep
-  if (!MethodFlushing || !sweep_in_progress() NOT_JVMCI(|| !Thread::current()->is_Compiler_thread()) JVMCI_ONLY(|| !Thread::current()->is_Java_thread())) {
+  Thread* thread = Thread::current();
+  if (CodeCacheSweeperThreads > 0 && !thread->is_Code_cache_sweeper_thread()) {
+    // Only the dedicated sweeper threads sweep, wake them up if the
+    // code cache is getting full
+    if (MethodFlushing && !CompileBroker::should_compile_new_jobs()) {
+      MutexLockerEx ml(CodeCacheSweeper_lock, Mutex::_no_safepoint_check_flag);
+      CodeCacheSweeper_lock->notify_all();
+    }
+    return;
+  }
+  // Only compiler threads and sweeper threads are allowed to sweep
+  if (!MethodFlushing || !sweep_in_progress() ||
+      !(thread->is_Code_cache_sweeper_thread() NOT_JVMCI(|| thread->is_Compiler_thread()) JVMCI_ONLY(|| thread->is_Java_thread()))) {
     return;
   }
 
@@ -301,6 +335,9 @@ void NMethodSweeper::possibly_sweep() {
     // We are done with sweeping the code cache once.
     if (_sweep_fractions_left == 0) {
       _total_nof_code_cache_sweeps++;
+      if (UsePerfData) {
+        _perf_sweeps->inc();
+      }
       _last_sweep = _time_counter;
       // Reset flag; temporarily disables sweeper
       _should_sweep = false;
@@ -324,7 +361,9 @@ static void post_sweep_event(EventSweepCodeCache* event,
                              s4 traversals,
                              int swept,
                              int flushed,
-                             int zombified) {
+                             int zombified,
+                             int freed,
+                             int threads) {
   assert(event != NULL, "invariant");
   assert(event->should_commit(), "invariant");
   event->set_starttime(start);
@@ -333,6 +372,23 @@ static void post_sweep_event(EventSweepCodeCache* event,
   event->set_sweptCount(swept);
   event->set_flushedCount(flushed);
   event->set_zombifiedCount(zombified);
+  event->set_freedBytes(freed);
+  event->set_threadCount(threads);
+  event->commit();
+}
+
+static void post_hot_code_relocation_event(EventHotCodeRelocation* event,
+                                           const Ticks& start,
+                                           const Ticks& end,
+                                           s4 traversals,
+                                           int relocated) {
+  assert(event != NULL, "invariant");
+  assert(event->should_commit(), "invariant");
+  event->set_starttime(start);
+  event->set_endtime(end);
+  event->set_sweepId(traversals);
+  event->set_relocatedCount(relocated);
+  event->set_unallocatedCapacity(CodeCache::unallocated_capacity(CodeBlobType::MethodHot));
   event->commit();
 }
 
@@ -341,8 +397,12 @@ void NMethodSweeper::sweep_code_cache() {
   Ticks sweep_start_counter = Ticks::now();
 
   _flushed_count                = 0;
+  _flushed_c2_count             = 0;
   _zombified_count              = 0;
   _marked_for_reclamation_count = 0;
+  _hot_relocation_count         = 0;
+  _pc_desc_index_count          = 0;
+  _swept_count                  = 0;
 
   if (PrintMethodFlushing && Verbose) {
     tty->print_cr("### Sweep at %d out of %d. Invocations left: %d", _seen, CodeCache::nof_nmethods(), _sweep_fractions_left);
@@ -361,44 +421,40 @@ void NMethodSweeper::sweep_code_cache() {
   // the number of nmethods changes during the sweep so the final
   // stage must iterate until it there are no more nmethods.
   int todo = (CodeCache::nof_nmethods() - _seen) / _sweep_fractions_left;
-  int swept_count = 0;
-
 
   assert(!SafepointSynchronize::is_at_safepoint(), "should not be in safepoint when we get here");
   assert(!CodeCache_lock->owned_by_self(), "just checking");
 
-  int freed_memory = 0;
-  {
-    MutexLockerEx mu(CodeCache_lock, Mutex::_no_safepoint_check_flag);
-
-    // The last invocation iterates until there are no more nmethods
-    for (int i = 0; (i < todo || _sweep_fractions_left == 1) && _current != NULL; i++) {
-      swept_count++;
-      if (SafepointSynchronize::is_synchronizing()) { // Safepoint request
-        if (PrintMethodFlushing && Verbose) {
-          tty->print_cr("### Sweep at %d out of %d, invocation: %d, yielding to safepoint", _seen, CodeCache::nof_nmethods(), _sweep_fractions_left);
-        }
-        MutexUnlockerEx mu(CodeCache_lock, Mutex::_no_safepoint_check_flag);
-
-        assert(Thread::current()->is_Java_thread(), "should be java thread");
-        JavaThread* thread = (JavaThread*)Thread::current();
-        ThreadBlockInVM tbivm(thread);
-        thread->java_suspend_self();
-      }
-      // Since we will give up the CodeCache_lock, always skip ahead
-      // to the next nmethod.  Other blobs can be deleted by other
-      // threads but nmethods are only reclaimed by the sweeper.
-      nmethod* next = CodeCache::next_nmethod(_current);
+  // Let the other sweeper threads help with this sweep
+  bool parallel = Thread::current()->is_Code_cache_sweeper_thread() && CodeCacheSweeperThreads > 1;
+  if (parallel) {
+    MutexLockerEx ml(CodeCacheSweeper_lock, Mutex::_no_safepoint_check_flag);
+    _sweep_todo          = todo;
+    _helper_count        = 0;
+    _helper_freed_memory = 0;
+    _helping_allowed     = true;
+    CodeCacheSweeper_lock->notify_all();
+  }
 
-      // Now ready to process nmethod and give up CodeCache_lock
-      {
-        MutexUnlockerEx mu(CodeCache_lock, Mutex::_no_safepoint_check_flag);
-        freed_memory += process_nmethod(_current);
-      }
-      _seen++;
-      _current = next;
+  int swept = 0;
+  int freed_memory = sweep_nmethods(todo, &swept);
+
+  int threads = 1;
+  if (parallel) {
+    // Wait for the helpers to finish the nmethods they claimed
+    JavaThread* thread = JavaThread::current();
+    ThreadBlockInVM tbivm(thread);
+    MutexLockerEx ml(CodeCacheSweeper_lock, Mutex::_no_safepoint_check_flag);
+    _helping_allowed = false;
+    while (_active_helpers > 0) {
+      CodeCacheSweeper_lock->wait(Mutex::_no_safepoint_check_flag);
     }
+    freed_memory += _helper_freed_memory;
+    threads += _helper_count;
   }
+  int swept_count = _swept_count;
+
+  relocate_hot_nmethods();
 
   assert(_sweep_fractions_left > 1 || _current == NULL, "must have scanned the whole cache");
 
@@ -409,10 +465,28 @@ void NMethodSweeper::sweep_code_cache() {
   _peak_sweep_fraction_time = MAX2(sweep_time, _peak_sweep_fraction_time);
   _total_flushed_size += freed_memory;
   _total_nof_methods_reclaimed += _flushed_count;
+  _total_nof_c2_methods_reclaimed += _flushed_c2_count;
+
+  if (UsePerfData) {
+    _perf_nmethods_swept->inc(swept_count);
+    _perf_nmethods_flushed->inc(_flushed_count);
+    _perf_helpers->inc(threads - 1);
+    _perf_pc_desc_indexes->inc(_pc_desc_index_count);
+    _perf_bytes_flushed->inc(freed_memory);
+    _perf_total_time->inc(sweep_time.value());
+    _perf_peak_fraction_time->set_value(_peak_sweep_fraction_time.value());
+  }
 
   EventSweepCodeCache event(UNTIMED);
   if (event.should_commit()) {
-    post_sweep_event(&event, sweep_start_counter, sweep_end_counter, (s4)_traversals, swept_count, _flushed_count, _zombified_count);
+    post_sweep_event(&event, sweep_start_counter, sweep_end_counter, (s4)_traversals, swept_count,
+                     _flushed_count, _zombified_count, freed_memory, threads);
+  }
+  if (_hot_relocation_count > 0) {
+    EventHotCodeRelocation hot_event(UNTIMED);
+    if (hot_event.should_commit()) {
+      post_hot_code_relocation_event(&hot_event, sweep_start_counter, sweep_end_counter, (s4)_traversals, _hot_relocation_count);
+    }
   }
 
 #ifdef ASSERT
@@ -442,6 +516,129 @@ void NMethodSweeper::sweep_code_cache() {
   }
 }
 
+/**
+ * Claims nmethods of the current sweep and processes them until the
+ * sweep is done. Sweeper threads call this in parallel, the claiming is
+ * serialized by the CodeCache_lock. Returns the memory freed by the
+ * current thread and the number of nmethods it processed in 'swept'.
+ */
+int NMethodSweeper::sweep_nmethods(int todo, int* swept) {
+  int freed_memory = 0;
+  *swept = 0;
+  MutexLockerEx mu(CodeCache_lock, Mutex::_no_safepoint_check_flag);
+
+  // The last invocation iterates until there are no more nmethods
+  while ((_swept_count < todo || _sweep_fractions_left == 1) && _current != NULL) {
+    if (SafepointSynchronize::is_synchronizing()) { // Safepoint request
+      if (PrintMethodFlushing && Verbose) {
+        tty->print_cr("### Sweep at %d out of %d, invocation: %d, yielding to safepoint", _seen, CodeCache::nof_nmethods(), _sweep_fractions_left);
+      }
+      MutexUnlockerEx mu(CodeCache_lock, Mutex::_no_safepoint_check_flag);
+
+      assert(Thread::current()->is_Java_thread(), "should be java thread");
+      JavaThread* thread = (JavaThread*)Thread::current();
+      ThreadBlockInVM tbivm(thread);
+      thread->java_suspend_self();
+      // Another sweeper thread may have claimed the current nmethod meanwhile
+      continue;
+    }
+    // Claim the current nmethod. Since we will give up the CodeCache_lock,
+    // always skip ahead to the next nmethod. Other blobs can be deleted by
+    // other threads but nmethods are only reclaimed by the sweeper, and
+    // only after they have been claimed.
+    nmethod* nm = _current;
+    _current = CodeCache::next_nmethod(nm);
+    _swept_count++;
+    _seen++;
+    (*swept)++;
+
+    // Now ready to process nmethod and give up CodeCache_lock
+    {
+      MutexUnlockerEx mu(CodeCache_lock, Mutex::_no_safepoint_check_flag);
+      freed_memory += process_nmethod(nm);
+    }
+  }
+  return freed_memory;
+}
+
+bool NMethodSweeper::has_sweep_work() {
+  assert_lock_strong(CodeCacheSweeper_lock);
+  return _helping_allowed && _current != NULL;
+}
+
+/**
+ * Called by the sweeper threads to join the sweep that another sweeper
+ * thread started, if any.
+ */
+void NMethodSweeper::help_sweep() {
+  int todo;
+  {
+    MutexLockerEx ml(CodeCacheSweeper_lock, Mutex::_no_safepoint_check_flag);
+    if (!has_sweep_work()) {
+      return;
+    }
+    _active_helpers++;
+    todo = _sweep_todo;
+  }
+
+  int swept = 0;
+  int freed_memory = sweep_nmethods(todo, &swept);
+
+  {
+    MutexLockerEx ml(CodeCacheSweeper_lock, Mutex::_no_safepoint_check_flag);
+    _helper_freed_memory += freed_memory;
+    if (swept > 0) {
+      _helper_count++;
+    }
+    if (--_active_helpers == 0) {
+      CodeCacheSweeper_lock->notify_all();
+    }
+  }
+}
+
+void NMethodSweeper::initialize() {
+  if (UsePerfData) {
+    EXCEPTION_MARK;
+
+    _perf_sweeps =
+                 PerfDataManager::create_counter(SUN_CI, "sweeper.sweeps",
+                                                 PerfData::U_Events, CHECK);
+    _perf_nmethods_swept =
+                 PerfDataManager::create_counter(SUN_CI, "sweeper.nmethodsSwept",
+                                                 PerfData::U_Events, CHECK);
+    _perf_nmethods_flushed =
+                 PerfDataManager::create_counter(SUN_CI, "sweeper.nmethodsFlushed",
+                                                 PerfData::U_Events, CHECK);
+    _perf_helpers =
+                 PerfDataManager::create_counter(SUN_CI, "sweeper.helpers",
+                                                 PerfData::U_Events, CHECK);
+    _perf_pc_desc_indexes =
+                 PerfDataManager::create_counter(SUN_CI, "sweeper.pcDescIndexes",
+                                                 PerfData::U_Events, CHECK);
+    _perf_bytes_flushed =
+                 PerfDataManager::create_counter(SUN_CI, "sweeper.bytesFlushed",
+                                                 PerfData::U_Bytes, CHECK);
+    _perf_total_time =
+                 PerfDataManager::create_counter(SUN_CI, "sweeper.totalTime",
+                                                 PerfData::U_Ticks, CHECK);
+    _perf_peak_fraction_time =
+                 PerfDataManager::create_variable(SUN_CI, "sweeper.peakFractionTime",
+                                                  PerfData::U_Ticks, CHECK);
+    PerfDataManager::create_constant(SUN_CI, "sweeper.threads",
+                                     PerfData::U_None, (jlong)CodeCacheSweeperThreads, CHECK);
+  }
+
+  if (CodeCache::heap_available(CodeBlobType::MethodHot) && HotCodeRelocationLimit > 0) {
+    _hot_nmethods = NEW_C_HEAP_ARRAY(nmethod*, HotCodeRelocationLimit, mtCode);
+  }
+}
+
+void NMethodSweeper::start_threads() {
+  if (MethodFlushing && CodeCacheSweeperThreads > 0) {
+    CodeCacheSweeperThread::initialize();
+  }
+}
+
 /**
  * This function updates the sweeper statistics that keep track of nmethods
  * state changes. If there is 'enough' state change, the sweeper is invoked
@@ -469,18 +666,10 @@ void NMethodSweeper::possibly_enable_sweeper() {
 
 class NMethodMarker: public StackObj {
  private:
-#if INCLUDE_JVMCI
   JavaThread* _thread;
-#else
-  CompilerThread* _thread;
-#endif
  public:
   NMethodMarker(nmethod* nm) {
-#if INCLUDE_JVMCI
     _thread = JavaThread::current();
-#else
-    _thread = CompilerThread::current();
-#endif
     if (!nm->is_zombie() && !nm->is_unloaded()) {
       // Only expose live nmethods for scanning
       _thread->set_scanned_nmethod(nm);
@@ -540,10 +729,10 @@ int NMethodSweeper::process_nmethod(nmethod *nm) {
       }
       freed_memory = nm->total_size();
       if (nm->is_compiled_by_c2()) {
-        _total_nof_c2_methods_reclaimed++;
+        Atomic::inc(&_flushed_c2_count);
       }
       release_nmethod(nm);
-      _flushed_count++;
+      Atomic::inc(&_flushed_count);
     } else {
       if (PrintMethodFlushing && Verbose) {
         tty->print_cr("### Nmethod %3d/" PTR_FORMAT " (zombie) being marked for reclamation", nm->compile_id(), nm);
@@ -551,7 +740,7 @@ int NMethodSweeper::process_nmethod(nmethod *nm) {
       nm->mark_for_reclamation();
       // Keep track of code cache state change
       _bytes_changed += nm->total_size();
-      _marked_for_reclamation_count++;
+      Atomic::inc(&_marked_for_reclamation_count);
       SWEEP(nm);
     }
   } else if (nm->is_not_entrant()) {
@@ -569,7 +758,7 @@ int NMethodSweeper::process_nmethod(nmethod *nm) {
       }
       // Code cache state change is tracked in make_zombie()
       nm->make_zombie();
-      _zombified_count++;
+      Atomic::inc(&_zombified_count);
       SWEEP(nm);
     } else {
       // Still alive, clean up its inline caches
@@ -587,10 +776,10 @@ int NMethodSweeper::process_nmethod(nmethod *nm) {
       // No inline caches will ever point to osr methods, so we can just remove it
       freed_memory = nm->total_size();
       if (nm->is_compiled_by_c2()) {
-        _total_nof_c2_methods_reclaimed++;
+        Atomic::inc(&_flushed_c2_count);
       }
       release_nmethod(nm);
-      _flushed_count++;
+      Atomic::inc(&_flushed_count);
     } else {
       {
         // Clean ICs of unloaded nmethods as well because they may reference other
@@ -600,7 +789,7 @@ int NMethodSweeper::process_nmethod(nmethod *nm) {
       }
       // Code cache state change is tracked in make_zombie()
       nm->make_zombie();
-      _zombified_count++;
+      Atomic::inc(&_zombified_count);
       SWEEP(nm);
     }
   } else {
@@ -632,9 +821,14 @@ int NMethodSweeper::process_nmethod(nmethod *nm) {
             tty->print_cr("### Nmethod %d/" PTR_FORMAT "made not-entrant: hotness counter %d/%d threshold %f",
                           nm->compile_id(), nm, nm->hotness_counter(), reset_val, threshold);
           }
+        } else if (nm->is_in_use()) {
+          possibly_relocate_hot_nmethod(nm, time_since_reset);
         }
       }
     }
+    if (UsePcDescIndex && nm->possibly_build_pc_desc_index()) {
+      Atomic::inc(&_pc_desc_index_count);
+    }
     // Clean-up all inline caches that point to zombie/non-reentrant methods
     MutexLocker cl(CompiledIC_lock);
     nm->cleanup_inline_caches();
@@ -643,6 +837,111 @@ int NMethodSweeper::process_nmethod(nmethod *nm) {
   return freed_memory;
 }
 
+/**
+ * An nmethod that was found active on a thread stack in HotCodeMinSweeps
+ * consecutive sweeps is moved to the hot code heap. This is a cheap proxy
+ * for hot code: code of the highest tier does not update the invocation
+ * and backedge counters, so the sweeper only knows whether an nmethod was
+ * on a stack at a safepoint. Besides frequently executed code this also
+ * selects the frames of long running loops and of threads that are blocked
+ * in compiled code, which are not necessarily hot. The code of an nmethod
+ * cannot be moved in place, so the method is recompiled in the background
+ * and the new nmethod is allocated in the hot code heap (see
+ * nmethod::new_nmethod()). Installing it makes the old nmethod not-entrant,
+ * which is eventually flushed by the sweeper.
+ *
+ * The nmethod is only queued here. The recompilations are requested by
+ * relocate_hot_nmethods() once all sweeper threads are done with the sweep.
+ */
+void NMethodSweeper::possibly_relocate_hot_nmethod(nmethod* nm, int time_since_reset) {
+  if (_hot_nmethods == NULL) {
+    return;
+  }
+  // The hotness counter was reset if the nmethod was on a stack since it was swept last
+  if (time_since_reset > 1) {
+    nm->reset_hot_sweep_count();
+    return;
+  }
+  if (nm->inc_hot_sweep_count() < HotCodeMinSweeps) {
+    return;
+  }
+  nm->reset_hot_sweep_count();
+
+  // Only the non-profiled code of the highest tier is moved. A blocking
+  // compilation could deadlock with the compiler thread that is sweeping.
+  if (nm->comp_level() != CompLevel_highest_tier || nm->method()->is_hot_code() ||
+      !BackgroundCompilation || !CompileBroker::should_compile_new_jobs() ||
+      _hot_relocation_count >= HotCodeRelocationLimit ||
+      CodeCache::get_code_heap(nm)->code_blob_type() == CodeBlobType::MethodHot ||
+      CodeCache::unallocated_capacity(CodeBlobType::MethodHot) <= (size_t)nm->total_size() + CodeCacheMinimumFreeSpace) {
+    return;
+  }
+
+  // Sweeper threads may find hot nmethods concurrently, each claims a slot
+  int slot = Atomic::add(1, &_hot_relocation_count) - 1;
+  if (slot < HotCodeRelocationLimit) {
+    _hot_nmethods[slot] = nm;
+  }
+}
+
+// Requests the recompilation of the nmethods queued by
+// possibly_relocate_hot_nmethod() during the current sweep
+void NMethodSweeper::relocate_hot_nmethods() {
+  int queued = MIN2((int)_hot_relocation_count, (int)HotCodeRelocationLimit);
+  _hot_relocation_count = 0;
+  if (queued == 0) {
+    return;
+  }
+
+  JavaThread* thread = JavaThread::current();
+  for (int i = 0; i < queued; i++) {
+    nmethod* nm = _hot_nmethods[i];
+    _hot_nmethods[i] = NULL;
+    // An nmethod is not flushed in the sweep that found it hot, but its
+    // class may have been unloaded at a safepoint since then
+    if (!nm->is_in_use() || nm->method()->is_hot_code()) {
+      continue;
+    }
+
+    HandleMark hm(thread);
+    methodHandle mh(thread, nm->method());
+    // Keep the holder alive while the compilation is requested
+    Handle holder(thread, mh->method_holder()->klass_holder());
+    // The flag directs the next nmethod of the method into the hot code
+    // heap. It is cleared again if no compilation ends up installing one.
+    mh->set_hot_code(true);
+    CompileBroker::compile_method(mh, InvocationEntryBci, CompLevel_highest_tier,
+                                  mh, 0, "hot code relocation", thread);
+    if (thread->has_pending_exception()) {
+      thread->clear_pending_exception();
+    }
+    // The compilation may have been rejected
+    possibly_clear_hot_code(mh());
+    if (!mh->is_hot_code()) {
+      continue;
+    }
+    _hot_relocation_count++;
+    if (PrintMethodFlushing && Verbose) {
+      tty->print_cr("### Nmethod %d/" PTR_FORMAT " is hot, recompiling into the hot code heap",
+                    nm->compile_id(), nm);
+    }
+  }
+}
+
+// Clears the hot code flag of `method` if no compilation of it is pending
+// and its code is not in the hot code heap, i.e., the relocation requested
+// by relocate_hot_nmethods() was rejected, failed or dropped from the
+// compile queue. The method can then be found hot again in a later sweep.
+void NMethodSweeper::possibly_clear_hot_code(Method* method) {
+  if (!method->is_hot_code() || method->queued_for_compilation()) {
+    return;
+  }
+  nmethod* code = method->code();
+  if (code == NULL || CodeCache::get_code_heap(code)->code_blob_type() != CodeBlobType::MethodHot) {
+    method->set_hot_code(false);
+  }
+}
+
 // Print out some state information about the current sweep and the
 // state of the code cache if it's requested.
 void NMethodSweeper::log_sweep(const char* msg, const char* format, ...) {
@@ -25,7 +25,9 @@
 #ifndef SHARE_VM_RUNTIME_SWEEPER_HPP
 #define SHARE_VM_RUNTIME_SWEEPER_HPP
 
+#include "runtime/perfData.hpp"
 #include "utilities/ticks.hpp"
+
 // An NmethodSweeper is an incremental cleaner for:
 //    - cleanup inline caches
 //    - reclamation of nmethods
@@ -52,6 +54,9 @@
 //     nmethod's space is freed. Sweeping is currently done by compiler threads between
 //     compilations or at least each 5 sec (NmethodSweepCheckInterval) when the code cache
 //     is full.
+//     With CodeCacheSweeperThreads, dedicated sweeper threads sweep instead. The
+//     thread that starts a sweep lets the others join it, all of them claim nmethods
+//     from the shared cursor '_current' and process them in parallel.
 
 class NMethodSweeper : public AllStatic {
   static long      _traversals;                     // Stack scan count, also sweep ID.
@@ -60,9 +65,14 @@ class NMethodSweeper : public AllStatic {
   static long      _last_sweep;                     // Value of _time_counter when the last sweep happened
   static nmethod*  _current;                        // Current nmethod
   static int       _seen;                           // Nof. nmethod we have currently processed in current pass of CodeCache
-  static int       _flushed_count;                  // Nof. nmethods flushed in current sweep
-  static int       _zombified_count;                // Nof. nmethods made zombie in current sweep
-  static int       _marked_for_reclamation_count;   // Nof. nmethods marked for reclaim in current sweep
+  static int       _swept_count;                    // Nof. nmethods claimed in current sweep
+  static volatile int _flushed_count;               // Nof. nmethods flushed in current sweep
+  static volatile int _flushed_c2_count;            // Nof. C2-compiled nmethods flushed in current sweep
+  static volatile int _zombified_count;             // Nof. nmethods made zombie in current sweep
+  static volatile int _marked_for_reclamation_count; // Nof. nmethods marked for reclaim in current sweep
+  static volatile int _hot_relocation_count;        // Nof. nmethods moved to the hot code heap in current sweep
+  static volatile int _pc_desc_index_count;         // Nof. PcDesc indexes built in current sweep
+  static nmethod** _hot_nmethods;                   // Hot nmethods found in current sweep, HotCodeRelocationLimit at most
 
   static volatile int  _sweep_fractions_left;       // Nof. invocations left until we are completed with this pass
   static volatile int  _sweep_started;              // Flag to control conc sweeper
@@ -82,11 +92,31 @@ class NMethodSweeper : public AllStatic {
   static Tickspan  _peak_sweep_time;                // Peak time for a full sweep
   static Tickspan  _peak_sweep_fraction_time;       // Peak time sweeping one fraction
 
+  // Coordination of the sweeper threads, protected by the CodeCacheSweeper_lock
+  static bool      _helping_allowed;                // Other sweeper threads may join the current sweep
+  static int       _sweep_todo;                     // Nof. nmethods to sweep in the current sweep
+  static int       _active_helpers;                 // Nof. sweeper threads helping with the current sweep
+  static int       _helper_count;                   // Nof. sweeper threads that helped with the current sweep
+  static int       _helper_freed_memory;            // Memory freed by the helping sweeper threads
+
+  // Performance counters
+  static PerfCounter*  _perf_sweeps;
+  static PerfCounter*  _perf_nmethods_swept;
+  static PerfCounter*  _perf_nmethods_flushed;
+  static PerfCounter*  _perf_helpers;
+  static PerfCounter*  _perf_pc_desc_indexes;
+  static PerfCounter*  _perf_bytes_flushed;
+  static PerfCounter*  _perf_total_time;
+  static PerfVariable* _perf_peak_fraction_time;
+
   static int  process_nmethod(nmethod *nm);
+  static void possibly_relocate_hot_nmethod(nmethod* nm, int time_since_reset);
+  static void relocate_hot_nmethods();
   static void release_nmethod(nmethod* nm);
 
   static bool sweep_in_progress();
   static void sweep_code_cache();
+  static int  sweep_nmethods(int todo, int* swept);
 
  public:
   static long traversal_count()              { return _traversals; }
@@ -105,10 +135,15 @@ class NMethodSweeper : public AllStatic {
   static void report_events();
 #endif
 
+  static void initialize();                // Creates the counters, before any thread can sweep
+  static void start_threads();             // Starts the dedicated sweeper threads, if any
   static void mark_active_nmethods();      // Invoked at the end of each safepoint
   static void possibly_sweep();            // Compiler threads call this to sweep
+  static bool has_sweep_work();            // Whether sweeper threads can help with the current sweep
+  static void help_sweep();                // Sweeper threads call this to join the current sweep
 
   static int hotness_counter_reset_val();
+  static void possibly_clear_hot_code(Method* method); // Called when a compilation of `method` is done
   static void report_state_change(nmethod* nm);
   static void possibly_enable_sweeper();
   static void print();   // Printing/debugging
@@ -324,6 +324,7 @@ class Thread: public ThreadShadow {
   virtual bool is_VM_thread()       const            { return false; }
   virtual bool is_Java_thread()     const            { return false; }
   virtual bool is_Compiler_thread() const            { return false; }
+  virtual bool is_Code_cache_sweeper_thread() const  { return false; }
   virtual bool is_hidden_from_external_view() const  { return false; }
   virtual bool is_jvmti_agent_thread() const         { return false; }
   // True iff the thread can perform GC operations at a safepoint.
@@ -949,15 +950,22 @@ class JavaThread: public Thread {
   } _jvmci;
 
   // Support for high precision, thread sensitive counters in JVMCI compiled code.
+  // The counters are managed by JVMCICounters.
   jlong*    _jvmci_counters;
 
- public:
-  static jlong* _jvmci_old_thread_counters;
-  static void collect_counters(jlong* array, int length);
+  // Number of CompilerToVM calls made by this thread and the time they
+  // took. Only updated when JVMCIProfileVMEntries is true.
+  jlong     _jvmci_vm_entry_count;
+  jlong     _jvmci_vm_entry_ticks;
 
-  bool resize_counters(int current_size, int new_size);
+ public:
+  jlong* jvmci_counters() const                  { return _jvmci_counters; }
+  void set_jvmci_counters(jlong* counters)       { _jvmci_counters = counters; }
 
-  static bool resize_all_jvmci_counters(int new_size);
+  jlong jvmci_vm_entry_count() const             { return _jvmci_vm_entry_count; }
+  jlong jvmci_vm_entry_ticks() const             { return _jvmci_vm_entry_ticks; }
+  void add_jvmci_vm_entry_ticks(jlong ticks)     { _jvmci_vm_entry_count++; _jvmci_vm_entry_ticks += ticks; }
+  void reset_jvmci_vm_entry_ticks()              { _jvmci_vm_entry_count = 0; _jvmci_vm_entry_ticks = 0; }
 
  private:
 #endif
@@ -1921,7 +1929,6 @@ class CompilerThread : public JavaThread {
   CompileQueue*     _queue;
   BufferBlob*       _buffer_blob;
 
-  nmethod*          _scanned_nmethod;  // nmethod being scanned by the sweeper
   AbstractCompiler* _compiler;
 
  public:
@@ -1962,11 +1969,6 @@ class CompilerThread : public JavaThread {
     _log = log;
   }
 
-  // GC support
-  // Apply "f->do_oop" to all root oops in "this".
-  // Apply "cf->do_code_blob" (if !NULL) to all code blobs active in frames
-  void oops_do(OopClosure* f, CLDClosure* cld_f, CodeBlobClosure* cf);
-
 #ifndef PRODUCT
 private:
   IdealGraphPrinter *_ideal_graph_printer;
@@ -1978,12 +1980,6 @@ public:
   // Get/set the thread's current task
   CompileTask*  task()                           { return _task; }
   void          set_task(CompileTask* task)      { _task = task; }
-
-  // Track the nmethod currently being scanned by the sweeper
-  void          set_scanned_nmethod(nmethod* nm) {
-    assert(_scanned_nmethod == NULL || nm == NULL, "should reset to NULL before writing a new value");
-    _scanned_nmethod = nm;
-  }
 };
 
 inline CompilerThread* CompilerThread::current() {
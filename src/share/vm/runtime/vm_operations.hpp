@@ -98,9 +98,9 @@
   template(LinuxDllLoad)                          \
   template(RotateGCLog)                           \
   template(WhiteBoxOperation)                     \
-  template(JVMCIResizeCounters)                   \
   template(ClassLoaderStatsOperation)             \
   template(JFROldObject)                          \
+  template(JVMCIResizeCounters)                   \
 
 class VM_Operation: public CHeapObj<mtInternal> {
  public:
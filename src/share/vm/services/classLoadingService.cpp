@@ -106,6 +106,11 @@ PerfCounter*    ClassLoadingService::_shared_classbytes_loaded = NULL;
 PerfCounter*    ClassLoadingService::_shared_classbytes_unloaded = NULL;
 PerfVariable*   ClassLoadingService::_class_methods_size = NULL;
 
+// counters for dependency checking on class loading
+PerfCounter*    ClassLoadingService::_dependency_check_time = NULL;
+PerfCounter*    ClassLoadingService::_dependency_checked_classes = NULL;
+PerfVariable*   ClassLoadingService::_max_dependency_check_time = NULL;
+
 void ClassLoadingService::init() {
   EXCEPTION_MARK;
 
@@ -146,6 +151,16 @@ void ClassLoadingService::init() {
     _class_methods_size =
                  PerfDataManager::create_variable(SUN_CLS, "methodBytes",
                                                   PerfData::U_Bytes, CHECK);
+
+    _dependency_check_time =
+                 PerfDataManager::create_counter(SUN_CLS, "dependencyCheckTime",
+                                                 PerfData::U_Ticks, CHECK);
+    _dependency_checked_classes =
+                 PerfDataManager::create_counter(SUN_CLS, "dependencyCheckedClasses",
+                                                 PerfData::U_Events, CHECK);
+    _max_dependency_check_time =
+                 PerfDataManager::create_variable(SUN_CLS, "maxDependencyCheckTime",
+                                                  PerfData::U_Ticks, CHECK);
   }
 
   if (LogEvents) {
@@ -197,6 +212,17 @@ void ClassLoadingService::notify_class_loaded(InstanceKlass* k, bool shared_clas
   }
 }
 
+void ClassLoadingService::add_dependency_check_time(jlong ticks) {
+  // Called with the Compile_lock held
+  if (UsePerfData) {
+    _dependency_check_time->inc(ticks);
+    _dependency_checked_classes->inc();
+    if (ticks > _max_dependency_check_time->get_value()) {
+      _max_dependency_check_time->set_value(ticks);
+    }
+  }
+}
+
 size_t ClassLoadingService::compute_class_size(InstanceKlass* k) {
   // lifted from ClassStatistics.do_class(Klass* k)
 
@@ -49,6 +49,11 @@ private:
 
   static PerfVariable* _class_methods_size;
 
+  // Counters for dependency checking of compiled code on class loading
+  static PerfCounter*  _dependency_check_time;
+  static PerfCounter*  _dependency_checked_classes;
+  static PerfVariable* _max_dependency_check_time;
+
   static size_t compute_class_size(InstanceKlass* k);
 
 public:
@@ -107,6 +112,9 @@ public:
       NOT_MANAGEMENT_RETURN;
   // All unloaded classes are non-shared
   static void notify_class_unloaded(InstanceKlass* k) NOT_MANAGEMENT_RETURN;
+  // Records the time spent checking the dependencies of compiled code
+  // on a newly loaded class
+  static void add_dependency_check_time(jlong ticks) NOT_MANAGEMENT_RETURN;
   static void add_class_method_size(int size) {
 #if INCLUDE_MANAGEMENT
     if (UsePerfData) {
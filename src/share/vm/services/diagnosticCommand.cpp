@@ -24,6 +24,7 @@
 
 #include "precompiled.hpp"
 #include "classfile/classLoaderStats.hpp"
+#include "code/codeCache.hpp"
 #include "gc_implementation/shared/vmGCOperations.hpp"
 #include "runtime/javaCalls.hpp"
 #include "runtime/os.hpp"
@@ -34,6 +35,10 @@
 #include "services/management.hpp"
 #include "utilities/macros.hpp"
 #include "oops/objArrayOop.hpp"
+#if INCLUDE_JVMCI
+#include "jvmci/jvmciCompilationCache.hpp"
+#include "jvmci/jvmciEntryProfiler.hpp"
+#endif
 
 PRAGMA_FORMAT_MUTE_WARNINGS_FOR_GCC
 
@@ -63,6 +68,11 @@ void DCmdRegistrant::register_dcmds(){
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<ThreadDumpDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<RotateGCLogDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<ClassLoaderStatsDCmd>(full_export, true, false));
+  DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<CodeCacheFreeListDCmd>(full_export, true, false));
+#if INCLUDE_JVMCI
+  DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<JVMCICompilationCacheDCmd>(full_export, true, false));
+  DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<JVMCIVMEntriesDCmd>(full_export, true, false));
+#endif // INCLUDE_JVMCI
 
   // Enhanced JMX Agent Support
   // These commands won't be exported via the DiagnosticCommandMBean until an
@@ -736,3 +746,38 @@ void RotateGCLogDCmd::execute(DCmdSource source, TRAPS) {
     output()->print_cr("Target VM does not support GC log file rotation.");
   }
 }
+
+void CodeCacheFreeListDCmd::execute(DCmdSource source, TRAPS) {
+  CodeCache::print_freelist_statistics(output());
+}
+
+#if INCLUDE_JVMCI
+void JVMCICompilationCacheDCmd::execute(DCmdSource source, TRAPS) {
+  JVMCICompilationCache::print_statistics(output());
+}
+
+JVMCIVMEntriesDCmd::JVMCIVMEntriesDCmd(outputStream* output, bool heap) :
+                                       DCmdWithParser(output, heap),
+  _reset("-reset", "Clear the statistics after printing them",
+         "BOOLEAN", false, "false") {
+  _dcmdparser.add_dcmd_option(&_reset);
+}
+
+void JVMCIVMEntriesDCmd::execute(DCmdSource source, TRAPS) {
+  JVMCIEntryProfiler::print_on(output());
+  if (_reset.value()) {
+    JVMCIEntryProfiler::reset();
+  }
+}
+
+int JVMCIVMEntriesDCmd::num_arguments() {
+  ResourceMark rm;
+  JVMCIVMEntriesDCmd* dcmd = new JVMCIVMEntriesDCmd(NULL, false);
+  if (dcmd != NULL) {
+    DCmdMark mark(dcmd);
+    return dcmd->_dcmdparser.num_arguments();
+  } else {
+    return 0;
+  }
+}
+#endif // INCLUDE_JVMCI
@@ -441,4 +441,62 @@ public:
   }
 };
 
+class CodeCacheFreeListDCmd : public DCmd {
+public:
+  CodeCacheFreeListDCmd(outputStream* output, bool heap) : DCmd(output, heap) {}
+  static const char* name() { return "Compiler.codecache_freelist"; }
+  static const char* description() {
+    return "Print the free blocks and the fragmentation of the code heaps.";
+  }
+  static const char* impact() {
+    return "Low: Depends on the number of free blocks";
+  }
+  static int num_arguments() { return 0; }
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+                        "monitor", NULL};
+    return p;
+  }
+  virtual void execute(DCmdSource source, TRAPS);
+};
+
+#if INCLUDE_JVMCI
+class JVMCICompilationCacheDCmd : public DCmd {
+public:
+  JVMCICompilationCacheDCmd(outputStream* output, bool heap) : DCmd(output, heap) {}
+  static const char* name() { return "Compiler.jvmci_compilation_cache"; }
+  static const char* description() {
+    return "Print statistics about the JVMCI compilation cache.";
+  }
+  static const char* impact() { return "Low"; }
+  static int num_arguments() { return 0; }
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+                        "monitor", NULL};
+    return p;
+  }
+  virtual void execute(DCmdSource source, TRAPS);
+};
+
+class JVMCIVMEntriesDCmd : public DCmdWithParser {
+protected:
+  DCmdArgument<bool> _reset;
+public:
+  JVMCIVMEntriesDCmd(outputStream* output, bool heap);
+  static const char* name() { return "Compiler.jvmci_vm_entries"; }
+  static const char* description() {
+    return "Print call counts and latency histograms of the JVMCI CompilerToVM entry points. "
+           "Requires -XX:+JVMCIProfileVMEntries.";
+  }
+  static const char* impact() { return "Low"; }
+  static int num_arguments();
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+                        "monitor", NULL};
+    return p;
+  }
+  virtual void execute(DCmdSource source, TRAPS);
+};
+#endif // INCLUDE_JVMCI
+
 #endif // SHARE_VM_SERVICES_DIAGNOSTICCOMMAND_HPP
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Checks VM options related to the segmented code cache
+ * @library /testlibrary
+ *
+ */
+import com.oracle.java.testlibrary.*;
+
+public class CheckSegmentedCodeCache {
+  private static final String NON_NMETHOD  = "CodeHeap 'non-nmethods'";
+  private static final String PROFILED     = "CodeHeap 'profiled nmethods'";
+  private static final String NON_PROFILED = "CodeHeap 'non-profiled nmethods'";
+  private static final String HOT          = "CodeHeap 'hot nmethods'";
+
+  private static void verifySegmented(ProcessBuilder pb, boolean profiled) throws Exception {
+    verifySegmented(pb, profiled, false);
+  }
+
+  private static void verifySegmented(ProcessBuilder pb, boolean profiled, boolean hot) throws Exception {
+    OutputAnalyzer out = new OutputAnalyzer(pb.start());
+    out.shouldHaveExitValue(0);
+    out.shouldContain(NON_NMETHOD);
+    out.shouldContain(NON_PROFILED);
+    if (profiled) {
+      out.shouldContain(PROFILED);
+    } else {
+      out.shouldNotContain(PROFILED);
+    }
+    if (hot) {
+      out.shouldContain(HOT);
+    } else {
+      out.shouldNotContain(HOT);
+    }
+  }
+
+  public static void main(String[] args) throws Exception {
+    ProcessBuilder pb;
+    OutputAnalyzer out;
+
+    // The code cache is not segmented by default
+    pb = ProcessTools.createJavaProcessBuilder("-XX:+PrintCodeCache", "-version");
+    out = new OutputAnalyzer(pb.start());
+    out.shouldHaveExitValue(0);
+    out.shouldNotContain(NON_NMETHOD);
+
+    // All three code heaps are used with TieredCompilation
+    pb = ProcessTools.createJavaProcessBuilder("-XX:+SegmentedCodeCache",
+                                               "-XX:+TieredCompilation",
+                                               "-XX:+PrintCodeCache", "-version");
+    verifySegmented(pb, true);
+
+    // There is no profiled code heap without TieredCompilation
+    pb = ProcessTools.createJavaProcessBuilder("-XX:+SegmentedCodeCache",
+                                               "-XX:-TieredCompilation",
+                                               "-XX:+PrintCodeCache", "-version");
+    verifySegmented(pb, false);
+
+    // The code cache size is derived from the code heap sizes
+    pb = ProcessTools.createJavaProcessBuilder("-XX:+SegmentedCodeCache",
+                                               "-XX:+TieredCompilation",
+                                               "-XX:NonNMethodCodeHeapSize=8M",
+                                               "-XX:ProfiledCodeHeapSize=32M",
+                                               "-XX:NonProfiledCodeHeapSize=32M",
+                                               "-XX:+PrintCodeCache", "-version");
+    verifySegmented(pb, true);
+
+    // The code heaps must fit into the code cache
+    pb = ProcessTools.createJavaProcessBuilder("-XX:+SegmentedCodeCache",
+                                               "-XX:ReservedCodeCacheSize=64M",
+                                               "-XX:NonNMethodCodeHeapSize=8M",
+                                               "-XX:ProfiledCodeHeapSize=32M",
+                                               "-XX:NonProfiledCodeHeapSize=32M",
+                                               "-version");
+    out = new OutputAnalyzer(pb.start());
+    out.shouldContain("Invalid code heap sizes");
+    out.shouldHaveExitValue(1);
+
+    // The non-nmethod code heap must be large enough to run the VM
+    pb = ProcessTools.createJavaProcessBuilder("-XX:+SegmentedCodeCache",
+                                               "-XX:NonNMethodCodeHeapSize=100K",
+                                               "-version");
+    out = new OutputAnalyzer(pb.start());
+    out.shouldContain("Not enough space in non-nmethod code heap to run VM");
+    out.shouldHaveExitValue(1);
+
+    // The hot code heap is only created if HotCodeHeapSize is set
+    pb = ProcessTools.createJavaProcessBuilder("-XX:+SegmentedCodeCache",
+                                               "-XX:+TieredCompilation",
+                                               "-XX:HotCodeHeapSize=8M",
+                                               "-XX:+PrintCodeCache", "-version");
+    verifySegmented(pb, true, true);
+
+    // There is no hot code heap without SegmentedCodeCache
+    pb = ProcessTools.createJavaProcessBuilder("-XX:HotCodeHeapSize=8M",
+                                               "-XX:+PrintCodeCache", "-version");
+    out = new OutputAnalyzer(pb.start());
+    out.shouldContain("HotCodeHeapSize is ignored without SegmentedCodeCache");
+    out.shouldNotContain(HOT);
+    out.shouldHaveExitValue(0);
+
+    // The hot code heap must be larger than CodeCacheMinimumFreeSpace
+    pb = ProcessTools.createJavaProcessBuilder("-XX:+SegmentedCodeCache",
+                                               "-XX:HotCodeHeapSize=100K",
+                                               "-version");
+    out = new OutputAnalyzer(pb.start());
+    out.shouldContain("Not enough space in hot code heap");
+    out.shouldHaveExitValue(1);
+  }
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Installs and frees millions of code blobs of random sizes and
+ *          checks that the code heap free lists reuse the freed space
+ * @library /testlibrary /testlibrary/whitebox
+ * @build sun.hotspot.WhiteBox
+ * @run main ClassFileInstaller sun.hotspot.WhiteBox
+ *                              sun.hotspot.WhiteBox$WhiteBoxPermission
+ * @run main/othervm -Xbootclasspath/a:. -XX:+UnlockDiagnosticVMOptions -XX:+WhiteBoxAPI
+ *                   CodeHeapFreeListStress
+ * @run main/othervm -Xbootclasspath/a:. -XX:+UnlockDiagnosticVMOptions -XX:+WhiteBoxAPI
+ *                   -XX:+SegmentedCodeCache CodeHeapFreeListStress
+ */
+import java.lang.management.ManagementFactory;
+import java.util.Random;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+import javax.management.ObjectName;
+
+import sun.hotspot.WhiteBox;
+
+public class CodeHeapFreeListStress {
+  private static final WhiteBox WB = WhiteBox.getWhiteBox();
+
+  // CodeBlobType::NonNMethod, mapped to the only code heap if the code
+  // cache is not segmented
+  private static final int BLOB_TYPE    = 2;
+  private static final int OPERATIONS   = 2_000_000;
+  private static final int LIVE_BLOBS   = 1024;
+  private static final int MAX_SIZE     = 8 * 1024;
+
+  public static void main(String[] args) throws Exception {
+    Random random = new Random(42);
+    long[] blobs = new long[LIVE_BLOBS];
+
+    // Fill the window first so that the free lists, and not the unallocated
+    // end of the code heap, serve the allocations that follow
+    for (int i = 0; i < LIVE_BLOBS; i++) {
+      blobs[i] = allocate(random);
+    }
+    long highWater = highWater(freeListStatistics());
+
+    long start = System.nanoTime();
+    for (int i = 0; i < OPERATIONS; i++) {
+      int victim = random.nextInt(LIVE_BLOBS);
+      WB.freeCodeBlob(blobs[victim]);
+      blobs[victim] = allocate(random);
+    }
+    long elapsed = System.nanoTime() - start;
+    System.out.println(String.format("%d code blob replacements: %.1f ns/op",
+                                     OPERATIONS, (double)elapsed / OPERATIONS));
+
+    // The live set has the same size distribution as before, so a heap
+    // that reuses and merges freed blocks does not move its high water mark,
+    // the start of its never allocated part, much further
+    String statistics = freeListStatistics();
+    System.out.println(statistics);
+    if (!statistics.contains("fragmentation=")) {
+      throw new RuntimeException("Missing fragmentation in Compiler.codecache_freelist output");
+    }
+    long grown = highWater(statistics) - highWater;
+    System.out.println("Code heaps grew by " + grown / 1024 + "Kb");
+    if (grown > (long)LIVE_BLOBS * MAX_SIZE) {
+      throw new RuntimeException("Freed code heap space is not reused: grew by " + grown + " bytes");
+    }
+
+    for (int i = 0; i < LIVE_BLOBS; i++) {
+      WB.freeCodeBlob(blobs[i]);
+    }
+  }
+
+  private static long allocate(Random random) {
+    // Mostly small blobs like adapters and stubs, with some large ones
+    int size = random.nextInt(8) == 0 ? random.nextInt(MAX_SIZE) : random.nextInt(512);
+    long blob = WB.allocateCodeBlob(size, BLOB_TYPE);
+    if (blob == 0) {
+      throw new RuntimeException("Code blob allocation failed");
+    }
+    return blob;
+  }
+
+  // Sums the high water marks of all code heaps, in bytes
+  private static long highWater(String statistics) {
+    Matcher m = Pattern.compile("high_water=(\\d+)Kb").matcher(statistics);
+    long highWater = 0;
+    boolean found = false;
+    while (m.find()) {
+      highWater += Long.parseLong(m.group(1)) * 1024;
+      found = true;
+    }
+    if (!found) {
+      throw new RuntimeException("Missing high_water in Compiler.codecache_freelist output");
+    }
+    return highWater;
+  }
+
+  private static String freeListStatistics() throws Exception {
+    ObjectName name = new ObjectName("com.sun.management:type=DiagnosticCommand");
+    return (String)ManagementFactory.getPlatformMBeanServer().invoke(name,
+        "compilerCodecacheFreelist", new Object[] { null }, new String[] { String[].class.getName() });
+  }
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary The sweeper moves a method that is always active on a thread
+ *          stack into the hot code heap
+ * @library /testlibrary /testlibrary/whitebox
+ * @build HotCodeRelocation sun.hotspot.WhiteBox sun.hotspot.code.NMethod
+ * @run main ClassFileInstaller sun.hotspot.WhiteBox
+ *                              sun.hotspot.WhiteBox$WhiteBoxPermission
+ * @run main/othervm -Xbootclasspath/a:. -XX:+UnlockDiagnosticVMOptions -XX:+WhiteBoxAPI
+ *                   -XX:+SegmentedCodeCache -XX:HotCodeHeapSize=8M -XX:HotCodeMinSweeps=1
+ *                   -XX:-TieredCompilation -XX:NmethodSweepFraction=1 -XX:NmethodSweepCheckInterval=1
+ *                   -XX:CompileCommand=dontinline,HotCodeRelocation::hot
+ *                   HotCodeRelocation
+ */
+import java.lang.reflect.Method;
+
+import sun.hotspot.WhiteBox;
+import sun.hotspot.code.NMethod;
+
+public class HotCodeRelocation {
+  private static final WhiteBox WB = WhiteBox.getWhiteBox();
+
+  // CodeBlobType::MethodHot
+  private static final int METHOD_HOT = 3;
+  // CompLevel_full_optimization
+  private static final int COMP_LEVEL = 4;
+  private static final long TIMEOUT_MS = 60_000;
+
+  private static volatile boolean done;
+  private static volatile long sink;
+
+  // Runs long enough that the worker thread is nearly always inside it
+  static long hot(int n) {
+    long sum = 0;
+    for (int i = 0; i < n; i++) {
+      sum += i ^ (sum >>> 3);
+    }
+    return sum;
+  }
+
+  public static void main(String[] args) throws Exception {
+    Method hot = HotCodeRelocation.class.getDeclaredMethod("hot", int.class);
+    WB.enqueueMethodForCompilation(hot, COMP_LEVEL);
+    while (!WB.isMethodCompiled(hot)) {
+      Thread.sleep(10);
+    }
+    NMethod nm = NMethod.get(hot, false);
+    System.out.println("Compiled: " + nm);
+    if (nm.code_blob_type == METHOD_HOT) {
+      throw new RuntimeException("Method is in the hot code heap before it ran");
+    }
+
+    Thread worker = new Thread() {
+      public void run() {
+        while (!done) {
+          sink += hot(1_000_000);
+        }
+      }
+    };
+    worker.start();
+
+    // Every safepoint records that hot() is active on the worker's stack
+    long deadline = System.currentTimeMillis() + TIMEOUT_MS;
+    try {
+      while (System.currentTimeMillis() < deadline) {
+        WB.youngGC();
+        nm = NMethod.get(hot, false);
+        if (nm != null && nm.code_blob_type == METHOD_HOT) {
+          System.out.println("Relocated: " + nm);
+          return;
+        }
+        Thread.sleep(50);
+      }
+    } finally {
+      done = true;
+      worker.join();
+    }
+    throw new RuntimeException("hot() was not moved to the hot code heap: " + nm);
+  }
+}
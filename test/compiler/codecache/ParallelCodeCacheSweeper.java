@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Dedicated code cache sweeper threads flush unloaded nmethods in parallel
+ * @library /testlibrary
+ * @run main/othervm -XX:+UsePerfData -XX:CodeCacheSweeperThreads=2 -XX:NmethodSweepFraction=1
+ *                   -XX:NmethodSweepActivity=1 ParallelCodeCacheSweeper
+ */
+import java.lang.reflect.Method;
+
+import com.oracle.java.testlibrary.IsolatedClassLoader;
+import com.oracle.java.testlibrary.PerfCounters;
+
+public class ParallelCodeCacheSweeper {
+  private static final int LOADERS = 200;
+  private static final int ITERATIONS = 20_000;
+  private static final long TIMEOUT_MS = 60_000;
+
+  public static class Worker {
+    public static int work(int x) {
+      int sum = 0;
+      for (int i = 0; i < x; i++) {
+        sum += i ^ x;
+      }
+      return sum;
+    }
+  }
+
+  // Runs fresh copies of Worker so that their compiled code is unloaded
+  // together with the loaders and has to be flushed by the sweeper
+  private static long runWorkers(byte[] bytes) throws Exception {
+    long sum = 0;
+    for (int l = 0; l < LOADERS; l++) {
+      Class<?> c = new IsolatedClassLoader(Worker.class, bytes).loadClass(Worker.class.getName());
+      Method work = c.getMethod("work", int.class);
+      for (int i = 0; i < ITERATIONS; i++) {
+        sum += (Integer) work.invoke(null, i % 100);
+      }
+      if (l % 20 == 0) {
+        // Unload the workers and let the sweeper threads flush their code
+        System.gc();
+      }
+    }
+    return sum;
+  }
+
+  private static long counter(String name) throws Exception {
+    return PerfCounters.findByName("sun.ci.sweeper." + name).longValue();
+  }
+
+  public static void main(String[] args) throws Exception {
+    byte[] bytes = IsolatedClassLoader.getClassBytes(Worker.class);
+    long deadline = System.currentTimeMillis() + TIMEOUT_MS;
+    long sum = 0;
+    do {
+      sum += runWorkers(bytes);
+      System.out.println("sweeps = " + counter("sweeps") + " helpers = " + counter("helpers") +
+                         " flushed = " + counter("nmethodsFlushed"));
+      // A second sweeper thread has to have joined a sweep, and the code
+      // of the unloaded workers has to have been flushed
+      if (counter("helpers") > 0 && counter("nmethodsFlushed") > 0) {
+        System.out.println("sum = " + sum);
+        return;
+      }
+    } while (System.currentTimeMillis() < deadline);
+    throw new RuntimeException("The sweeper threads did not flush nmethods in parallel");
+  }
+}
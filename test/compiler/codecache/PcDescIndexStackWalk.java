@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Stack traces of compiled frames are correct with the PcDesc index
+ * @library /testlibrary
+ * @run main/othervm -XX:+UsePerfData -XX:+UsePcDescIndex -XX:PcDescIndexThreshold=1
+ *                   -XX:NmethodSweepFraction=1 -XX:NmethodSweepCheckInterval=1
+ *                   PcDescIndexStackWalk true
+ * @run main/othervm -XX:+UsePerfData -XX:-UsePcDescIndex -XX:PcDescIndexThreshold=1
+ *                   -XX:NmethodSweepFraction=1 -XX:NmethodSweepCheckInterval=1
+ *                   PcDescIndexStackWalk false
+ */
+import com.oracle.java.testlibrary.PerfCounters;
+
+public class PcDescIndexStackWalk {
+  private static final int DEPTH = 20;
+  private static final int ITERATIONS = 200_000;
+  private static final long TIMEOUT_MS = 60_000;
+
+  private static int recurse(int depth, int x) {
+    if (depth == 0) {
+      if (x % 1000 == 0) {
+        throw new RuntimeException("bottom");
+      }
+      return x;
+    }
+    return recurse(depth - 1, x) + 1;
+  }
+
+  private static void check(RuntimeException e) {
+    StackTraceElement[] trace = e.getStackTrace();
+    int frames = 0;
+    for (StackTraceElement element : trace) {
+      if (element.getMethodName().equals("recurse")) {
+        frames++;
+      }
+    }
+    if (frames != DEPTH + 1) {
+      throw new RuntimeException("Expected " + (DEPTH + 1) + " recurse frames, found " + frames, e);
+    }
+  }
+
+  private static long walk() {
+    long sum = 0;
+    for (int i = 1; i <= ITERATIONS; i++) {
+      try {
+        sum += recurse(DEPTH, i);
+      } catch (RuntimeException e) {
+        check(e);
+      }
+      if (i % 20_000 == 0) {
+        // Trigger safepoints and sweeps while the code is being walked
+        System.gc();
+      }
+    }
+    return sum;
+  }
+
+  private static long indexes() throws Exception {
+    return PerfCounters.findByName("sun.ci.sweeper.pcDescIndexes").longValue();
+  }
+
+  public static void main(String[] args) throws Exception {
+    boolean useIndex = Boolean.parseBoolean(args[0]);
+    long deadline = System.currentTimeMillis() + TIMEOUT_MS;
+    long sum = walk();
+    if (!useIndex) {
+      if (indexes() != 0) {
+        throw new RuntimeException("PcDesc indexes were built without UsePcDescIndex");
+      }
+    } else {
+      // Keep walking the stacks until the sweeper built an index, so that
+      // some of the walks went through it
+      while (indexes() == 0) {
+        if (System.currentTimeMillis() > deadline) {
+          throw new RuntimeException("No PcDesc index was built");
+        }
+        sum += walk();
+      }
+      sum += walk();
+    }
+    System.out.println("sum = " + sum + " indexes = " + indexes());
+  }
+}
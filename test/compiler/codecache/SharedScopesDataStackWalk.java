@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Stack traces are correct when nmethods share their debug info
+ * @library /testlibrary
+ * @run main SharedScopesDataStackWalk
+ */
+import java.lang.reflect.InvocationTargetException;
+import java.lang.reflect.Method;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+import com.oracle.java.testlibrary.*;
+
+public class SharedScopesDataStackWalk {
+  private static final int LOADERS = 8;
+  private static final int ITERATIONS = 50_000;
+
+  public static class Worker {
+    private static int inner(int x) {
+      if (x % 1000 == 0) {
+        throw new RuntimeException("inner");
+      }
+      return x * 31;
+    }
+
+    private static int middle(int x) {
+      return inner(x) + inner(x + 1);
+    }
+
+    public static int outer(int x) {
+      return middle(x) ^ middle(x + 2);
+    }
+  }
+
+  private static void check(Throwable t) {
+    String[] expected = { "inner", "middle", "outer" };
+    StackTraceElement[] trace = t.getStackTrace();
+    for (int i = 0; i < expected.length; i++) {
+      if (!trace[i].getMethodName().equals(expected[i])) {
+        throw new RuntimeException("Expected " + expected[i] + " at depth " + i + ", found " + trace[i], t);
+      }
+    }
+  }
+
+  public static class Workload {
+    public static void main(String[] args) throws Exception {
+      byte[] bytes = IsolatedClassLoader.getClassBytes(Worker.class);
+      // Fresh copies of Worker are compiled to nmethods with identical debug info
+      Method[] work = new Method[LOADERS];
+      for (int l = 0; l < LOADERS; l++) {
+        work[l] = new IsolatedClassLoader(Worker.class, bytes).loadClass(Worker.class.getName()).getMethod("outer", int.class);
+      }
+      long sum = 0;
+      for (int i = 1; i <= ITERATIONS; i++) {
+        for (int l = 0; l < LOADERS; l++) {
+          try {
+            sum += (Integer) work[l].invoke(null, i);
+          } catch (InvocationTargetException e) {
+            check(e.getCause());
+          }
+        }
+      }
+      System.out.println("sum = " + sum);
+    }
+  }
+
+  public static void main(String[] args) throws Exception {
+    ProcessBuilder pb = ProcessTools.createJavaProcessBuilder("-XX:+ShareDebugInfoAcrossNMethods",
+                                                              "-XX:+PrintCodeCache",
+                                                              Workload.class.getName());
+    OutputAnalyzer out = new OutputAnalyzer(pb.start());
+    out.shouldHaveExitValue(0);
+    Matcher m = Pattern.compile("shared scopes data: entries=(\\d+) size=\\d+ bytes saved=(\\d+) bytes").matcher(out.getStdout());
+    if (!m.find()) {
+      throw new RuntimeException("No shared scopes data statistics in output");
+    }
+    if (Long.parseLong(m.group(2)) == 0) {
+      throw new RuntimeException("No scopes data was shared between the Worker copies (entries=" + m.group(1) + ")");
+    }
+  }
+}
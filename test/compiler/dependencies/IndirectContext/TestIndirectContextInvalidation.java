@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Loading a class deoptimizes code whose dependencies have a super class
+ *          or an interface of the new class as context
+ * @library /testlibrary
+ * @run main TestIndirectContextInvalidation
+ */
+import com.oracle.java.testlibrary.*;
+
+public class TestIndirectContextInvalidation {
+  private static final int ITERATIONS = 100_000;
+
+  static abstract class A {
+    abstract int get();
+  }
+
+  static class B extends A {
+    int get() { return 1; }
+  }
+
+  // Loaded after callA has been compiled with a unique concrete
+  // method dependency on A.get()
+  static class C extends B {
+    int get() { return 2; }
+  }
+
+  interface I {
+    int value();
+  }
+
+  static class J implements I {
+    public int value() { return 1; }
+  }
+
+  // Loaded after callI has been compiled with a unique implementor
+  // dependency on I
+  static class K extends J {
+    public int value() { return 2; }
+  }
+
+  static int callA(A a) {
+    return a.get();
+  }
+
+  static int callI(I i) {
+    return i.value();
+  }
+
+  public static class Workload {
+    public static void main(String[] args) {
+      A b = new B();
+      I j = new J();
+      for (int i = 0; i < ITERATIONS; i++) {
+        callA(b);
+        callI(j);
+      }
+      if (callA(new C()) != 2) {
+        throw new RuntimeException("callA was not deoptimized");
+      }
+      if (callI(new K()) != 2) {
+        throw new RuntimeException("callI was not deoptimized");
+      }
+    }
+  }
+
+  public static void main(String[] args) throws Exception {
+    // VerifyDependencies checks all nmethods after each class load and
+    // reports the ones that the per-class dependency check missed
+    ProcessBuilder pb = ProcessTools.createJavaProcessBuilder("-XX:+IgnoreUnrecognizedVMOptions",
+                                                              "-XX:+VerifyDependencies",
+                                                              Workload.class.getName());
+    OutputAnalyzer out = new OutputAnalyzer(pb.start());
+    out.shouldHaveExitValue(0);
+    out.shouldNotContain("Should have been marked for deoptimization");
+  }
+}
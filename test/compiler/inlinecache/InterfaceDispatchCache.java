@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Megamorphic interface calls dispatch correctly through the
+ *          interface dispatch cache and report its hits and misses
+ * @library /testlibrary
+ * @run driver InterfaceDispatchCache
+ */
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.Platform;
+import com.oracle.java.testlibrary.ProcessTools;
+
+public class InterfaceDispatchCache {
+
+  public static void main(String[] args) throws Exception {
+    OutputAnalyzer out;
+
+    out = run("-XX:-UseInterfaceDispatchCache");
+    out.shouldNotContain("Interface dispatch cache:");
+
+    out = run("-XX:+UseInterfaceDispatchCache");
+    if (Platform.isX64()) {
+      out.shouldMatch("Interface dispatch cache: [1-9][0-9]* hits");
+    }
+
+    // Same call sites compiled by C2 only, with the cache probed by
+    // uncompressed klass pointers
+    if (Platform.is64bit()) {
+      run("-XX:+UseInterfaceDispatchCache", "-XX:-TieredCompilation", "-XX:-UseCompressedClassPointers");
+    }
+  }
+
+  private static OutputAnalyzer run(String... flags) throws Exception {
+    String[] args = new String[flags.length + 4];
+    args[0] = "-XX:+UnlockDiagnosticVMOptions";
+    args[1] = "-XX:+CountInterfaceDispatchCache";
+    System.arraycopy(flags, 0, args, 2, flags.length);
+    args[flags.length + 2] = Bench.class.getName();
+    args[flags.length + 3] = "20";
+    ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(args);
+    OutputAnalyzer out = new OutputAnalyzer(pb.start());
+    System.out.println(out.getOutput());
+    out.shouldHaveExitValue(0);
+    return out;
+  }
+
+  interface Shape {
+    int id();
+  }
+  static class S0  implements Shape { public int id() { return 0; } }
+  static class S1  implements Shape { public int id() { return 1; } }
+  static class S2  implements Shape { public int id() { return 2; } }
+  static class S3  implements Shape { public int id() { return 3; } }
+  static class S4  implements Shape { public int id() { return 4; } }
+  static class S5  implements Shape { public int id() { return 5; } }
+  static class S6  implements Shape { public int id() { return 6; } }
+  static class S7  implements Shape { public int id() { return 7; } }
+  static class S8  implements Shape { public int id() { return 8; } }
+  static class S9  implements Shape { public int id() { return 9; } }
+  static class S10 implements Shape { public int id() { return 10; } }
+  static class S11 implements Shape { public int id() { return 11; } }
+  static class S12 implements Shape { public int id() { return 12; } }
+  static class S13 implements Shape { public int id() { return 13; } }
+  static class S14 implements Shape { public int id() { return 14; } }
+  static class S15 implements Shape { public int id() { return 15; } }
+
+  // Measures megamorphic interface calls for 3, 4, 8 and 16 receiver
+  // types, in the style of a JMH average time benchmark: a warmup phase
+  // followed by measured iterations of a fixed number of operations.
+  public static class Bench {
+    private static final int OPERATIONS = 1_000_000;
+    private static final int WARMUP_ITERATIONS = 5;
+
+    private static final Shape[] SHAPES = {
+      new S0(), new S1(), new S2(), new S3(), new S4(), new S5(), new S6(), new S7(),
+      new S8(), new S9(), new S10(), new S11(), new S12(), new S13(), new S14(), new S15()
+    };
+
+    private static final int[] WAYS = { 3, 4, 8, 16 };
+
+    // One call site per polymorphism degree, so that each of them sees
+    // exactly its receiver types. C2 inlines call sites with two receiver
+    // types, so the smallest one has three to stay megamorphic.
+    static int call3(Shape s)  { return s.id(); }
+    static int call4(Shape s)  { return s.id(); }
+    static int call8(Shape s)  { return s.id(); }
+    static int call16(Shape s) { return s.id(); }
+
+    static int call(int ways, Shape s) {
+      switch (ways) {
+        case 3:  return call3(s);
+        case 4:  return call4(s);
+        case 8:  return call8(s);
+        default: return call16(s);
+      }
+    }
+
+    static long iteration(int ways, Shape[] receivers) {
+      long sum = 0;
+      for (int i = 0; i < OPERATIONS; i++) {
+        Shape s = receivers[i % ways];
+        int id = call(ways, s);
+        if (id != i % ways) {
+          throw new RuntimeException("Wrong method called: expected S" + (i % ways) + " but got S" + id);
+        }
+        sum += id;
+      }
+      return sum;
+    }
+
+    public static void main(String[] args) {
+      int iterations = Integer.parseInt(args[0]);
+      for (int ways : WAYS) {
+        Shape[] receivers = new Shape[ways];
+        System.arraycopy(SHAPES, 0, receivers, 0, ways);
+
+        for (int i = 0; i < WARMUP_ITERATIONS; i++) {
+          iteration(ways, receivers);
+        }
+        long start = System.nanoTime();
+        for (int i = 0; i < iterations; i++) {
+          iteration(ways, receivers);
+          if (i % 5 == 4) {
+            System.gc();
+          }
+        }
+        double ns = (double)(System.nanoTime() - start) / ((double)iterations * OPERATIONS);
+        System.out.println(String.format("Benchmark megamorphic.interface.%dway  avgt  %6.3f ns/op", ways, ns));
+      }
+    }
+  }
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Virtual call sites that turn megamorphic while other threads
+ *          execute them dispatch to the right methods
+ * @run main/othervm -XX:-BackgroundCompilation MegamorphicVirtualCalls
+ */
+public class MegamorphicVirtualCalls {
+  private static final int THREADS = 4;
+  private static final int ITERATIONS = 200_000;
+
+  static abstract class Shape {
+    abstract int id();
+  }
+  static class S0 extends Shape { int id() { return 0; } }
+  static class S1 extends Shape { int id() { return 1; } }
+  static class S2 extends Shape { int id() { return 2; } }
+  static class S3 extends Shape { int id() { return 3; } }
+  static class S4 extends Shape { int id() { return 4; } }
+
+  private static final Shape[] SHAPES = { new S0(), new S1(), new S2(), new S3(), new S4() };
+
+  static int call(Shape s) {
+    return s.id();
+  }
+
+  public static void main(String[] args) throws Exception {
+    final Throwable[] failure = new Throwable[1];
+    Thread[] threads = new Thread[THREADS];
+    for (int t = 0; t < THREADS; t++) {
+      final int offset = t;
+      threads[t] = new Thread() {
+        public void run() {
+          try {
+            for (int i = 0; i < ITERATIONS; i++) {
+              // Start monomorphic and add receiver types over time so
+              // that the call site goes through all IC states
+              int kinds = 1 + Math.min(SHAPES.length - 1, i / (ITERATIONS / 10));
+              int k = (i + offset) % kinds;
+              if (call(SHAPES[k]) != k) {
+                throw new RuntimeException("Wrong method called for S" + k);
+              }
+            }
+          } catch (Throwable e) {
+            synchronized (failure) {
+              failure[0] = e;
+            }
+          }
+        }
+      };
+      threads[t].start();
+    }
+    for (Thread thread : threads) {
+      thread.join();
+    }
+    if (failure[0] != null) {
+      throw new RuntimeException(failure[0]);
+    }
+  }
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @key gc
+ * @summary Unload nmethods of unloaded classes with the GC worker threads
+ * @library /testlibrary /testlibrary/whitebox
+ * @build TestParallelCodeCacheUnloading
+ * @run main ClassFileInstaller sun.hotspot.WhiteBox
+ * @run driver TestParallelCodeCacheUnloading
+ */
+
+import com.oracle.java.testlibrary.IsolatedClassLoader;
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+import java.lang.reflect.Method;
+import java.util.ArrayList;
+import java.util.Arrays;
+import sun.hotspot.WhiteBox;
+
+public class TestParallelCodeCacheUnloading {
+
+  private static OutputAnalyzer run(String mode, String... flags) throws Exception {
+    ArrayList<String> args = new ArrayList<String>();
+    args.add("-Xbootclasspath/a:.");
+    args.add("-XX:+UnlockDiagnosticVMOptions");
+    args.add("-XX:+WhiteBoxAPI");
+    args.add("-XX:ParallelGCThreads=4");
+    args.add("-XX:+PrintGCDetails");
+    args.add("-XX:+TraceClassUnloading");
+    args.addAll(Arrays.asList(flags));
+    args.add(UnloadCompiledClasses.class.getName());
+    args.add(mode);
+    ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(args.toArray(new String[args.size()]));
+    OutputAnalyzer out = new OutputAnalyzer(pb.start());
+    out.shouldHaveExitValue(0);
+    // Workers with compiled code were unloaded, which requires that their
+    // nmethods were unloaded first
+    out.shouldMatch("compiled workers = [1-9]");
+    out.shouldContain("[Unloading class " + Worker.class.getName() + " ");
+    return out;
+  }
+
+  public static void main(String args[]) throws Exception {
+    OutputAnalyzer out;
+
+    // The remark pause reports the per-worker times at the finest level
+    out = run("concurrent", "-XX:+UseG1GC", "-XX:+UnlockExperimentalVMOptions", "-XX:G1LogLevel=finest");
+    out.shouldContain("Code Cache Unloading (ms)");
+    out.shouldContain("Cleaned NMethods");
+
+    out = run("concurrent", "-XX:+UseG1GC", "-XX:+UnlockExperimentalVMOptions", "-XX:G1LogLevel=finer");
+    out.shouldNotContain("Code Cache Unloading (ms)");
+
+    run("full", "-XX:+UseG1GC");
+    run("full", "-XX:+UseG1GC", "-XX:-ParallelCodeCacheUnloading");
+
+    // CMS collects the unloaded classes in its remark pause
+    run("system", "-XX:+UseConcMarkSweepGC", "-XX:+ExplicitGCInvokesConcurrent", "-XX:+CMSClassUnloadingEnabled");
+    run("system", "-XX:+UseConcMarkSweepGC", "-XX:+ExplicitGCInvokesConcurrent", "-XX:+CMSClassUnloadingEnabled",
+        "-XX:-ParallelCodeCacheUnloading");
+  }
+
+  public static class Worker {
+    public static int work(int x) {
+      int sum = 0;
+      for (int i = 0; i < x; i++) {
+        sum += i ^ x;
+      }
+      return sum;
+    }
+  }
+
+  public static class UnloadCompiledClasses {
+    private static final int LOADERS = 30;
+    private static final int ITERATIONS = 20_000;
+
+    private static void collect(String mode) throws Exception {
+      WhiteBox wb = WhiteBox.getWhiteBox();
+      if (mode.equals("concurrent")) {
+        wb.g1StartConcMarkCycle();
+        while (wb.g1InConcurrentMark()) {
+          Thread.sleep(5);
+        }
+      } else if (mode.equals("full")) {
+        wb.fullGC();
+      } else {
+        System.gc();
+      }
+    }
+
+    public static void main(String[] args) throws Exception {
+      WhiteBox wb = WhiteBox.getWhiteBox();
+      byte[] bytes = IsolatedClassLoader.getClassBytes(Worker.class);
+      long sum = 0;
+      int compiled = 0;
+      for (int l = 0; l < LOADERS; l++) {
+        // A fresh copy of Worker is unloaded together with its loader
+        Class<?> c = new IsolatedClassLoader(Worker.class, bytes).loadClass(Worker.class.getName());
+        Method work = c.getMethod("work", int.class);
+        for (int i = 0; i < ITERATIONS; i++) {
+          sum += (Integer) work.invoke(null, i % 100);
+        }
+        if (wb.isMethodCompiled(work)) {
+          compiled++;
+        }
+        if (l % 10 == 9) {
+          collect(args[0]);
+        }
+      }
+      System.out.println("sum = " + sum);
+      System.out.println("compiled workers = " + compiled);
+    }
+  }
+}
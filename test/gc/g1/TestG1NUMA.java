@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test TestG1NUMA
+ * @key gc
+ * @summary Verify that G1 runs with -XX:+UseNUMA, which on hosts with several nodes
+ *          binds regions to nodes and allocates eden and survivor regions per node.
+ *          The per-node heap summary is checked on Linux hosts with several nodes.
+ * @library /testlibrary
+ * @run main TestG1NUMA
+ */
+
+import com.oracle.java.testlibrary.*;
+
+import java.io.File;
+import java.nio.file.Files;
+import java.util.ArrayList;
+import java.util.List;
+
+class TestG1NUMAHelper {
+
+    static final int NUM_THREADS = 4;
+    static final int ALLOCATIONS_PER_THREAD = 20000;
+
+    static volatile Object sink;
+
+    public static void main(String[] args) throws Exception {
+        final List<Object> live = new ArrayList<Object>();
+        Thread[] threads = new Thread[NUM_THREADS];
+        for (int i = 0; i < NUM_THREADS; i++) {
+            threads[i] = new Thread() {
+                public void run() {
+                    List<byte[]> mine = new ArrayList<byte[]>();
+                    for (int j = 0; j < ALLOCATIONS_PER_THREAD; j++) {
+                        byte[] b = new byte[1024];
+                        sink = b;
+                        // Keep some objects alive so that they get copied
+                        // to survivor and old regions.
+                        if (j % 100 == 0) {
+                            mine.add(b);
+                        }
+                    }
+                    synchronized (live) {
+                        live.add(mine);
+                    }
+                }
+            };
+            threads[i].start();
+        }
+        for (Thread t : threads) {
+            t.join();
+        }
+        System.gc();
+        System.out.println(live.size());
+    }
+}
+
+public class TestG1NUMA {
+
+    public static void main(String[] args) throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            "-XX:+UseG1GC", "-Xmx64m", "-Xmn8m", "-XX:G1HeapRegionSize=1m",
+            "-XX:+UseNUMA",
+            "-XX:+UnlockDiagnosticVMOptions", "-XX:+VerifyAfterGC",
+            "-XX:+PrintHeapAtGC", "-XX:+PrintFlagsFinal",
+            TestG1NUMAHelper.class.getName());
+
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldContain("garbage-first heap");
+        output.shouldHaveExitValue(0);
+
+        // The VM turns UseNUMA off if it cannot use the NUMA API.
+        boolean numa = output.getStdout().matches("(?s).*bool UseNUMA\\s+:?= true.*");
+        int nodes = nodesWithMemory();
+        System.out.println("UseNUMA: " + numa + ", nodes with memory: " + nodes);
+        if (numa && nodes > 1) {
+            output.shouldContain("node 0 (id ");
+            output.shouldContain("node 1 (id ");
+        } else if (nodes == 1) {
+            output.shouldNotContain("node 0 (id ");
+        }
+    }
+
+    // Returns the number of NUMA nodes that have memory, or -1 if unknown.
+    static int nodesWithMemory() throws Exception {
+        File file = new File("/sys/devices/system/node/has_memory");
+        if (!file.exists()) {
+            return -1;
+        }
+        // A list of node ranges such as "0-1,3"
+        String list = new String(Files.readAllBytes(file.toPath())).trim();
+        if (list.isEmpty()) {
+            return -1;
+        }
+        int nodes = 0;
+        for (String range : list.split(",")) {
+            String[] bounds = range.split("-");
+            int low = Integer.parseInt(bounds[0]);
+            int high = bounds.length > 1 ? Integer.parseInt(bounds[1]) : low;
+            nodes += high - low + 1;
+        }
+        return nodes;
+    }
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test TestParallelFullGC
+ * @summary Check that the G1 full collection using the GC worker threads
+ * keeps the object graph intact and logs its phases.
+ * @key gc
+ * @library /testlibrary
+ */
+
+import java.lang.ref.WeakReference;
+import java.util.ArrayList;
+import java.util.Random;
+
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+
+public class TestParallelFullGC {
+
+    private static final String[] PHASES = {
+        "Parallel Full GC",
+        "Marking (ms)",
+        "Prepare Compaction (ms)",
+        "Adjust Pointers (ms)",
+        "Compaction (ms)",
+    };
+
+    private static OutputAnalyzer run(String... flags) throws Exception {
+        ArrayList<String> args = new ArrayList<String>();
+        args.add("-XX:+UseG1GC");
+        args.add("-Xmx128m");
+        args.add("-XX:G1HeapRegionSize=1m");
+        args.add("-XX:ParallelGCThreads=4");
+        args.add("-XX:+PrintGCDetails");
+        args.add("-XX:+UnlockExperimentalVMOptions");
+        args.add("-XX:G1LogLevel=finest");
+        for (String flag : flags) {
+            args.add(flag);
+        }
+        args.add(Workload.class.getName());
+
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(args.toArray(new String[0]));
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+        output.shouldContain("Workload passed");
+        return output;
+    }
+
+    public static void main(String[] args) throws Exception {
+        OutputAnalyzer output = run();
+        for (String phase : PHASES) {
+            output.shouldContain(phase);
+        }
+        output.shouldContain("Marked Objects");
+        output.shouldContain("Compacted Regions");
+
+        run("-XX:+ParallelRefProcEnabled");
+        run("-XX:+UseStringDeduplication");
+        run("-XX:-ClassUnloading");
+        run("-XX:+UnlockDiagnosticVMOptions", "-XX:+VerifyBeforeGC",
+            "-XX:+VerifyDuringGC", "-XX:+VerifyAfterGC");
+
+        output = run("-XX:-G1ParallelFullGC");
+        output.shouldNotContain("Parallel Full GC");
+    }
+
+    static class Node {
+        Node next;
+        Object[] refs;
+        final int value;
+
+        Node(int value) {
+            this.value = value;
+        }
+    }
+
+    static class Workload {
+        private static final int LISTS = 64;
+        private static final int LENGTH = 2000;
+
+        private static Node[] lists = new Node[LISTS];
+        private static long[] sums = new long[LISTS];
+
+        private static void build(Random rnd) {
+            for (int i = 0; i < LISTS; i++) {
+                Node head = null;
+                long sum = 0;
+                for (int j = 0; j < LENGTH; j++) {
+                    Node n = new Node(rnd.nextInt());
+                    // Interleave garbage so that the live objects are moved.
+                    Object garbage = new byte[rnd.nextInt(256)];
+                    n.next = head;
+                    head = n;
+                    sum += n.value;
+                }
+                lists[i] = head;
+                sums[i] = sum;
+            }
+            // Large arrays are scanned in chunks by several workers.
+            for (int i = 0; i < LISTS; i += 8) {
+                Object[] array = new Object[100000];
+                Node n = lists[i];
+                for (int j = 0; j < array.length; j++) {
+                    array[j] = n;
+                    n = (n.next == null) ? lists[i] : n.next;
+                }
+                lists[i].refs = array;
+            }
+        }
+
+        private static void verify() {
+            for (int i = 0; i < LISTS; i++) {
+                long sum = 0;
+                for (Node n = lists[i]; n != null; n = n.next) {
+                    sum += n.value;
+                }
+                if (sum != sums[i]) {
+                    throw new RuntimeException("List " + i + " is corrupted");
+                }
+                Object[] array = lists[i].refs;
+                if (array != null) {
+                    for (int j = 0; j < array.length; j++) {
+                        if (!(array[j] instanceof Node)) {
+                            throw new RuntimeException("Array " + i + " is corrupted at " + j);
+                        }
+                    }
+                }
+            }
+        }
+
+        public static void main(String[] args) {
+            Random rnd = new Random(42);
+            build(rnd);
+
+            Object strong = new Object();
+            WeakReference<Object> live = new WeakReference<Object>(strong);
+            WeakReference<Object> dead = new WeakReference<Object>(new Object());
+            Object humongous = new long[512 * 1024];
+
+            for (int i = 0; i < 5; i++) {
+                System.gc();
+                verify();
+                // Replace some of the lists to create fragmentation.
+                int index = rnd.nextInt(LISTS);
+                Node head = null;
+                long sum = 0;
+                for (int j = 0; j < LENGTH; j++) {
+                    Node n = new Node(rnd.nextInt());
+                    n.next = head;
+                    head = n;
+                    sum += n.value;
+                }
+                lists[index] = head;
+                sums[index] = sum;
+            }
+
+            if (live.get() != strong) {
+                throw new RuntimeException("Reachable referent was cleared");
+            }
+            if (dead.get() != null) {
+                throw new RuntimeException("Unreachable referent was not cleared");
+            }
+            if (((long[]) humongous).length != 512 * 1024) {
+                throw new RuntimeException("Humongous object is corrupted");
+            }
+            System.out.println("Workload passed");
+        }
+    }
+}
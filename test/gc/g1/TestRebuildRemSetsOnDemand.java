@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test TestRebuildRemSetsOnDemand
+ * @key gc
+ * @summary Verify that remembered sets rebuilt after marking with -XX:+G1RebuildRemSetsOnDemand are complete
+ *          and that dropping the remembered set of a region keeps its strong code roots
+ * @library /testlibrary /testlibrary/whitebox
+ * @build TestSummarizeRSetStatsTools TestRebuildRemSetsOnDemand
+ * @run main ClassFileInstaller sun.hotspot.WhiteBox
+ * @run main TestRebuildRemSetsOnDemand
+ */
+
+import com.oracle.java.testlibrary.*;
+import sun.hotspot.WhiteBox;
+
+import java.lang.reflect.Method;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.List;
+
+class TestRebuildRemSetsOnDemandHelper {
+
+    // Objects whose addresses are embedded in compiled code. They are only
+    // allocated when the class is initialized from codeRoots().
+    static class Constants {
+        static final byte[] C0 = new byte[ALLOCATION_SIZE];
+        static final byte[] C1 = new byte[ALLOCATION_SIZE];
+        static final byte[] C2 = new byte[ALLOCATION_SIZE];
+        static final byte[] C3 = new byte[ALLOCATION_SIZE];
+    }
+
+    static Object constant0() { return Constants.C0; }
+    static Object constant1() { return Constants.C1; }
+    static Object constant2() { return Constants.C2; }
+    static Object constant3() { return Constants.C3; }
+
+    static final int ALLOCATION_SIZE = 20000;
+    static final int ALLOCATION_COUNT = 15;
+
+    static final List<Object[]> liveOldObjects = new ArrayList<Object[]>();
+    static final List<byte[]> newObjects = new ArrayList<byte[]>();
+
+    private static void waitTillCMCFinished(WhiteBox wb) {
+        while (wb.g1InConcurrentMark()) {
+            try {
+                Thread.sleep(10);
+            } catch (InterruptedException e) {
+            }
+        }
+    }
+
+    private static void compile(WhiteBox wb, Method m) throws Exception {
+        // Try C2 first, then C1 for VMs without it.
+        if (!wb.enqueueMethodForCompilation(m, 4)) {
+            wb.enqueueMethodForCompilation(m, 1);
+        }
+        for (int i = 0; i < 1000 && !wb.isMethodCompiled(m); i++) {
+            Thread.sleep(10);
+        }
+        if (!wb.isMethodCompiled(m)) {
+            throw new RuntimeException(m + " was not compiled");
+        }
+    }
+
+    private static void checkConstants() {
+        if (constant0() != Constants.C0 || constant1() != Constants.C1 ||
+            constant2() != Constants.C2 || constant3() != Constants.C3) {
+            throw new RuntimeException("compiled code refers to a stale copy of a constant");
+        }
+    }
+
+    // Embeds references to old objects in compiled code, lets the regions
+    // holding them lose their remembered sets while they are mostly live,
+    // and then has them rebuilt and evacuated by mixed collections. The
+    // compiled code is only updated if the regions kept their code roots.
+    private static void codeRoots(WhiteBox wb) throws Exception {
+        List<byte[]> filler = new ArrayList<byte[]>();
+        for (int i = 0; i < ALLOCATION_COUNT; i++) {
+            filler.add(new byte[ALLOCATION_SIZE]);
+        }
+        checkConstants(); // initializes Constants
+        for (int i = 0; i < ALLOCATION_COUNT; i++) {
+            filler.add(new byte[ALLOCATION_SIZE]);
+        }
+        for (int i = 0; i < 4; i++) {
+            compile(wb, TestRebuildRemSetsOnDemandHelper.class.getDeclaredMethod("constant" + i));
+        }
+        wb.youngGC();
+        wb.youngGC();
+
+        // The old regions are almost entirely live, so they are not
+        // candidates and their remembered sets are dropped.
+        waitTillCMCFinished(wb);
+        wb.g1StartConcMarkCycle();
+        waitTillCMCFinished(wb);
+        wb.youngGC();
+        checkConstants();
+
+        // Now they are mostly garbage, so their remembered sets are rebuilt
+        // and mixed collections evacuate them.
+        filler.clear();
+        wb.g1StartConcMarkCycle();
+        waitTillCMCFinished(wb);
+        wb.youngGC();
+        for (int i = 0; i < ALLOCATION_COUNT * 20; i++) {
+            try {
+                newObjects.add(new byte[ALLOCATION_SIZE]);
+            } catch (OutOfMemoryError e) {
+                newObjects.clear();
+                break;
+            }
+            checkConstants();
+        }
+        wb.youngGC();
+        checkConstants();
+    }
+
+    public static void main(String[] args) throws Exception {
+        WhiteBox wb = WhiteBox.getWhiteBox();
+
+        if (args.length > 0 && args[0].equals("codeRoots")) {
+            codeRoots(wb);
+            return;
+        }
+
+        // Mix live and dead objects in the old regions, and make the live
+        // ones refer to each other so that the rebuilt remembered sets
+        // have something to hold.
+        List<byte[]> deadOldObjects = new ArrayList<byte[]>();
+        Object[] previous = null;
+        for (int i = 0; i < ALLOCATION_COUNT; ++i) {
+            Object[] holder = new Object[] { new byte[ALLOCATION_SIZE * 5], previous };
+            liveOldObjects.add(holder);
+            deadOldObjects.add(new byte[ALLOCATION_SIZE * 5]);
+            previous = holder;
+        }
+        // MaxTenuringThreshold=1 promotes everything with two young collections.
+        wb.youngGC();
+        wb.youngGC();
+        deadOldObjects = null;
+
+        waitTillCMCFinished(wb);
+        wb.g1StartConcMarkCycle();
+        waitTillCMCFinished(wb);
+        wb.youngGC();
+
+        // Provoke mixed collections of the regions whose remembered set
+        // has been rebuilt; heap verification checks them in every pause.
+        for (int i = 0; i < ALLOCATION_COUNT * 20; i++) {
+            try {
+                newObjects.add(new byte[ALLOCATION_SIZE]);
+            } catch (OutOfMemoryError e) {
+                newObjects.clear();
+                break;
+            }
+        }
+
+        // Finally do a full collection, after which all old remembered sets
+        // are untracked again, and mark once more.
+        wb.fullGC();
+        wb.g1StartConcMarkCycle();
+        waitTillCMCFinished(wb);
+        wb.youngGC();
+
+        System.out.println(liveOldObjects.size());
+    }
+}
+
+public class TestRebuildRemSetsOnDemand {
+
+    public static void main(String[] args) throws Exception {
+        if (!TestSummarizeRSetStatsTools.testingG1GC()) {
+            return;
+        }
+
+        OutputAnalyzer output = run("100");
+        output.shouldContain("[GC concurrent-rebuild-remsets-start");
+        output.shouldContain("[GC concurrent-rebuild-remsets-end");
+        output.shouldContain("(mixed)");
+        output.shouldHaveExitValue(0);
+
+        // With the default live threshold, almost entirely live regions are
+        // not candidates, which is when their remembered sets are dropped.
+        output = run("85", "codeRoots");
+        output.shouldContain("[GC concurrent-rebuild-remsets-end");
+        output.shouldContain("(mixed)");
+        output.shouldNotContain("not in strong code roots");
+        output.shouldHaveExitValue(0);
+    }
+
+    private static OutputAnalyzer run(String liveThresholdPercent, String... helperArgs) throws Exception {
+        List<String> args = new ArrayList<String>();
+        Collections.addAll(args,
+            "-XX:+UseG1GC", "-Xmx14m", "-Xms14m", "-XX:G1HeapRegionSize=1m",
+            "-XX:SurvivorRatio=1", "-XX:MaxTenuringThreshold=1",
+            "-XX:InitiatingHeapOccupancyPercent=100", "-XX:G1HeapWastePercent=0",
+            "-XX:+UnlockExperimentalVMOptions", "-XX:G1MixedGCLiveThresholdPercent=" + liveThresholdPercent,
+            "-XX:+G1RebuildRemSetsOnDemand",
+            "-XX:+UnlockDiagnosticVMOptions", "-XX:+VerifyBeforeGC", "-XX:+VerifyAfterGC",
+            "-XX:+G1VerifyHeapRegionCodeRoots",
+            "-XX:-BackgroundCompilation",
+            "-XX:+PrintGC",
+            "-Xbootclasspath/a:.", "-XX:+WhiteBoxAPI",
+            "-cp", System.getProperty("java.class.path"),
+            TestRebuildRemSetsOnDemandHelper.class.getName());
+        Collections.addAll(args, helperArgs);
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(args.toArray(new String[args.size()]));
+        return new OutputAnalyzer(pb.start());
+    }
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test TestSummarizeRSetStatsContainers.java
+ * @library /testlibrary
+ * @build TestSummarizeRSetStatsTools TestSummarizeRSetStatsContainers
+ * @summary Verify the remembered set container sizes printed by -XX:+G1SummarizeRSetStats
+ * @run main TestSummarizeRSetStatsContainers
+ */
+
+import com.oracle.java.testlibrary.*;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+class SparseCrossRegionReferences {
+    static final int REGION_SIZE = 1024 * 1024;
+    static final int SOURCE_REGIONS = 6;
+    // Fewer than G1RSetCardArrayEntries (128 with 1M regions), but more
+    // than a sparse table entry holds.
+    static final int HOLDERS_PER_REGION = 20;
+
+    static Object target;
+    static List<Object> keepAlive = new ArrayList<Object>();
+
+    public static void main(String[] args) {
+        target = new Object();
+        // Separate the target from the holders.
+        keepAlive.add(new byte[REGION_SIZE]);
+        int fillerSize = REGION_SIZE / HOLDERS_PER_REGION - 64;
+        for (int i = 0; i < SOURCE_REGIONS * HOLDERS_PER_REGION; i++) {
+            // Each holder is on a card of its own, so every source region
+            // references the target region from about HOLDERS_PER_REGION
+            // cards.
+            keepAlive.add(new Object[] { target });
+            keepAlive.add(new byte[fillerSize]);
+        }
+        // Promote everything; the full collection keeps the allocation
+        // order and rebuilds the remembered sets.
+        System.gc();
+        System.gc();
+    }
+}
+
+public class TestSummarizeRSetStatsContainers {
+
+    private static final Pattern CARD_ARRAYS = Pattern.compile("in (\\d+) card arrays");
+    private static final Pattern CARD_ARRAY_SIZES =
+        Pattern.compile("(\\d+)([BKMG]) \\(\\s*[\\d.]+%\\) in (\\d+) card arrays, (\\d+)([BKMG]) as bitmaps");
+    private static final Pattern BITMAPS = Pattern.compile("in (\\d+) bitmaps");
+
+    private static int countMatches(String result, Pattern pattern) {
+        Matcher m = pattern.matcher(result);
+        int count = 0;
+        while (m.find()) {
+            count++;
+        }
+        return count;
+    }
+
+    private static void expectContainerSummaries(String result, int expected) throws Exception {
+        int actualTotal = result.split("Container sizes").length - 1;
+        if (actualTotal != expected) {
+            throw new Exception("Incorrect amount of container size summaries. Expected " + expected + ", got " + actualTotal);
+        }
+        if (countMatches(result, CARD_ARRAYS) != expected || countMatches(result, BITMAPS) != expected) {
+            throw new Exception("Container size summaries do not mention card arrays and bitmaps");
+        }
+    }
+
+    private static void expectNoCardArrays(String result) throws Exception {
+        Matcher m = CARD_ARRAYS.matcher(result);
+        while (m.find()) {
+            if (Integer.parseInt(m.group(1)) != 0) {
+                throw new Exception("Found card arrays although they are disabled: " + m.group());
+            }
+        }
+    }
+
+    private static long toBytes(String size, String unit) {
+        long value = Long.parseLong(size);
+        switch (unit.charAt(0)) {
+            case 'G': return value * 1024 * 1024 * 1024;
+            case 'M': return value * 1024 * 1024;
+            case 'K': return value * 1024;
+            default:  return value;
+        }
+    }
+
+    // Checks that some summary reports tables using card arrays, and that
+    // these take less memory than bitmaps would.
+    private static void expectSmallCardArrays(String result) throws Exception {
+        Matcher m = CARD_ARRAY_SIZES.matcher(result);
+        boolean found = false;
+        while (m.find()) {
+            long num = Long.parseLong(m.group(3));
+            if (num == 0) {
+                continue;
+            }
+            found = true;
+            long arrays = toBytes(m.group(1), m.group(2));
+            long asBitmaps = toBytes(m.group(4), m.group(5));
+            if (arrays >= asBitmaps) {
+                throw new Exception("Card arrays do not save memory: " + m.group());
+            }
+        }
+        if (!found) {
+            throw new Exception("No remembered set used card arrays");
+        }
+    }
+
+    public static void main(String[] args) throws Exception {
+        String result;
+
+        if (!TestSummarizeRSetStatsTools.testingG1GC()) {
+            return;
+        }
+
+        // container sizes are part of every remembered set summary
+        result = TestSummarizeRSetStatsTools.runTest(new String[] { "-XX:+G1SummarizeRSetStats", "-XX:G1SummarizeRSetStatsPeriod=1" }, 3);
+        expectContainerSummaries(result, 1 + 6);
+
+        // without card arrays all fine-grain tables are bitmaps
+        result = TestSummarizeRSetStatsTools.runTest(new String[] { "-XX:+G1SummarizeRSetStats", "-XX:G1SummarizeRSetStatsPeriod=1",
+                                                                    "-XX:G1RSetCardArrayEntries=0" }, 3);
+        expectContainerSummaries(result, 1 + 6);
+        expectNoCardArrays(result);
+
+        // tiny card arrays overflow into bitmaps almost immediately
+        result = TestSummarizeRSetStatsTools.runTest(new String[] { "-XX:+G1SummarizeRSetStats", "-XX:G1SummarizeRSetStatsPeriod=1",
+                                                                    "-XX:G1RSetCardArrayEntries=1", "-XX:+VerifyAfterGC" }, 3);
+        expectContainerSummaries(result, 1 + 6);
+
+        // sparse references from other regions are kept in card arrays
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            "-XX:+UseG1GC", "-Xmn4m", "-Xmx32m", "-XX:G1HeapRegionSize=1M",
+            "-XX:InitiatingHeapOccupancyPercent=100",
+            "-XX:+UnlockDiagnosticVMOptions",
+            "-XX:+G1SummarizeRSetStats", "-XX:G1SummarizeRSetStatsPeriod=1",
+            SparseCrossRegionReferences.class.getName());
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+        expectSmallCardArrays(output.getStdout());
+    }
+}
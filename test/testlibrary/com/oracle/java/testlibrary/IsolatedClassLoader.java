@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package com.oracle.java.testlibrary;
+
+import java.io.ByteArrayOutputStream;
+import java.io.IOException;
+import java.io.InputStream;
+
+/**
+ * {@code IsolatedClassLoader} defines its own copy of a class that is also
+ * on the class path, instead of delegating to its parent for it. Every
+ * loader yields a distinct class, which can be unloaded together with the
+ * loader and the code compiled for it.
+ *
+ * @see ByteCodeLoader
+ */
+public class IsolatedClassLoader extends ClassLoader {
+    private final String className;
+    private final byte[] byteCode;
+
+    /**
+     * Creates a new {@code IsolatedClassLoader} that defines a copy of the
+     * given class from the given byte code. All other classes are loaded
+     * by the loader of the given class.
+     *
+     * @param c The class to copy
+     * @param byteCode The byte code of the class, see {@link #getClassBytes}
+     */
+    public IsolatedClassLoader(Class<?> c, byte[] byteCode) {
+        super(c.getClassLoader());
+        this.className = c.getName();
+        this.byteCode = byteCode;
+    }
+
+    @Override
+    protected Class<?> loadClass(String name, boolean resolve) throws ClassNotFoundException {
+        if (!name.equals(className)) {
+            return super.loadClass(name, resolve);
+        }
+        synchronized (getClassLoadingLock(name)) {
+            Class<?> c = findLoadedClass(name);
+            if (c == null) {
+                c = defineClass(name, byteCode, 0, byteCode.length);
+            }
+            if (resolve) {
+                resolveClass(c);
+            }
+            return c;
+        }
+    }
+
+    /**
+     * Reads the byte code of the given class from the class path.
+     *
+     * @param c The class
+     * @throws IOException if the class file can't be read
+     * @return The byte code of the class
+     */
+    public static byte[] getClassBytes(Class<?> c) throws IOException {
+        String resource = c.getName().replace('.', '/') + ".class";
+        try (InputStream in = c.getClassLoader().getResourceAsStream(resource)) {
+            if (in == null) {
+                throw new IOException("Class file of " + c.getName() + " not found");
+            }
+            ByteArrayOutputStream out = new ByteArrayOutputStream();
+            byte[] buffer = new byte[4096];
+            int n;
+            while ((n = in.read(buffer)) > 0) {
+                out.write(buffer, 0, n);
+            }
+            return out.toByteArray();
+        }
+    }
+}
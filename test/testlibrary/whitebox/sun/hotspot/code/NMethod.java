@@ -34,14 +34,16 @@ public class NMethod {
     return obj == null ? null : new NMethod(obj);
   }
   private NMethod(Object[] obj) {
-    assert obj.length == 3;
+    assert obj.length == 4;
     comp_level = (Integer) obj[0];
     compile_id = (Integer) obj[1];
     insts = (byte[]) obj[2];
+    code_blob_type = (Integer) obj[3];
   }
   public final byte[] insts;
   public final int comp_level;
   public final int compile_id;
+  public final int code_blob_type;
 
   @Override
   public String toString() {
@@ -49,6 +51,7 @@ public class NMethod {
         "insts=" + insts +
         ", comp_level=" + comp_level +
         ", compile_id=" + compile_id +
+        ", code_blob_type=" + code_blob_type +
         '}';
   }
 }